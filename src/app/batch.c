@@ -0,0 +1,371 @@
+/**
+ * @file batch.c
+ * @brief Multi-core batch processing of recorded sessions
+ */
+
+#include "batch.h"
+#include "../dsp/simd_dispatch.h"
+#include "../platform/platform.h"
+#include "../utils/atomic_compat.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ============================================================================
+// Job list
+// ============================================================================
+
+static char *str_dup(const char *s) {
+  size_t n = strlen(s) + 1;
+  char *d = (char *)malloc(n);
+  if (d)
+    memcpy(d, s, n);
+  return d;
+}
+
+static int has_suffix(const char *s, const char *suffix) {
+  size_t n = strlen(s), m = strlen(suffix);
+  if (n < m)
+    return 0;
+  for (size_t i = 0; i < m; i++) {
+    char c = s[n - m + i];
+    if (c >= 'A' && c <= 'Z')
+      c = (char)(c - 'A' + 'a');
+    if (c != suffix[i])
+      return 0;
+  }
+  return 1;
+}
+
+// "<out_dir>/<base name of in_path, extension replaced by .wav>"
+static char *output_path(const char *out_dir, const char *in_path) {
+  const char *base = in_path;
+  for (const char *p = in_path; *p; p++) {
+    if (*p == '/' || *p == '\\')
+      base = p + 1;
+  }
+  size_t stem = strlen(base);
+  const char *dot = strrchr(base, '.');
+  if (dot)
+    stem = (size_t)(dot - base);
+
+  size_t n = strlen(out_dir) + 1 + stem + 5;
+  char *path = (char *)malloc(n);
+  if (path)
+    snprintf(path, n, "%s/%.*s.wav", out_dir, (int)stem, base);
+  return path;
+}
+
+static int list_add(BatchList *list, const char *in_path, const char *out_dir) {
+  if (list->count == list->capacity) {
+    int cap = list->capacity ? 2 * list->capacity : 16;
+    BatchJob *jobs = (BatchJob *)realloc(list->jobs, cap * sizeof(BatchJob));
+    if (!jobs)
+      return -1;
+    list->jobs = jobs;
+    list->capacity = cap;
+  }
+  BatchJob *job = &list->jobs[list->count];
+  job->in_path = str_dup(in_path);
+  job->out_path = out_dir ? output_path(out_dir, in_path) : NULL;
+  if (!job->in_path || (out_dir && !job->out_path)) {
+    free((char *)job->in_path);
+    free((char *)job->out_path);
+    return -1;
+  }
+  list->count++;
+  return 0;
+}
+
+typedef struct {
+  BatchList *list;
+  const char *dir;
+  const char *out_dir;
+  int error;
+} DirScan;
+
+static void on_dir_entry(const char *name, void *user) {
+  DirScan *scan = (DirScan *)user;
+  if (!has_suffix(name, ".wav") && !has_suffix(name, ".raw"))
+    return;
+  size_t n = strlen(scan->dir) + 1 + strlen(name) + 1;
+  char *path = (char *)malloc(n);
+  if (!path) {
+    scan->error = 1;
+    return;
+  }
+  snprintf(path, n, "%s/%s", scan->dir, name);
+  if (list_add(scan->list, path, scan->out_dir) != 0)
+    scan->error = 1;
+  free(path);
+}
+
+static int job_cmp(const void *a, const void *b) {
+  return strcmp(((const BatchJob *)a)->in_path,
+                ((const BatchJob *)b)->in_path);
+}
+
+int batch_collect(const char *source, const char *out_dir, BatchList *list) {
+  memset(list, 0, sizeof(*list));
+
+  DirScan scan = {list, source, out_dir, 0};
+  if (platform_list_dir(source, on_dir_entry, &scan) >= 0) {
+    // Directory order is arbitrary; keep runs reproducible
+    if (list->count > 1)
+      qsort(list->jobs, list->count, sizeof(BatchJob), job_cmp);
+    return scan.error ? -1 : 0;
+  }
+
+  FILE *f = fopen(source, "r");
+  if (!f)
+    return -1;
+  char line[4096];
+  int ret = 0;
+  while (ret == 0 && fgets(line, sizeof(line), f)) {
+    size_t n = strlen(line);
+    while (n > 0 && (line[n - 1] == '\n' || line[n - 1] == '\r' ||
+                     line[n - 1] == ' ' || line[n - 1] == '\t'))
+      line[--n] = '\0';
+    if (n == 0 || line[0] == '#')
+      continue;
+    ret = list_add(list, line, out_dir);
+  }
+  fclose(f);
+  return ret;
+}
+
+void batch_list_free(BatchList *list) {
+  for (int i = 0; i < list->count; i++) {
+    free((char *)list->jobs[i].in_path);
+    free((char *)list->jobs[i].out_path);
+  }
+  free(list->jobs);
+  memset(list, 0, sizeof(*list));
+}
+
+// ============================================================================
+// Workers
+// ============================================================================
+
+typedef struct {
+  const BatchJob *jobs;
+  int count;
+  le_atomic_int next; // Next job index (work queue)
+  const OfflineOptions *base;
+  const PipelineConfig *cfg;
+  BatchResult *results;
+} BatchQueue;
+
+// Everything a worker touches while processing: no sharing between workers
+typedef struct {
+  BatchQueue *q;
+  Pipeline pl;
+  float *beta_hist; // Beta after every block of the current file
+  long beta_len;
+  long beta_cap;
+  int block_frames;
+  double sum_in;
+  double sum_out;
+  int alloc_failed;
+} BatchWorker;
+
+static void on_block(const Pipeline *pl, const float *in, const float *out,
+                     int frames, void *user) {
+  BatchWorker *w = (BatchWorker *)user;
+  for (int i = 0; i < frames; i++) {
+    float mid = 0.5f * (in[i * 3 + 0] + in[i * 3 + 1]);
+    w->sum_in += (double)mid * mid;
+    w->sum_out += (double)out[i * 2] * out[i * 2];
+  }
+
+  if (w->beta_len == w->beta_cap) {
+    long cap = w->beta_cap ? 2 * w->beta_cap : 1024;
+    float *h = (float *)realloc(w->beta_hist, (size_t)cap * sizeof(float));
+    if (!h) {
+      w->alloc_failed = 1;
+      return;
+    }
+    w->beta_hist = h;
+    w->beta_cap = cap;
+  }
+  w->beta_hist[w->beta_len++] = pipeline_beta(pl);
+}
+
+float batch_beta_convergence(const float *beta_hist, long blocks,
+                             int block_frames, int sample_rate) {
+  if (blocks <= 0 || sample_rate <= 0)
+    return 0.0f;
+  float final_beta = beta_hist[blocks - 1];
+  long last_out = -1; // Last block outside the convergence band
+  for (long k = blocks - 1; k >= 0; k--) {
+    if (fabsf(beta_hist[k] - final_beta) > BATCH_BETA_TOL) {
+      last_out = k;
+      break;
+    }
+  }
+  return (float)((double)(last_out + 1) * block_frames / sample_rate);
+}
+
+static void finish_metrics(BatchWorker *w, BatchResult *r) {
+  r->rms_in = r->frames > 0 ? (float)sqrt(w->sum_in / r->frames) : 0.0f;
+  r->rms_out = r->frames > 0 ? (float)sqrt(w->sum_out / r->frames) : 0.0f;
+
+  long n = w->beta_len;
+  if (n == 0)
+    return;
+  r->beta_final = w->beta_hist[n - 1];
+  r->convergence_s = batch_beta_convergence(w->beta_hist, n, w->block_frames,
+                                            r->sample_rate);
+
+  r->beta_points = n < BATCH_BETA_POINTS ? (int)n : BATCH_BETA_POINTS;
+  for (int j = 0; j < r->beta_points; j++)
+    r->beta[j] = w->beta_hist[(long)(j + 1) * n / r->beta_points - 1];
+}
+
+static void worker_main(void *arg) {
+  BatchWorker *w = (BatchWorker *)arg;
+  BatchQueue *q = w->q;
+
+  OfflineOptions opts = *q->base;
+  opts.on_block = on_block;
+  opts.user = w;
+
+  for (;;) {
+    int idx = le_atomic_fetch_add(&q->next, 1);
+    if (idx >= q->count)
+      break;
+
+    BatchResult *r = &q->results[idx];
+    memset(r, 0, sizeof(*r));
+    opts.in_path = q->jobs[idx].in_path;
+    opts.out_path = q->jobs[idx].out_path;
+    // The reader follows the file, a directory may hold both kinds: *.wav
+    // is always WAV, anything else is raw when a raw format is given
+    opts.raw_channels =
+        has_suffix(opts.in_path, ".wav") ? 0 : q->base->raw_channels;
+    if (opts.raw_channels <= 0 && has_suffix(opts.in_path, ".raw")) {
+      fprintf(stderr, "%s: raw input needs --raw <channels>\n",
+              opts.in_path);
+      r->status = -1;
+      continue;
+    }
+    w->beta_len = 0;
+    w->sum_in = 0.0;
+    w->sum_out = 0.0;
+    w->alloc_failed = 0;
+
+    OfflineStats stats;
+    if (offline_process(&opts, q->cfg, &w->pl, &stats) != 0 ||
+        w->alloc_failed) {
+      r->status = -1;
+      continue;
+    }
+    r->frames = stats.frames;
+    r->sample_rate = stats.sample_rate;
+    r->wall_us = stats.wall_us;
+    finish_metrics(w, r);
+  }
+}
+
+int batch_run(const BatchJob *jobs, int count, const OfflineOptions *base,
+              const PipelineConfig *cfg, int threads, BatchResult *results,
+              BatchSummary *summary) {
+  if (threads <= 0)
+    threads = platform_cpu_count();
+  if (threads > count)
+    threads = count > 0 ? count : 1;
+  le_simd_init(); // Workers initialize their pipelines concurrently
+
+  BatchQueue q;
+  q.jobs = jobs;
+  q.count = count;
+  le_atomic_store(&q.next, 0);
+  q.base = base;
+  q.cfg = cfg;
+  q.results = results;
+
+  BatchWorker *workers = (BatchWorker *)calloc(threads, sizeof(BatchWorker));
+  PlatformThread **handles =
+      (PlatformThread **)calloc(threads, sizeof(PlatformThread *));
+  if (!workers || !handles) {
+    free(workers);
+    free(handles);
+    for (int i = 0; i < count; i++) {
+      memset(&results[i], 0, sizeof(BatchResult));
+      results[i].status = -1;
+    }
+    return count;
+  }
+
+  double t0 = platform_time_us();
+  for (int t = 0; t < threads; t++) {
+    workers[t].q = &q;
+    workers[t].block_frames = cfg->block_frames;
+    // Worker 0 runs on the calling thread; a failed start leaves its share
+    // of the queue to the others
+    if (t > 0)
+      handles[t] = platform_thread_start(worker_main, &workers[t]);
+  }
+  worker_main(&workers[0]);
+  for (int t = 1; t < threads; t++)
+    platform_thread_join(handles[t]);
+  double wall_us = platform_time_us() - t0;
+
+  int failed = 0;
+  double audio_s = 0.0, dsp_us = 0.0, sum_rms = 0.0, sum_conv = 0.0;
+  for (int i = 0; i < count; i++) {
+    if (results[i].status != 0) {
+      failed++;
+      continue;
+    }
+    audio_s += (double)results[i].frames / results[i].sample_rate;
+    dsp_us += results[i].wall_us;
+    sum_rms += results[i].rms_out;
+    sum_conv += results[i].convergence_s;
+  }
+
+  if (summary) {
+    int ok = count - failed;
+    summary->files = count;
+    summary->failed = failed;
+    summary->threads = threads;
+    summary->audio_s = audio_s;
+    summary->wall_s = wall_us * 1e-6;
+    summary->dsp_s = dsp_us * 1e-6;
+    summary->speedup = wall_us > 0.0 ? audio_s / (wall_us * 1e-6) : 0.0;
+    summary->mean_rms_out = ok > 0 ? (float)(sum_rms / ok) : 0.0f;
+    summary->mean_convergence_s = ok > 0 ? (float)(sum_conv / ok) : 0.0f;
+  }
+
+  for (int t = 0; t < threads; t++) {
+    pipeline_free(&workers[t].pl);
+    free(workers[t].beta_hist);
+  }
+  free(workers);
+  free(handles);
+  return failed;
+}
+
+int batch_write_csv(const char *path, const BatchJob *jobs,
+                    const BatchResult *results, int count) {
+  FILE *f = fopen(path, "w");
+  if (!f)
+    return -1;
+  fprintf(f, "file,status,frames,sample_rate,dsp_ms,rms_in,rms_out,gain_db,"
+             "beta_final,convergence_s,beta_trajectory\n");
+  for (int i = 0; i < count; i++) {
+    const BatchResult *r = &results[i];
+    double gain_db = (r->rms_in > 0.0f && r->rms_out > 0.0f)
+                         ? 20.0 * log10((double)r->rms_out / r->rms_in)
+                         : 0.0;
+    fprintf(f, "\"%s\",%s,%ld,%d,%.3f,%.6f,%.6f,%.2f,%.4f,%.3f,\"",
+            jobs[i].in_path, r->status == 0 ? "ok" : "failed", r->frames,
+            r->sample_rate, r->wall_us / 1000.0, r->rms_in, r->rms_out,
+            gain_db, r->beta_final, r->convergence_s);
+    for (int j = 0; j < r->beta_points; j++)
+      fprintf(f, "%s%.4f", j ? " " : "", r->beta[j]);
+    fprintf(f, "\"\n");
+  }
+  return fclose(f) == 0 ? 0 : -1;
+}
@@ -0,0 +1,108 @@
+/**
+ * @file batch.h
+ * @brief Multi-core batch processing of recorded sessions
+ *
+ * Worker threads pull files from a shared lock-free index and run them
+ * through the offline runner. Each worker owns one Pipeline (all DSP state
+ * and buffers) and reuses it across files, so the DSP path never takes a
+ * lock or allocates per block. Per-file metrics are written into a result
+ * slot owned by the job.
+ */
+
+#ifndef BATCH_H
+#define BATCH_H
+
+#include "offline.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define BATCH_BETA_POINTS 32 // Beta trajectory samples per file
+#define BATCH_BETA_TOL 0.05f // Convergence band around the final beta
+
+typedef struct {
+  const char *in_path;
+  const char *out_path; // NULL: metrics only
+} BatchJob;
+
+typedef struct {
+  int status;     // 0: processed, -1: failed
+  long frames;
+  int sample_rate;
+  double wall_us; // Time spent in pipeline_process
+  float rms_in;   // Fixed beamformer input (L + R) / 2
+  float rms_out;
+  float beta_final;
+  float convergence_s; // Beta stays within BATCH_BETA_TOL of beta_final after
+  int beta_points;
+  float beta[BATCH_BETA_POINTS]; // Trajectory, evenly spaced over the file
+} BatchResult;
+
+typedef struct {
+  int files;
+  int failed;
+  int threads;
+  double audio_s;  // Total duration of the processed audio
+  double wall_s;   // Elapsed time of the whole batch
+  double dsp_s;    // Sum of per-file pipeline time over all workers
+  double speedup;  // audio_s / wall_s
+  float mean_rms_out;
+  float mean_convergence_s;
+} BatchSummary;
+
+// Job list with owned path strings
+typedef struct {
+  BatchJob *jobs;
+  int count;
+  int capacity;
+} BatchList;
+
+/**
+ * Collect jobs from a directory (every *.wav / *.raw file) or a manifest
+ * (one input path per line; blank lines and lines starting with '#' are
+ * skipped).
+ * @param source: Directory or manifest file
+ * @param out_dir: Output directory (same file name, .wav), NULL: metrics only
+ * @return 0 on success, -1 if source cannot be read
+ */
+int batch_collect(const char *source, const char *out_dir, BatchList *list);
+
+void batch_list_free(BatchList *list);
+
+/**
+ * Process all jobs.
+ * @param jobs: Files to process
+ * @param count: Number of jobs
+ * @param base: Options shared by every job (channel map, raw format; the
+ *              raw format applies to every input not named *.wav)
+ * @param cfg: Pipeline configuration
+ * @param threads: Worker count, <= 0: one per CPU core
+ * @param results: Output, one per job
+ * @param summary: Output, may be NULL
+ * @return Number of failed jobs
+ */
+int batch_run(const BatchJob *jobs, int count, const OfflineOptions *base,
+              const PipelineConfig *cfg, int threads, BatchResult *results,
+              BatchSummary *summary);
+
+/**
+ * Convergence time of a per-block beta history: the end of the last block
+ * outside BATCH_BETA_TOL of the final value.
+ * @return Seconds (0 if beta never left the band)
+ */
+float batch_beta_convergence(const float *beta_hist, long blocks,
+                             int block_frames, int sample_rate);
+
+/**
+ * Write one CSV row per job (path, status, metrics, beta trajectory).
+ * @return 0 on success, -1 on I/O error
+ */
+int batch_write_csv(const char *path, const BatchJob *jobs,
+                    const BatchResult *results, int count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BATCH_H
@@ -0,0 +1,170 @@
+/**
+ * @file latency_probe.c
+ * @brief Round-trip latency measurement (see latency_probe.h)
+ */
+
+#include "latency_probe.h"
+#include "../dsp/phase_align.h"
+#include "../utils/atomic_compat.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Galois LFSR feedback masks of maximal length, orders 10 - 16
+static const unsigned int k_mls_taps[] = {0x240,  0x500,  0xE08, 0x1C80,
+                                          0x3802, 0x6000, 0xD008};
+#define MLS_MIN_ORDER 10
+#define MLS_MAX_ORDER 16
+
+struct LatencyProbe {
+  LatencyProbeConfig cfg;
+  int mls_len;
+  float *ref; // [fft_size] Excitation (with level), zero-padded
+  float *rec; // [repeats * fft_size] Recorded input, one window each
+  long total; // Lead-in window + measurement windows, in samples
+
+  long pos; // Callback-only: samples since the first callback
+  le_atomic_int done;
+};
+
+void latency_probe_default_config(LatencyProbeConfig *cfg, int sample_rate) {
+  memset(cfg, 0, sizeof(*cfg));
+  cfg->sample_rate = sample_rate;
+  cfg->output_channels = 2;
+  cfg->input_channels = 3;
+  cfg->channel = 0;
+  int n = 8192;
+  while (n < sample_rate && n < 32768)
+    n *= 2;
+  cfg->fft_size = n;
+  cfg->mls_order = 12;
+  cfg->level = 0.25f;
+  cfg->repeats = 5;
+}
+
+LatencyProbe *latency_probe_create(const LatencyProbeConfig *cfg) {
+  const int n = cfg->fft_size;
+  if (cfg->sample_rate <= 0 || cfg->output_channels <= 0 ||
+      cfg->input_channels < 3 || cfg->input_channels > 4 ||
+      cfg->channel < 0 || cfg->channel >= cfg->input_channels || n <= 0 ||
+      n > 32768 || (n & (n - 1)) != 0 || cfg->mls_order < MLS_MIN_ORDER ||
+      cfg->mls_order > MLS_MAX_ORDER || cfg->repeats < 1 ||
+      cfg->repeats > LATENCY_PROBE_MAX_REPEATS)
+    return NULL;
+  int mls_len = (1 << cfg->mls_order) - 1;
+  if (mls_len >= n)
+    return NULL;
+
+  LatencyProbe *lp = (LatencyProbe *)calloc(1, sizeof(LatencyProbe));
+  if (!lp)
+    return NULL;
+  lp->cfg = *cfg;
+  lp->mls_len = mls_len;
+  lp->total = (long)(cfg->repeats + 1) * n;
+  lp->ref = (float *)calloc((size_t)n, sizeof(float));
+  lp->rec = (float *)calloc((size_t)cfg->repeats * n, sizeof(float));
+  if (!lp->ref || !lp->rec) {
+    latency_probe_destroy(lp);
+    return NULL;
+  }
+
+  unsigned int taps = k_mls_taps[cfg->mls_order - MLS_MIN_ORDER];
+  unsigned int state = 1;
+  for (int i = 0; i < mls_len; i++) {
+    unsigned int bit = state & 1u;
+    state >>= 1;
+    if (bit)
+      state ^= taps;
+    lp->ref[i] = bit ? cfg->level : -cfg->level;
+  }
+  return lp;
+}
+
+void latency_probe_destroy(LatencyProbe *lp) {
+  if (!lp)
+    return;
+  free(lp->ref);
+  free(lp->rec);
+  free(lp);
+}
+
+int latency_probe_process(const float *in, float *out, int frames,
+                          void *user) {
+  LatencyProbe *lp = (LatencyProbe *)user;
+  const int n = lp->cfg.fft_size;
+  const int C = lp->cfg.output_channels;
+  const int L = lp->cfg.input_channels;
+  const int ch = lp->cfg.channel;
+
+  for (int i = 0; i < frames; i++) {
+    float v = 0.0f;
+    if (lp->pos < lp->total) {
+      // Window 0 is a silent lead-in: the stream settles (priming, first
+      // xruns) before anything is measured
+      long w = lp->pos / n - 1;
+      long k = lp->pos % n;
+      if (w >= 0) {
+        lp->rec[w * n + k] = in[i * L + ch];
+        v = lp->ref[k];
+      }
+      lp->pos++;
+    }
+    for (int c = 0; c < C; c++)
+      out[i * C + c] = v;
+  }
+  if (lp->pos >= lp->total)
+    le_atomic_store(&lp->done, 1);
+  return 0;
+}
+
+int latency_probe_done(LatencyProbe *lp) { return le_atomic_load(&lp->done); }
+
+int latency_probe_analyze(LatencyProbe *lp, LatencyResult *res) {
+  memset(res, 0, sizeof(*res));
+  const int n = lp->cfg.fft_size;
+  long recorded = lp->pos - n;
+  if (recorded > (long)lp->cfg.repeats * n)
+    recorded = (long)lp->cfg.repeats * n;
+  int windows = recorded > 0 ? (int)(recorded / n) : 0;
+  if (windows == 0)
+    return -1;
+
+  PhaseAligner *pa = phase_align_create(n, lp->cfg.sample_rate, 2);
+  if (!pa)
+    return -1;
+  phase_align_set_smoothing(pa, 1.0f); // Every window on its own
+
+  double energy = 0.0;
+  for (int w = 0; w < windows; w++) {
+    const float *chans[2] = {lp->ref, lp->rec + (long)w * n};
+    float lag;
+    phase_align_reset(pa);
+    phase_align_estimate(pa, chans, n, &lag);
+    res->delay_samples[w] = lag;
+    for (int k = 0; k < n; k++)
+      energy += (double)chans[1][k] * chans[1][k];
+  }
+  phase_align_destroy(pa);
+  res->count = windows;
+  res->input_rms = (float)sqrt(energy / ((double)windows * n));
+
+  // Median of a handful of values: insertion sort of a copy
+  float sorted[LATENCY_PROBE_MAX_REPEATS];
+  memcpy(sorted, res->delay_samples, (size_t)windows * sizeof(float));
+  for (int i = 1; i < windows; i++) {
+    float v = sorted[i];
+    int j = i - 1;
+    while (j >= 0 && sorted[j] > v) {
+      sorted[j + 1] = sorted[j];
+      j--;
+    }
+    sorted[j + 1] = v;
+  }
+  res->min_samples = sorted[0];
+  res->max_samples = sorted[windows - 1];
+  res->median_samples = (windows & 1) ? sorted[windows / 2]
+                                      : 0.5f * (sorted[windows / 2 - 1] +
+                                                sorted[windows / 2]);
+  res->median_ms = 1000.0 * res->median_samples / lp->cfg.sample_rate;
+  return 0;
+}
@@ -0,0 +1,85 @@
+/**
+ * @file latency_probe.h
+ * @brief Round-trip latency measurement: MLS out, GCC-PHAT on the input
+ *
+ * Runs as the audio callback in place of the pipeline. Every measurement
+ * window of fft_size samples starts with a maximum-length sequence on all
+ * outputs, followed by silence, while one logical input channel is
+ * recorded. Afterwards each window is correlated against the excitation
+ * with the GCC-PHAT estimator of phase_align.c; the peak lag is the delay
+ * from the callback's output buffer back to its input buffer, i.e. the
+ * full output + analog/acoustic path + input latency.
+ *
+ * The callback only copies samples; all allocation and analysis happen on
+ * the calling thread.
+ */
+
+#ifndef LATENCY_PROBE_H
+#define LATENCY_PROBE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define LATENCY_PROBE_MAX_REPEATS 32
+
+typedef struct {
+  int sample_rate;
+  int output_channels; // Interleaved outputs, all carry the excitation
+  int input_channels;  // Logical channels per input frame (3, 4: 4 mics)
+  int channel;         // Logical input channel recorded (0 L, 1 R, 2 B)
+  int fft_size;        // Window per measurement (power of 2, <= 32768);
+                       // delays below fft_size / 2 are measured
+  int mls_order;       // Excitation length 2^order - 1 (10 - 16)
+  float level;         // Excitation amplitude (linear)
+  int repeats;         // Measurements (1 - LATENCY_PROBE_MAX_REPEATS)
+} LatencyProbeConfig;
+
+typedef struct {
+  int count;                                    // Measurements analyzed
+  float delay_samples[LATENCY_PROBE_MAX_REPEATS]; // Per measurement
+  float median_samples;
+  float min_samples;
+  float max_samples;
+  double median_ms;
+  float input_rms; // Recorded input RMS (0: nothing came back)
+} LatencyResult;
+
+typedef struct LatencyProbe LatencyProbe;
+
+/**
+ * Defaults for a sample rate: windows of about one second (delays up to
+ * half a second), 4095-sample MLS at -12 dBFS, 5 measurements on input L.
+ */
+void latency_probe_default_config(LatencyProbeConfig *cfg, int sample_rate);
+
+/**
+ * @return Probe or NULL on invalid configuration / out of memory
+ */
+LatencyProbe *latency_probe_create(const LatencyProbeConfig *cfg);
+
+void latency_probe_destroy(LatencyProbe *lp);
+
+/**
+ * AudioProcessFn: plays the excitation and records the input. Outputs
+ * silence once all windows are recorded. user is the LatencyProbe.
+ */
+int latency_probe_process(const float *in, float *out, int frames,
+                          void *user);
+
+/**
+ * Non-zero once every window has been recorded (safe from any thread).
+ */
+int latency_probe_done(LatencyProbe *lp);
+
+/**
+ * Correlate the recorded windows. Call after latency_probe_done.
+ * @return 0 on success, -1 if nothing was recorded
+ */
+int latency_probe_analyze(LatencyProbe *lp, LatencyResult *res);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LATENCY_PROBE_H
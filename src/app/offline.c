@@ -0,0 +1,117 @@
+/**
+ * @file offline.c
+ * @brief Headless file runner: feed a recording through the pipeline
+ */
+
+#include "offline.h"
+#include "../platform/platform.h"
+#include "../utils/wav_io.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+void offline_default_options(OfflineOptions *opts) {
+  memset(opts, 0, sizeof(*opts));
+  opts->raw_rate = 16000; // Pipeline rate: raw recordings usually come from it
+  opts->channel_map[0] = 0;
+  opts->channel_map[1] = 1;
+  opts->channel_map[2] = 2;
+}
+
+int offline_run(const OfflineOptions *opts, const PipelineConfig *cfg,
+                OfflineStats *stats) {
+  Pipeline pl;
+  memset(&pl, 0, sizeof(pl));
+  int ret = offline_process(opts, cfg, &pl, stats);
+  pipeline_free(&pl);
+  return ret;
+}
+
+int offline_process(const OfflineOptions *opts, const PipelineConfig *cfg,
+                    Pipeline *pl, OfflineStats *stats) {
+  WavInfo info;
+  WavReader *wr =
+      opts->raw_channels > 0
+          ? wav_open_raw(opts->in_path, opts->raw_channels, opts->raw_rate,
+                         &info)
+          : wav_open_read(opts->in_path, &info);
+  if (!wr) {
+    fprintf(stderr, "Cannot read input file: %s\n", opts->in_path);
+    return -1;
+  }
+
+  WavWriter *ww = NULL;
+  if (opts->out_path) {
+    ww = wav_open_write(opts->out_path, info.sample_rate, 2);
+    if (!ww) {
+      fprintf(stderr, "Cannot create output file: %s\n", opts->out_path);
+      wav_close_read(wr);
+      return -1;
+    }
+  }
+
+  PipelineConfig pcfg = *cfg;
+  pcfg.sample_rate = info.sample_rate;
+  if (pipeline_reuse(pl, &pcfg) != 0) {
+    fprintf(stderr, "Failed to initialize the processing pipeline\n");
+    wav_close_read(wr);
+    wav_close_write(ww);
+    return -1;
+  }
+  pl->profile = opts->profile;
+
+  const int N = pcfg.block_frames;
+  const int C = info.channels;
+  float *raw = malloc((size_t)N * C * sizeof(float));
+  float *in = malloc((size_t)N * 3 * sizeof(float));
+  float *out = malloc((size_t)N * 2 * sizeof(float));
+  int ret = (raw && in && out) ? 0 : -1;
+
+  long total = 0;
+  double wall_us = 0.0;
+  while (ret == 0) {
+    long got = wav_read_frames(wr, raw, N);
+    if (got <= 0)
+      break;
+
+    // Same remapping as the audio backend; absent channels stay silent, and
+    // a short final block is zero-padded to keep the AEC partition intact.
+    memset(in, 0, (size_t)N * 3 * sizeof(float));
+    for (long i = 0; i < got; i++) {
+      for (int p = 0; p < C && p < 3; p++) {
+        int logical = opts->channel_map[p];
+        if (logical >= 0 && logical < 3)
+          in[i * 3 + logical] = raw[i * C + p];
+      }
+    }
+
+    double t0 = platform_time_us();
+    pipeline_process(in, out, N, pl);
+    wall_us += platform_time_us() - t0;
+    if (opts->on_block)
+      opts->on_block(pl, in, out, (int)got, opts->user);
+
+    if (ww && wav_write_frames(ww, out, got) != 0) {
+      fprintf(stderr, "Write error: %s\n", opts->out_path);
+      ret = -1;
+    }
+    total += got;
+  }
+
+  if (ww && wav_close_write(ww) != 0)
+    ret = -1;
+  wav_close_read(wr);
+  free(raw);
+  free(in);
+  free(out);
+
+  if (stats) {
+    stats->frames = total;
+    stats->sample_rate = info.sample_rate;
+    stats->wall_us = wall_us;
+    stats->samples_per_sec =
+        wall_us > 0.0 ? (double)total * 1e6 / wall_us : 0.0;
+    stats->rtf = total > 0 ? wall_us * 1e-6 * info.sample_rate / total : 0.0;
+  }
+  return ret;
+}
@@ -0,0 +1,74 @@
+/**
+ * @file offline.h
+ * @brief Headless file runner: feed a recording through the pipeline
+ *
+ * Reads a multichannel WAV (or headerless float32) file, runs
+ * pipeline_process block by block as fast as possible and writes the stereo
+ * output as a float32 WAV. Used for regression tests and batch tuning on
+ * machines without audio hardware.
+ */
+
+#ifndef OFFLINE_H
+#define OFFLINE_H
+
+#include "pipeline.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Per-block observer: in/out as passed to pipeline_process, frames counts
+// only the frames read from the file
+typedef void (*OfflineBlockFn)(const Pipeline *pl, const float *in,
+                               const float *out, int frames, void *user);
+
+typedef struct {
+  const char *in_path;
+  const char *out_path;    // NULL: process only (benchmarking)
+  int raw_channels;        // > 0: input is headerless float32 with N channels
+  int raw_rate;            // Sample rate of raw input (default 16000)
+  int channel_map[3];      // Physical channel -> logical (L=0, R=1, B=2)
+  OfflineBlockFn on_block; // Optional, called after every block
+  void *user;              // Passed to on_block
+  StageProfile *profile;   // Per-stage ticks (LE_PROFILE_STAGES builds),
+                           // may be shared by batch workers. NULL: none
+} OfflineOptions;
+
+typedef struct {
+  long frames;       // Frames processed
+  int sample_rate;   // Sample rate of the input
+  double wall_us;    // Time spent in pipeline_process
+  double samples_per_sec;
+  double rtf;        // Real-time factor: processing time / audio duration
+} OfflineStats;
+
+/**
+ * Default options: identity channel map, no raw input.
+ */
+void offline_default_options(OfflineOptions *opts);
+
+/**
+ * Process one file. The pipeline sample rate is taken from the file; the
+ * block size from cfg. A short final block is zero-padded and trimmed, so
+ * the output has exactly as many frames as the input.
+ * @param opts: Input/output files and channel map
+ * @param cfg: Pipeline configuration (sample_rate is overridden)
+ * @param stats: Output, may be NULL
+ * @return 0 on success, -1 on I/O or initialization failure
+ */
+int offline_run(const OfflineOptions *opts, const PipelineConfig *cfg,
+                OfflineStats *stats);
+
+/**
+ * Same as offline_run on a caller-owned pipeline, which is prepared with
+ * pipeline_reuse: a worker processing many files keeps one set of buffers.
+ * @param pl: Zeroed or previously used pipeline; release with pipeline_free
+ */
+int offline_process(const OfflineOptions *opts, const PipelineConfig *cfg,
+                    Pipeline *pl, OfflineStats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // OFFLINE_H
@@ -0,0 +1,509 @@
+/**
+ * @file pipeline.c
+ * @brief The LombardEar processing chain (GSC -> AEC -> AGC -> Noise Gate)
+ */
+
+#include "pipeline.h"
+#include "../platform/platform.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+void pipeline_default_config(PipelineConfig *cfg) {
+  memset(cfg, 0, sizeof(*cfg));
+  cfg->sample_rate = 16000;
+  cfg->block_frames = 480; // 30ms
+
+  cfg->gsc.M = 64;
+  cfg->gsc.alpha = 0.01f; // Much slower adaptation
+  cfg->gsc.eps = 1e-6f;
+  cfg->gsc.mu_max = 0.01f; // Much conservative max step size
+  cfg->gsc.eta_max = 0.001f;
+  cfg->gsc.leak_lambda = 0.0001f;
+  cfg->gsc.g_lo = 0.1f;
+  cfg->gsc.g_hi = 0.3f;
+  cfg->gsc.beta_min = -2.0f;
+  cfg->gsc.beta_max = 2.0f;
+
+  cfg->gsc_mode = GSC_MODE_TIME;
+  cfg->subband.fft_size = 256;
+  cfg->subband.hop = 128;
+  cfg->subband.mu = 0.5f;
+  cfg->subband.power_alpha = 0.8f;
+  cfg->mics = 3;
+  cfg->beam_dir = BEAM_DIR_FRONT;
+
+  // ~120ms of loopback latency plus room reverberation.
+  // Need to fine-tune the tail based on Measured Loopback Latency.
+  cfg->aec_tail_ms = 120;
+  cfg->agc_target_db = -30.0f;
+  cfg->ng_thresh_db = -50.0f;
+  cfg->aec_on = 0; // Off by default to isolate GSC stability
+  cfg->agc_on = 0;
+  cfg->ng_on = 0;
+}
+
+static void pipeline_apply_controls(Pipeline *pl, const PipelineConfig *cfg);
+static void pipeline_set_mic_hpf(Pipeline *pl, const PipelineConfig *cfg);
+
+#ifdef LE_FIXED_POINT
+#define PIPELINE_FIXED 1
+#else
+#define PIPELINE_FIXED 0
+#endif
+
+// Q15 GSC, Q15 block buffers and a time-domain Q15 AEC over the whole tail
+static int pipeline_init_fixed(Pipeline *pl, const PipelineConfig *cfg) {
+  int n = pl->gsc_out_frames;
+  size_t gsc_size = gsc_q15_mem_bytes(&pl->cfg);
+  int aec_len = cfg->sample_rate * cfg->aec_tail_ms / 1000;
+  if (aec_len < 1)
+    aec_len = 1;
+  size_t aec_size = aec_q15_mem_bytes(aec_len);
+  pl->gsc_q_mem = malloc(gsc_size);
+  pl->aec_q_mem = malloc(aec_size);
+  pl->q_in = malloc((size_t)n * 3 * sizeof(q15_t));
+  pl->q_out = malloc((size_t)n * sizeof(q15_t));
+  pl->q_ref = calloc(n, sizeof(q15_t));
+  if (!pl->gsc_q_mem || !pl->aec_q_mem || !pl->q_in || !pl->q_out ||
+      !pl->q_ref ||
+      gsc_q15_init(&pl->st_q, &pl->cfg, pl->gsc_q_mem, gsc_size) != 0 ||
+      aec_q15_init(&pl->aec_q, aec_len, pl->aec_q_mem, aec_size) != 0)
+    return -1;
+  pl->fixed = 1;
+  return 0;
+}
+
+int pipeline_init(Pipeline *pl, const PipelineConfig *cfg) {
+  memset(pl, 0, sizeof(*pl));
+  if (cfg->sample_rate <= 0 || cfg->block_frames <= 0)
+    return -1;
+  pl->setup = *cfg;
+
+  pl->cfg = cfg->gsc;
+  size_t mem_size = gsc_mem_bytes(&pl->cfg);
+  pl->gsc_mem = malloc(mem_size);
+  pl->gsc_out_frames = cfg->block_frames;
+  pl->gsc_out = malloc(pl->gsc_out_frames * sizeof(float));
+  if (!pl->gsc_mem || !pl->gsc_out ||
+      gsc_init(&pl->st, &pl->cfg, pl->gsc_mem, mem_size) != 0) {
+    pipeline_free(pl);
+    return -1;
+  }
+  // O(1) sliding-window power instead of a 2*M sum every sample
+  gsc_set_power_mode(&pl->st, GSC_POWER_RUNNING);
+
+  pl->mics = cfg->mics == 4 ? 4 : 3;
+  pl->beam_dir = cfg->beam_dir;
+  if (pl->mics == 4) {
+    pl->in3 = malloc((size_t)pl->gsc_out_frames * 3 * sizeof(float));
+    if (!pl->in3) {
+      pipeline_free(pl);
+      return -1;
+    }
+  }
+
+  if (cfg->mic_hpf_hz > 0.0f) {
+    size_t hpf_size = biquad_bank_mem_bytes(pl->mics, 1);
+    pl->mic_hpf_mem = malloc(hpf_size);
+    pl->pre = malloc((size_t)pl->gsc_out_frames * pl->mics * sizeof(float));
+    if (!pl->mic_hpf_mem || !pl->pre ||
+        biquad_bank_init(&pl->mic_hpf, pl->mics, 1, pl->mic_hpf_mem,
+                         hpf_size) != 0) {
+      pipeline_free(pl);
+      return -1;
+    }
+    pipeline_set_mic_hpf(pl, cfg);
+  }
+
+  pl->gsc_mode = cfg->gsc_mode;
+  if (pl->gsc_mode == GSC_MODE_SUBBAND && pl->mics == 4) {
+    fprintf(stderr, "Subband GSC is 3-channel, using time-domain GSC\n");
+    pl->gsc_mode = GSC_MODE_TIME;
+  }
+  if (pl->gsc_mode == GSC_MODE_SUBBAND) {
+    size_t sb_size = gsc_subband_mem_bytes(&cfg->subband);
+    pl->sb_mem = sb_size ? malloc(sb_size) : NULL;
+    if (!pl->sb_mem ||
+        gsc_subband_init(&pl->sb, &cfg->subband, pl->sb_mem, sb_size) != 0) {
+      fprintf(stderr, "Invalid subband GSC config, using time-domain GSC\n");
+      free(pl->sb_mem);
+      pl->sb_mem = NULL;
+      pl->gsc_mode = GSC_MODE_TIME;
+    }
+  }
+
+  if (PIPELINE_FIXED && pl->mics == 3 && pl->gsc_mode == GSC_MODE_TIME) {
+    if (pipeline_init_fixed(pl, cfg) != 0) {
+      pipeline_free(pl);
+      return -1;
+    }
+    pipeline_apply_controls(pl, cfg);
+    return 0;
+  }
+
+  // AEC (partitioned-block, frequency domain): one partition per callback
+  // block, enough partitions to cover the echo tail.
+  int aec_N = cfg->block_frames;
+  int aec_tail = cfg->sample_rate * cfg->aec_tail_ms / 1000;
+  int aec_P = (aec_tail + aec_N - 1) / aec_N;
+  if (aec_P < 1)
+    aec_P = 1;
+  size_t aec_mem_size = aec_fd_mem_bytes(aec_N, aec_P);
+  pl->aec_mem = malloc(aec_mem_size);
+  pl->aec_ref = calloc(aec_N, sizeof(float));
+  if (!pl->aec_mem || !pl->aec_ref ||
+      aec_fd_init(&pl->aec, aec_N, aec_P, pl->aec_mem, aec_mem_size) != 0) {
+    pipeline_free(pl);
+    return -1;
+  }
+
+  pipeline_apply_controls(pl, cfg);
+  return 0;
+}
+
+// Settings that need no reallocation: AGC/NG and the processing switches
+static void pipeline_apply_controls(Pipeline *pl, const PipelineConfig *cfg) {
+  // AGC: attack 10ms, release 500ms, max +20dB
+  agc_init(&pl->agc, cfg->agc_target_db, 10.0f, 500.0f, 20.0f,
+           cfg->sample_rate);
+
+  // Noise Gate: hold 200ms, release 100ms
+  noise_gate_init(&pl->ng, cfg->ng_thresh_db, 200.0f, 100.0f,
+                  cfg->sample_rate);
+
+  pl->aec_on = cfg->aec_on;
+  pl->agc_on = cfg->agc_on;
+  pl->ng_on = cfg->ng_on;
+
+  DspParams initial = {.gsc = pl->cfg,
+                       .aec_on = pl->aec_on,
+                       .agc_on = pl->agc_on,
+                       .ng_on = pl->ng_on,
+                       .agc_target_db = cfg->agc_target_db,
+                       .ng_thresh_db = cfg->ng_thresh_db};
+  param_mailbox_init(&pl->params, &initial);
+}
+
+// Same DC blocker on every mic, state cleared
+static void pipeline_set_mic_hpf(Pipeline *pl, const PipelineConfig *cfg) {
+  BiquadState dc;
+  biquad_dc_block(&dc, (float)cfg->sample_rate, cfg->mic_hpf_hz);
+  for (int m = 0; m < pl->mics; m++)
+    biquad_bank_set(&pl->mic_hpf, 0, m, &dc);
+}
+
+static int same_layout(const PipelineConfig *a, const PipelineConfig *b) {
+  if (a->sample_rate != b->sample_rate || a->block_frames != b->block_frames ||
+      a->gsc.M != b->gsc.M || a->gsc_mode != b->gsc_mode ||
+      a->aec_tail_ms != b->aec_tail_ms || (a->mics == 4) != (b->mics == 4) ||
+      (a->mic_hpf_hz > 0.0f) != (b->mic_hpf_hz > 0.0f))
+    return 0;
+  return a->gsc_mode != GSC_MODE_SUBBAND ||
+         (a->subband.fft_size == b->subband.fft_size &&
+          a->subband.hop == b->subband.hop &&
+          a->subband.mu == b->subband.mu &&
+          a->subband.power_alpha == b->subband.power_alpha);
+}
+
+int pipeline_reuse(Pipeline *pl, const PipelineConfig *cfg) {
+  ScopeTap *scope = pl->scope;
+  PipelineTelemetryFn telemetry = pl->telemetry;
+  DeadlineMonitor *monitor = pl->monitor;
+  StageProfile *profile = pl->profile;
+
+  if (!pl->gsc_mem || !same_layout(&pl->setup, cfg)) {
+    pipeline_free(pl);
+    if (pipeline_init(pl, cfg) != 0)
+      return -1;
+  } else {
+    pl->setup = *cfg;
+    pl->cfg = cfg->gsc;
+    pl->beam_dir = cfg->beam_dir;
+    gsc_reset(&pl->st);
+    gsc_set_power_mode(&pl->st, GSC_POWER_RUNNING);
+    if (pl->sb_mem)
+      gsc_subband_reset(&pl->sb);
+    if (pl->mic_hpf_mem)
+      pipeline_set_mic_hpf(pl, cfg);
+    if (pl->fixed) {
+      gsc_q15_set_config(&pl->st_q, &pl->cfg);
+      gsc_q15_reset(&pl->st_q);
+      aec_q15_reset(&pl->aec_q);
+      memset(pl->q_ref, 0, pl->gsc_out_frames * sizeof(q15_t));
+    } else {
+      aec_fd_reset(&pl->aec);
+      memset(pl->aec_ref, 0, pl->gsc_out_frames * sizeof(float));
+    }
+    pipeline_apply_controls(pl, cfg);
+    pl->call_count = 0;
+    pl->denormals = 0;
+  }
+
+  pl->scope = scope;
+  pl->telemetry = telemetry;
+  pl->monitor = monitor;
+  pl->profile = profile;
+  return 0;
+}
+
+float pipeline_beta(const Pipeline *pl) {
+  if (pl->fixed)
+    return (float)pl->st_q.beta / (float)(1 << GSC_Q15_BETA_FRAC);
+  return (pl->gsc_mode == GSC_MODE_SUBBAND) ? pl->sb.beta : pl->st.beta;
+}
+
+int pipeline_latency(const Pipeline *pl) {
+  return (pl->gsc_mode == GSC_MODE_SUBBAND) ? gsc_subband_latency(&pl->sb) : 0;
+}
+
+void pipeline_free(Pipeline *pl) {
+  free(pl->gsc_mem);
+  free(pl->gsc_out);
+  free(pl->sb_mem);
+  free(pl->aec_mem);
+  free(pl->aec_ref);
+  free(pl->in3);
+  free(pl->mic_hpf_mem);
+  free(pl->pre);
+  free(pl->gsc_q_mem);
+  free(pl->aec_q_mem);
+  free(pl->q_in);
+  free(pl->q_out);
+  free(pl->q_ref);
+  pl->gsc_mem = NULL;
+  pl->gsc_out = NULL;
+  pl->sb_mem = NULL;
+  pl->aec_mem = NULL;
+  pl->aec_ref = NULL;
+  pl->in3 = NULL;
+  pl->mic_hpf_mem = NULL;
+  pl->pre = NULL;
+  pl->gsc_q_mem = NULL;
+  pl->aec_q_mem = NULL;
+  pl->q_in = NULL;
+  pl->q_out = NULL;
+  pl->q_ref = NULL;
+  pl->fixed = 0;
+}
+
+#ifdef LE_COUNT_DENORMALS
+static int count_subnormal(const float *x, int n) {
+  int count = 0;
+  for (int i = 0; i < n; i++)
+    count += fpclassify(x[i]) == FP_SUBNORMAL;
+  return count;
+}
+
+// Decaying state that would turn subnormal in quiet passages without
+// flush-to-zero: the AIC weights, AGC/NG envelopes and gains, the output
+static long long pipeline_count_denormals(const Pipeline *ctx, int n) {
+  long long count = count_subnormal(ctx->gsc_out, n);
+  if (ctx->gsc_mode != GSC_MODE_SUBBAND) {
+    count += count_subnormal(ctx->st.w1, ctx->st.M);
+    count += count_subnormal(ctx->st.w2, ctx->st.M);
+  }
+  const float gains[4] = {ctx->agc.envelope, ctx->agc.gain, ctx->ng.envelope,
+                          ctx->ng.gain};
+  return count + count_subnormal(gains, 4);
+}
+#endif
+
+#ifdef LE_PROFILE_STAGES
+// Charge the ticks since *t to a stage and start the next interval
+static void stage_mark(Pipeline *ctx, PipelineStage stage, int n,
+                       unsigned long long *t) {
+  unsigned long long now = platform_ticks();
+  stage_profile_add(ctx->profile, stage, n, now - *t);
+  *t = now;
+}
+#define STAGE_START()                                                          \
+  unsigned long long stage_t = ctx->profile ? platform_ticks() : 0
+#define STAGE_MARK(stage, n)                                                   \
+  do {                                                                         \
+    if (ctx->profile)                                                          \
+      stage_mark(ctx, (stage), (n), &stage_t);                                 \
+  } while (0)
+#else
+#define STAGE_START() ((void)0)
+#define STAGE_MARK(stage, n) ((void)0)
+#endif
+
+int pipeline_process(const float *in, float *out, int frames, void *user) {
+  Pipeline *ctx = (Pipeline *)user;
+
+  // Decaying filters, envelopes and leaky weights reach the denormal range
+  // in quiet passages, where they cost 10-100x per operation. Set per call:
+  // the FP environment is per thread and the host may run other code on it.
+  platform_fp_flush_denormals();
+
+  // Apply control changes. Wait-free, and a no-op unless a new snapshot was
+  // published since the previous callback.
+  const DspParams *p;
+  if (param_mailbox_poll(&ctx->params, &p)) {
+    int M = ctx->cfg.M; // Filter memory is sized for the initial M
+    ctx->cfg = p->gsc;
+    ctx->cfg.M = M;
+    if (ctx->fixed)
+      gsc_q15_set_config(&ctx->st_q, &ctx->cfg);
+    ctx->aec_on = p->aec_on;
+    ctx->agc_on = p->agc_on;
+    ctx->ng_on = p->ng_on;
+    ctx->agc.target_rms = p->agc_target_rms;
+    ctx->ng.threshold_linear = p->ng_thresh_linear;
+  }
+
+  float sum_l = 0, sum_r = 0, sum_b = 0, sum_e = 0;
+
+  // Profiling
+  double start_us = platform_time_us();
+  STAGE_START();
+
+  for (int base = 0; base < frames; base += ctx->gsc_out_frames) {
+    int n = frames - base;
+    if (n > ctx->gsc_out_frames)
+      n = ctx->gsc_out_frames;
+    const float *blk_in = in + base * ctx->mics;
+    float *blk_out = out + base * 2;
+
+    // 0. Per-mic DC blockers, all mics in one pass of the bank (the scope
+    // and the stats see the filtered input)
+    if (ctx->mic_hpf_mem) {
+      biquad_bank_process(&ctx->mic_hpf, blk_in, ctx->mics, ctx->pre, n);
+      blk_in = ctx->pre;
+    }
+
+    // 1. GSC (Beamforming), whole block at once
+    if (ctx->fixed) {
+      float_to_q15_batch(blk_in, ctx->q_in, n * 3);
+      gsc_q15_process_block(&ctx->st_q, ctx->q_in, ctx->q_out, n);
+    } else if (ctx->mics == 4)
+      gsc_process_block_4ch(&ctx->st, &ctx->cfg, blk_in, ctx->gsc_out, n,
+                            ctx->beam_dir);
+    else if (ctx->gsc_mode == GSC_MODE_SUBBAND)
+      gsc_subband_process_block(&ctx->sb, &ctx->cfg, blk_in, ctx->gsc_out, n);
+    else
+      gsc_process_block(&ctx->st, &ctx->cfg, blk_in, ctx->gsc_out, n);
+    STAGE_MARK(PIPE_STAGE_GSC, n);
+
+    // 2. AEC (Remove echo of PREVIOUS block output from CURRENT block)
+    // The partition size equals the callback block; a short trailing chunk
+    // (never produced with a fixed frames_per_buffer) passes through.
+    int aec_ran = ctx->aec_on && (ctx->fixed || n == ctx->aec.N);
+    if (ctx->fixed) {
+      if (aec_ran)
+        aec_q15_process_block(&ctx->aec_q, ctx->q_out, ctx->q_ref,
+                              ctx->q_out, n);
+      q15_to_float_batch(ctx->q_out, ctx->gsc_out, n);
+    } else if (aec_ran) {
+      aec_fd_process(&ctx->aec, ctx->gsc_out, ctx->aec_ref, ctx->gsc_out);
+    }
+    STAGE_MARK(PIPE_STAGE_AEC, aec_ran ? n : 0);
+
+    // The scope and the stats show [xL, xR, xB]: with 4 mics, the left and
+    // right pairs and the back pair
+    if (ctx->mics == 4) {
+      for (int i = 0; i < n; i++) {
+        const float *x = &blk_in[i * 4];
+        ctx->in3[i * 3 + 0] = 0.5f * (x[0] + x[2]);
+        ctx->in3[i * 3 + 1] = 0.5f * (x[1] + x[3]);
+        ctx->in3[i * 3 + 2] = 0.5f * (x[2] + x[3]);
+      }
+      blk_in = ctx->in3;
+    }
+
+    // Scope tap: copy only, analysis runs on the server thread
+    if (ctx->scope)
+      scope_tap_push(ctx->scope, blk_in, ctx->gsc_out, n, pipeline_beta(ctx));
+    STAGE_MARK(PIPE_STAGE_OUTPUT, 0);
+
+    // 3. AGC and 4. Noise Gate, in place, one stage per pass (each is a
+    // sample-by-sample recursion, so the order of the passes is exact)
+    if (ctx->agc_on) {
+      for (int i = 0; i < n; i++)
+        ctx->gsc_out[i] = agc_process(&ctx->agc, ctx->gsc_out[i]);
+    }
+    STAGE_MARK(PIPE_STAGE_AGC, ctx->agc_on ? n : 0);
+    if (ctx->ng_on) {
+      for (int i = 0; i < n; i++)
+        ctx->gsc_out[i] = noise_gate_process(&ctx->ng, ctx->gsc_out[i]);
+    }
+    STAGE_MARK(PIPE_STAGE_GATE, ctx->ng_on ? n : 0);
+
+    for (int i = 0; i < n; i++) {
+      float xL = blk_in[i * 3 + 0];
+      float xR = blk_in[i * 3 + 1];
+      float xB = blk_in[i * 3 + 2];
+      float y = ctx->gsc_out[i];
+
+      // Stats accumulation (using y as 'e' - enhanced)
+      sum_l += xL * xL;
+      sum_r += xR * xR;
+      sum_b += xB * xB;
+      sum_e += y * y;
+
+      // Output
+      blk_out[i * 2 + 0] = y;
+      blk_out[i * 2 + 1] = y;
+
+      // Update reference for next block
+      if (!ctx->fixed)
+        ctx->aec_ref[i] = y;
+    }
+    if (ctx->fixed)
+      float_to_q15_batch(ctx->gsc_out, ctx->q_ref, n);
+#ifdef LE_COUNT_DENORMALS
+    long long denormals = pipeline_count_denormals(ctx, n);
+    ctx->denormals += denormals;
+    if (ctx->monitor)
+      deadline_monitor_add_denormals(ctx->monitor, denormals);
+#endif
+    STAGE_MARK(PIPE_STAGE_OUTPUT, n);
+  }
+
+  double end_us = platform_time_us();
+  double elapsed_us = end_us - start_us;
+
+  ctx->call_count++;
+#ifdef LE_PROFILE_STAGES
+  if (ctx->profile)
+    stage_profile_end_block(ctx->profile);
+#endif
+
+  // Lock-free counters only; reporting happens on other threads
+  if (ctx->monitor)
+    deadline_monitor_record(ctx->monitor, elapsed_us,
+                            1e6 * frames / ctx->setup.sample_rate);
+
+  // Per-block telemetry (the sink copies it into a lock-free ring; the server
+  // thread formats and sends it). No jitter buffer or phase aligner runs in
+  // this chain, so those fields stay zero.
+  if (ctx->telemetry && frames > 0) {
+    TelemetryRecord rec;
+    memset(&rec, 0, sizeof(rec));
+    rec.seq = (uint32_t)ctx->call_count;
+    rec.frames = (uint32_t)frames;
+    rec.rms_l = sqrtf(sum_l / frames);
+    rec.rms_r = sqrtf(sum_r / frames);
+    rec.rms_b = sqrtf(sum_b / frames);
+    rec.rms_out = sqrtf(sum_e / frames);
+    if (ctx->fixed) {
+      rec.beta = pipeline_beta(ctx);
+      rec.mu = q31_to_float(ctx->st_q.last_mu);
+      rec.gamma = q15_to_float(ctx->st_q.last_gamma);
+    } else if (ctx->gsc_mode == GSC_MODE_SUBBAND) {
+      rec.beta = ctx->sb.beta;
+      rec.mu = ctx->sb.last_mu;
+      rec.gamma = ctx->sb.last_gamma;
+    } else {
+      rec.beta = ctx->st.beta;
+      rec.mu = ctx->st.last_mu;
+      rec.gamma = ctx->st.last_gamma;
+    }
+    rec.dsp_us = (float)elapsed_us;
+    ctx->telemetry(&rec);
+  }
+
+  return 0; // Continue
+}
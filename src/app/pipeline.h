@@ -0,0 +1,173 @@
+/**
+ * @file pipeline.h
+ * @brief The LombardEar processing chain (GSC -> AEC -> AGC -> Noise Gate)
+ *
+ * One pipeline instance owns all DSP state for a stream. pipeline_process
+ * has the AudioProcessFn signature, so the same function runs behind the
+ * live audio backend and the offline file runner. The input is either the
+ * 3-mic layout [xL, xR, xB] or the 4-mic headset layout [xTL, xTR, xBL, xBR].
+ */
+
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include "../dsp/aec_fd.h"
+#include "../dsp/aec_q15.h"
+#include "../dsp/agc.h"
+#include "../dsp/biquad.h"
+#include "../dsp/gsc.h"
+#include "../dsp/gsc_q15.h"
+#include "../dsp/gsc_subband.h"
+#include "../dsp/noise_gate.h"
+#include "../dsp/scope_tap.h"
+#include "../utils/deadline_monitor.h"
+#include "../utils/param_mailbox.h"
+#include "../utils/telemetry.h"
+#include "stage_profile.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+  int sample_rate;
+  int block_frames; // Callback block size (also the AEC partition size)
+
+  GscConfig gsc;
+  GscMode gsc_mode;
+  GscSubbandConfig subband; // Used when gsc_mode == GSC_MODE_SUBBAND
+  int mics;                 // Input layout: 3 (also 0) or 4 (4-channel GSC)
+  BeamDirection beam_dir;   // 4-mic beam steering
+  float mic_hpf_hz;         // Per-mic DC blocker before the GSC, 0: off
+
+  int aec_tail_ms;     // Echo path length covered by the AEC
+  float agc_target_db;
+  float ng_thresh_db;
+  int aec_on;
+  int agc_on;
+  int ng_on;
+} PipelineConfig;
+
+// Per-block telemetry sink (called from the audio thread; must not block)
+typedef void (*PipelineTelemetryFn)(const TelemetryRecord *rec);
+
+typedef struct {
+  PipelineConfig setup; // Configuration the state was allocated for
+
+  GscState st;
+  GscConfig cfg;
+  float *gsc_mem;
+  float *gsc_out;     // Mono GSC output for one block
+  int gsc_out_frames; // Capacity of gsc_out in frames
+
+  // Subband beamformer (used when gsc_mode == GSC_MODE_SUBBAND)
+  GscMode gsc_mode;
+  GscSubbandState sb;
+  void *sb_mem;
+
+  // 4-mic input (mics == 4): 4-channel GSC, steered by beam_dir
+  int mics;
+  BeamDirection beam_dir;
+  float *in3; // 4-mic block folded to [xL, xR, xB] for the scope and stats
+
+  // Per-mic DC blockers (mic_hpf_hz > 0): one bank lane per mic, the
+  // filtered block in pre [gsc_out_frames * mics]
+  BiquadBank mic_hpf;
+  float *mic_hpf_mem;
+  float *pre;
+
+  // Fixed-point GSC and AEC (LE_FIXED_POINT builds, 3-mic time-domain GSC):
+  // Q15 blocks through gsc_q15 and a time-domain aec_q15 covering the tail
+  int fixed;
+  GscQ15State st_q;
+  AecQ15State aec_q;
+  void *gsc_q_mem;
+  void *aec_q_mem;
+  q15_t *q_in;  // [3 * gsc_out_frames]
+  q15_t *q_out; // [gsc_out_frames]
+  q15_t *q_ref; // Previous block output (AEC reference) [gsc_out_frames]
+
+  // DSP States
+  AecFdState aec;
+  AgcState agc;
+  NoiseGateState ng;
+
+  // DSP Buffers
+  void *aec_mem;
+  float *aec_ref; // Previous block output (AEC reference) [gsc_out_frames]
+
+  // Controls
+  int aec_on;
+  int agc_on;
+  int ng_on;
+  ParamMailbox params; // Published by the web UI, polled per callback
+
+  // Optional taps (set by the caller after pipeline_init)
+  ScopeTap *scope;               // Spectrum/waveform tap, NULL: disabled
+  PipelineTelemetryFn telemetry; // NULL: disabled
+  DeadlineMonitor *monitor;      // DSP time per block, NULL: disabled
+  StageProfile *profile; // Ticks per stage (LE_PROFILE_STAGES), NULL: none
+
+  // Profiling
+  long long call_count;
+  long long denormals; // Subnormal state/output values seen (counted only in
+                       // LE_COUNT_DENORMALS builds)
+} Pipeline;
+
+/**
+ * Defaults used by the realtime app (16 kHz, 480-frame blocks, 3 mics,
+ * time-domain GSC with running power, AEC/AGC/NG off).
+ */
+void pipeline_default_config(PipelineConfig *cfg);
+
+/**
+ * Allocate and initialize all DSP state. An invalid subband configuration
+ * falls back to the time-domain GSC, as does the subband mode with 4 mics
+ * (the subband beamformer is 3-channel). LE_FIXED_POINT builds run the
+ * 3-mic time-domain GSC and the AEC in Q15 (pl->fixed); the 4-mic and
+ * subband beamformers stay in float.
+ * @return 0 on success, -1 on allocation or configuration failure
+ */
+int pipeline_init(Pipeline *pl, const PipelineConfig *cfg);
+
+/**
+ * Prepare a pipeline for a new stream, reusing its memory when possible.
+ * State allocated for the same rate, block size, filter length and
+ * beamformer layout is reset in place (the result is identical to a fresh
+ * pipeline_init); otherwise it is freed and re-initialized. A zeroed
+ * Pipeline is initialized. Taps, the monitor and the profile are kept.
+ * @return 0 on success, -1 on allocation or configuration failure
+ */
+int pipeline_reuse(Pipeline *pl, const PipelineConfig *cfg);
+
+/**
+ * Release the memory allocated by pipeline_init.
+ */
+void pipeline_free(Pipeline *pl);
+
+/**
+ * Current back-mic coupling (beta) of the active beamformer.
+ */
+float pipeline_beta(const Pipeline *pl);
+
+/**
+ * Algorithmic delay from input to output in samples (subband GSC: its FFT
+ * size; time-domain chain: 0).
+ */
+int pipeline_latency(const Pipeline *pl);
+
+/**
+ * Process one block (AudioProcessFn).
+ * @param in: Interleaved [xL, xR, xB] frames ([xTL, xTR, xBL, xBR] with
+ *            mics == 4)
+ * @param out: Interleaved stereo output (the enhanced signal on both sides)
+ * @param user: Pipeline
+ * @return 0 (continue)
+ */
+int pipeline_process(const float *in, float *out, int frames, void *user);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PIPELINE_H
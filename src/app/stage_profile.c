@@ -0,0 +1,95 @@
+/**
+ * @file stage_profile.c
+ * @brief Per-stage cycle accounting (see stage_profile.h)
+ */
+
+#include "stage_profile.h"
+#include "../platform/platform.h"
+#include <stdio.h>
+#include <string.h>
+
+static const char *const k_stage_names[PIPE_STAGE_COUNT] = {
+    "gsc", "aec", "agc", "gate", "output"};
+
+void stage_profile_init(StageProfile *p) {
+  memset(p, 0, sizeof(*p));
+  p->ticks_per_us = platform_ticks_per_us();
+}
+
+void stage_profile_add(StageProfile *p, PipelineStage stage, int samples,
+                       unsigned long long ticks) {
+  le_atomic_fetch_add64(&p->ticks[stage], (long long)ticks);
+  if (samples > 0)
+    le_atomic_fetch_add64(&p->samples[stage], samples);
+}
+
+void stage_profile_end_block(StageProfile *p) {
+  le_atomic_fetch_add64(&p->blocks, 1);
+}
+
+void stage_profile_snapshot(StageProfile *p, StageProfileStats *s) {
+  s->blocks = le_atomic_load64(&p->blocks);
+  s->ticks_per_us = p->ticks_per_us;
+  for (int i = 0; i < PIPE_STAGE_COUNT; i++) {
+    perf_reset(&s->stage[i]);
+    perf_update(&s->stage[i], (uint64_t)le_atomic_load64(&p->samples[i]),
+                (uint64_t)le_atomic_load64(&p->ticks[i]));
+  }
+}
+
+void stage_profile_diff(const StageProfileStats *now,
+                        const StageProfileStats *prev, StageProfileStats *out) {
+  out->blocks = now->blocks - prev->blocks;
+  out->ticks_per_us = now->ticks_per_us;
+  for (int i = 0; i < PIPE_STAGE_COUNT; i++) {
+    perf_reset(&out->stage[i]);
+    perf_update(&out->stage[i],
+                now->stage[i].samples_processed -
+                    prev->stage[i].samples_processed,
+                now->stage[i].total_cycles - prev->stage[i].total_cycles);
+  }
+}
+
+const char *stage_profile_name(PipelineStage stage) {
+  return stage >= 0 && stage < PIPE_STAGE_COUNT ? k_stage_names[stage] : "?";
+}
+
+double stage_profile_us_per_block(const StageProfileStats *s,
+                                  PipelineStage stage) {
+  if (s->blocks <= 0 || s->ticks_per_us <= 0.0)
+    return 0.0;
+  return (double)s->stage[stage].total_cycles / s->ticks_per_us /
+         (double)s->blocks;
+}
+
+size_t stage_profile_format_json(const StageProfileStats *s, char *out,
+                                 size_t out_size) {
+  double total = 0.0;
+  for (int i = 0; i < PIPE_STAGE_COUNT; i++)
+    total += (double)s->stage[i].total_cycles;
+
+  int n = snprintf(out, out_size,
+                   "{\"type\":\"profile\",\"blocks\":%lld,"
+                   "\"ticks_per_us\":%.3f,\"stages\":[",
+                   s->blocks, s->ticks_per_us);
+  if (n < 0 || (size_t)n >= out_size)
+    return 0;
+  size_t pos = (size_t)n;
+  for (int i = 0; i < PIPE_STAGE_COUNT; i++) {
+    n = snprintf(out + pos, out_size - pos,
+                 "%s{\"name\":\"%s\",\"cycles_per_sample\":%.1f,"
+                 "\"us_per_block\":%.2f,\"share\":%.4f}",
+                 i ? "," : "", k_stage_names[i],
+                 s->stage[i].avg_cycles_per_sample,
+                 stage_profile_us_per_block(s, (PipelineStage)i),
+                 total > 0.0 ? (double)s->stage[i].total_cycles / total
+                             : 0.0);
+    if (n < 0 || (size_t)n >= out_size - pos)
+      return 0;
+    pos += (size_t)n;
+  }
+  n = snprintf(out + pos, out_size - pos, "]}");
+  if (n < 0 || (size_t)n >= out_size - pos)
+    return 0;
+  return pos + (size_t)n;
+}
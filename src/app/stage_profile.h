@@ -0,0 +1,87 @@
+/**
+ * @file stage_profile.h
+ * @brief Per-stage cycle accounting for the processing chain
+ *
+ * In LE_PROFILE_STAGES builds pipeline_process reads platform_ticks() at
+ * every stage boundary and charges the difference to the stage it just ran.
+ * The audio thread is the only writer and only does atomic adds; readers
+ * (offline runner, web server) take snapshots and aggregate them into one
+ * PerfMetrics per stage. Without the flag the pipeline never touches the
+ * profile and the snapshot stays empty.
+ */
+
+#ifndef STAGE_PROFILE_H
+#define STAGE_PROFILE_H
+
+#include "../dsp/steer_fast.h"
+#include "../utils/atomic_compat.h"
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+  PIPE_STAGE_GSC = 0, // Beamformer (time-domain or subband)
+  PIPE_STAGE_AEC,
+  PIPE_STAGE_AGC,
+  PIPE_STAGE_GATE,
+  PIPE_STAGE_OUTPUT, // Scope tap, levels, interleaving, denormal count
+  PIPE_STAGE_COUNT
+} PipelineStage;
+
+typedef struct {
+  le_atomic_i64 ticks[PIPE_STAGE_COUNT];
+  le_atomic_i64 samples[PIPE_STAGE_COUNT]; // Samples the stage ran on
+  le_atomic_i64 blocks;                    // Callbacks
+  double ticks_per_us;                     // platform_ticks() rate
+} StageProfile;
+
+typedef struct {
+  PerfMetrics stage[PIPE_STAGE_COUNT]; // Cycles are platform_ticks()
+  long long blocks;
+  double ticks_per_us;
+} StageProfileStats;
+
+/**
+ * Zero the counters and calibrate the tick rate (takes about 10 ms on x86).
+ * Call before the stream starts.
+ */
+void stage_profile_init(StageProfile *p);
+
+// Audio thread: a stage ran on `samples` samples for `ticks`. Disabled
+// stages are charged with 0 samples (the branch that skips them).
+void stage_profile_add(StageProfile *p, PipelineStage stage, int samples,
+                       unsigned long long ticks);
+
+// Audio thread: one callback finished
+void stage_profile_end_block(StageProfile *p);
+
+// Any thread: aggregate the counters
+void stage_profile_snapshot(StageProfile *p, StageProfileStats *s);
+
+// out = now - prev, with the per-sample averages recomputed
+void stage_profile_diff(const StageProfileStats *now,
+                        const StageProfileStats *prev, StageProfileStats *out);
+
+// Lower-case stage name ("gsc", "aec", ...)
+const char *stage_profile_name(PipelineStage stage);
+
+// Mean microseconds per callback spent in a stage (0 if no blocks)
+double stage_profile_us_per_block(const StageProfileStats *s,
+                                  PipelineStage stage);
+
+/**
+ * JSON object {"type":"profile","blocks":...,"ticks_per_us":...,
+ * "stages":[{"name":"gsc","cycles_per_sample":...,"us_per_block":...,
+ * "share":...}, ...]}. share is the stage's fraction of all profiled ticks.
+ * @return Length, or 0 if out is too small
+ */
+size_t stage_profile_format_json(const StageProfileStats *s, char *out,
+                                 size_t out_size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // STAGE_PROFILE_H
@@ -0,0 +1,599 @@
+/**
+ * @file tuner.c
+ * @brief GscConfig parameter search over a labelled corpus
+ */
+
+#include "tuner.h"
+#include "../dsp/simd_dispatch.h"
+#include "../platform/platform.h"
+#include "../utils/atomic_compat.h"
+#include "../utils/wav_io.h"
+#include "batch.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TUNE_CHUNK 256      // Grid candidates scored per parallel pass
+#define TUNE_MAX_THREADS 64
+
+// ============================================================================
+// Corpus
+// ============================================================================
+
+// Scale-invariant SNR of est against ref (optimal gain applied to ref)
+static float si_snr_db(const float *est, const float *ref, long n) {
+  double dot = 0.0, rr = 0.0, ee = 0.0;
+  for (long i = 0; i < n; i++) {
+    dot += (double)est[i] * ref[i];
+    rr += (double)ref[i] * ref[i];
+    ee += (double)est[i] * est[i];
+  }
+  if (rr <= 0.0)
+    return 0.0f;
+  double sig = dot * dot / rr;
+  double err = ee - sig;
+  if (err < 1e-20)
+    err = 1e-20;
+  if (sig < 1e-20)
+    sig = 1e-20;
+  return (float)(10.0 * log10(sig / err));
+}
+
+int tune_corpus_add(TuneCorpus *corpus, const char *name, const float *in,
+                    const float *target, long frames, int sample_rate) {
+  if (frames <= 0 || sample_rate <= 0)
+    return -1;
+  if (corpus->count == corpus->capacity) {
+    int cap = corpus->capacity ? 2 * corpus->capacity : 8;
+    TuneItem *items =
+        (TuneItem *)realloc(corpus->items, cap * sizeof(TuneItem));
+    if (!items)
+      return -1;
+    corpus->items = items;
+    corpus->capacity = cap;
+  }
+
+  TuneItem *it = &corpus->items[corpus->count];
+  memset(it, 0, sizeof(*it));
+  size_t name_len = strlen(name) + 1;
+  it->name = (char *)malloc(name_len);
+  it->in = (float *)malloc((size_t)frames * 3 * sizeof(float));
+  it->target = (float *)malloc((size_t)frames * sizeof(float));
+  float *mid = (float *)malloc((size_t)frames * sizeof(float));
+  if (!it->name || !it->in || !it->target || !mid) {
+    free(it->name);
+    free(it->in);
+    free(it->target);
+    free(mid);
+    return -1;
+  }
+  memcpy(it->name, name, name_len);
+  memcpy(it->in, in, (size_t)frames * 3 * sizeof(float));
+  memcpy(it->target, target, (size_t)frames * sizeof(float));
+  it->frames = frames;
+  it->sample_rate = sample_rate;
+
+  for (long i = 0; i < frames; i++)
+    mid[i] = 0.5f * (in[i * 3 + 0] + in[i * 3 + 1]);
+  it->snr_in_db = si_snr_db(mid, target, frames);
+  free(mid);
+
+  corpus->count++;
+  return 0;
+}
+
+// Decode a whole file; channel_map NULL: keep channel 0 only (mono)
+static float *load_file(const char *path, const int *channel_map, long *frames,
+                        int *sample_rate) {
+  WavInfo info;
+  WavReader *wr = wav_open_read(path, &info);
+  if (!wr)
+    return NULL;
+  const int C = info.channels;
+  const int out_ch = channel_map ? 3 : 1;
+  float *raw = (float *)malloc((size_t)info.frames * C * sizeof(float));
+  float *out = (float *)calloc((size_t)info.frames * out_ch, sizeof(float));
+  long got = (raw && out) ? wav_read_frames(wr, raw, info.frames) : 0;
+  wav_close_read(wr);
+  if (got <= 0) {
+    free(raw);
+    free(out);
+    return NULL;
+  }
+
+  for (long i = 0; i < got; i++) {
+    if (!channel_map) {
+      out[i] = raw[i * C];
+      continue;
+    }
+    for (int p = 0; p < C && p < 3; p++) {
+      int logical = channel_map[p];
+      if (logical >= 0 && logical < 3)
+        out[i * 3 + logical] = raw[i * C + p];
+    }
+  }
+  free(raw);
+  *frames = got;
+  *sample_rate = info.sample_rate;
+  return out;
+}
+
+int tune_corpus_load(TuneCorpus *corpus, const char *manifest,
+                     const int channel_map[3]) {
+  FILE *f = fopen(manifest, "r");
+  if (!f) {
+    fprintf(stderr, "Cannot read tuning manifest: %s\n", manifest);
+    return -1;
+  }
+
+  char line[8192];
+  int ret = 0;
+  while (ret == 0 && fgets(line, sizeof(line), f)) {
+    char mix_path[4096], tgt_path[4096];
+    if (line[0] == '#' ||
+        sscanf(line, "%4095s %4095s", mix_path, tgt_path) != 2)
+      continue;
+
+    long n_mix = 0, n_tgt = 0;
+    int fs_mix = 0, fs_tgt = 0;
+    float *mix = load_file(mix_path, channel_map, &n_mix, &fs_mix);
+    float *tgt = load_file(tgt_path, NULL, &n_tgt, &fs_tgt);
+    if (!mix || !tgt || fs_mix != fs_tgt) {
+      fprintf(stderr, "Cannot load corpus pair: %s %s\n", mix_path, tgt_path);
+      ret = -1;
+    } else {
+      long n = n_mix < n_tgt ? n_mix : n_tgt;
+      ret = tune_corpus_add(corpus, mix_path, mix, tgt, n, fs_mix);
+    }
+    free(mix);
+    free(tgt);
+  }
+  fclose(f);
+  return ret;
+}
+
+void tune_corpus_free(TuneCorpus *corpus) {
+  for (int i = 0; i < corpus->count; i++) {
+    free(corpus->items[i].name);
+    free(corpus->items[i].in);
+    free(corpus->items[i].target);
+  }
+  free(corpus->items);
+  memset(corpus, 0, sizeof(*corpus));
+}
+
+// ============================================================================
+// Parallel evaluation
+// ============================================================================
+
+// Per-worker arena: pipeline state plus output/beta buffers sized for the
+// longest item, allocated once and reused for every trial
+typedef struct {
+  Pipeline pl;
+  float *blk_in;  // [N * 3] Zero-padded final block
+  float *blk_out; // [N * 2]
+  float *y;       // [max_frames] Mono output
+  float *beta;    // [max_blocks] Beta after every block
+  int failed;
+} TuneWorker;
+
+typedef struct {
+  const TuneCorpus *corpus;
+  const PipelineConfig *base;
+  const GscConfig *cands;
+  int units; // cands * items
+  le_atomic_int next;
+  float *gain; // [units]
+  float *conv; // [units]
+  TuneWorker *workers;
+  int threads;
+} TunePool;
+
+static int worker_init(TuneWorker *w, const TuneCorpus *corpus, int N) {
+  long max_frames = 0;
+  for (int i = 0; i < corpus->count; i++) {
+    if (corpus->items[i].frames > max_frames)
+      max_frames = corpus->items[i].frames;
+  }
+  long max_blocks = (max_frames + N - 1) / N;
+  memset(w, 0, sizeof(*w));
+  w->blk_in = (float *)calloc((size_t)N * 3, sizeof(float));
+  w->blk_out = (float *)malloc((size_t)N * 2 * sizeof(float));
+  w->y = (float *)malloc((size_t)max_blocks * N * sizeof(float));
+  w->beta = (float *)malloc((size_t)max_blocks * sizeof(float));
+  return (w->blk_in && w->blk_out && w->y && w->beta) ? 0 : -1;
+}
+
+static void worker_free(TuneWorker *w) {
+  pipeline_free(&w->pl);
+  free(w->blk_in);
+  free(w->blk_out);
+  free(w->y);
+  free(w->beta);
+}
+
+// One trial: run the item through the pipeline, score the output
+static int run_trial(TuneWorker *w, const PipelineConfig *base,
+                     const GscConfig *gsc, const TuneItem *it, float *gain,
+                     float *conv) {
+  PipelineConfig cfg = *base;
+  cfg.gsc = *gsc;
+  cfg.sample_rate = it->sample_rate;
+  if (pipeline_reuse(&w->pl, &cfg) != 0)
+    return -1;
+
+  const int N = cfg.block_frames;
+  long blocks = 0;
+  for (long base_i = 0; base_i < it->frames; base_i += N, blocks++) {
+    long n = it->frames - base_i < N ? it->frames - base_i : N;
+    const float *src = it->in + base_i * 3;
+    if (n < N) {
+      memset(w->blk_in, 0, (size_t)N * 3 * sizeof(float));
+      memcpy(w->blk_in, src, (size_t)n * 3 * sizeof(float));
+      src = w->blk_in;
+    }
+    pipeline_process(src, w->blk_out, N, &w->pl);
+    for (long i = 0; i < n; i++)
+      w->y[base_i + i] = w->blk_out[i * 2];
+    w->beta[blocks] = pipeline_beta(&w->pl);
+  }
+
+  long lat = pipeline_latency(&w->pl);
+  if (lat >= it->frames)
+    return -1;
+  *gain = si_snr_db(w->y + lat, it->target, it->frames - lat) - it->snr_in_db;
+  *conv = batch_beta_convergence(w->beta, blocks, N, it->sample_rate);
+  return 0;
+}
+
+typedef struct {
+  TunePool *pool;
+  TuneWorker *w;
+} TuneThreadArg;
+
+static void pool_worker(void *arg) {
+  TuneThreadArg *a = (TuneThreadArg *)arg;
+  TunePool *pool = a->pool;
+  const int items = pool->corpus->count;
+  for (;;) {
+    int u = le_atomic_fetch_add(&pool->next, 1);
+    if (u >= pool->units)
+      break;
+    const GscConfig *gsc = &pool->cands[u / items];
+    const TuneItem *it = &pool->corpus->items[u % items];
+    if (run_trial(a->w, pool->base, gsc, it, &pool->gain[u], &pool->conv[u]) !=
+        0)
+      a->w->failed = 1;
+  }
+}
+
+static int pool_init(TunePool *pool, const TuneCorpus *corpus,
+                     const PipelineConfig *base, int threads) {
+  le_simd_init(); // Workers initialize their pipelines concurrently
+  memset(pool, 0, sizeof(*pool));
+  pool->corpus = corpus;
+  pool->base = base;
+  pool->threads = threads > 0 ? threads : platform_cpu_count();
+  if (pool->threads > TUNE_MAX_THREADS)
+    pool->threads = TUNE_MAX_THREADS;
+  pool->workers = (TuneWorker *)calloc(pool->threads, sizeof(TuneWorker));
+  if (!pool->workers)
+    return -1;
+  for (int t = 0; t < pool->threads; t++) {
+    if (worker_init(&pool->workers[t], corpus, base->block_frames) != 0)
+      return -1;
+  }
+  return 0;
+}
+
+static void pool_free(TunePool *pool) {
+  if (pool->workers) {
+    for (int t = 0; t < pool->threads; t++)
+      worker_free(&pool->workers[t]);
+  }
+  free(pool->workers);
+  free(pool->gain);
+  free(pool->conv);
+  memset(pool, 0, sizeof(*pool));
+}
+
+static int pool_evaluate(TunePool *pool, const GscConfig *cands, int count,
+                         float conv_weight, TuneResult *results) {
+  const int items = pool->corpus->count;
+  if (items == 0 || count <= 0)
+    return -1;
+
+  int units = count * items;
+  float *gain = (float *)realloc(pool->gain, (size_t)units * sizeof(float));
+  if (gain)
+    pool->gain = gain;
+  float *conv = (float *)realloc(pool->conv, (size_t)units * sizeof(float));
+  if (conv)
+    pool->conv = conv;
+  if (!gain || !conv)
+    return -1;
+
+  pool->cands = cands;
+  pool->units = units;
+  le_atomic_store(&pool->next, 0);
+
+  int threads = pool->threads < units ? pool->threads : units;
+  TuneThreadArg args[TUNE_MAX_THREADS];
+  PlatformThread *handles[TUNE_MAX_THREADS];
+  for (int t = 0; t < threads; t++) {
+    args[t].pool = pool;
+    args[t].w = &pool->workers[t];
+    handles[t] = t > 0 ? platform_thread_start(pool_worker, &args[t]) : NULL;
+  }
+  pool_worker(&args[0]);
+  for (int t = 1; t < threads; t++)
+    platform_thread_join(handles[t]);
+
+  for (int t = 0; t < threads; t++) {
+    if (pool->workers[t].failed)
+      return -1;
+  }
+
+  for (int c = 0; c < count; c++) {
+    double g = 0.0, cv = 0.0;
+    for (int i = 0; i < items; i++) {
+      g += pool->gain[c * items + i];
+      cv += pool->conv[c * items + i];
+    }
+    results[c].gsc = cands[c];
+    results[c].snr_gain_db = (float)(g / items);
+    results[c].convergence_s = (float)(cv / items);
+    results[c].score =
+        results[c].snr_gain_db - conv_weight * results[c].convergence_s;
+  }
+  return 0;
+}
+
+int tune_evaluate(const TuneCorpus *corpus, const PipelineConfig *base,
+                  const GscConfig *cands, int count, const TuneOptions *opts,
+                  TuneResult *results) {
+  TunePool pool;
+  int ret = pool_init(&pool, corpus, base, opts->threads);
+  if (ret == 0)
+    ret = pool_evaluate(&pool, cands, count, opts->conv_weight, results);
+  pool_free(&pool);
+  return ret;
+}
+
+// ============================================================================
+// Search
+// ============================================================================
+
+void tune_default_options(TuneOptions *opts) {
+  memset(opts, 0, sizeof(*opts));
+  opts->method = TUNE_METHOD_ADAPTIVE;
+  opts->trials = 64;
+  opts->population = 16;
+  opts->threads = 0;
+  opts->conv_weight = 1.0f; // 1 dB of SNR gain is worth 1 s of convergence
+  opts->seed = 1;
+
+  const TuneRange defaults[TUNE_PARAM_COUNT] = {
+      [TUNE_ALPHA] = {1, 0.001f, 0.05f, 1, 3},
+      [TUNE_MU_MAX] = {1, 0.001f, 0.1f, 1, 3},
+      [TUNE_ETA_MAX] = {1, 0.0001f, 0.01f, 1, 3},
+      [TUNE_LEAK_LAMBDA] = {1, 1e-6f, 1e-3f, 1, 3},
+      [TUNE_G_LO] = {1, 0.02f, 0.3f, 0, 3},
+      [TUNE_G_HI] = {1, 0.1f, 0.8f, 0, 3},
+  };
+  memcpy(opts->range, defaults, sizeof(defaults));
+}
+
+static float *param_ptr(GscConfig *g, int p) {
+  switch (p) {
+  case TUNE_ALPHA:
+    return &g->alpha;
+  case TUNE_MU_MAX:
+    return &g->mu_max;
+  case TUNE_ETA_MAX:
+    return &g->eta_max;
+  case TUNE_LEAK_LAMBDA:
+    return &g->leak_lambda;
+  case TUNE_G_LO:
+    return &g->g_lo;
+  default:
+    return &g->g_hi;
+  }
+}
+
+// Map x in [0, 1] onto the range
+static float range_value(const TuneRange *r, float x) {
+  if (x < 0.0f)
+    x = 0.0f;
+  if (x > 1.0f)
+    x = 1.0f;
+  if (r->log_scale && r->lo > 0.0f && r->hi > 0.0f)
+    return r->lo * powf(r->hi / r->lo, x);
+  return r->lo + (r->hi - r->lo) * x;
+}
+
+static float range_position(const TuneRange *r, float v) {
+  float x;
+  if (r->log_scale && r->lo > 0.0f && r->hi > 0.0f && v > 0.0f)
+    x = logf(v / r->lo) / logf(r->hi / r->lo);
+  else
+    x = (r->hi != r->lo) ? (v - r->lo) / (r->hi - r->lo) : 0.0f;
+  return x < 0.0f ? 0.0f : (x > 1.0f ? 1.0f : x);
+}
+
+// Soft-control thresholds must stay ordered
+static void fix_order(GscConfig *g) {
+  if (g->g_lo > g->g_hi) {
+    float t = g->g_lo;
+    g->g_lo = g->g_hi;
+    g->g_hi = t;
+  }
+}
+
+static unsigned rng_next(unsigned *s) {
+  // xorshift32
+  unsigned x = *s ? *s : 0x9E3779B9u;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  *s = x;
+  return x;
+}
+
+static float rng_uniform(unsigned *s) {
+  return (float)(rng_next(s) >> 8) * (1.0f / 16777216.0f);
+}
+
+static float rng_gauss(unsigned *s) {
+  float u1 = rng_uniform(s), u2 = rng_uniform(s);
+  if (u1 < 1e-7f)
+    u1 = 1e-7f;
+  return sqrtf(-2.0f * logf(u1)) * cosf(6.2831853f * u2);
+}
+
+typedef struct {
+  TuneResult best;
+  TuneResult *history;
+  int history_cap;
+  int evaluated;
+} TuneLog;
+
+static void log_results(TuneLog *log, const TuneResult *r, int count) {
+  for (int i = 0; i < count; i++) {
+    if (log->evaluated == 0 || r[i].score > log->best.score)
+      log->best = r[i];
+    if (log->history && log->evaluated < log->history_cap)
+      log->history[log->evaluated] = r[i];
+    log->evaluated++;
+  }
+}
+
+static int search_grid(TunePool *pool, const GscConfig *base,
+                       const TuneOptions *opts, TuneLog *log) {
+  long total = 1;
+  int steps[TUNE_PARAM_COUNT];
+  for (int p = 0; p < TUNE_PARAM_COUNT; p++) {
+    const TuneRange *r = &opts->range[p];
+    steps[p] = (r->enabled && r->steps > 1) ? r->steps : 1;
+    total *= steps[p];
+  }
+
+  GscConfig *cands = (GscConfig *)malloc(TUNE_CHUNK * sizeof(GscConfig));
+  TuneResult *res = (TuneResult *)malloc(TUNE_CHUNK * sizeof(TuneResult));
+  int ret = (cands && res) ? 0 : -1;
+
+  // Base config first, then the grid (mixed-radix counter over the ranges)
+  int n = 0;
+  if (ret == 0)
+    cands[n++] = *base;
+  for (long k = 0; ret == 0 && k < total; k++) {
+    GscConfig g = *base;
+    long rem = k;
+    for (int p = 0; p < TUNE_PARAM_COUNT; p++) {
+      const TuneRange *r = &opts->range[p];
+      int idx = (int)(rem % steps[p]);
+      rem /= steps[p];
+      if (r->enabled)
+        *param_ptr(&g, p) = range_value(
+            r, steps[p] > 1 ? (float)idx / (float)(steps[p] - 1) : 0.0f);
+    }
+    if (g.g_lo >= g.g_hi)
+      continue; // Inverted soft-control band: not a valid candidate
+    cands[n++] = g;
+    if (n == TUNE_CHUNK) {
+      ret = pool_evaluate(pool, cands, n, opts->conv_weight, res);
+      if (ret == 0)
+        log_results(log, res, n);
+      n = 0;
+    }
+  }
+  if (ret == 0 && n > 0) {
+    ret = pool_evaluate(pool, cands, n, opts->conv_weight, res);
+    if (ret == 0)
+      log_results(log, res, n);
+  }
+  free(cands);
+  free(res);
+  return ret;
+}
+
+static int search_adaptive(TunePool *pool, const GscConfig *base,
+                           const TuneOptions *opts, TuneLog *log) {
+  int pop = opts->population > 0 ? opts->population : 16;
+  GscConfig *cands = (GscConfig *)malloc((size_t)pop * sizeof(GscConfig));
+  TuneResult *res = (TuneResult *)malloc((size_t)pop * sizeof(TuneResult));
+  if (!cands || !res) {
+    free(cands);
+    free(res);
+    return -1;
+  }
+
+  unsigned seed = opts->seed;
+  float sigma = 0.25f; // Neighbourhood radius in normalized range units
+  int ret = 0;
+  int remaining = opts->trials > 0 ? opts->trials : 1;
+  int gen = 0;
+  while (ret == 0 && remaining > 0) {
+    int n = remaining < pop ? remaining : pop;
+    for (int c = 0; c < n; c++) {
+      GscConfig g = (gen == 0) ? *base : log->best.gsc;
+      if (gen == 0 && c == 0) {
+        cands[c] = g;
+        continue;
+      }
+      for (int p = 0; p < TUNE_PARAM_COUNT; p++) {
+        const TuneRange *r = &opts->range[p];
+        if (!r->enabled)
+          continue;
+        float *v = param_ptr(&g, p);
+        // First generation explores the whole box, later ones the
+        // neighbourhood of the best candidate so far
+        float x = (gen == 0) ? rng_uniform(&seed)
+                             : range_position(r, *v) + sigma * rng_gauss(&seed);
+        *v = range_value(r, x);
+      }
+      fix_order(&g);
+      cands[c] = g;
+    }
+
+    ret = pool_evaluate(pool, cands, n, opts->conv_weight, res);
+    if (ret == 0)
+      log_results(log, res, n);
+    remaining -= n;
+    if (gen > 0)
+      sigma *= 0.7f;
+    gen++;
+  }
+  free(cands);
+  free(res);
+  return ret;
+}
+
+int tune_run(const TuneCorpus *corpus, const PipelineConfig *base,
+             const TuneOptions *opts, TuneResult *best, TuneResult *history,
+             int history_cap, int *evaluated) {
+  if (corpus->count == 0)
+    return -1;
+
+  TunePool pool;
+  int ret = pool_init(&pool, corpus, base, opts->threads);
+  TuneLog log;
+  memset(&log, 0, sizeof(log));
+  log.history = history;
+  log.history_cap = history_cap;
+
+  if (ret == 0) {
+    if (opts->method == TUNE_METHOD_GRID)
+      ret = search_grid(&pool, &base->gsc, opts, &log);
+    else
+      ret = search_adaptive(&pool, &base->gsc, opts, &log);
+  }
+  pool_free(&pool);
+
+  if (ret == 0 && best)
+    *best = log.best;
+  if (evaluated)
+    *evaluated = log.evaluated;
+  return ret;
+}
@@ -0,0 +1,128 @@
+/**
+ * @file tuner.h
+ * @brief GscConfig parameter search over a labelled corpus
+ *
+ * A corpus item is a 3-channel mixture plus the clean target it contains.
+ * Both are decoded once into memory; every trial is then pure DSP. A
+ * candidate is scored per item by the scale-invariant SNR gain of the
+ * pipeline output over the fixed beamformer (L + R) / 2, minus a penalty
+ * per second of beta convergence time, and averaged over the corpus.
+ *
+ * Trials (candidate x item pairs) are spread over worker threads through a
+ * lock-free index; every worker owns its Pipeline and scratch buffers.
+ */
+
+#ifndef TUNER_H
+#define TUNER_H
+
+#include "pipeline.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+  TUNE_ALPHA = 0,
+  TUNE_MU_MAX,
+  TUNE_ETA_MAX,
+  TUNE_LEAK_LAMBDA,
+  TUNE_G_LO,
+  TUNE_G_HI,
+  TUNE_PARAM_COUNT
+} TuneParam;
+
+typedef enum {
+  TUNE_METHOD_GRID = 0, // Cartesian product of `steps` points per range
+  TUNE_METHOD_ADAPTIVE  // Random start, then sampling around the best
+} TuneMethod;
+
+typedef struct {
+  int enabled;   // 0: keep the base value
+  float lo;
+  float hi;
+  int log_scale; // Sample log-uniformly (step sizes, leakage)
+  int steps;     // Grid points (>= 2; 1 uses lo)
+} TuneRange;
+
+typedef struct {
+  TuneMethod method;
+  TuneRange range[TUNE_PARAM_COUNT];
+  int trials;        // Adaptive: total candidates including the base config
+  int population;    // Adaptive: candidates per generation
+  int threads;       // <= 0: one per CPU core
+  float conv_weight; // Score penalty in dB per second of convergence
+  unsigned seed;     // Adaptive: random seed (runs are reproducible)
+} TuneOptions;
+
+typedef struct {
+  GscConfig gsc;
+  float score;         // Mean over the corpus (higher is better)
+  float snr_gain_db;   // Mean SI-SNR improvement over (L + R) / 2
+  float convergence_s; // Mean beta convergence time
+} TuneResult;
+
+typedef struct {
+  char *name;
+  float *in;     // [frames * 3] Logical [xL, xR, xB]
+  float *target; // [frames] Clean target as seen by the fixed beamformer
+  long frames;
+  int sample_rate;
+  float snr_in_db; // SI-SNR of (L + R) / 2 against target
+} TuneItem;
+
+typedef struct {
+  TuneItem *items;
+  int count;
+  int capacity;
+} TuneCorpus;
+
+/**
+ * Default options: adaptive search, 64 trials, all ranges enabled.
+ */
+void tune_default_options(TuneOptions *opts);
+
+/**
+ * Add an item (the buffers are copied).
+ * @return 0 on success, -1 on allocation failure or empty input
+ */
+int tune_corpus_add(TuneCorpus *corpus, const char *name, const float *in,
+                    const float *target, long frames, int sample_rate);
+
+/**
+ * Load a manifest: one "<mixture.wav> <target.wav>" pair per line ('#'
+ * comments). The mixture is remapped with channel_map; the first channel of
+ * the target file is used.
+ * @return 0 on success, -1 on I/O error (the message names the file)
+ */
+int tune_corpus_load(TuneCorpus *corpus, const char *manifest,
+                     const int channel_map[3]);
+
+void tune_corpus_free(TuneCorpus *corpus);
+
+/**
+ * Score a list of candidates in parallel.
+ * @param base: Pipeline settings shared by all trials (gsc is replaced)
+ * @param results: Output, one per candidate (gsc copied from cands)
+ * @return 0 on success, -1 on allocation failure
+ */
+int tune_evaluate(const TuneCorpus *corpus, const PipelineConfig *base,
+                  const GscConfig *cands, int count, const TuneOptions *opts,
+                  TuneResult *results);
+
+/**
+ * Run the search. The base configuration is always candidate 0, so the best
+ * result never scores below it.
+ * @param history: Optional output of every evaluated candidate
+ * @param history_cap: Capacity of history
+ * @param evaluated: Output, number of candidates evaluated (may be NULL)
+ * @return 0 on success, -1 on failure
+ */
+int tune_run(const TuneCorpus *corpus, const PipelineConfig *base,
+             const TuneOptions *opts, TuneResult *best, TuneResult *history,
+             int history_cap, int *evaluated);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TUNER_H
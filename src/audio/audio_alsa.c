@@ -0,0 +1,425 @@
+/**
+ * @file audio_alsa.c
+ * @brief Native mmap-mode ALSA backend (Linux)
+ *
+ * Capture and playback are linked PCMs serviced by one realtime thread:
+ * wait for a capture period, process it, write it straight into the
+ * playback ring. No intermediate buffering, so the round trip is one
+ * capture period plus the playback buffer (periods * period) plus the
+ * converter delay of the hardware.
+ */
+
+#ifdef LE_WITH_ALSA
+
+#include "../platform/platform.h"
+#include "../utils/atomic_compat.h"
+#include "audio_backend.h"
+#include "sample_convert.h"
+#include <alsa/asoundlib.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+  snd_pcm_t *cap;
+  snd_pcm_t *play;
+  snd_pcm_format_t cap_fmt;
+  snd_pcm_format_t play_fmt;
+  unsigned int cap_ch;  // Hardware channels (may exceed the used ones)
+  unsigned int play_ch;
+  snd_pcm_uframes_t period;
+  snd_pcm_uframes_t buffer; // Playback buffer
+
+  AudioConfig cfg;
+  AudioProcessFn fn;
+  void *user;
+  float *in_buf;  // [period * mics] Logical [L, R, B] or [TL, TR, BL, BR]
+  float *out_buf; // [period * output_channels]
+
+  PlatformThread *thread;
+  le_atomic_int running;
+  le_atomic_int xruns;
+  le_atomic_int rt_status; // platform_rt_enter result, -1: not started
+} AlsaIO;
+
+// Formats tried in order; float avoids any conversion
+static const snd_pcm_format_t k_formats[] = {
+    SND_PCM_FORMAT_FLOAT_LE, SND_PCM_FORMAT_S32_LE, SND_PCM_FORMAT_S16_LE};
+#define FORMAT_COUNT (sizeof(k_formats) / sizeof(k_formats[0]))
+
+static const char *pcm_name(const char *name) {
+  return name[0] ? name : "default";
+}
+
+// hw params: mmap interleaved, exact rate (no resampling), at least
+// min_channels, period of `period` frames and `periods` periods
+static int setup_pcm(snd_pcm_t *pcm, const char *what, unsigned int rate,
+                     unsigned int min_channels, snd_pcm_uframes_t period,
+                     unsigned int periods, snd_pcm_format_t *fmt,
+                     unsigned int *channels, snd_pcm_uframes_t *period_out,
+                     snd_pcm_uframes_t *buffer_out) {
+  snd_pcm_hw_params_t *hw;
+  snd_pcm_hw_params_alloca(&hw);
+  int err = snd_pcm_hw_params_any(pcm, hw);
+  if (err >= 0)
+    err = snd_pcm_hw_params_set_access(pcm, hw,
+                                       SND_PCM_ACCESS_MMAP_INTERLEAVED);
+  if (err < 0) {
+    fprintf(stderr, "ALSA %s: no mmap access: %s\n", what, snd_strerror(err));
+    return -1;
+  }
+
+  size_t f = 0;
+  while (f < FORMAT_COUNT &&
+         snd_pcm_hw_params_test_format(pcm, hw, k_formats[f]) < 0)
+    f++;
+  if (f == FORMAT_COUNT) {
+    fprintf(stderr, "ALSA %s: no float/S32/S16 format\n", what);
+    return -1;
+  }
+  *fmt = k_formats[f];
+
+  unsigned int ch = min_channels;
+  snd_pcm_uframes_t buffer = period * periods;
+  if ((err = snd_pcm_hw_params_set_format(pcm, hw, *fmt)) < 0 ||
+      (err = snd_pcm_hw_params_set_channels_near(pcm, hw, &ch)) < 0 ||
+      (err = snd_pcm_hw_params_set_rate_resample(pcm, hw, 0)) < 0 ||
+      (err = snd_pcm_hw_params_set_rate(pcm, hw, rate, 0)) < 0 ||
+      (err = snd_pcm_hw_params_set_period_size_near(pcm, hw, &period, NULL)) <
+          0 ||
+      (err = snd_pcm_hw_params_set_buffer_size_near(pcm, hw, &buffer)) < 0 ||
+      (err = snd_pcm_hw_params(pcm, hw)) < 0) {
+    fprintf(stderr, "ALSA %s: %u Hz / %lu frames not supported: %s\n", what,
+            rate, (unsigned long)period, snd_strerror(err));
+    return -1;
+  }
+  if (ch < min_channels) {
+    fprintf(stderr, "ALSA %s: %u channels needed, device has %u\n", what,
+            min_channels, ch);
+    return -1;
+  }
+  snd_pcm_hw_params_get_period_size(hw, period_out, NULL);
+  snd_pcm_hw_params_get_buffer_size(hw, buffer_out);
+  *channels = ch;
+
+  // Started explicitly (linked), woken once per period
+  snd_pcm_sw_params_t *sw;
+  snd_pcm_sw_params_alloca(&sw);
+  if ((err = snd_pcm_sw_params_current(pcm, sw)) < 0 ||
+      (err = snd_pcm_sw_params_set_start_threshold(pcm, sw, *buffer_out * 2)) <
+          0 ||
+      (err = snd_pcm_sw_params_set_avail_min(pcm, sw, *period_out)) < 0 ||
+      (err = snd_pcm_sw_params(pcm, sw)) < 0) {
+    fprintf(stderr, "ALSA %s: sw params: %s\n", what, snd_strerror(err));
+    return -1;
+  }
+  return 0;
+}
+
+// Address of frame `offset` of channel `c` in an mmap area
+static inline void *area_ptr(const snd_pcm_channel_area_t *areas,
+                             unsigned int c, snd_pcm_uframes_t offset) {
+  const snd_pcm_channel_area_t *a = &areas[c];
+  return (char *)a->addr + (a->first + offset * a->step) / 8;
+}
+
+static inline float sample_in(const void *p, snd_pcm_format_t fmt) {
+  switch (fmt) {
+  case SND_PCM_FORMAT_FLOAT_LE:
+    return *(const float *)p;
+  case SND_PCM_FORMAT_S32_LE:
+    return sample_s32_to_float(*(const int32_t *)p);
+  default:
+    return sample_s16_to_float(*(const int16_t *)p);
+  }
+}
+
+static inline void sample_out(void *p, snd_pcm_format_t fmt, float v) {
+  switch (fmt) {
+  case SND_PCM_FORMAT_FLOAT_LE:
+    *(float *)p = v;
+    break;
+  case SND_PCM_FORMAT_S32_LE:
+    *(int32_t *)p = sample_float_to_s32(v);
+    break;
+  default:
+    *(int16_t *)p = sample_float_to_s16(v);
+    break;
+  }
+}
+
+// Copy one capture period into in_buf, remapped to logical channels
+static int read_period(AlsaIO *io) {
+  snd_pcm_uframes_t done = 0;
+  while (done < io->period) {
+    const snd_pcm_channel_area_t *areas;
+    snd_pcm_uframes_t offset, frames = io->period - done;
+    int err = snd_pcm_mmap_begin(io->cap, &areas, &offset, &frames);
+    if (err < 0)
+      return err;
+    if (frames == 0)
+      return -EPIPE; // Called with a full period available: out of sync
+    const int L = audio_mic_count(&io->cfg);
+    for (snd_pcm_uframes_t i = 0; i < frames; i++) {
+      float *dst = &io->in_buf[(done + i) * L];
+      for (unsigned int p = 0; p < io->cap_ch && p < AUDIO_MAX_MICS; p++) {
+        int logical = io->cfg.channel_map[p];
+        if (logical >= 0 && logical < L)
+          dst[logical] = sample_in(area_ptr(areas, p, offset + i), io->cap_fmt);
+      }
+    }
+    snd_pcm_sframes_t n = snd_pcm_mmap_commit(io->cap, offset, frames);
+    if (n < 0)
+      return (int)n;
+    done += (snd_pcm_uframes_t)n;
+  }
+  return 0;
+}
+
+// Write `count` frames of out_buf (NULL: silence) into the playback ring.
+// Waits for room while the ring is full; a ring that does not drain within
+// one buffer time is reported as an xrun (-EPIPE).
+static int write_frames(AlsaIO *io, const float *src, snd_pcm_uframes_t count) {
+  const int out_ch = io->cfg.output_channels;
+  const int wait_ms = (int)(1000 * io->buffer / io->cfg.sample_rate) + 1;
+  snd_pcm_uframes_t done = 0;
+  while (done < count) {
+    // mmap_begin only sees the space found by the last avail_update
+    snd_pcm_sframes_t avail = snd_pcm_avail_update(io->play);
+    if (avail < 0)
+      return (int)avail;
+    if (avail == 0) {
+      int err = snd_pcm_wait(io->play, wait_ms);
+      if (err < 0)
+        return err;
+      if (err == 0)
+        return -EPIPE;
+      continue;
+    }
+
+    const snd_pcm_channel_area_t *areas;
+    snd_pcm_uframes_t offset, frames = count - done;
+    if (frames > (snd_pcm_uframes_t)avail)
+      frames = (snd_pcm_uframes_t)avail;
+    int err = snd_pcm_mmap_begin(io->play, &areas, &offset, &frames);
+    if (err < 0)
+      return err;
+    if (frames == 0)
+      return -EPIPE; // Never spin on an empty commit
+    for (snd_pcm_uframes_t i = 0; i < frames; i++) {
+      for (unsigned int c = 0; c < io->play_ch; c++) {
+        float v =
+            (src && (int)c < out_ch) ? src[(done + i) * out_ch + c] : 0.0f;
+        sample_out(area_ptr(areas, c, offset + i), io->play_fmt, v);
+      }
+    }
+    snd_pcm_sframes_t n = snd_pcm_mmap_commit(io->play, offset, frames);
+    if (n < 0)
+      return (int)n;
+    if (n == 0)
+      return -EPIPE;
+    done += (snd_pcm_uframes_t)n;
+  }
+  return 0;
+}
+
+// Prepare both (linked) streams, fill the playback buffer with silence and
+// start them together
+static int restart(AlsaIO *io) {
+  int err;
+  snd_pcm_drop(io->cap);
+  if ((err = snd_pcm_prepare(io->cap)) < 0 ||
+      (err = write_frames(io, NULL, io->buffer)) < 0 ||
+      (err = snd_pcm_start(io->cap)) < 0)
+    return err;
+  return 0;
+}
+
+static void alsa_thread(void *arg) {
+  AlsaIO *io = (AlsaIO *)arg;
+  le_atomic_store(&io->rt_status, platform_rt_enter(&io->cfg.rt));
+
+  while (le_atomic_load(&io->running)) {
+    int err = snd_pcm_wait(io->cap, 1000);
+    if (err == 0)
+      continue; // Timeout: re-check running
+    if (err > 0) {
+      snd_pcm_sframes_t avail = snd_pcm_avail_update(io->cap);
+      if (avail < 0)
+        err = (int)avail;
+      else if ((snd_pcm_uframes_t)avail < io->period)
+        continue;
+      else
+        err = read_period(io);
+    }
+
+    // Capture errors lose input; a failed write means playback ran dry
+    DeadlineXrun kind = DEADLINE_XRUN_INPUT_OVERFLOW;
+    if (err >= 0) {
+      if (io->fn(io->in_buf, io->out_buf, (int)io->period, io->user) != 0)
+        break;
+      err = write_frames(io, io->out_buf, io->period);
+      kind = DEADLINE_XRUN_OUTPUT_UNDERFLOW;
+    }
+
+    if (err < 0) {
+      // Overrun/underrun (-EPIPE) or suspend (-ESTRPIPE): resync both
+      le_atomic_fetch_add(&io->xruns, 1);
+      if (io->cfg.monitor)
+        deadline_monitor_xrun(io->cfg.monitor, kind);
+      if (restart(io) < 0) {
+        fprintf(stderr, "ALSA: cannot recover stream: %s\n",
+                snd_strerror(err));
+        break;
+      }
+    }
+  }
+  le_atomic_store(&io->running, 0);
+}
+
+static void alsa_close(void *impl) {
+  AlsaIO *io = (AlsaIO *)impl;
+  if (!io)
+    return;
+  if (io->cap && io->play)
+    snd_pcm_unlink(io->cap);
+  if (io->cap)
+    snd_pcm_close(io->cap);
+  if (io->play)
+    snd_pcm_close(io->play);
+  free(io->in_buf);
+  free(io->out_buf);
+  free(io);
+}
+
+static void *alsa_open(const AudioConfig *cfg, AudioProcessFn fn, void *user) {
+  AlsaIO *io = (AlsaIO *)calloc(1, sizeof(AlsaIO));
+  if (!io)
+    return NULL;
+  io->cfg = *cfg;
+  io->fn = fn;
+  io->user = user;
+  le_atomic_store(&io->rt_status, -1);
+  unsigned int periods =
+      cfg->alsa.periods > 0 ? (unsigned int)cfg->alsa.periods : 2;
+
+  const char *cap_name = pcm_name(cfg->alsa.capture);
+  const char *play_name = pcm_name(cfg->alsa.playback);
+  int err = snd_pcm_open(&io->cap, cap_name, SND_PCM_STREAM_CAPTURE, 0);
+  if (err >= 0)
+    err = snd_pcm_open(&io->play, play_name, SND_PCM_STREAM_PLAYBACK, 0);
+  if (err < 0) {
+    fprintf(stderr, "ALSA: cannot open %s / %s: %s\n", cap_name, play_name,
+            snd_strerror(err));
+    alsa_close(io);
+    return NULL;
+  }
+
+  snd_pcm_uframes_t cap_buffer;
+  if (setup_pcm(io->cap, "capture", (unsigned int)cfg->sample_rate,
+                (unsigned int)cfg->input_channels,
+                (snd_pcm_uframes_t)cfg->frames_per_buffer, periods,
+                &io->cap_fmt, &io->cap_ch, &io->period, &cap_buffer) != 0) {
+    alsa_close(io);
+    return NULL;
+  }
+  // The callback block is the period, and the pipeline is sized for
+  // frames_per_buffer: a rounded period would split every block
+  if (io->period != (snd_pcm_uframes_t)cfg->frames_per_buffer) {
+    fprintf(stderr,
+            "ALSA capture: period of %d frames not supported (nearest %lu), "
+            "set frames_per_buffer to %lu\n",
+            cfg->frames_per_buffer, (unsigned long)io->period,
+            (unsigned long)io->period);
+    alsa_close(io);
+    return NULL;
+  }
+  snd_pcm_uframes_t play_period;
+  if (setup_pcm(io->play, "playback", (unsigned int)cfg->sample_rate,
+                (unsigned int)cfg->output_channels, io->period, periods,
+                &io->play_fmt, &io->play_ch, &play_period, &io->buffer) != 0) {
+    alsa_close(io);
+    return NULL;
+  }
+  if (play_period != io->period) {
+    fprintf(stderr, "ALSA: capture/playback periods differ (%lu / %lu)\n",
+            (unsigned long)io->period, (unsigned long)play_period);
+    alsa_close(io);
+    return NULL;
+  }
+  // Linked: one start, one prepare, and both share the hardware clock phase
+  if ((err = snd_pcm_link(io->cap, io->play)) < 0) {
+    fprintf(stderr, "ALSA: cannot link capture and playback: %s\n",
+            snd_strerror(err));
+    alsa_close(io);
+    return NULL;
+  }
+
+  io->in_buf =
+      (float *)calloc(io->period * audio_mic_count(cfg), sizeof(float));
+  io->out_buf =
+      (float *)calloc(io->period * cfg->output_channels, sizeof(float));
+  if (!io->in_buf || !io->out_buf) {
+    alsa_close(io);
+    return NULL;
+  }
+
+  printf("ALSA mmap: %s -> %s, %u Hz, period %lu frames, buffer %lu frames "
+         "(%s / %s), round trip ~%.2f ms + converters\n",
+         cap_name, play_name, cfg->sample_rate, (unsigned long)io->period,
+         (unsigned long)io->buffer, snd_pcm_format_name(io->cap_fmt),
+         snd_pcm_format_name(io->play_fmt),
+         1000.0 * (double)(io->period + io->buffer) / cfg->sample_rate);
+  return io;
+}
+
+static int alsa_start(void *impl) {
+  AlsaIO *io = (AlsaIO *)impl;
+  int err = restart(io);
+  if (err < 0) {
+    fprintf(stderr, "ALSA: cannot start streams: %s\n", snd_strerror(err));
+    return -1;
+  }
+  le_atomic_store(&io->running, 1);
+  io->thread = platform_thread_start(alsa_thread, io);
+  if (!io->thread) {
+    le_atomic_store(&io->running, 0);
+    snd_pcm_drop(io->cap);
+    return -1;
+  }
+  return 0;
+}
+
+static int alsa_stop(void *impl) {
+  AlsaIO *io = (AlsaIO *)impl;
+  if (!io->thread)
+    return -1;
+  le_atomic_store(&io->running, 0);
+  platform_thread_join(io->thread); // Wakes within one period (or 1 s)
+  io->thread = NULL;
+  snd_pcm_drop(io->cap);
+  int xruns = le_atomic_load(&io->xruns);
+  if (xruns > 0)
+    printf("ALSA: %d xruns recovered\n", xruns);
+  return 0;
+}
+
+// A capture period is complete before it is processed; output then waits
+// behind the playback buffer
+static int alsa_latency(void *impl, double *input_s, double *output_s) {
+  AlsaIO *io = (AlsaIO *)impl;
+  *input_s = (double)io->period / io->cfg.sample_rate;
+  *output_s = (double)io->buffer / io->cfg.sample_rate;
+  return 0;
+}
+
+static int alsa_rt_status(void *impl) {
+  return le_atomic_load(&((AlsaIO *)impl)->rt_status);
+}
+
+const AudioBackendOps audio_alsa_ops = {
+    "alsa_mmap", alsa_open,    alsa_start,    alsa_stop,
+    alsa_close,  alsa_latency, alsa_rt_status};
+
+#endif // LE_WITH_ALSA
@@ -0,0 +1,46 @@
+/**
+ * @file audio_backend.h
+ * @brief Native (non-PortAudio) backends behind audio_open
+ *
+ * Internal to src/audio. A backend owns its I/O thread and calls the
+ * AudioProcessFn with logical [L, R, B] input, exactly like the PortAudio
+ * path.
+ */
+
+#ifndef AUDIO_BACKEND_H
+#define AUDIO_BACKEND_H
+
+#include "audio_io.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+  const char *name;
+  // Returns the backend state, NULL on failure (the message is printed)
+  void *(*open)(const AudioConfig *cfg, AudioProcessFn fn, void *user);
+  int (*start)(void *impl);
+  int (*stop)(void *impl);
+  void (*close)(void *impl);
+  // Optional (NULL: unknown): input and output latency in seconds
+  int (*latency)(void *impl, double *input_s, double *output_s);
+  // Optional (NULL: nothing to report): platform_rt_enter result of the
+  // I/O thread, -1 until the thread has started
+  int (*rt_status)(void *impl);
+} AudioBackendOps;
+
+// Timer-driven simulated device, no hardware (audio_file.c)
+extern const AudioBackendOps audio_file_ops; // WAV in, WAV out
+extern const AudioBackendOps audio_null_ops; // Silence in, output dropped
+
+#ifdef LE_WITH_ALSA
+// mmap-mode ALSA, full duplex on one thread (audio_alsa.c)
+extern const AudioBackendOps audio_alsa_ops;
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // AUDIO_BACKEND_H
@@ -0,0 +1,307 @@
+/**
+ * @file audio_file.c
+ * @brief Simulated audio device: timer thread, WAV input/output
+ *
+ * Stands in for a sound card on headless machines. Block k becomes available
+ * at t0 + k * period on the monotonic clock; the thread sleeps until then
+ * (plus the injected jitter), processes the block and owes its output by the
+ * next block, as with a two-period device buffer. Deadlines are absolute, so
+ * jitter delays single blocks but never the long-term rate. A thread more
+ * than a period behind drops the missed blocks like an xrun recovery.
+ */
+
+#include "../platform/platform.h"
+#include "../utils/atomic_compat.h"
+#include "../utils/wav_io.h"
+#include "audio_backend.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Largest data chunk a WAV header can describe (32-bit RIFF sizes)
+#define WAV_MAX_DATA_BYTES (0xFFFFFFFFu - 36u)
+
+typedef struct {
+  AudioConfig cfg;
+  AudioProcessFn fn;
+  void *user;
+  int frames;       // Block size
+  double period_us; // Block period on the simulated device clock
+
+  WavReader *in; // NULL: silence
+  WavInfo in_info;
+  WavWriter *out; // NULL: discarded
+  long out_frames;
+  long out_max_frames;
+  float *raw;     // [frames * in_info.channels] Physical input
+  float *in_buf;  // [frames * mics] Logical [L, R, B] or [TL, TR, BL, BR]
+  float *out_buf; // [frames * output_channels]
+  uint32_t rng;
+
+  PlatformThread *thread;
+  le_atomic_int running;
+  le_atomic_int rt_status; // platform_rt_enter result, -1: not started
+
+  // Timer-thread statistics, read after join
+  long long blocks;
+  long long late;    // Output finished after its deadline
+  long long dropped; // Blocks skipped after falling behind
+  double max_late_us;
+  double max_callback_us;
+} FileIO;
+
+// xorshift32: cheap, and the sequence is fixed by the seed
+static double jitter_uniform(FileIO *io) {
+  uint32_t x = io->rng;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  io->rng = x;
+  return (double)(x >> 8) * (1.0 / 16777216.0);
+}
+
+// Late wake-up of the next block in microseconds
+static double next_jitter_us(FileIO *io) {
+  const AudioFileConfig *f = &io->cfg.file;
+  double us = 0.0;
+  if (f->jitter_ms > 0.0f)
+    us += 1000.0 * f->jitter_ms * jitter_uniform(io);
+  if (f->stall_prob > 0.0f && jitter_uniform(io) < f->stall_prob)
+    us += 1000.0 * f->stall_ms;
+  return us;
+}
+
+static int open_input(FileIO *io) {
+  io->in = wav_open_read(io->cfg.file.input, &io->in_info);
+  if (!io->in)
+    return -1;
+  float *raw = (float *)realloc(
+      io->raw, (size_t)io->frames * io->in_info.channels * sizeof(float));
+  if (!raw)
+    return -1;
+  io->raw = raw;
+  return 0;
+}
+
+// Fill in_buf with the next block; silence past the end of a non-looping
+// input (wav_io has no seek, so looping reopens the file)
+static void read_block(FileIO *io) {
+  const int N = io->frames;
+  const int L = audio_mic_count(&io->cfg);
+  memset(io->in_buf, 0, (size_t)N * L * sizeof(float));
+  if (!io->in)
+    return;
+
+  const int C = io->in_info.channels;
+  long got = 0;
+  while (got < N) {
+    long n = wav_read_frames(io->in, io->raw + got * C, N - got);
+    if (n > 0) {
+      got += n;
+      continue;
+    }
+    wav_close_read(io->in);
+    io->in = NULL;
+    if (!io->cfg.file.loop || open_input(io) != 0 || io->in_info.frames == 0)
+      break;
+  }
+
+  // Same remapping as the PortAudio callback
+  for (long i = 0; i < got; i++) {
+    for (int p = 0; p < C && p < AUDIO_MAX_MICS; p++) {
+      int logical = io->cfg.channel_map[p];
+      if (logical >= 0 && logical < L)
+        io->in_buf[i * L + logical] = io->raw[i * C + p];
+    }
+  }
+}
+
+static void write_block(FileIO *io) {
+  if (!io->out)
+    return;
+  if (io->out_frames + io->frames > io->out_max_frames) {
+    // A longer soak keeps running; the file stays a valid WAV
+    fprintf(stderr, "File backend: %s reached the WAV size limit, output "
+                    "recording stopped\n",
+            io->cfg.file.output);
+    wav_close_write(io->out);
+    io->out = NULL;
+    return;
+  }
+  if (wav_write_frames(io->out, io->out_buf, io->frames) != 0) {
+    fprintf(stderr, "File backend: write error on %s, output recording "
+                    "stopped\n",
+            io->cfg.file.output);
+    wav_close_write(io->out);
+    io->out = NULL;
+    return;
+  }
+  io->out_frames += io->frames;
+}
+
+static void file_thread(void *arg) {
+  FileIO *io = (FileIO *)arg;
+  le_atomic_store(&io->rt_status, platform_rt_enter(&io->cfg.rt));
+
+  const double period = io->period_us;
+  const double t0 = platform_time_us();
+  long long k = 0;
+  while (le_atomic_load(&io->running)) {
+    double ready = t0 + (double)k * period;
+    platform_sleep_until_us(ready + next_jitter_us(io));
+
+    read_block(io);
+    double start = platform_time_us();
+    int stop = io->fn(io->in_buf, io->out_buf, io->frames, io->user);
+    double end = platform_time_us();
+    write_block(io);
+
+    io->blocks++;
+    if (end - start > io->max_callback_us)
+      io->max_callback_us = end - start;
+    double late = end - (ready + period);
+    if (late > 0.0) {
+      io->late++;
+      if (late > io->max_late_us)
+        io->max_late_us = late;
+      if (io->cfg.monitor)
+        deadline_monitor_xrun(io->cfg.monitor, DEADLINE_XRUN_OUTPUT_UNDERFLOW);
+    }
+    if (stop)
+      break; // The final block is still played, as with paComplete
+
+    // Blocks that arrived while this one was late and no longer fit the
+    // two-period buffer are lost
+    k++;
+    double behind = platform_time_us() - (t0 + (double)k * period);
+    if (behind > period) {
+      long long lost = (long long)(behind / period);
+      io->dropped += lost;
+      k += lost;
+      if (io->cfg.monitor)
+        deadline_monitor_xrun(io->cfg.monitor, DEADLINE_XRUN_INPUT_OVERFLOW);
+    }
+  }
+  le_atomic_store(&io->running, 0);
+}
+
+static void file_close(void *impl) {
+  FileIO *io = (FileIO *)impl;
+  if (!io)
+    return;
+  if (io->in)
+    wav_close_read(io->in);
+  if (io->out && wav_close_write(io->out) != 0)
+    fprintf(stderr, "File backend: cannot finalize %s\n", io->cfg.file.output);
+  free(io->raw);
+  free(io->in_buf);
+  free(io->out_buf);
+  free(io);
+}
+
+static void *open_common(const AudioConfig *cfg, AudioProcessFn fn, void *user,
+                         int use_files) {
+  if (cfg->sample_rate <= 0 || cfg->frames_per_buffer <= 0 ||
+      cfg->output_channels <= 0)
+    return NULL;
+  FileIO *io = (FileIO *)calloc(1, sizeof(FileIO));
+  if (!io)
+    return NULL;
+  io->cfg = *cfg;
+  io->fn = fn;
+  io->user = user;
+  le_atomic_store(&io->rt_status, -1);
+  io->frames = cfg->frames_per_buffer;
+  io->period_us = 1e6 * cfg->frames_per_buffer / cfg->sample_rate /
+                  (1.0 + 1e-6 * cfg->file.drift_ppm);
+  io->rng = cfg->file.seed ? cfg->file.seed : 0x2545F491u;
+
+  const char *in_name = "silence";
+  const char *out_name = "discarded";
+  if (use_files && cfg->file.input[0]) {
+    if (open_input(io) != 0) {
+      fprintf(stderr, "File backend: cannot read %s\n", cfg->file.input);
+      file_close(io);
+      return NULL;
+    }
+    if (io->in_info.sample_rate != cfg->sample_rate)
+      fprintf(stderr, "Warning: %s is %d Hz, played at %d Hz\n",
+              cfg->file.input, io->in_info.sample_rate, cfg->sample_rate);
+    in_name = cfg->file.input;
+  }
+  if (use_files && cfg->file.output[0]) {
+    io->out = wav_open_write(cfg->file.output, cfg->sample_rate,
+                             cfg->output_channels);
+    if (!io->out) {
+      fprintf(stderr, "File backend: cannot create %s\n", cfg->file.output);
+      file_close(io);
+      return NULL;
+    }
+    io->out_max_frames =
+        (long)(WAV_MAX_DATA_BYTES / (4u * (unsigned)cfg->output_channels));
+    out_name = cfg->file.output;
+  }
+
+  io->in_buf = (float *)calloc((size_t)io->frames * audio_mic_count(cfg),
+                               sizeof(float));
+  io->out_buf = (float *)calloc((size_t)io->frames * cfg->output_channels,
+                                sizeof(float));
+  if (!io->in_buf || !io->out_buf) {
+    file_close(io);
+    return NULL;
+  }
+
+  printf("%s device: %s -> %s, %d Hz, %d frames (%.2f ms), jitter %.2f ms, "
+         "stalls %.2f ms @ %.4f, drift %.1f ppm\n",
+         use_files ? "File" : "Null", in_name, out_name, cfg->sample_rate,
+         io->frames, io->period_us * 1e-3, cfg->file.jitter_ms,
+         cfg->file.stall_ms, cfg->file.stall_prob, cfg->file.drift_ppm);
+  return io;
+}
+
+static void *file_open(const AudioConfig *cfg, AudioProcessFn fn, void *user) {
+  return open_common(cfg, fn, user, 1);
+}
+
+static void *null_open(const AudioConfig *cfg, AudioProcessFn fn, void *user) {
+  return open_common(cfg, fn, user, 0);
+}
+
+static int file_start(void *impl) {
+  FileIO *io = (FileIO *)impl;
+  if (io->thread)
+    return -1;
+  le_atomic_store(&io->running, 1);
+  io->thread = platform_thread_start(file_thread, io);
+  if (!io->thread) {
+    le_atomic_store(&io->running, 0);
+    return -1;
+  }
+  return 0;
+}
+
+static int file_stop(void *impl) {
+  FileIO *io = (FileIO *)impl;
+  if (!io->thread)
+    return -1;
+  le_atomic_store(&io->running, 0);
+  platform_thread_join(io->thread); // Wakes within a period plus jitter
+  io->thread = NULL;
+  printf("Simulated device: %lld blocks, %lld late (max %.2f ms), %lld "
+         "dropped, callback max %.2f ms\n",
+         io->blocks, io->late, io->max_late_us * 1e-3, io->dropped,
+         io->max_callback_us * 1e-3);
+  return 0;
+}
+
+static int file_rt_status(void *impl) {
+  return le_atomic_load(&((FileIO *)impl)->rt_status);
+}
+
+const AudioBackendOps audio_file_ops = {"file",    file_open,  file_start,
+                                        file_stop, file_close, NULL,
+                                        file_rt_status};
+const AudioBackendOps audio_null_ops = {"null",    null_open,  file_start,
+                                        file_stop, file_close, NULL,
+                                        file_rt_status};
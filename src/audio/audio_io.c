@@ -1,4 +1,6 @@
 #include "audio_io.h"
+#include "../utils/atomic_compat.h"
+#include "audio_backend.h"
 #include <portaudio.h>
 #ifdef _WIN32
 #include <pa_win_wasapi.h>
@@ -13,8 +15,71 @@ struct AudioIO {
   void *user_data;
   AudioConfig config;
   float *temp_input_buffer;
+  int rt_entered; // Callback thread already configured (callback-only)
+  le_atomic_int rt_status; // platform_rt_enter result, -1: not entered yet
+
+  // Host timestamp histograms (written by the callback only)
+  le_atomic_i64 timed_callbacks;
+  le_atomic_i64 untimed_callbacks;
+  le_atomic_i64 input_hist[AUDIO_TIMING_BINS];
+  le_atomic_i64 output_hist[AUDIO_TIMING_BINS];
+
+  // Native backend (PortAudio is bypassed when set)
+  const AudioBackendOps *native;
+  void *impl;
 };
 
+// Backends that bypass PortAudio for the requested type, NULL: PortAudio
+static const AudioBackendOps *native_backend(AudioBackend backend) {
+  switch (backend) {
+  case AUDIO_BACKEND_FILE:
+    return &audio_file_ops;
+  case AUDIO_BACKEND_NULL:
+    return &audio_null_ops;
+#ifdef LE_WITH_ALSA
+  case AUDIO_BACKEND_ALSA_MMAP:
+    return &audio_alsa_ops;
+#endif
+  default:
+    return NULL;
+  }
+}
+
+static int timing_bin(double seconds) {
+  double bin = seconds * 1000.0 / AUDIO_TIMING_BIN_MS;
+  if (bin < 0.0)
+    return 0;
+  return bin < AUDIO_TIMING_BINS - 1 ? (int)bin : AUDIO_TIMING_BINS - 1;
+}
+
+// Input age and output lead of this block, from the host API timestamps.
+// Some host APIs leave them at zero.
+static void record_timing(AudioIO *aio, const PaStreamCallbackTimeInfo *ti) {
+  if (!ti ||
+      (ti->inputBufferAdcTime == 0.0 && ti->outputBufferDacTime == 0.0)) {
+    le_atomic_fetch_add64(&aio->untimed_callbacks, 1);
+    return;
+  }
+  le_atomic_fetch_add64(
+      &aio->input_hist[timing_bin(ti->currentTime - ti->inputBufferAdcTime)],
+      1);
+  le_atomic_fetch_add64(
+      &aio->output_hist[timing_bin(ti->outputBufferDacTime - ti->currentTime)],
+      1);
+  le_atomic_fetch_add64(&aio->timed_callbacks, 1);
+}
+
+static void record_xruns(DeadlineMonitor *m, PaStreamCallbackFlags flags) {
+  if (flags & paInputUnderflow)
+    deadline_monitor_xrun(m, DEADLINE_XRUN_INPUT_UNDERFLOW);
+  if (flags & paInputOverflow)
+    deadline_monitor_xrun(m, DEADLINE_XRUN_INPUT_OVERFLOW);
+  if (flags & paOutputUnderflow)
+    deadline_monitor_xrun(m, DEADLINE_XRUN_OUTPUT_UNDERFLOW);
+  if (flags & paOutputOverflow)
+    deadline_monitor_xrun(m, DEADLINE_XRUN_OUTPUT_OVERFLOW);
+}
+
 static int paCallback(const void *inputBuffer, void *outputBuffer,
                       unsigned long framesPerBuffer,
                       const PaStreamCallbackTimeInfo *timeInfo,
@@ -24,13 +89,24 @@ static int paCallback(const void *inputBuffer, void *outputBuffer,
   float *out = (float *)outputBuffer;
   int frames = (int)framesPerBuffer;
   int num_in_ch = aio->config.input_channels;
+  int num_mics = audio_mic_count(&aio->config);
+
+
+  // The callback thread belongs to the host API: configure it from inside,
+  // once, before the first block is processed. Failures are reported by
+  // audio_report_rt_status, never printed from here.
+  if (!aio->rt_entered) {
+    aio->rt_entered = 1;
+    le_atomic_store(&aio->rt_status, platform_rt_enter(&aio->config.rt));
+  }
 
-  (void)timeInfo;
-  (void)statusFlags;
+  record_timing(aio, timeInfo);
+  if (statusFlags && aio->config.monitor)
+    record_xruns(aio->config.monitor, statusFlags);
 
   if (in == NULL) {
     // Input underflow? Silence input
-    memset(aio->temp_input_buffer, 0, frames * num_in_ch * sizeof(float));
+    memset(aio->temp_input_buffer, 0, frames * num_mics * sizeof(float));
   } else {
     // Remap input channels
     // Logic: channel_map[i] tells which logical channel (L=0, R=1, B=2)
@@ -45,17 +121,20 @@ static int paCallback(const void *inputBuffer, void *outputBuffer,
     // But map is phy->log.
     // So Dest[frame*3 + map[phy]] = Src[frame*N + phy].
 
-    int map[3];
+    int map[AUDIO_MAX_MICS];
     memcpy(map, aio->config.channel_map, sizeof(map));
 
     // Input buffer is interleaved: [P0][P1][P2] [P0][P1][P2] ...
     // We want temp buffer:         [L][R][B]    [L][R][B] ...
+    // (4-mic layout: [TL][TR][BL][BR]; physical channels past the map are
+    // not used)
 
     for (int i = 0; i < frames; i++) {
-      for (int p = 0; p < num_in_ch; p++) {
+      for (int p = 0; p < num_in_ch && p < AUDIO_MAX_MICS; p++) {
         int logical = map[p];
-        if (logical >= 0 && logical < 3) {
-          aio->temp_input_buffer[i * 3 + logical] = in[i * num_in_ch + p];
+        if (logical >= 0 && logical < num_mics) {
+          aio->temp_input_buffer[i * num_mics + logical] =
+              in[i * num_in_ch + p];
         }
       }
     }
@@ -85,10 +164,28 @@ int audio_open(AudioIO **aio_out, const AudioConfig *cfg, AudioProcessFn fn,
   aio->config = *cfg;
   aio->callback_fn = fn;
   aio->user_data = user;
+  le_atomic_store(&aio->rt_status, -1);
+
+  // Process-wide, so done here rather than on the audio thread. Covers the
+  // DSP state allocated so far and every page mapped later.
+  if (cfg->rt.lock_memory && platform_rt_lock_memory() != 0)
+    fprintf(stderr, "Warning: mlockall failed (check RLIMIT_MEMLOCK), "
+                    "memory is not locked\n");
+
+  aio->native = native_backend(cfg->backend);
+  if (aio->native) {
+    aio->impl = aio->native->open(cfg, fn, user);
+    if (!aio->impl) {
+      free(aio);
+      return -1;
+    }
+    *aio_out = aio;
+    return 0;
+  }
 
-  // Allocate temp buffer for logical input (always 3 channels internal)
-  aio->temp_input_buffer =
-      (float *)malloc(cfg->frames_per_buffer * 3 * sizeof(float));
+  // Allocate temp buffer for logical input (3 or 4 channels internal)
+  aio->temp_input_buffer = (float *)malloc(
+      cfg->frames_per_buffer * audio_mic_count(cfg) * sizeof(float));
   if (!aio->temp_input_buffer) {
     free(aio);
     return -1;
@@ -112,6 +209,11 @@ int audio_open(AudioIO **aio_out, const AudioConfig *cfg, AudioProcessFn fn,
   case AUDIO_BACKEND_ASIO:
     requestedType = paASIO;
     break;
+  case AUDIO_BACKEND_ALSA_MMAP:
+    fprintf(stderr, "Warning: built without LE_WITH_ALSA, using PortAudio's "
+                    "ALSA host API\n");
+    requestedType = paALSA;
+    break;
   case AUDIO_BACKEND_ALSA:
     requestedType = paALSA;
     break;
@@ -222,6 +324,8 @@ int audio_open(AudioIO **aio_out, const AudioConfig *cfg, AudioProcessFn fn,
 }
 
 int audio_start(AudioIO *aio) {
+  if (aio && aio->native)
+    return aio->native->start(aio->impl);
   if (!aio || !aio->stream)
     return -1;
   PaError err = Pa_StartStream(aio->stream);
@@ -233,6 +337,8 @@ int audio_start(AudioIO *aio) {
 }
 
 int audio_stop(AudioIO *aio) {
+  if (aio && aio->native)
+    return aio->native->stop(aio->impl);
   if (!aio || !aio->stream)
     return -1;
   PaError err = Pa_StopStream(aio->stream);
@@ -244,6 +350,11 @@ int audio_stop(AudioIO *aio) {
 void audio_close(AudioIO *aio) {
   if (!aio)
     return;
+  if (aio->native) {
+    aio->native->close(aio->impl);
+    free(aio);
+    return;
+  }
   if (aio->stream) {
     Pa_CloseStream(aio->stream);
   }
@@ -253,6 +364,56 @@ void audio_close(AudioIO *aio) {
   free(aio);
 }
 
+int audio_get_latency(AudioIO *aio, double *input_s, double *output_s) {
+  if (!aio)
+    return -1;
+  if (aio->native)
+    return aio->native->latency
+               ? aio->native->latency(aio->impl, input_s, output_s)
+               : -1;
+  const PaStreamInfo *info =
+      aio->stream ? Pa_GetStreamInfo(aio->stream) : NULL;
+  if (!info)
+    return -1;
+  *input_s = info->inputLatency;
+  *output_s = info->outputLatency;
+  return 0;
+}
+
+int audio_get_rt_status(AudioIO *aio) {
+  if (!aio)
+    return -1;
+  if (aio->native)
+    return aio->native->rt_status ? aio->native->rt_status(aio->impl) : 0;
+  return le_atomic_load(&aio->rt_status);
+}
+
+int audio_report_rt_status(AudioIO *aio) {
+  int failed = audio_get_rt_status(aio);
+  if (failed < 0)
+    return 0;
+  if (failed & PLATFORM_RT_SCHED_FAILED)
+    fprintf(stderr, "Warning: realtime scheduling not permitted "
+                    "(needs CAP_SYS_NICE or an rtprio limit)\n");
+  if (failed & PLATFORM_RT_AFFINITY_FAILED)
+    fprintf(stderr, "Warning: cannot pin audio thread to CPU %d\n",
+            aio->config.rt.cpu);
+  return 1;
+}
+
+int audio_get_timing(AudioIO *aio, AudioTimingStats *stats) {
+  memset(stats, 0, sizeof(*stats));
+  if (!aio || aio->native)
+    return -1;
+  stats->callbacks = le_atomic_load64(&aio->timed_callbacks);
+  stats->missing = le_atomic_load64(&aio->untimed_callbacks);
+  for (int i = 0; i < AUDIO_TIMING_BINS; i++) {
+    stats->input_ms[i] = le_atomic_load64(&aio->input_hist[i]);
+    stats->output_ms[i] = le_atomic_load64(&aio->output_hist[i]);
+  }
+  return 0;
+}
+
 int audio_get_devices(AudioDeviceInfo *devices, int max_devices) {
   PaError err = Pa_Initialize();
   if (err != paNoError) {
@@ -1,6 +1,9 @@
 #ifndef AUDIO_IO_H
 #define AUDIO_IO_H
 
+#include "../platform/platform.h"
+#include "../utils/deadline_monitor.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -10,29 +13,69 @@ typedef enum {
   AUDIO_BACKEND_WASAPI_SHARED,
   AUDIO_BACKEND_WASAPI_EXCLUSIVE, // Windows Low-Latency
   AUDIO_BACKEND_ASIO,             // Professional Audio
-  AUDIO_BACKEND_ALSA,             // Linux
-  AUDIO_BACKEND_JACK              // Linux Low-Latency
+  AUDIO_BACKEND_ALSA,             // Linux (PortAudio host API)
+  AUDIO_BACKEND_JACK,             // Linux Low-Latency
+  AUDIO_BACKEND_ALSA_MMAP,        // Linux, native mmap ALSA (LE_WITH_ALSA)
+  AUDIO_BACKEND_FILE,             // No device: timer thread, WAV in/out
+  AUDIO_BACKEND_NULL              // No device: timer thread, silence in
 } AudioBackend;
 
+// Native ALSA backend settings (AUDIO_BACKEND_ALSA_MMAP)
+typedef struct {
+  char capture[64];  // PCM name, e.g. "hw:1,0"; empty: "default"
+  char playback[64]; // PCM name; empty: "default"
+  int periods;       // Playback buffer in periods (<= 0: 2)
+} AudioAlsaConfig;
+
+// Simulated device settings (AUDIO_BACKEND_FILE / AUDIO_BACKEND_NULL).
+// Blocks are clocked by a timer thread at sample_rate; the jitter settings
+// delay individual wake-ups the way a loaded scheduler would.
+typedef struct {
+  char input[256];   // WAV read as physical input (FILE); empty: silence
+  char output[256];  // WAV written with the output (FILE); empty: discarded
+  int loop;          // Restart the input at end of file (else silence)
+  float jitter_ms;   // Late wake-up per block, uniform in [0, jitter_ms]
+  float stall_ms;    // Extra delay of an occasional stall
+  float stall_prob;  // Probability of a stall per block
+  float drift_ppm;   // Simulated device clock error (+: runs fast)
+  unsigned int seed; // Jitter sequence seed (0: fixed default)
+} AudioFileConfig;
+
+// Logical input channels of the largest mic layout (4-mic headsets)
+#define AUDIO_MAX_MICS 4
+
 typedef struct {
   int sample_rate;       // 48000 recommended
-  int input_channels;    // 3 (L, R, Back)
+  int input_channels;    // Physical device channels, 3 (L, R, Back)
   int output_channels;   // 1 or 2
   int frames_per_buffer; // 480 (10ms @ 48kHz)
   int input_device_id;   // -1: use default
   int output_device_id;  // -1: use default
-  int channel_map[3];    // physical index to logical index mapping {L, R, B}
-                         // e.g. {0, 1, 2} means Phy0->L, Phy1->R, Phy2->B
+  int mics;              // Logical layout: 3 {L, R, B} (also 0) or
+                         // 4 {TL, TR, BL, BR} (temple and back pairs)
+  int channel_map[AUDIO_MAX_MICS]; // physical index to logical index mapping
+                         // e.g. {0, 1, 2} means Phy0->L, Phy1->R, Phy2->B;
+                         // -1 (or a logical index >= mics) drops it
   AudioBackend backend;  // Desired audio backend
+  PlatformRtConfig rt;   // Callback thread scheduling (applied on first entry)
+  AudioAlsaConfig alsa;  // AUDIO_BACKEND_ALSA_MMAP devices and buffering
+  AudioFileConfig file;  // AUDIO_BACKEND_FILE / AUDIO_BACKEND_NULL timing
+  DeadlineMonitor *monitor; // Xrun counters (set by the caller), NULL: none
 } AudioConfig;
 
 typedef struct AudioIO AudioIO;
 
+// Logical channels per frame handed to the callback (3 or 4)
+static inline int audio_mic_count(const AudioConfig *cfg) {
+  return cfg->mics == 4 ? 4 : 3;
+}
+
 /*
  * Audio processing callback.
  *
  * in_interleaved: Input buffer [frame0_ch0, frame0_ch1, frame0_ch2,
- * frame1_ch0...] out_interleaved: Output buffer to fill frames: Number of
+ * frame1_ch0...], audio_mic_count(cfg) logical channels per frame
+ * out_interleaved: Output buffer to fill frames: Number of
  * frames to process user: User data pointer passed to audio_open
  *
  * Returns: 0 to continue, non-zero to stop (paComplete/paAbort)
@@ -46,6 +89,35 @@ int audio_start(AudioIO *aio);
 int audio_stop(AudioIO *aio);
 void audio_close(AudioIO *aio);
 
+// Stream latencies reported by the backend in seconds (PortAudio:
+// Pa_GetStreamInfo). Returns -1 if the backend does not report them.
+int audio_get_latency(AudioIO *aio, double *input_s, double *output_s);
+
+// Realtime setup of the audio thread (AudioConfig.rt): -1 until the
+// thread has configured itself, then a mask of PLATFORM_RT_*_FAILED bits
+// (0: everything applied). Safe to poll while the stream runs.
+int audio_get_rt_status(AudioIO *aio);
+
+// Print a warning for each failed realtime setting once the audio thread
+// has configured itself. Call from a non-realtime thread, e.g. a polling
+// loop after audio_start. Returns 1 once the status is known, 0 before.
+int audio_report_rt_status(AudioIO *aio);
+
+// Per-callback latencies from the host timestamps (PaStreamCallbackTimeInfo)
+#define AUDIO_TIMING_BINS 256
+#define AUDIO_TIMING_BIN_MS 0.5 // Last bin: everything above
+
+typedef struct {
+  long long callbacks; // Callbacks with timestamps
+  long long missing;   // Callbacks where the host API gave none
+  long long input_ms[AUDIO_TIMING_BINS];  // currentTime - inputBufferAdcTime
+  long long output_ms[AUDIO_TIMING_BINS]; // outputBufferDacTime - currentTime
+} AudioTimingStats;
+
+// Snapshot of the histograms, safe while the stream runs. Returns -1 for
+// native backends (no host timestamps).
+int audio_get_timing(AudioIO *aio, AudioTimingStats *stats);
+
 // Device info structure for programmatic access
 typedef struct {
   int id;
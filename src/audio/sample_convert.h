@@ -0,0 +1,46 @@
+/**
+ * @file sample_convert.h
+ * @brief Float <-> integer PCM sample conversion for the native backends
+ *
+ * Internal to src/audio. Integer samples are read as x / 2^(bits-1) and
+ * written as round-toward-zero of v * (2^(bits-1) - 1) after clamping to
+ * [-1, 1], so full scale maps to the largest code of either sign.
+ */
+
+#ifndef SAMPLE_CONVERT_H
+#define SAMPLE_CONVERT_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+static inline float sample_s16_to_float(int16_t x) {
+  return (float)x * (1.0f / 32768.0f);
+}
+
+static inline float sample_s32_to_float(int32_t x) {
+  return (float)x * (1.0f / 2147483648.0f);
+}
+
+// Clamp to [-1, 1]; NaN becomes 1 rather than an undefined conversion
+static inline float sample_clamp(float v) {
+  return v < 1.0f ? (v > -1.0f ? v : -1.0f) : 1.0f;
+}
+
+static inline int16_t sample_float_to_s16(float v) {
+  return (int16_t)(sample_clamp(v) * 32767.0f);
+}
+
+// Scaled in double: 2147483647.0f rounds to 2^31, which would overflow
+// int32 at full scale
+static inline int32_t sample_float_to_s32(float v) {
+  return (int32_t)((double)sample_clamp(v) * 2147483647.0);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SAMPLE_CONVERT_H
@@ -1,6 +1,17 @@
 #include "aec.h"
 #include <string.h>
 
+// Running power is recomputed exactly this often (in samples)
+#define AEC_POWER_RESYNC_INTERVAL 1024
+
+static float aec_history_power(const AecState *st) {
+  float sum = 0.0f;
+  for (int i = 0; i < st->M; i++) {
+    sum += st->x_history[i] * st->x_history[i];
+  }
+  return sum;
+}
+
 int aec_init(AecState *st, int filter_len, float *mem, size_t mem_size) {
   if (!st || !mem || filter_len <= 0)
     return -1;
@@ -21,12 +32,19 @@ int aec_init(AecState *st, int filter_len, float *mem, size_t mem_size) {
   st->mu = 0.05f;
   st->param_regularization = 1e-6f;
   st->power_est = 0.0f;
+  st->power_mode = AEC_POWER_EXACT;
+  st->power_resync = 0;
 
   return 0;
 }
 
 float aec_process(AecState *st, float mic_in, float ref_in) {
   // 1. Update reference history (Circular buffer)
+  if (st->power_mode == AEC_POWER_RUNNING) {
+    // The slot being overwritten holds the sample leaving the window
+    float oldest = st->x_history[st->write_idx];
+    st->power_est += ref_in * ref_in - oldest * oldest;
+  }
   st->x_history[st->write_idx] = ref_in;
 
   // 2. Filter (Convolution)
@@ -47,19 +65,21 @@ float aec_process(AecState *st, float mic_in, float ref_in) {
   // e = d - y_est = mic_in - y_est
   float e = mic_in - y_est;
 
-  // 4. Update Power Estimate (Simple L2 norm or Exponential Average)
-  // For NLMS, we need ||x||^2
-  // Optimization: Update iteratively? Or just recompute?
-  // recomputing for stability for now, or use sliding window
-  // subtraction/addition
-
-  // Power of vector x_history.
-  // Optimization: Running sum of squares is faster but risks drift.
-  // Let's use loop for safety for now (M is small, e.g. 256).
-  // AVX2 optimization would act here if critical.
-  float x_norm_sq = 0.0f;
-  for (int i = 0; i < st->M; i++) {
-    x_norm_sq += st->x_history[i] * st->x_history[i];
+  // 4. Update Power Estimate
+  // For NLMS, we need ||x||^2. The exact mode recomputes it over the whole
+  // window; the running mode keeps the sliding sum updated in step 1 and only
+  // re-syncs it periodically.
+  float x_norm_sq;
+  if (st->power_mode == AEC_POWER_RUNNING) {
+    if (++st->power_resync >= AEC_POWER_RESYNC_INTERVAL) {
+      st->power_resync = 0;
+      st->power_est = aec_history_power(st);
+    } else if (st->power_est < 0.0f) {
+      st->power_est = 0.0f;
+    }
+    x_norm_sq = st->power_est;
+  } else {
+    x_norm_sq = aec_history_power(st);
   }
 
   // 5. Update Weights (NLMS)
@@ -89,3 +109,11 @@ void aec_set_step_size(AecState *st, float mu) {
   if (st)
     st->mu = mu;
 }
+
+void aec_set_power_mode(AecState *st, AecPowerMode mode) {
+  if (!st)
+    return;
+  st->power_mode = mode;
+  st->power_resync = 0;
+  st->power_est = aec_history_power(st);
+}
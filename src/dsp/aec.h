@@ -7,6 +7,12 @@
 extern "C" {
 #endif
 
+// Reference power normalization for the NLMS update
+typedef enum {
+  AEC_POWER_EXACT = 0, // Recompute ||x||^2 over the window every sample
+  AEC_POWER_RUNNING    // Sliding sum: add newest^2, subtract oldest^2
+} AecPowerMode;
+
 typedef struct {
   float *w;                   // Filter coefficients (length M)
   float *x_history;           // Reference signal history (length M)
@@ -15,6 +21,8 @@ typedef struct {
   float mu;                   // Step size
   float param_regularization; // Regularization parameter for NLMS (eps)
   float power_est;            // Power estimate of reference signal
+  AecPowerMode power_mode;    // How power_est is maintained
+  int power_resync;           // Samples since last exact recomputation
 } AecState;
 
 /**
@@ -43,6 +51,16 @@ float aec_process(AecState *st, float mic_in, float ref_in);
  */
 void aec_set_step_size(AecState *st, float mu);
 
+/**
+ * Select the NLMS power normalization (default: AEC_POWER_EXACT).
+ * AEC_POWER_RUNNING keeps ||x||^2 as a sliding sum in O(1) per sample and
+ * recomputes it exactly every AEC_POWER_RESYNC_INTERVAL samples to bound
+ * float drift.
+ * @param st: State structure
+ * @param mode: Power mode
+ */
+void aec_set_power_mode(AecState *st, AecPowerMode mode);
+
 #ifdef __cplusplus
 }
 #endif
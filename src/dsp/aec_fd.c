@@ -0,0 +1,173 @@
+#include "aec_fd.h"
+#include <string.h>
+
+static int aec_fd_fft_size(int block_len) {
+  int L = 2;
+  while (L < 2 * block_len)
+    L <<= 1;
+  return L;
+}
+
+static size_t aec_fd_float_count(int N, int P) {
+  int L = aec_fd_fft_size(N);
+  size_t nb = (size_t)(L / 2 + 1);
+  // x_buf[L] + X[2*P*nb] + W[2*P*nb] + power[nb] + buf[2*nb] + time[L]
+  // + E[2*nb]
+  return 2 * (size_t)L + 4 * (size_t)P * nb + 5 * nb;
+}
+
+size_t aec_fd_mem_bytes(int block_len, int num_partitions) {
+  if (block_len <= 0 || num_partitions <= 0)
+    return 0;
+  return le_rfft_plan_bytes(aec_fd_fft_size(block_len)) +
+         aec_fd_float_count(block_len, num_partitions) * sizeof(float);
+}
+
+int aec_fd_init(AecFdState *st, int block_len, int num_partitions, void *mem,
+                size_t mem_size) {
+  if (!st || !mem || block_len <= 0 || num_partitions <= 0)
+    return -1;
+  if (mem_size < aec_fd_mem_bytes(block_len, num_partitions))
+    return -1;
+
+  st->N = block_len;
+  st->L = aec_fd_fft_size(block_len);
+  st->P = num_partitions;
+  st->nb = st->L / 2 + 1;
+  st->simd = le_simd_kernels();
+
+  size_t plan_bytes = le_rfft_plan_bytes(st->L);
+  if (le_rfft_plan_init(&st->plan, st->L, mem, plan_bytes) != 0)
+    return -1;
+
+  float *p = (float *)((char *)mem + plan_bytes);
+  size_t pn = (size_t)st->P * st->nb;
+  st->x_buf = p;
+  p += st->L;
+  st->X_re = p;
+  p += pn;
+  st->X_im = p;
+  p += pn;
+  st->W_re = p;
+  p += pn;
+  st->W_im = p;
+  p += pn;
+  st->power = p;
+  p += st->nb;
+  st->buf_re = p;
+  p += st->nb;
+  st->buf_im = p;
+  p += st->nb;
+  st->time = p;
+  p += st->L;
+  st->E_re = p;
+  p += st->nb;
+  st->E_im = p;
+
+  // Defaults
+  st->mu = 0.5f;
+  st->param_regularization = 1e-6f;
+  st->power_alpha = 0.9f;
+
+  aec_fd_reset(st);
+  return 0;
+}
+
+void aec_fd_reset(AecFdState *st) {
+  memset(st->x_buf, 0, aec_fd_float_count(st->N, st->P) * sizeof(float));
+  st->head = 0;
+  st->constrain = 0;
+}
+
+void aec_fd_process(AecFdState *st, const float *mic_in, const float *ref_in,
+                    float *out) {
+  const int N = st->N;
+  const int L = st->L;
+  const int P = st->P;
+  const int nb = st->nb;
+  float *re = st->buf_re;
+  float *im = st->buf_im;
+  float *t = st->time;
+
+  // 1. Slide reference window and transform it into the newest partition
+  memmove(st->x_buf, st->x_buf + N, (size_t)(L - N) * sizeof(float));
+  memcpy(st->x_buf + L - N, ref_in, (size_t)N * sizeof(float));
+
+  st->head = (st->head + 1) % P;
+  le_rfft_forward(&st->plan, st->x_buf, re, im);
+
+  float *xr = st->X_re + (size_t)st->head * nb;
+  float *xi = st->X_im + (size_t)st->head * nb;
+  const float a = st->power_alpha;
+  for (int k = 0; k < nb; k++) {
+    xr[k] = re[k];
+    xi[k] = im[k];
+    st->power[k] =
+        a * st->power[k] + (1.0f - a) * (re[k] * re[k] + im[k] * im[k]);
+  }
+
+  // 2. Echo estimate: Y = sum_p W_p * X_(head - p)
+  for (int k = 0; k < nb; k++) {
+    re[k] = 0.0f;
+    im[k] = 0.0f;
+  }
+  for (int p = 0; p < P; p++) {
+    int slot = (st->head - p + P) % P;
+    const float *Xr = st->X_re + (size_t)slot * nb;
+    const float *Xi = st->X_im + (size_t)slot * nb;
+    const float *Wr = st->W_re + (size_t)p * nb;
+    const float *Wi = st->W_im + (size_t)p * nb;
+    st->simd->cmac(re, im, Wr, Wi, Xr, Xi, nb);
+  }
+  le_rfft_inverse(&st->plan, re, im, t);
+
+  // 3. Error (overlap-save: the last N samples are the valid ones)
+  for (int i = 0; i < N; i++) {
+    out[i] = mic_in[i] - t[L - N + i];
+  }
+
+  // 4. Error spectrum E = FFT([0 ... 0, e])
+  memset(t, 0, (size_t)(L - N) * sizeof(float));
+  memcpy(t + L - N, out, (size_t)N * sizeof(float));
+  le_rfft_forward(&st->plan, t, re, im);
+
+  // Fold the per-bin normalization into E once instead of once per partition
+  for (int k = 0; k < nb; k++) {
+    float g = st->mu / (st->power[k] * (float)P + st->param_regularization);
+    st->E_re[k] = re[k] * g;
+    st->E_im[k] = im[k] * g;
+  }
+
+  // 5. Update: W_p += conj(X_(head - p)) * E
+  for (int p = 0; p < P; p++) {
+    int slot = (st->head - p + P) % P;
+    const float *Xr = st->X_re + (size_t)slot * nb;
+    const float *Xi = st->X_im + (size_t)slot * nb;
+    float *Wr = st->W_re + (size_t)p * nb;
+    float *Wi = st->W_im + (size_t)p * nb;
+
+    if (p != st->constrain) {
+      // Unconstrained update (cheap)
+      st->simd->cmac_conj(Wr, Wi, Wr, Wi, Xr, Xi, st->E_re, st->E_im, nb);
+      continue;
+    }
+
+    // Constrained update: project W_p + G onto the first N taps so the
+    // accumulated circular wrap-around of the other partitions is removed
+    st->simd->cmac_conj(re, im, Wr, Wi, Xr, Xi, st->E_re, st->E_im, nb);
+    le_rfft_inverse(&st->plan, re, im, t);
+    memset(t + N, 0, (size_t)(L - N) * sizeof(float));
+    le_rfft_forward(&st->plan, t, re, im);
+    for (int k = 0; k < nb; k++) {
+      Wr[k] = re[k];
+      Wi[k] = im[k];
+    }
+  }
+
+  st->constrain = (st->constrain + 1) % P;
+}
+
+void aec_fd_set_step_size(AecFdState *st, float mu) {
+  if (st)
+    st->mu = mu;
+}
@@ -0,0 +1,97 @@
+#ifndef AEC_FD_H
+#define AEC_FD_H
+
+#include "le_fft.h"
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Partitioned-block frequency-domain AEC (PBFDAF / MDF).
+ *
+ * The echo path of num_partitions * block_len taps is split into partitions
+ * of block_len taps, each adapted in the frequency domain with overlap-save
+ * (FFT size = next power of 2 >= 2 * block_len). Per-bin step normalization
+ * uses a smoothed reference power. The gradient constraint is applied to one
+ * partition per block in round-robin (as in AUMDF), so the cost per block is
+ * about five real FFTs plus 2 * num_partitions complex MACs per bin (SIMD
+ * kernels from simd_dispatch.h).
+ */
+typedef struct {
+  int N;   // Block length (samples per aec_fd_process call)
+  int L;   // FFT size
+  int P;   // Number of partitions
+  int nb;  // Number of bins kept (L/2 + 1)
+  int head;      // Ring index of the newest reference spectrum
+  int constrain; // Partition constrained on the next block
+
+  float mu;                   // Step size
+  float param_regularization; // Regularization for the power normalization
+  float power_alpha;          // Smoothing factor for per-bin power
+
+  LeRfftPlan plan;
+  const LeSimdKernels *simd; // Spectrum MAC kernels, chosen at init
+
+  // Arrays (pointers into provided memory)
+  float *x_buf;  // [L] Last L reference samples
+  float *X_re;   // [P * nb] Reference spectra ring
+  float *X_im;   // [P * nb]
+  float *W_re;   // [P * nb] Filter partitions
+  float *W_im;   // [P * nb]
+  float *power;  // [nb] Smoothed reference power per bin
+  float *buf_re; // [nb] Spectrum work buffers
+  float *buf_im; // [nb]
+  float *time;   // [L] Time-domain work buffer
+  float *E_re;   // [nb] Error spectrum
+  float *E_im;   // [nb]
+} AecFdState;
+
+/**
+ * Memory required by aec_fd_init.
+ * @param block_len: Samples per block (matches the audio callback block)
+ * @param num_partitions: Number of partitions (tail = P * block_len taps)
+ * @return Size in bytes, or 0 on invalid parameters
+ */
+size_t aec_fd_mem_bytes(int block_len, int num_partitions);
+
+/**
+ * Initialize frequency-domain AEC state.
+ * @param st: State structure
+ * @param block_len: Samples per block
+ * @param num_partitions: Number of partitions
+ * @param mem: Memory buffer provided by caller
+ * @param mem_size: Size of memory buffer in bytes
+ * @return 0 on success, -1 on invalid parameters or insufficient memory
+ */
+int aec_fd_init(AecFdState *st, int block_len, int num_partitions, void *mem,
+                size_t mem_size);
+
+/**
+ * Clear filter, history and power estimates.
+ */
+void aec_fd_reset(AecFdState *st);
+
+/**
+ * Process one block of block_len samples.
+ * @param st: State structure
+ * @param mic_in: Microphone block (Input) [block_len]
+ * @param ref_in: Reference block sent to speaker [block_len]
+ * @param out: Echo-cancelled block [block_len] (may alias mic_in)
+ */
+void aec_fd_process(AecFdState *st, const float *mic_in, const float *ref_in,
+                    float *out);
+
+/**
+ * Set adaptation step size.
+ * @param st: State structure
+ * @param mu: Step size (0.0 to 1.0)
+ */
+void aec_fd_set_step_size(AecFdState *st, float mu);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // AEC_FD_H
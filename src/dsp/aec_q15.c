@@ -0,0 +1,83 @@
+#include "aec_q15.h"
+#include "nlms_q15.h"
+#include <string.h>
+
+size_t aec_q15_mem_bytes(int filter_len) {
+  if (filter_len <= 0)
+    return 0;
+  // w[M] (Q31), w_q15[M] + x_hist[2M]
+  return (size_t)filter_len * sizeof(q31_t) +
+         3 * (size_t)filter_len * sizeof(q15_t);
+}
+
+int aec_q15_init(AecQ15State *st, int filter_len, void *mem,
+                 size_t mem_size) {
+  if (!st || !mem || filter_len <= 0)
+    return -1;
+  if (mem_size < aec_q15_mem_bytes(filter_len))
+    return -1;
+
+  st->M = filter_len;
+  st->w = (q31_t *)mem;
+  st->w_q15 = (q15_t *)(st->w + filter_len);
+  st->x_hist = st->w_q15 + filter_len;
+
+  // Defaults (as aec_init)
+  aec_q15_set_step_size(st, 0.05f);
+  st->eps = 1073; // 1e-6 in Q30
+
+  aec_q15_reset(st);
+  return 0;
+}
+
+void aec_q15_reset(AecQ15State *st) {
+  memset(st->w, 0, st->M * sizeof(q31_t));
+  memset(st->w_q15, 0, st->M * sizeof(q15_t));
+  memset(st->x_hist, 0, 2 * st->M * sizeof(q15_t));
+  st->p_idx = 0;
+  st->power = 0;
+}
+
+void aec_q15_set_step_size(AecQ15State *st, float mu) {
+  if (st)
+    st->mu = float_to_q31(mu);
+}
+
+static inline q15_t aec_q15_step(AecQ15State *st, q15_t mic_in,
+                                 q15_t ref_in) {
+  int M = st->M;
+
+  // 1. Update reference history; the slot being overwritten (and its
+  //    mirror) holds the sample leaving the window
+  int p = st->p_idx - 1;
+  if (p < 0)
+    p = M - 1;
+  int32_t oldest = st->x_hist[p + M];
+  st->power += (int64_t)ref_in * ref_in - oldest * oldest;
+  st->x_hist[p] = ref_in;
+  st->x_hist[p + M] = ref_in;
+  st->p_idx = p;
+  const q15_t *x = &st->x_hist[p];
+
+  // 2. Filter (Convolution), Q30
+  int64_t y_est = nlms_q15_dot(st->w_q15, x, M);
+
+  // 3. Error calculation
+  q15_t e = q15_sat((int32_t)mic_in - (int32_t)q_round_shift(y_est, 15));
+
+  // 4. Update Weights (NLMS, no leak)
+  q31_t step = nlms_q15_step(st->mu, e, st->power, st->eps);
+  nlms_q15_update(st->w, st->w_q15, x, M, Q31_MAX, step);
+
+  return e;
+}
+
+q15_t aec_q15_process(AecQ15State *st, q15_t mic_in, q15_t ref_in) {
+  return aec_q15_step(st, mic_in, ref_in);
+}
+
+void aec_q15_process_block(AecQ15State *st, const q15_t *mic,
+                           const q15_t *ref, q15_t *out, int n) {
+  for (int i = 0; i < n; i++)
+    out[i] = aec_q15_step(st, mic[i], ref[i]);
+}
@@ -0,0 +1,70 @@
+#ifndef AEC_Q15_H
+#define AEC_Q15_H
+
+#include "fixed_point.h"
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Fixed-point (Q15 signals, Q31 weights) time-domain NLMS echo canceller.
+ *
+ * Same algorithm as aec_process with AEC_POWER_EXACT; the reference power
+ * is an exact integer sliding sum, so the O(1) update needs no resync.
+ * No float operation runs per sample.
+ */
+
+typedef struct {
+  q31_t *w;       // [M] Filter coefficients (Q31)
+  q15_t *w_q15;   // [M] Filter copy of w
+  q15_t *x_hist;  // [2*M] Reference history, mirrored, newest at [p_idx]
+  int M;          // Filter length
+  int p_idx;
+  q31_t mu;       // Step size (Q31)
+  int64_t eps;    // NLMS regularization (Q30)
+  int64_t power;  // ||x||^2 over the window (Q30, exact)
+} AecQ15State;
+
+// Memory required by aec_q15_init (10 * filter_len bytes).
+size_t aec_q15_mem_bytes(int filter_len);
+
+/**
+ * Initialize AEC state.
+ * @param st: State structure
+ * @param filter_len: Length of adaptive filter
+ * @param mem: Memory buffer provided by caller
+ * @param mem_size: Size of memory buffer in bytes
+ * @return 0 on success, -1 if memory insufficient
+ */
+int aec_q15_init(AecQ15State *st, int filter_len, void *mem, size_t mem_size);
+
+// Clear the history and the weights.
+void aec_q15_reset(AecQ15State *st);
+
+/**
+ * Set adaptation step size.
+ * @param st: State structure
+ * @param mu: Step size (0.0 to 1.0)
+ */
+void aec_q15_set_step_size(AecQ15State *st, float mu);
+
+/**
+ * Process one sample.
+ * @param st: State structure
+ * @param mic_in: Signal from microphone (Q15)
+ * @param ref_in: Signal sent to speaker (Q15)
+ * @return Echo-cancelled signal (Q15)
+ */
+q15_t aec_q15_process(AecQ15State *st, q15_t mic_in, q15_t ref_in);
+
+// Process n samples; out may alias mic.
+void aec_q15_process_block(AecQ15State *st, const q15_t *mic,
+                           const q15_t *ref, q15_t *out, int n);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // AEC_Q15_H
@@ -1,5 +1,6 @@
 #include "biquad.h"
 #include <math.h>
+#include <string.h>
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846f
@@ -70,3 +71,64 @@ void biquad_bandpass(BiquadState *st, float sample_rate, float center_hz,
   st->z1 = 0.0f;
   st->z2 = 0.0f;
 }
+
+void biquad_dc_block(BiquadState *st, float sample_rate, float cutoff_hz) {
+  // Pole at R = 1 - 2*pi*fc/fs (valid for fc << fs), zero at DC
+  float R = 1.0f - 2.0f * M_PI * cutoff_hz / sample_rate;
+  if (R < 0.0f)
+    R = 0.0f;
+  biquad_init(st, 1.0f, -1.0f, 0.0f, -R, 0.0f);
+}
+
+// ============================================================================
+// Biquad bank
+// ============================================================================
+
+size_t biquad_bank_mem_bytes(int lanes, int stages) {
+  if (lanes <= 0 || stages <= 0)
+    return 0;
+  return (size_t)BIQUAD_BANK_FLOATS(lanes, stages) * sizeof(float);
+}
+
+int biquad_bank_init(BiquadBank *bk, int lanes, int stages, float *mem,
+                     size_t mem_bytes) {
+  if (!bk || !mem)
+    return -1;
+  size_t required = biquad_bank_mem_bytes(lanes, stages);
+  if (required == 0 || mem_bytes < required)
+    return -1;
+
+  memset(mem, 0, required);
+  bk->lanes = lanes;
+  bk->stages = stages;
+  bk->stride = BIQUAD_BANK_STRIDE(lanes);
+  bk->coef = mem;
+  bk->z = mem + 5 * stages * bk->stride;
+  bk->simd = le_simd_kernels();
+
+  // Pass-through: b0 = 1, everything else 0 (padding lanes included)
+  for (int s = 0; s < stages; s++) {
+    for (int l = 0; l < bk->stride; l++)
+      bk->coef[s * 5 * bk->stride + l] = 1.0f;
+  }
+  return 0;
+}
+
+void biquad_bank_set(BiquadBank *bk, int stage, int lane,
+                     const BiquadState *sec) {
+  if (stage < 0 || stage >= bk->stages || lane < 0 || lane >= bk->lanes)
+    return;
+  float *c = bk->coef + stage * 5 * bk->stride + lane;
+  c[0] = sec->b0;
+  c[bk->stride] = sec->b1;
+  c[2 * bk->stride] = sec->b2;
+  c[3 * bk->stride] = sec->a1;
+  c[4 * bk->stride] = sec->a2;
+  float *z = bk->z + stage * 2 * bk->stride + lane;
+  z[0] = 0.0f;
+  z[bk->stride] = 0.0f;
+}
+
+void biquad_bank_reset(BiquadBank *bk) {
+  memset(bk->z, 0, 2 * (size_t)bk->stages * bk->stride * sizeof(float));
+}
@@ -1,6 +1,9 @@
 #ifndef BIQUAD_H
 #define BIQUAD_H
 
+#include "simd_dispatch.h"
+#include <stddef.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -40,6 +43,71 @@ void biquad_highpass(BiquadState *st, float sample_rate, float cutoff_hz);
 void biquad_bandpass(BiquadState *st, float sample_rate, float center_hz,
                      float bandwidth_hz);
 
+// DC blocker: first-order highpass y = x - x[n-1] + R * y[n-1]
+void biquad_dc_block(BiquadState *st, float sample_rate, float cutoff_hz);
+
+// ============================================================================
+// Biquad bank: independent cascades across SIMD lanes
+// ============================================================================
+
+/**
+ * `lanes` independent channels, each a cascade of `stages` sections (DF2T,
+ * same arithmetic as biquad_process). A single section is a serial
+ * recursion, so the bank vectorizes across lanes instead: four bands or
+ * four mics per SSE2 / NEON vector, eight per AVX2 vector. Coefficients and
+ * state are stored transposed (one row of `stride` lanes per coefficient).
+ * A block runs through groups of up to four stages, each lane group keeping
+ * those sections in registers for the whole block so that the recursions
+ * of consecutive stages overlap. The kernel comes from the SIMD dispatch
+ * table active at biquad_bank_init.
+ */
+typedef struct {
+  int lanes;
+  int stages;
+  int stride;  // lanes rounded up to BIQUAD_BANK_ALIGN
+  float *coef; // [stages][5][stride]: b0, b1, b2, a1, a2
+  float *z;    // [stages][2][stride]: z1, z2
+  const LeSimdKernels *simd;
+} BiquadBank;
+
+#define BIQUAD_BANK_ALIGN 8
+#define BIQUAD_BANK_STRIDE(lanes)                                              \
+  (((lanes) + BIQUAD_BANK_ALIGN - 1) / BIQUAD_BANK_ALIGN * BIQUAD_BANK_ALIGN)
+// Memory for biquad_bank_init, in floats (for embedding in a state struct)
+#define BIQUAD_BANK_FLOATS(lanes, stages)                                      \
+  (7 * (stages) * BIQUAD_BANK_STRIDE(lanes))
+
+// Memory required by biquad_bank_init, in bytes.
+size_t biquad_bank_mem_bytes(int lanes, int stages);
+
+// Initialize with every section passing its input through unchanged.
+// Returns 0 on success, -1 on error (invalid size, insufficient memory).
+int biquad_bank_init(BiquadBank *bk, int lanes, int stages, float *mem,
+                     size_t mem_bytes);
+
+// Load the coefficients of a designed section (its state is ignored) into
+// one stage of one lane, and clear that section's state.
+void biquad_bank_set(BiquadBank *bk, int stage, int lane,
+                     const BiquadState *sec);
+
+// Reset state (clear history of every section)
+void biquad_bank_reset(BiquadBank *bk);
+
+/**
+ * Process a block through every cascade.
+ * @param in: Lane l reads in[n * in_stride + l] (in_stride >= lanes), or
+ *            in[n] for every lane when in_stride == 0 (one signal through
+ *            several filters)
+ * @param out: [frames][lanes] interleaved; may alias in when
+ *             in_stride == lanes
+ */
+static inline void biquad_bank_process(BiquadBank *bk, const float *in,
+                                       int in_stride, float *out,
+                                       int frames) {
+  bk->simd->biquad_bank(bk->coef, bk->z, bk->stride, bk->lanes, bk->stages,
+                        in, in_stride, out, frames);
+}
+
 #ifdef __cplusplus
 }
 #endif
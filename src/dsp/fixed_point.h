@@ -110,6 +110,46 @@ static inline q31_t q31_mul(q31_t a, q31_t b) {
   return (q31_t)prod;
 }
 
+// Saturate a wider intermediate to Q15 / Q31
+static inline q15_t q15_sat(int32_t x) {
+  if (x > Q15_MAX)
+    return Q15_MAX;
+  if (x < Q15_MIN)
+    return Q15_MIN;
+  return (q15_t)x;
+}
+
+static inline q31_t q31_sat(int64_t x) {
+  if (x > Q31_MAX)
+    return Q31_MAX;
+  if (x < Q31_MIN)
+    return Q31_MIN;
+  return (q31_t)x;
+}
+
+// Arithmetic right shift with round-half-up (shift >= 1)
+static inline int64_t q_round_shift(int64_t x, int shift) {
+  return (x + ((int64_t)1 << (shift - 1))) >> shift;
+}
+
+// floor(sqrt(x)), bit by bit (no FPU, no divide)
+static inline uint32_t q_isqrt64(uint64_t x) {
+  uint64_t root = 0;
+  uint64_t bit = (uint64_t)1 << 62;
+  while (bit > x)
+    bit >>= 2;
+  while (bit) {
+    if (x >= root + bit) {
+      x -= root + bit;
+      root = (root >> 1) + bit;
+    } else {
+      root >>= 1;
+    }
+    bit >>= 2;
+  }
+  return (uint32_t)root;
+}
+
 // ============================================================================
 // Batch Conversion (for buffer processing)
 // ============================================================================
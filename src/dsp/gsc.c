@@ -1,8 +1,10 @@
 #include "gsc.h"
 #include "math_fast.h"
-#include <immintrin.h>
 #include <string.h>
 
+// Running power is recomputed exactly this often (in samples)
+#define GSC_POWER_RESYNC_INTERVAL 1024
+
 static inline float clampf(float v, float min, float max) {
   if (v < min)
     return min;
@@ -11,15 +13,24 @@ static inline float clampf(float v, float min, float max) {
   return v;
 }
 
+size_t gsc_mem_bytes(const GscConfig *cfg) {
+  if (!cfg || cfg->M <= 0)
+    return 0;
+  // w1[M] + w2[M] + u1_hist[2M] + u2_hist[2M]
+  return 6 * (size_t)cfg->M * sizeof(float);
+}
+
 int gsc_init(GscState *st, const GscConfig *cfg, void *mem, size_t mem_bytes) {
   if (!st || !cfg || !mem)
     return -1;
 
-  size_t required = 4 * cfg->M * sizeof(float);
-  if (mem_bytes < required)
+  size_t required = gsc_mem_bytes(cfg);
+  if (required == 0 || mem_bytes < required)
     return -1;
 
   st->M = cfg->M;
+  st->power_mode = GSC_POWER_EXACT;
+  st->simd = le_simd_kernels();
 
   float *ptr = (float *)mem;
   st->w1 = ptr;
@@ -27,9 +38,9 @@ int gsc_init(GscState *st, const GscConfig *cfg, void *mem, size_t mem_bytes) {
   st->w2 = ptr;
   ptr += cfg->M;
   st->u1_hist = ptr;
-  ptr += cfg->M;
+  ptr += 2 * cfg->M;
   st->u2_hist = ptr;
-  ptr += cfg->M;
+  ptr += 2 * cfg->M;
 
   gsc_reset(st);
   return 0;
@@ -37,12 +48,14 @@ int gsc_init(GscState *st, const GscConfig *cfg, void *mem, size_t mem_bytes) {
 
 void gsc_reset(GscState *st) {
   st->p_idx = 0;
+  st->Pu = 0.0f;
+  st->power_resync = 0;
   st->beta = 0.0f;
 
   memset(st->w1, 0, st->M * sizeof(float));
   memset(st->w2, 0, st->M * sizeof(float));
-  memset(st->u1_hist, 0, st->M * sizeof(float));
-  memset(st->u2_hist, 0, st->M * sizeof(float));
+  memset(st->u1_hist, 0, 2 * st->M * sizeof(float));
+  memset(st->u2_hist, 0, 2 * st->M * sizeof(float));
 
   st->Ed = 0.0f;
   st->Eu2 = 0.0f;
@@ -55,178 +68,67 @@ void gsc_reset(GscState *st) {
   st->last_y = 0;
 }
 
-float gsc_process_sample(GscState *st, const GscConfig *cfg, float xL, float xR,
-                         float xB) {
-  int M = st->M;
-  int p = st->p_idx;
+// ============================================================================
+// Shared AIC step
+// ============================================================================
 
-  // 1. Calculate inputs
-  float mid = 0.5f * (xL + xR);
-  float d = mid;
-  float u1 = xL - xR;
-  float u2 = mid - st->beta * xB;
+// Push (u1, u2) into the mirrored history. The write index moves backwards so
+// the newest M samples always sit contiguously at [p_idx, p_idx + M).
+static inline void gsc_push(GscState *st, float u1, float u2) {
+  int M = st->M;
+  int p = st->p_idx - 1;
+  if (p < 0)
+    p = M - 1;
+
+  if (st->power_mode == GSC_POWER_RUNNING) {
+    // Slot p (and its mirror) held u[n-M], which just left the window
+    float old1 = st->u1_hist[p + M];
+    float old2 = st->u2_hist[p + M];
+    st->Pu += u1 * u1 + u2 * u2 - old1 * old1 - old2 * old2;
+  }
 
-  // 2. Update history buffer
   st->u1_hist[p] = u1;
+  st->u1_hist[p + M] = u1;
   st->u2_hist[p] = u2;
+  st->u2_hist[p + M] = u2;
+  st->p_idx = p;
+}
 
-  // 3. Filter (Convolution)
-  float yhat = 0.0f;
-
-// AVX2 SIMD optimization path
-#ifdef __AVX2__
-  // Limit stack buffer usage. If M > 256, strictly fallback or malloc (avoided
-  // here for speed)
-  if (M <= 256) {
-    float u1_lin[256];
-    float u2_lin[256];
-
-    // Linearize history buffers for SIMD (reverse order: newest at 0)
-    // u_lin[k] corresponds to u[n-k]
-    // Part 1: p down to 0  -> maps to k=0...(p)
-    // Part 2: M-1 down to p+1 -> maps to k=(p+1)...(M-1)
-
-    int k_lin = 0;
-    // [p...0]
-    for (int i = p; i >= 0; i--) {
-      u1_lin[k_lin] = st->u1_hist[i];
-      u2_lin[k_lin] = st->u2_hist[i];
-      k_lin++;
-    }
-    // [M-1...p+1]
-    for (int i = M - 1; i > p; i--) {
-      u1_lin[k_lin] = st->u1_hist[i];
-      u2_lin[k_lin] = st->u2_hist[i];
-      k_lin++;
-    }
-
-    // SIMD Convolution
-    int M_simd = M - (M % 8);
-    __m256 v_yhat = _mm256_setzero_ps();
-
-    for (int k = 0; k < M_simd; k += 8) {
-      __m256 v_w1 = _mm256_loadu_ps(&st->w1[k]);
-      __m256 v_u1 = _mm256_loadu_ps(&u1_lin[k]);
-      v_yhat = _mm256_fmadd_ps(v_w1, v_u1, v_yhat);
-
-      __m256 v_w2 = _mm256_loadu_ps(&st->w2[k]);
-      __m256 v_u2 = _mm256_loadu_ps(&u2_lin[k]);
-      v_yhat = _mm256_fmadd_ps(v_w2, v_u2, v_yhat);
-    }
-
-    // Horizontal sum
-    float temp[8];
-    _mm256_storeu_ps(temp, v_yhat);
-    for (int i = 0; i < 8; i++)
-      yhat += temp[i];
-
-    // Tails
-    for (int k = M_simd; k < M; k++) {
-      yhat += st->w1[k] * u1_lin[k];
-      yhat += st->w2[k] * u2_lin[k];
-    }
-
-    // 4. Error output
-    float e = d - yhat;
-
-    // 5. Leakage Detection (EWMA)
-    st->Ed = (1.0f - cfg->alpha) * st->Ed + cfg->alpha * d * d;
-    st->Eu2 = (1.0f - cfg->alpha) * st->Eu2 + cfg->alpha * u2 * u2;
-    st->Edu2 = (1.0f - cfg->alpha) * st->Edu2 + cfg->alpha * d * u2;
-
-    float denom = fast_sqrtf(st->Ed * st->Eu2) + cfg->eps;
-    float gamma = st->Edu2 / denom;
-    float g = fast_absf(gamma);
-
-    // 6. Soft Rate Control
-    float p_control = 0.0f;
-    if (g <= cfg->g_lo) {
-      p_control = 0.0f;
-    } else if (g >= cfg->g_hi) {
-      p_control = 1.0f;
-    } else {
-      p_control = (g - cfg->g_lo) / (cfg->g_hi - cfg->g_lo);
-    }
-
-    float one_minus_p = 1.0f - p_control;
-    float muAIC = cfg->mu_max * one_minus_p * one_minus_p;
-    float etaBeta = cfg->eta_max * p_control * p_control;
-
-    // 7. AIC Update (Leaky NLMS) - Optimized
-    float Pu = 0.0f;
-    // Calculate power over the window M using linear buffers
-    __m256 v_Pu = _mm256_setzero_ps();
-    for (int k = 0; k < M_simd; k += 8) {
-      __m256 v_u1 = _mm256_loadu_ps(&u1_lin[k]);
-      v_Pu = _mm256_fmadd_ps(v_u1, v_u1, v_Pu);
-      __m256 v_u2 = _mm256_loadu_ps(&u2_lin[k]);
-      v_Pu = _mm256_fmadd_ps(v_u2, v_u2, v_Pu);
-    }
-    _mm256_storeu_ps(temp, v_Pu);
-    for (int i = 0; i < 8; i++)
-      Pu += temp[i];
-    for (int k = M_simd; k < M; k++) {
-      Pu += u1_lin[k] * u1_lin[k];
-      Pu += u2_lin[k] * u2_lin[k];
-    }
-
-    float norm = Pu + cfg->eps;
-    float factor = muAIC * e / norm;
-    float leak = 1.0f - cfg->leak_lambda;
-
-    __m256 v_factor = _mm256_set1_ps(factor);
-    __m256 v_leak = _mm256_set1_ps(leak);
-
-    for (int k = 0; k < M_simd; k += 8) {
-      __m256 v_w1 = _mm256_loadu_ps(&st->w1[k]);
-      __m256 v_u1 = _mm256_loadu_ps(&u1_lin[k]);
-      // w = leak*w + factor*u
-      v_w1 = _mm256_fmadd_ps(v_leak, v_w1, _mm256_mul_ps(v_factor, v_u1));
-      _mm256_storeu_ps(&st->w1[k], v_w1);
-
-      __m256 v_w2 = _mm256_loadu_ps(&st->w2[k]);
-      __m256 v_u2 = _mm256_loadu_ps(&u2_lin[k]);
-      v_w2 = _mm256_fmadd_ps(v_leak, v_w2, _mm256_mul_ps(v_factor, v_u2));
-      _mm256_storeu_ps(&st->w2[k], v_w2);
-    }
-    for (int k = M_simd; k < M; k++) {
-      st->w1[k] = leak * st->w1[k] + factor * u1_lin[k];
-      st->w2[k] = leak * st->w2[k] + factor * u2_lin[k];
-    }
-
-    // 8. Beta Update (1-tap NLMS)
-    float factor_beta = etaBeta * (xB * u2) / (xB * xB + cfg->eps);
-    st->beta += factor_beta;
-    st->beta = clampf(st->beta, cfg->beta_min, cfg->beta_max);
-
-    // 9. Advance index
-    st->p_idx = (p + 1) % M;
-
-    // Debug stats copy
-    st->last_gamma = gamma;
-    st->last_p = p_control;
-    st->last_mu = muAIC;
-    st->last_eta = etaBeta;
-    st->last_y = e;
-
-    return e;
+// Window power ||u1||^2 + ||u2||^2 for the NLMS normalization.
+static inline float gsc_window_power(GscState *st, const float *u1,
+                                     const float *u2) {
+  if (st->power_mode != GSC_POWER_RUNNING)
+    return st->simd->energy2(u1, u2, st->M);
+
+  if (++st->power_resync >= GSC_POWER_RESYNC_INTERVAL) {
+    st->power_resync = 0;
+    st->Pu = st->simd->energy2(u1, u2, st->M);
+  } else if (st->Pu < 0.0f) {
+    st->Pu = 0.0f; // Cancellation error can push a tiny sum negative
   }
-#endif // force scalar
+  return st->Pu;
+}
 
-  // Scalar Fallback (also used if M > 256 or AVX2 disabled)
-  for (int k = 0; k < M; k++) {
-    int idx = (p - k + M) % M;
-    yhat += st->w1[k] * st->u1_hist[idx];
-    yhat += st->w2[k] * st->u2_hist[idx];
-  }
+// Filter, leakage detection, soft rate control and leaky NLMS update.
+// d: Desired (fixed beamformer) sample
+// u_ref: Blocking-matrix output used for leakage detection
+// Returns the error e[n]; *eta_out receives the beta step size.
+static inline float gsc_aic_step(GscState *st, const GscConfig *cfg, float d,
+                                 float u_ref, float *eta_out) {
+  int M = st->M;
+  const float *u1 = &st->u1_hist[st->p_idx];
+  const float *u2 = &st->u2_hist[st->p_idx];
+
+  // 3. Filter (Convolution)
+  float yhat = st->simd->dot2(st->w1, u1, st->w2, u2, M);
 
   // 4. Error output
   float e = d - yhat;
 
   // 5. Leakage Detection (EWMA)
   st->Ed = (1.0f - cfg->alpha) * st->Ed + cfg->alpha * d * d;
-  st->Eu2 = (1.0f - cfg->alpha) * st->Eu2 + cfg->alpha * u2 * u2;
-  st->Edu2 = (1.0f - cfg->alpha) * st->Edu2 + cfg->alpha * d * u2;
+  st->Eu2 = (1.0f - cfg->alpha) * st->Eu2 + cfg->alpha * u_ref * u_ref;
+  st->Edu2 = (1.0f - cfg->alpha) * st->Edu2 + cfg->alpha * d * u_ref;
 
   float denom = fast_sqrtf(st->Ed * st->Eu2) + cfg->eps;
   float gamma = st->Edu2 / denom;
@@ -247,30 +149,13 @@ float gsc_process_sample(GscState *st, const GscConfig *cfg, float xL, float xR,
   float etaBeta = cfg->eta_max * p_control * p_control;
 
   // 7. AIC Update (Leaky NLMS)
-  float Pu = 0.0f;
-  // Calculate power over the window M
-  for (int k = 0; k < M; k++) {
-    Pu += st->u1_hist[k] * st->u1_hist[k];
-    Pu += st->u2_hist[k] * st->u2_hist[k];
-  }
+  float Pu = gsc_window_power(st, u1, u2);
 
   float norm = Pu + cfg->eps;
   float factor = muAIC * e / norm;
   float leak = 1.0f - cfg->leak_lambda;
 
-  for (int k = 0; k < M; k++) {
-    int idx = (p - k + M) % M;
-    st->w1[k] = leak * st->w1[k] + factor * st->u1_hist[idx];
-    st->w2[k] = leak * st->w2[k] + factor * st->u2_hist[idx];
-  }
-
-  // 8. Beta Update (1-tap NLMS)
-  float factor_beta = etaBeta * (xB * u2) / (xB * xB + cfg->eps);
-  st->beta += factor_beta;
-  st->beta = clampf(st->beta, cfg->beta_min, cfg->beta_max);
-
-  // 9. Advance index
-  st->p_idx = (p + 1) % M;
+  st->simd->update2(st->w1, u1, st->w2, u2, M, leak, factor);
 
   // Debug stats copy
   st->last_gamma = gamma;
@@ -279,16 +164,35 @@ float gsc_process_sample(GscState *st, const GscConfig *cfg, float xL, float xR,
   st->last_eta = etaBeta;
   st->last_y = e;
 
+  *eta_out = etaBeta;
   return e;
 }
 
-// 4-channel mode with direction selection
-float gsc_process_sample_4ch(GscState *st, const GscConfig *cfg, float xTL,
-                             float xTR, float xBL, float xBR,
-                             BeamDirection dir) {
-  int M = st->M;
-  int p = st->p_idx;
+static inline float gsc_step_3ch(GscState *st, const GscConfig *cfg, float xL,
+                                 float xR, float xB) {
+  // 1. Calculate inputs
+  float mid = 0.5f * (xL + xR);
+  float d = mid;
+  float u1 = xL - xR;
+  float u2 = mid - st->beta * xB;
 
+  // 2. Update history buffer
+  gsc_push(st, u1, u2);
+
+  float etaBeta;
+  float e = gsc_aic_step(st, cfg, d, u2, &etaBeta);
+
+  // 8. Beta Update (1-tap NLMS)
+  float factor_beta = etaBeta * (xB * u2) / (xB * xB + cfg->eps);
+  st->beta += factor_beta;
+  st->beta = clampf(st->beta, cfg->beta_min, cfg->beta_max);
+
+  return e;
+}
+
+static inline float gsc_step_4ch(GscState *st, const GscConfig *cfg, float xTL,
+                                 float xTR, float xBL, float xBR,
+                                 BeamDirection dir) {
   // 1. Compute beams based on direction
   float d, u1_raw;
   switch (dir) {
@@ -319,74 +223,56 @@ float gsc_process_sample_4ch(GscState *st, const GscConfig *cfg, float xTL,
   float u2 = u2_raw;
 
   // 2. Update history buffer
-  st->u1_hist[p] = u1;
-  st->u2_hist[p] = u2;
+  gsc_push(st, u1, u2);
 
-  // 3. Filter (Convolution) - same as 3ch version
-  float yhat = 0.0f;
-  for (int k = 0; k < M; k++) {
-    int idx = (p - k + M) % M;
-    yhat += st->w1[k] * st->u1_hist[idx];
-    yhat += st->w2[k] * st->u2_hist[idx];
-  }
+  // 3-7. Filter + adaptation (leakage detected on d vs u1)
+  float etaBeta;
+  float e = gsc_aic_step(st, cfg, d, u1, &etaBeta);
 
-  // 4. Error output
-  float e = d - yhat;
-
-  // 5. Leakage Detection (EWMA)
-  st->Ed = (1.0f - cfg->alpha) * st->Ed + cfg->alpha * d * d;
-  st->Eu2 = (1.0f - cfg->alpha) * st->Eu2 + cfg->alpha * u1 * u1;
-  st->Edu2 = (1.0f - cfg->alpha) * st->Edu2 + cfg->alpha * d * u1;
+  // 8. Beta Update (1-tap NLMS) - adapts to leakage between d and u1_raw
+  float factor_beta = etaBeta * (u1_raw * u1) / (u1_raw * u1_raw + cfg->eps);
+  st->beta += factor_beta;
+  st->beta = clampf(st->beta, cfg->beta_min, cfg->beta_max);
 
-  float denom = fast_sqrtf(st->Ed * st->Eu2) + cfg->eps;
-  float gamma = st->Edu2 / denom;
-  float g = fast_absf(gamma);
+  return e;
+}
 
-  // 6. Soft Rate Control
-  float p_control = 0.0f;
-  if (g <= cfg->g_lo) {
-    p_control = 0.0f;
-  } else if (g >= cfg->g_hi) {
-    p_control = 1.0f;
-  } else {
-    p_control = (g - cfg->g_lo) / (cfg->g_hi - cfg->g_lo);
-  }
+// ============================================================================
+// Public API
+// ============================================================================
+
+void gsc_set_power_mode(GscState *st, GscPowerMode mode) {
+  if (!st)
+    return;
+  st->power_mode = mode;
+  st->power_resync = 0;
+  st->Pu = st->simd->energy2(&st->u1_hist[st->p_idx],
+                             &st->u2_hist[st->p_idx], st->M);
+}
 
-  float one_minus_p = 1.0f - p_control;
-  float muAIC = cfg->mu_max * one_minus_p * one_minus_p;
-  float etaBeta = cfg->eta_max * p_control * p_control;
+float gsc_process_sample(GscState *st, const GscConfig *cfg, float xL, float xR,
+                         float xB) {
+  return gsc_step_3ch(st, cfg, xL, xR, xB);
+}
 
-  // 7. AIC Update (Leaky NLMS)
-  float Pu = 0.0f;
-  for (int k = 0; k < M; k++) {
-    Pu += st->u1_hist[k] * st->u1_hist[k];
-    Pu += st->u2_hist[k] * st->u2_hist[k];
+void gsc_process_block(GscState *st, const GscConfig *cfg, const float *in,
+                       float *out, int frames) {
+  for (int i = 0; i < frames; i++) {
+    out[i] = gsc_step_3ch(st, cfg, in[i * 3 + 0], in[i * 3 + 1], in[i * 3 + 2]);
   }
+}
 
-  float norm = Pu + cfg->eps;
-  float factor = muAIC * e / norm;
-  float leak = 1.0f - cfg->leak_lambda;
+// 4-channel mode with direction selection
+float gsc_process_sample_4ch(GscState *st, const GscConfig *cfg, float xTL,
+                             float xTR, float xBL, float xBR,
+                             BeamDirection dir) {
+  return gsc_step_4ch(st, cfg, xTL, xTR, xBL, xBR, dir);
+}
 
-  for (int k = 0; k < M; k++) {
-    int idx = (p - k + M) % M;
-    st->w1[k] = leak * st->w1[k] + factor * st->u1_hist[idx];
-    st->w2[k] = leak * st->w2[k] + factor * st->u2_hist[idx];
+void gsc_process_block_4ch(GscState *st, const GscConfig *cfg, const float *in,
+                           float *out, int frames, BeamDirection dir) {
+  for (int i = 0; i < frames; i++) {
+    const float *x = &in[i * 4];
+    out[i] = gsc_step_4ch(st, cfg, x[0], x[1], x[2], x[3], dir);
   }
-
-  // 8. Beta Update (1-tap NLMS) - adapts to leakage between d and u1_raw
-  float factor_beta = etaBeta * (u1_raw * u1) / (u1_raw * u1_raw + cfg->eps);
-  st->beta += factor_beta;
-  st->beta = clampf(st->beta, cfg->beta_min, cfg->beta_max);
-
-  // 9. Advance index
-  st->p_idx = (p + 1) % M;
-
-  // Debug stats
-  st->last_gamma = gamma;
-  st->last_p = p_control;
-  st->last_mu = muAIC;
-  st->last_eta = etaBeta;
-  st->last_y = e;
-
-  return e;
 }
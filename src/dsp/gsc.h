@@ -1,6 +1,7 @@
 #ifndef GSC_H
 #define GSC_H
 
+#include "simd_dispatch.h"
 #include <stddef.h> // size_t
 
 #ifdef __cplusplus
@@ -28,17 +29,30 @@ typedef enum {
   BEAM_DIR_RIGHT
 } BeamDirection;
 
+// Input power normalization for the AIC NLMS update
+typedef enum {
+  GSC_POWER_EXACT = 0, // Recompute ||u||^2 over the window every sample
+  GSC_POWER_RUNNING    // Sliding sum: add newest^2, subtract oldest^2
+} GscPowerMode;
+
 typedef struct {
   // State variables
   int M;
-  int p_idx; // Ring buffer write index
+  int p_idx; // Ring buffer write index (moves backwards, newest at p_idx)
   float beta;
 
   // Arrays (pointers to provided memory)
   float *w1;      // [M]
   float *w2;      // [M]
-  float *u1_hist; // [M]
-  float *u2_hist; // [M]
+  float *u1_hist; // [2*M] mirrored: u1_hist[p_idx + k] == u1[n-k]
+  float *u2_hist; // [2*M] mirrored: u2_hist[p_idx + k] == u2[n-k]
+
+  const LeSimdKernels *simd; // Filter kernels, chosen at gsc_init
+
+  // NLMS power normalization
+  GscPowerMode power_mode;
+  float Pu;         // Running ||u1||^2 + ||u2||^2 (GSC_POWER_RUNNING)
+  int power_resync; // Samples since the last exact recomputation of Pu
 
   // Leakage EWMA states
   float Ed;
@@ -54,14 +68,23 @@ typedef struct {
 
 } GscState;
 
+// Memory required by gsc_init for the given config (6 * M floats: two weight
+// vectors plus two double-length mirrored histories).
+size_t gsc_mem_bytes(const GscConfig *cfg);
+
 // Initialize GSC state.
 // mem: Pointer to allocated memory block.
-// mem_bytes: Size of the block. Must be at least 4 * M * sizeof(float).
+// mem_bytes: Size of the block. Must be at least gsc_mem_bytes(cfg).
 // Returns 0 on success, -1 on error (insufficient memory).
 int gsc_init(GscState *st, const GscConfig *cfg, void *mem, size_t mem_bytes);
 
 void gsc_reset(GscState *st);
 
+// Select how the NLMS step is normalized (default: GSC_POWER_EXACT).
+// The running mode is O(1) per sample and is re-synced exactly every
+// GSC_POWER_RESYNC_INTERVAL samples to bound float drift.
+void gsc_set_power_mode(GscState *st, GscPowerMode mode);
+
 // Process one sample set (legacy 3-channel mode).
 // xL, xR: Left/Right mic inputs
 // xB: Back mic input
@@ -69,6 +92,14 @@ void gsc_reset(GscState *st);
 float gsc_process_sample(GscState *st, const GscConfig *cfg, float xL, float xR,
                          float xB);
 
+// Process a block of frames (3-channel mode).
+// in: Interleaved [xL, xR, xB] frames (frames * 3 floats)
+// out: Mono output, one sample per frame (frames floats)
+// Equivalent to calling gsc_process_sample once per frame; this is the entry
+// point used by the audio callback.
+void gsc_process_block(GscState *st, const GscConfig *cfg, const float *in,
+                       float *out, int frames);
+
 // Process one sample set (4-channel mode with direction selection).
 // xTL, xTR: Temple Left/Right (front)
 // xBL, xBR: Back Left/Right
@@ -78,6 +109,13 @@ float gsc_process_sample_4ch(GscState *st, const GscConfig *cfg, float xTL,
                              float xTR, float xBL, float xBR,
                              BeamDirection dir);
 
+// Process a block of frames (4-channel mode).
+// in: Interleaved [xTL, xTR, xBL, xBR] frames (frames * 4 floats)
+// out: Mono output, one sample per frame (frames floats)
+// Equivalent to calling gsc_process_sample_4ch once per frame.
+void gsc_process_block_4ch(GscState *st, const GscConfig *cfg, const float *in,
+                           float *out, int frames, BeamDirection dir);
+
 #ifdef __cplusplus
 }
 #endif
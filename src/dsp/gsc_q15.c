@@ -0,0 +1,215 @@
+#include "gsc_q15.h"
+#include "nlms_q15.h"
+#include <string.h>
+
+#define ONE_Q15 32768
+
+// Float parameter to Q29 (saturates at +-4)
+static q31_t to_q29(float v) { return float_to_q31(v * 0.25f); }
+
+// Positive regularization in Q(frac), at least one LSB so nothing divides
+// by zero
+static int64_t eps_to_q(float eps, int frac) {
+  int64_t v = (int64_t)(eps * (float)((int64_t)1 << frac));
+  return v > 0 ? v : 1;
+}
+
+size_t gsc_q15_mem_bytes(const GscConfig *cfg) {
+  if (!cfg || cfg->M <= 0)
+    return 0;
+  // w1[M] + w2[M] (Q31), w1_q15[M] + w2_q15[M] + u1_hist[2M] + u2_hist[2M]
+  return 2 * (size_t)cfg->M * sizeof(q31_t) +
+         6 * (size_t)cfg->M * sizeof(q15_t);
+}
+
+int gsc_q15_init(GscQ15State *st, const GscConfig *cfg, void *mem,
+                 size_t mem_bytes) {
+  if (!st || !cfg || !mem)
+    return -1;
+
+  size_t required = gsc_q15_mem_bytes(cfg);
+  if (required == 0 || mem_bytes < required)
+    return -1;
+
+  st->M = cfg->M;
+
+  // Q31 arrays first: they keep the alignment of mem
+  q31_t *w = (q31_t *)mem;
+  st->w1 = w;
+  st->w2 = w + cfg->M;
+  q15_t *ptr = (q15_t *)(w + 2 * cfg->M);
+  st->w1_q15 = ptr;
+  ptr += cfg->M;
+  st->w2_q15 = ptr;
+  ptr += cfg->M;
+  st->u1_hist = ptr;
+  ptr += 2 * cfg->M;
+  st->u2_hist = ptr;
+
+  gsc_q15_set_config(st, cfg);
+  gsc_q15_reset(st);
+  return 0;
+}
+
+void gsc_q15_reset(GscQ15State *st) {
+  st->p_idx = 0;
+  st->Pu = 0;
+  st->beta = 0;
+
+  memset(st->w1, 0, st->M * sizeof(q31_t));
+  memset(st->w2, 0, st->M * sizeof(q31_t));
+  memset(st->w1_q15, 0, st->M * sizeof(q15_t));
+  memset(st->w2_q15, 0, st->M * sizeof(q15_t));
+  memset(st->u1_hist, 0, 2 * st->M * sizeof(q15_t));
+  memset(st->u2_hist, 0, 2 * st->M * sizeof(q15_t));
+
+  st->Ed = 0;
+  st->Eu2 = 0;
+  st->Edu2 = 0;
+
+  st->last_gamma = 0;
+  st->last_p = 0;
+  st->last_mu = 0;
+  st->last_eta = 0;
+  st->last_y = 0;
+}
+
+void gsc_q15_set_config(GscQ15State *st, const GscConfig *cfg) {
+  GscQ15Params *p = &st->prm;
+  p->alpha = float_to_q31(cfg->alpha);
+  p->one_minus_alpha = float_to_q31(1.0f - cfg->alpha);
+  p->mu_max = float_to_q31(cfg->mu_max);
+  p->eta_max = float_to_q31(cfg->eta_max);
+  p->leak = float_to_q31(1.0f - cfg->leak_lambda);
+  p->g_lo = (int32_t)(cfg->g_lo * ONE_Q15);
+  p->g_hi = (int32_t)(cfg->g_hi * ONE_Q15);
+  p->beta_min = to_q29(cfg->beta_min);
+  p->beta_max = to_q29(cfg->beta_max);
+  p->eps_power = eps_to_q(cfg->eps, 30);
+  p->eps_gamma = eps_to_q(cfg->eps, 31);
+}
+
+// ============================================================================
+// Per-sample step
+// ============================================================================
+
+// Push (u1, u2) into the mirrored history and slide the window power.
+// Integer sums are exact, so the running power never drifts.
+static inline void gsc_q15_push(GscQ15State *st, q15_t u1, q15_t u2) {
+  int M = st->M;
+  int p = st->p_idx - 1;
+  if (p < 0)
+    p = M - 1;
+
+  // Slot p (and its mirror) held u[n-M], which just left the window
+  int32_t old1 = st->u1_hist[p + M];
+  int32_t old2 = st->u2_hist[p + M];
+  st->Pu += (int64_t)u1 * u1 + (int64_t)u2 * u2 - old1 * old1 - old2 * old2;
+
+  st->u1_hist[p] = u1;
+  st->u1_hist[p + M] = u1;
+  st->u2_hist[p] = u2;
+  st->u2_hist[p + M] = u2;
+  st->p_idx = p;
+}
+
+// E = (1 - alpha) * E + alpha * x, all Q31
+static inline q31_t ewma_q31(q31_t E, q31_t x, const GscQ15Params *c) {
+  return q31_sat((((int64_t)c->one_minus_alpha * E) >> 31) +
+                 (((int64_t)c->alpha * x) >> 31));
+}
+
+static inline q15_t gsc_q15_step(GscQ15State *st, q15_t xL, q15_t xR,
+                                 q15_t xB) {
+  const GscQ15Params *c = &st->prm;
+  int M = st->M;
+
+  // 1. Calculate inputs
+  int32_t d = ((int32_t)xL + xR) >> 1; // mid
+  q15_t u1 = q15_sat((int32_t)xL - xR);
+  int32_t beta_xB =
+      (int32_t)q_round_shift((int64_t)st->beta * xB, GSC_Q15_BETA_FRAC);
+  q15_t u2 = q15_sat(d - beta_xB);
+
+  // 2. Update history buffer
+  gsc_q15_push(st, u1, u2);
+  const q15_t *h1 = &st->u1_hist[st->p_idx];
+  const q15_t *h2 = &st->u2_hist[st->p_idx];
+
+  // 3. Filter (Convolution), Q30
+  int64_t yhat = nlms_q15_dot(st->w1_q15, h1, M) +
+                 nlms_q15_dot(st->w2_q15, h2, M);
+
+  // 4. Error output
+  q15_t e = q15_sat(d - (int32_t)q_round_shift(yhat, 15));
+
+  // 5. Leakage Detection (EWMA of Q30 products, doubled to Q31)
+  st->Ed = ewma_q31(st->Ed, q31_sat((int64_t)d * d * 2), c);
+  st->Eu2 = ewma_q31(st->Eu2, q31_sat((int64_t)u2 * u2 * 2), c);
+  st->Edu2 = ewma_q31(st->Edu2, q31_sat((int64_t)d * u2 * 2), c);
+
+  // gamma = Edu2 / (sqrt(Ed * Eu2) + eps); |gamma| <= 1 up to rounding
+  int64_t Ed = st->Ed > 0 ? st->Ed : 0;
+  int64_t Eu2 = st->Eu2 > 0 ? st->Eu2 : 0;
+  int64_t denom = (int64_t)q_isqrt64((uint64_t)(Ed * Eu2)) + c->eps_gamma;
+  int64_t gamma = (int64_t)st->Edu2 * ONE_Q15 / denom;
+  if (gamma > Q15_MAX)
+    gamma = Q15_MAX;
+  if (gamma < -ONE_Q15)
+    gamma = -ONE_Q15;
+  int32_t g = (int32_t)(gamma < 0 ? -gamma : gamma);
+
+  // 6. Soft Rate Control (p in [0, ONE_Q15])
+  int32_t p_control;
+  if (g <= c->g_lo) {
+    p_control = 0;
+  } else if (g >= c->g_hi) {
+    p_control = ONE_Q15;
+  } else {
+    p_control = (g - c->g_lo) * ONE_Q15 / (c->g_hi - c->g_lo);
+  }
+
+  int64_t one_minus_p = ONE_Q15 - p_control;
+  q31_t muAIC = (q31_t)(((int64_t)c->mu_max * one_minus_p * one_minus_p) >> 30);
+  q31_t etaBeta =
+      (q31_t)(((int64_t)c->eta_max * p_control * p_control) >> 30);
+
+  // 7. AIC Update (Leaky NLMS)
+  q31_t step = nlms_q15_step(muAIC, e, st->Pu, c->eps_power);
+  nlms_q15_update(st->w1, st->w1_q15, h1, M, c->leak, step);
+  nlms_q15_update(st->w2, st->w2_q15, h2, M, c->leak, step);
+
+  // 8. Beta Update (1-tap NLMS): eta * xB * u2 / (xB^2 + eps)
+  int64_t t = ((int64_t)etaBeta * ((int32_t)xB * u2)) >> 31; // Q30
+  int64_t delta = t * ((int64_t)1 << GSC_Q15_BETA_FRAC) /
+                  ((int64_t)xB * xB + c->eps_power);
+  int64_t beta = (int64_t)st->beta + delta;
+  if (beta < c->beta_min)
+    beta = c->beta_min;
+  if (beta > c->beta_max)
+    beta = c->beta_max;
+  st->beta = (q31_t)beta;
+
+  // Debug stats copy
+  st->last_gamma = (q15_t)gamma;
+  st->last_p = q15_sat(p_control);
+  st->last_mu = muAIC;
+  st->last_eta = etaBeta;
+  st->last_y = e;
+
+  return e;
+}
+
+// ============================================================================
+// Public API
+// ============================================================================
+
+q15_t gsc_q15_process_sample(GscQ15State *st, q15_t xL, q15_t xR, q15_t xB) {
+  return gsc_q15_step(st, xL, xR, xB);
+}
+
+void gsc_q15_process_block(GscQ15State *st, const q15_t *in, q15_t *out,
+                           int frames) {
+  for (int i = 0; i < frames; i++)
+    out[i] = gsc_q15_step(st, in[i * 3 + 0], in[i * 3 + 1], in[i * 3 + 2]);
+}
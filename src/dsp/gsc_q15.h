@@ -0,0 +1,98 @@
+#ifndef GSC_Q15_H
+#define GSC_Q15_H
+
+#include "fixed_point.h"
+#include "gsc.h"
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Fixed-point (Q15 signals, Q31 state) 3-channel GSC for FPU-less targets.
+ *
+ * Same algorithm as gsc_process_sample with GSC_POWER_EXACT: the window
+ * power is an exact integer sliding sum, so it needs no resync. The float
+ * GscConfig is converted once (gsc_q15_init / gsc_q15_set_config) and no
+ * float operation runs per sample. Weights are Q31 (range +-1) with Q15
+ * copies for the filter, beta is Q29 (range +-4).
+ *
+ * The beams are not scaled: keep the inputs below about -6 dBFS so that
+ * xL - xR does not saturate.
+ */
+
+#define GSC_Q15_BETA_FRAC 29
+
+// GscConfig in fixed point
+typedef struct {
+  q31_t alpha;           // EWMA factor
+  q31_t one_minus_alpha; // 1 - alpha
+  q31_t mu_max;          // AIC max step size
+  q31_t eta_max;         // Beta max step size
+  q31_t leak;            // 1 - leak_lambda
+  int32_t g_lo;          // Soft control thresholds (Q15, up to 1.0)
+  int32_t g_hi;
+  q31_t beta_min;        // Beta limits (Q29)
+  q31_t beta_max;
+  int64_t eps_power;     // NLMS / beta regularization (Q30)
+  int64_t eps_gamma;     // Leakage detector regularization (Q31)
+} GscQ15Params;
+
+typedef struct {
+  int M;
+  int p_idx;  // Newest sample at [p_idx], mirrored as in GscState
+  q31_t beta; // Q29
+
+  q31_t *w1;      // [M] Q31
+  q31_t *w2;      // [M] Q31
+  q15_t *w1_q15;  // [M] Filter copy of w1
+  q15_t *w2_q15;  // [M] Filter copy of w2
+  q15_t *u1_hist; // [2*M] mirrored
+  q15_t *u2_hist; // [2*M] mirrored
+
+  int64_t Pu; // ||u1||^2 + ||u2||^2 over the window (Q30, exact)
+
+  // Leakage EWMA states (Q31)
+  q31_t Ed;
+  q31_t Eu2;
+  q31_t Edu2;
+
+  GscQ15Params prm;
+
+  // Debug / Monitoring
+  q15_t last_gamma; // Q15
+  q15_t last_p;     // Q15
+  q31_t last_mu;    // Q31
+  q31_t last_eta;   // Q31
+  q15_t last_y;     // Q15
+} GscQ15State;
+
+// Memory required by gsc_q15_init (20 * M bytes).
+size_t gsc_q15_mem_bytes(const GscConfig *cfg);
+
+// Initialize from a float config (also converted by gsc_q15_set_config).
+// Returns 0 on success, -1 on error (insufficient memory).
+int gsc_q15_init(GscQ15State *st, const GscConfig *cfg, void *mem,
+                 size_t mem_bytes);
+
+// Clear history, weights, beta and the EWMAs.
+void gsc_q15_reset(GscQ15State *st);
+
+// Convert new parameters (cfg->M is ignored: the memory is sized for the
+// initial M).
+void gsc_q15_set_config(GscQ15State *st, const GscConfig *cfg);
+
+// Process one sample set: Q15 xL, xR (front pair), xB (back mic).
+// Returns the output e[n] in Q15.
+q15_t gsc_q15_process_sample(GscQ15State *st, q15_t xL, q15_t xR, q15_t xB);
+
+// Process a block of interleaved [xL, xR, xB] Q15 frames into Q15 mono.
+void gsc_q15_process_block(GscQ15State *st, const q15_t *in, q15_t *out,
+                           int frames);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // GSC_Q15_H
@@ -0,0 +1,244 @@
+#include "gsc_subband.h"
+#include "math_fast.h"
+#include <math.h>
+#include <string.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+static inline float clampf(float v, float min, float max) {
+  if (v < min)
+    return min;
+  if (v > max)
+    return max;
+  return v;
+}
+
+static int gsc_subband_valid(const GscSubbandConfig *sb) {
+  if (!sb || sb->hop <= 0 || le_rfft_plan_bytes(sb->fft_size) == 0)
+    return 0;
+  return (sb->fft_size % sb->hop) == 0 && sb->fft_size / sb->hop >= 2;
+}
+
+static size_t gsc_subband_float_count(int K) {
+  size_t nb = (size_t)(K / 2 + 1);
+  // win[K] + in_buf[3K] + ola[K] + out_fifo[<=K/2] + W[4nb] + Pu[nb]
+  // + spec[6nb] + time[K]
+  return 6 * (size_t)K + (size_t)(K / 2) + 11 * nb;
+}
+
+size_t gsc_subband_mem_bytes(const GscSubbandConfig *sb) {
+  if (!gsc_subband_valid(sb))
+    return 0;
+  return le_rfft_plan_bytes(sb->fft_size) +
+         gsc_subband_float_count(sb->fft_size) * sizeof(float);
+}
+
+int gsc_subband_init(GscSubbandState *st, const GscSubbandConfig *sb,
+                     void *mem, size_t mem_bytes) {
+  if (!st || !mem || !gsc_subband_valid(sb))
+    return -1;
+  if (mem_bytes < gsc_subband_mem_bytes(sb))
+    return -1;
+
+  int K = sb->fft_size;
+  st->K = K;
+  st->R = sb->hop;
+  st->nb = K / 2 + 1;
+  st->mu = sb->mu;
+  st->power_alpha = sb->power_alpha;
+
+  size_t plan_bytes = le_rfft_plan_bytes(K);
+  if (le_rfft_plan_init(&st->plan, K, mem, plan_bytes) != 0)
+    return -1;
+
+  float *p = (float *)((char *)mem + plan_bytes);
+  st->win = p;
+  p += K;
+  st->in_buf = p;
+  p += 3 * K;
+  st->ola = p;
+  p += K;
+  st->out_fifo = p;
+  p += K / 2;
+  st->W1_re = p;
+  p += st->nb;
+  st->W1_im = p;
+  p += st->nb;
+  st->W2_re = p;
+  p += st->nb;
+  st->W2_im = p;
+  p += st->nb;
+  st->Pu = p;
+  p += st->nb;
+  st->spec = p;
+  p += 6 * st->nb;
+  st->time = p;
+
+  // Periodic sqrt-Hann: analysis * synthesis = Hann, which overlap-adds to a
+  // constant (K / 2) / R for any integer K / R >= 2
+  float wsum = 0.0f;
+  for (int n = 0; n < K; n++) {
+    float h = 0.5f - 0.5f * cosf(2.0f * (float)M_PI * (float)n / (float)K);
+    st->win[n] = sqrtf(h);
+    wsum += h;
+  }
+  st->synth_scale = (float)st->R / wsum;
+
+  gsc_subband_reset(st);
+  return 0;
+}
+
+void gsc_subband_reset(GscSubbandState *st) {
+  if (!st)
+    return;
+  // Everything after the window is state
+  memset(st->in_buf, 0,
+         (gsc_subband_float_count(st->K) - (size_t)st->K) * sizeof(float));
+  st->pos = 0;
+  st->beta = 0.0f;
+  st->Ed = 0.0f;
+  st->Eu2 = 0.0f;
+  st->Edu2 = 0.0f;
+  st->last_gamma = 0.0f;
+  st->last_p = 0.0f;
+  st->last_mu = 0.0f;
+  st->last_eta = 0.0f;
+}
+
+int gsc_subband_latency(const GscSubbandState *st) { return st ? st->K : 0; }
+
+// One hop: analysis, per-bin AIC, beta loop, synthesis
+static void gsc_subband_frame(GscSubbandState *st, const GscConfig *cfg) {
+  const int K = st->K;
+  const int R = st->R;
+  const int nb = st->nb;
+
+  // 1. Analysis (windowed rFFT per channel)
+  for (int ch = 0; ch < 3; ch++) {
+    const float *x = st->in_buf + ch * K;
+    for (int n = 0; n < K; n++)
+      st->time[n] = x[n] * st->win[n];
+    le_rfft_forward(&st->plan, st->time, st->spec + 2 * ch * nb,
+                    st->spec + (2 * ch + 1) * nb);
+  }
+  const float *Lr = st->spec, *Li = st->spec + nb;
+  const float *Rr = st->spec + 2 * nb, *Ri = st->spec + 3 * nb;
+  const float *Br = st->spec + 4 * nb, *Bi = st->spec + 5 * nb;
+
+  // 2. Leakage detection on frame energies of D and U2
+  float ed = 0.0f, eu = 0.0f, edu = 0.0f;
+  for (int k = 0; k < nb; k++) {
+    float dr = 0.5f * (Lr[k] + Rr[k]), di = 0.5f * (Li[k] + Ri[k]);
+    float u2r = dr - st->beta * Br[k], u2i = di - st->beta * Bi[k];
+    ed += dr * dr + di * di;
+    eu += u2r * u2r + u2i * u2i;
+    edu += dr * u2r + di * u2i;
+  }
+
+  // Per-sample constants -> per-frame (R samples per update)
+  float a = 1.0f - powf(1.0f - cfg->alpha, (float)R);
+  st->Ed = (1.0f - a) * st->Ed + a * ed;
+  st->Eu2 = (1.0f - a) * st->Eu2 + a * eu;
+  st->Edu2 = (1.0f - a) * st->Edu2 + a * edu;
+
+  float denom = fast_sqrtf(st->Ed * st->Eu2) + cfg->eps;
+  float gamma = st->Edu2 / denom;
+  float g = fast_absf(gamma);
+
+  // 3. Soft Rate Control
+  float p_control = 0.0f;
+  if (g <= cfg->g_lo) {
+    p_control = 0.0f;
+  } else if (g >= cfg->g_hi) {
+    p_control = 1.0f;
+  } else {
+    p_control = (g - cfg->g_lo) / (cfg->g_hi - cfg->g_lo);
+  }
+
+  float one_minus_p = 1.0f - p_control;
+  float muAIC = st->mu * one_minus_p * one_minus_p;
+  float etaBeta = cfg->eta_max * p_control * p_control;
+  float leak = clampf(1.0f - cfg->leak_lambda * (float)R, 0.0f, 1.0f);
+  float pa = st->power_alpha;
+
+  // 4. Per-bin AIC filter + leaky complex NLMS, E written over the L spectrum
+  float *Er = st->spec, *Ei = st->spec + nb;
+  float xbu = 0.0f, xbb = 0.0f;
+  for (int k = 0; k < nb; k++) {
+    float dr = 0.5f * (Lr[k] + Rr[k]), di = 0.5f * (Li[k] + Ri[k]);
+    float u1r = Lr[k] - Rr[k], u1i = Li[k] - Ri[k];
+    float u2r = dr - st->beta * Br[k], u2i = di - st->beta * Bi[k];
+
+    float yr = st->W1_re[k] * u1r - st->W1_im[k] * u1i +
+               st->W2_re[k] * u2r - st->W2_im[k] * u2i;
+    float yi = st->W1_re[k] * u1i + st->W1_im[k] * u1r +
+               st->W2_re[k] * u2i + st->W2_im[k] * u2r;
+    float er = dr - yr;
+    float ei = di - yi;
+
+    st->Pu[k] = pa * st->Pu[k] +
+                (1.0f - pa) * (u1r * u1r + u1i * u1i + u2r * u2r + u2i * u2i);
+    float f = muAIC / (st->Pu[k] + cfg->eps);
+
+    // W += f * conj(U) * E
+    st->W1_re[k] = leak * st->W1_re[k] + f * (u1r * er + u1i * ei);
+    st->W1_im[k] = leak * st->W1_im[k] + f * (u1r * ei - u1i * er);
+    st->W2_re[k] = leak * st->W2_re[k] + f * (u2r * er + u2i * ei);
+    st->W2_im[k] = leak * st->W2_im[k] + f * (u2r * ei - u2i * er);
+
+    // Beta statistics: Re(conj(B) * U2), |B|^2
+    xbu += Br[k] * u2r + Bi[k] * u2i;
+    xbb += Br[k] * Br[k] + Bi[k] * Bi[k];
+
+    Er[k] = er;
+    Ei[k] = ei;
+  }
+
+  // 5. Beta Update (1-tap NLMS over the frame)
+  float eta_frame = clampf(etaBeta * (float)R, 0.0f, 1.0f);
+  st->beta += eta_frame * xbu / (xbb + cfg->eps);
+  st->beta = clampf(st->beta, cfg->beta_min, cfg->beta_max);
+
+  // 6. Synthesis (weighted overlap-add)
+  le_rfft_inverse(&st->plan, Er, Ei, st->time);
+  for (int n = 0; n < K; n++)
+    st->ola[n] += st->time[n] * st->win[n] * st->synth_scale;
+
+  memcpy(st->out_fifo, st->ola, (size_t)R * sizeof(float));
+  memmove(st->ola, st->ola + R, (size_t)(K - R) * sizeof(float));
+  memset(st->ola + K - R, 0, (size_t)R * sizeof(float));
+
+  // Debug stats copy
+  st->last_gamma = gamma;
+  st->last_p = p_control;
+  st->last_mu = muAIC;
+  st->last_eta = etaBeta;
+}
+
+void gsc_subband_process_block(GscSubbandState *st, const GscConfig *cfg,
+                               const float *in, float *out, int frames) {
+  const int K = st->K;
+  const int R = st->R;
+  float *xL = st->in_buf;
+  float *xR = st->in_buf + K;
+  float *xB = st->in_buf + 2 * K;
+
+  for (int i = 0; i < frames; i++) {
+    int slot = K - R + st->pos;
+    out[i] = st->out_fifo[st->pos];
+    xL[slot] = in[i * 3 + 0];
+    xR[slot] = in[i * 3 + 1];
+    xB[slot] = in[i * 3 + 2];
+
+    if (++st->pos == R) {
+      gsc_subband_frame(st, cfg);
+      for (int ch = 0; ch < 3; ch++) {
+        float *x = st->in_buf + ch * K;
+        memmove(x, x + R, (size_t)(K - R) * sizeof(float));
+      }
+      st->pos = 0;
+    }
+  }
+}
@@ -0,0 +1,93 @@
+#ifndef GSC_SUBBAND_H
+#define GSC_SUBBAND_H
+
+#include "gsc.h"
+#include "le_fft.h"
+#include <stddef.h> // size_t
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Beamformer implementation selected from config ("gsc.mode")
+typedef enum {
+  GSC_MODE_TIME = 0, // Fullband time-domain FIR GSC (gsc.c)
+  GSC_MODE_SUBBAND   // STFT subband GSC (gsc_subband.c)
+} GscMode;
+
+typedef struct {
+  int fft_size;      // Analysis frame / FFT size (power of 2, e.g. 256)
+  int hop;           // Frame advance; fft_size / hop must be an integer >= 2
+  float mu;          // Per-bin normalized AIC step size (e.g. 0.5)
+  float power_alpha; // Per-bin power smoothing per frame (e.g. 0.8)
+} GscSubbandConfig;
+
+// Same structure as the time-domain GSC, one complex AIC weight per bin:
+//   D = (L + R) / 2, U1 = L - R, U2 = D - beta * B
+//   E = D - (W1 * U1 + W2 * U2)
+// The leakage detector, soft rate control and beta loop use the GscConfig
+// parameters with per-sample constants converted to per-frame ones.
+typedef struct {
+  int K;   // FFT size
+  int R;   // Hop size
+  int nb;  // Bins (K/2 + 1)
+  int pos; // Samples collected in the current hop
+  float mu;
+  float power_alpha;
+  float synth_scale; // WOLA normalization for the window / hop pair
+  float beta;
+
+  // Leakage EWMA states (frame energies)
+  float Ed;
+  float Eu2;
+  float Edu2;
+
+  LeRfftPlan plan;
+
+  // Arrays (pointers to provided memory)
+  float *win;      // [K] sqrt-Hann analysis/synthesis window
+  float *in_buf;   // [3*K] Last K input samples per channel (L, R, B)
+  float *ola;      // [K] Overlap-add accumulator
+  float *out_fifo; // [R] Synthesized samples played out over the next hop
+  float *W1_re;    // [nb]
+  float *W1_im;    // [nb]
+  float *W2_re;    // [nb]
+  float *W2_im;    // [nb]
+  float *Pu;       // [nb] Smoothed |U1|^2 + |U2|^2
+  float *spec;     // [6*nb] L, R, B spectra (re, im)
+  float *time;     // [K] Windowed frame / synthesis scratch
+
+  // Debug / Monitoring (same meaning as GscState)
+  float last_gamma;
+  float last_p;
+  float last_mu;
+  float last_eta;
+} GscSubbandState;
+
+// Memory required by gsc_subband_init for the given config, or 0 if the
+// frame/hop combination is invalid.
+size_t gsc_subband_mem_bytes(const GscSubbandConfig *sb);
+
+// Initialize subband GSC state.
+// mem: Pointer to allocated memory block.
+// mem_bytes: Size of the block. Must be at least gsc_subband_mem_bytes(sb).
+// Returns 0 on success, -1 on error (invalid config or insufficient memory).
+int gsc_subband_init(GscSubbandState *st, const GscSubbandConfig *sb,
+                     void *mem, size_t mem_bytes);
+
+void gsc_subband_reset(GscSubbandState *st);
+
+// Algorithmic delay in samples (input to output), equal to fft_size.
+int gsc_subband_latency(const GscSubbandState *st);
+
+// Process a block of frames (3-channel mode), any block length.
+// in: Interleaved [xL, xR, xB] frames (frames * 3 floats)
+// out: Mono output, one sample per frame (frames floats)
+void gsc_subband_process_block(GscSubbandState *st, const GscConfig *cfg,
+                               const float *in, float *out, int frames);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // GSC_SUBBAND_H
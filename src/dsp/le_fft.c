@@ -0,0 +1,253 @@
+/**
+ * @file le_fft.c
+ * @brief Radix-2^2 FFT and packed real FFT with precomputed plans
+ */
+
+#include "le_fft.h"
+#include <math.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+static int le_fft_log2(int n) {
+  if (n < 2 || (n & (n - 1)) != 0)
+    return -1;
+  int bits = 0;
+  while ((1 << bits) < n)
+    bits++;
+  return bits;
+}
+
+// Span of the first radix-4 stage: 1 for even log2(n), 2 after the leading
+// radix-2 pass for odd log2(n)
+static int le_fft_first_span(int log2n) { return (log2n & 1) ? 2 : 1; }
+
+// Number of floats in the radix-4 stage twiddle table
+static size_t le_fft_tw_count(int n, int log2n) {
+  size_t count = 0;
+  for (int h = le_fft_first_span(log2n); 4 * h <= n; h *= 4)
+    count += 4 * (size_t)h;
+  return count;
+}
+
+size_t le_fft_plan_bytes(int n) {
+  int bits = le_fft_log2(n);
+  if (bits < 0)
+    return 0;
+  // bitrev[n] + stage twiddles
+  return (size_t)n * sizeof(int) + le_fft_tw_count(n, bits) * sizeof(float);
+}
+
+int le_fft_plan_init(LeFftPlan *plan, int n, void *mem, size_t mem_bytes) {
+  if (!plan || !mem)
+    return -1;
+  int bits = le_fft_log2(n);
+  if (bits < 0 || mem_bytes < le_fft_plan_bytes(n))
+    return -1;
+
+  plan->n = n;
+  plan->log2n = bits;
+  plan->simd = le_simd_kernels();
+  plan->bitrev = (int *)mem;
+  plan->tw = (float *)(plan->bitrev + n);
+
+  for (int i = 0; i < n; i++) {
+    int x = i;
+    int r = 0;
+    for (int b = 0; b < bits; b++) {
+      r = (r << 1) | (x & 1);
+      x >>= 1;
+    }
+    plan->bitrev[i] = r;
+  }
+
+  // Contiguous per-stage twiddles so butterflies load them as vectors
+  float *tw = plan->tw;
+  for (int h = le_fft_first_span(bits); 4 * h <= n; h *= 4) {
+    for (int k = 0; k < h; k++) {
+      double a1 = -2.0 * M_PI * (double)k / (double)(2 * h);
+      double a2 = -2.0 * M_PI * (double)k / (double)(4 * h);
+      tw[k] = (float)cos(a1);
+      tw[h + k] = (float)sin(a1);
+      tw[2 * h + k] = (float)cos(a2);
+      tw[3 * h + k] = (float)sin(a2);
+    }
+    tw += 4 * h;
+  }
+
+  return 0;
+}
+
+// Forward transform; the inverse is derived by conjugation
+static void le_fft_forward(const LeFftPlan *plan, float *re, float *im) {
+  int n = plan->n;
+
+  // Bit-reversal permutation from the precomputed table
+  for (int i = 0; i < n; i++) {
+    int j = plan->bitrev[i];
+    if (j > i) {
+      float tr = re[i];
+      float ti = im[i];
+      re[i] = re[j];
+      im[i] = im[j];
+      re[j] = tr;
+      im[j] = ti;
+    }
+  }
+
+  // Leading radix-2 pass for odd log2(n) (all twiddles are 1)
+  if (plan->log2n & 1) {
+    for (int i = 0; i < n; i += 2) {
+      float tr = re[i + 1];
+      float ti = im[i + 1];
+      re[i + 1] = re[i] - tr;
+      im[i + 1] = im[i] - ti;
+      re[i] += tr;
+      im[i] += ti;
+    }
+  }
+
+  const float *tw = plan->tw;
+  for (int h = le_fft_first_span(plan->log2n); 4 * h <= n; h *= 4) {
+    for (int i = 0; i < n; i += 4 * h) {
+      plan->simd->fft_radix4(re + i, im + i, h, tw);
+    }
+    tw += 4 * h;
+  }
+}
+
+void le_fft_complex(const LeFftPlan *plan, float *re, float *im, int inverse) {
+  int n = plan->n;
+
+  if (!inverse) {
+    le_fft_forward(plan, re, im);
+    return;
+  }
+
+  // IFFT(x) = conj(FFT(conj(x))) / n
+  for (int i = 0; i < n; i++)
+    im[i] = -im[i];
+
+  le_fft_forward(plan, re, im);
+
+  float scale = 1.0f / (float)n;
+  for (int i = 0; i < n; i++) {
+    re[i] *= scale;
+    im[i] *= -scale;
+  }
+}
+
+// ============================================================================
+// Real FFT (n real points via an n/2-point complex FFT)
+// ============================================================================
+
+size_t le_rfft_plan_bytes(int n) {
+  if (n < 4 || le_fft_log2(n) < 0)
+    return 0;
+  // Complex half plan + post-processing twiddles
+  return le_fft_plan_bytes(n / 2) + 2 * (size_t)(n / 4 + 1) * sizeof(float);
+}
+
+int le_rfft_plan_init(LeRfftPlan *plan, int n, void *mem, size_t mem_bytes) {
+  if (!plan || !mem)
+    return -1;
+  size_t required = le_rfft_plan_bytes(n);
+  if (required == 0 || mem_bytes < required)
+    return -1;
+
+  size_t half_bytes = le_fft_plan_bytes(n / 2);
+  if (le_fft_plan_init(&plan->half, n / 2, mem, half_bytes) != 0)
+    return -1;
+
+  plan->n = n;
+  plan->post_re = (float *)((char *)mem + half_bytes);
+  plan->post_im = plan->post_re + n / 4 + 1;
+  for (int k = 0; k <= n / 4; k++) {
+    double angle = -2.0 * M_PI * (double)k / (double)n;
+    plan->post_re[k] = (float)cos(angle);
+    plan->post_im[k] = (float)sin(angle);
+  }
+
+  return 0;
+}
+
+void le_rfft_forward(const LeRfftPlan *plan, const float *in, float *re,
+                     float *im) {
+  const int M = plan->n / 2;
+
+  // Pack even/odd samples as one complex sequence z[m] = x[2m] + j x[2m+1]
+  for (int m = 0; m < M; m++) {
+    re[m] = in[2 * m];
+    im[m] = in[2 * m + 1];
+  }
+  le_fft_forward(&plan->half, re, im);
+
+  // Split: X[k] = Ze[k] + W^k Zo[k], X[M-k] = conj(Ze[k] - W^k Zo[k])
+  float z0r = re[0];
+  float z0i = im[0];
+  re[0] = z0r + z0i;
+  im[0] = 0.0f;
+  re[M] = z0r - z0i;
+  im[M] = 0.0f;
+
+  for (int k = 1; k <= M / 2; k++) {
+    float ar = re[k], ai = im[k];
+    float br = re[M - k], bi = im[M - k];
+
+    float er = 0.5f * (ar + br);
+    float ei = 0.5f * (ai - bi);
+    float or_ = 0.5f * (ai + bi);
+    float oi = -0.5f * (ar - br);
+
+    float wr = plan->post_re[k];
+    float wi = plan->post_im[k];
+    float tr = wr * or_ - wi * oi;
+    float ti = wr * oi + wi * or_;
+
+    re[M - k] = er - tr;
+    im[M - k] = -(ei - ti);
+    re[k] = er + tr;
+    im[k] = ei + ti;
+  }
+}
+
+void le_rfft_inverse(const LeRfftPlan *plan, float *re, float *im,
+                     float *out) {
+  const int M = plan->n / 2;
+
+  // Rebuild Z[k] = Ze[k] + j Zo[k] from the half spectrum
+  float x0 = re[0];
+  float xm = re[M];
+  re[0] = 0.5f * (x0 + xm);
+  im[0] = 0.5f * (x0 - xm);
+
+  for (int k = 1; k <= M / 2; k++) {
+    float ar = re[k], ai = im[k];
+    float br = re[M - k], bi = im[M - k];
+
+    // Ze = (X[k] + conj(X[M-k])) / 2, Zo = (X[k] - conj(X[M-k])) conj(W^k) / 2
+    float er = 0.5f * (ar + br);
+    float ei = 0.5f * (ai - bi);
+    float dr = 0.5f * (ar - br);
+    float di = 0.5f * (ai + bi);
+
+    float wr = plan->post_re[k];
+    float wi = -plan->post_im[k];
+    float or_ = dr * wr - di * wi;
+    float oi = dr * wi + di * wr;
+
+    // Z[k] = Ze + j Zo, Z[M-k] = conj(Ze) + j conj(Zo)
+    re[k] = er - oi;
+    im[k] = ei + or_;
+    re[M - k] = er + oi;
+    im[M - k] = -ei + or_;
+  }
+
+  le_fft_complex(&plan->half, re, im, 1);
+
+  for (int m = 0; m < M; m++) {
+    out[2 * m] = re[m];
+    out[2 * m + 1] = im[m];
+  }
+}
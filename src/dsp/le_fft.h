@@ -0,0 +1,109 @@
+/**
+ * @file le_fft.h
+ * @brief Shared FFT for the LombardEar DSP library
+ *
+ * In-place complex FFT on split real/imag arrays, plus a packed real FFT
+ * built on a half-size complex transform. Bit-reversal indices and
+ * per-stage twiddle factors are precomputed once in a plan that lives in
+ * caller-provided memory, so transforms never allocate.
+ *
+ * Stages are fused pairwise into radix-4 (radix-2^2) passes whose
+ * butterflies come from the runtime-selected SIMD kernel table
+ * (simd_dispatch.h); a leading radix-2 pass handles odd log2(n).
+ */
+
+#ifndef LE_FFT_H
+#define LE_FFT_H
+
+#include "simd_dispatch.h"
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+  int n;       // Transform size (power of 2)
+  int log2n;   // log2(n)
+  int *bitrev; // [n] Bit-reversed index table
+  float *tw;   // Radix-4 stage twiddles, per stage of span h:
+               // [w1_re h][w1_im h][w2_re h][w2_im h],
+               // w1 = exp(-2*pi*i*k/(2h)), w2 = exp(-2*pi*i*k/(4h))
+  const LeSimdKernels *simd; // Butterfly kernels, chosen at plan init
+} LeFftPlan;
+
+typedef struct {
+  int n;          // Real transform size (power of 2, >= 4)
+  LeFftPlan half; // Complex plan of size n/2
+  float *post_re; // [n/4 + 1] cos(-2*pi*k/n)
+  float *post_im; // [n/4 + 1] sin(-2*pi*k/n)
+} LeRfftPlan;
+
+/**
+ * Memory required by le_fft_plan_init for a size-n plan.
+ * @return Size in bytes, or 0 if n is not a power of 2 >= 2
+ */
+size_t le_fft_plan_bytes(int n);
+
+/**
+ * Initialize a plan.
+ * @param plan      Plan structure
+ * @param n         Transform size (power of 2)
+ * @param mem       Memory block of at least le_fft_plan_bytes(n) bytes
+ * @param mem_bytes Size of the memory block
+ * @return 0 on success, -1 on invalid size or insufficient memory
+ */
+int le_fft_plan_init(LeFftPlan *plan, int n, void *mem, size_t mem_bytes);
+
+/**
+ * In-place complex FFT.
+ * @param plan    Plan for size n
+ * @param re      Real parts [n]
+ * @param im      Imaginary parts [n]
+ * @param inverse 0 = forward, 1 = inverse (scaled by 1/n)
+ */
+void le_fft_complex(const LeFftPlan *plan, float *re, float *im, int inverse);
+
+/**
+ * Memory required by le_rfft_plan_init for a size-n real plan.
+ * @return Size in bytes, or 0 if n is not a power of 2 >= 4
+ */
+size_t le_rfft_plan_bytes(int n);
+
+/**
+ * Initialize a real FFT plan.
+ * @param plan      Plan structure
+ * @param n         Real transform size (power of 2, >= 4)
+ * @param mem       Memory block of at least le_rfft_plan_bytes(n) bytes
+ * @param mem_bytes Size of the memory block
+ * @return 0 on success, -1 on invalid size or insufficient memory
+ */
+int le_rfft_plan_init(LeRfftPlan *plan, int n, void *mem, size_t mem_bytes);
+
+/**
+ * Real-to-complex forward FFT.
+ * Produces the non-redundant half spectrum; bins n/2+1..n-1 are the
+ * complex conjugates of bins n/2-1..1.
+ * @param plan Real plan for size n
+ * @param in   Real input [n] (must not alias re/im)
+ * @param re   Real parts of bins 0..n/2 [n/2 + 1]
+ * @param im   Imaginary parts of bins 0..n/2 [n/2 + 1] (im[0], im[n/2] = 0)
+ */
+void le_rfft_forward(const LeRfftPlan *plan, const float *in, float *re,
+                     float *im);
+
+/**
+ * Complex-to-real inverse FFT (scaled by 1/n).
+ * @param plan Real plan for size n
+ * @param re   Real parts of bins 0..n/2 [n/2 + 1] (overwritten as scratch)
+ * @param im   Imaginary parts of bins 0..n/2 [n/2 + 1] (overwritten)
+ * @param out  Real output [n] (must not alias re/im)
+ */
+void le_rfft_inverse(const LeRfftPlan *plan, float *re, float *im,
+                     float *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LE_FFT_H
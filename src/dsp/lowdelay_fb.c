@@ -0,0 +1,145 @@
+/**
+ * @file lowdelay_fb.c
+ * @brief Low-delay WOLA filterbank with asymmetric windows
+ *
+ * Window design after Mauler & Martin: the analysis window rises over a long
+ * sqrt-Hann flank and falls over the second half of a short sqrt-Hann of
+ * length synth_len; the synthesis window is chosen so that analysis times
+ * synthesis equals a synth_len Hann on the newest samples, which overlap-adds
+ * to a constant at the given hop.
+ */
+
+#include "lowdelay_fb.h"
+#include <math.h>
+#include <string.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+static int ldfb_valid(const LdfbConfig *cfg) {
+  if (!cfg || cfg->hop <= 0 || le_rfft_plan_bytes(cfg->frame_size) == 0)
+    return 0;
+  return cfg->synth_len % cfg->hop == 0 && cfg->synth_len >= 2 * cfg->hop &&
+         cfg->synth_len <= cfg->frame_size && cfg->synth_len % 2 == 0;
+}
+
+static size_t ldfb_float_count(const LdfbConfig *cfg) {
+  size_t K = (size_t)cfg->frame_size;
+  size_t Ls = (size_t)cfg->synth_len;
+  size_t nb = K / 2 + 1;
+  // win_a[K] + win_s[Ls] + in_buf[K] + ola[Ls] + time[K] + re/im[2*nb]
+  return 3 * K + 2 * Ls + 2 * nb;
+}
+
+size_t ldfb_mem_bytes(const LdfbConfig *cfg) {
+  if (!ldfb_valid(cfg))
+    return 0;
+  return le_rfft_plan_bytes(cfg->frame_size) +
+         ldfb_float_count(cfg) * sizeof(float);
+}
+
+int ldfb_init(LdfbState *st, const LdfbConfig *cfg, void *mem,
+              size_t mem_size) {
+  if (!st || !mem || !ldfb_valid(cfg))
+    return -1;
+  if (mem_size < ldfb_mem_bytes(cfg))
+    return -1;
+
+  int K = cfg->frame_size;
+  int Ls = cfg->synth_len;
+  st->K = K;
+  st->R = cfg->hop;
+  st->Ls = Ls;
+  st->nb = K / 2 + 1;
+
+  size_t plan_bytes = le_rfft_plan_bytes(K);
+  if (le_rfft_plan_init(&st->plan, K, mem, plan_bytes) != 0)
+    return -1;
+
+  float *p = (float *)((char *)mem + plan_bytes);
+  st->win_a = p;
+  p += K;
+  st->win_s = p;
+  p += Ls;
+  st->in_buf = p;
+  p += K;
+  st->ola = p;
+  p += Ls;
+  st->time = p;
+  p += K;
+  st->re = p;
+  p += st->nb;
+  st->im = p;
+
+  // Analysis: long rising sqrt-Hann flank, short falling sqrt-Hann flank
+  int rise = K - Ls / 2;
+  for (int n = 0; n < K; n++) {
+    double h;
+    if (n < rise) {
+      h = 0.5 - 0.5 * cos(M_PI * (double)n / (double)rise);
+    } else {
+      int m = n - (K - Ls);
+      h = 0.5 - 0.5 * cos(2.0 * M_PI * (double)m / (double)Ls);
+    }
+    st->win_a[n] = (float)sqrt(h);
+  }
+
+  // Synthesis: Hann(Ls) / analysis on the newest Ls samples, scaled so the
+  // Hann overlap-add at this hop sums to one
+  double scale = 2.0 * (double)st->R / (double)Ls;
+  for (int m = 0; m < Ls; m++) {
+    double h = 0.5 - 0.5 * cos(2.0 * M_PI * (double)m / (double)Ls);
+    float wa = st->win_a[K - Ls + m];
+    st->win_s[m] = (wa > 1e-9f) ? (float)(h / wa * scale) : 0.0f;
+  }
+
+  ldfb_reset(st);
+  return 0;
+}
+
+void ldfb_reset(LdfbState *st) {
+  if (!st)
+    return;
+  memset(st->in_buf, 0, (size_t)st->K * sizeof(float));
+  memset(st->ola, 0, (size_t)st->Ls * sizeof(float));
+}
+
+int ldfb_group_delay(const LdfbState *st) { return st ? st->Ls - st->R : 0; }
+
+int ldfb_process(LdfbState *st, const float *in, float *out, int frames,
+                 LdfbBandFn band_fn, void *user) {
+  const int K = st->K;
+  const int R = st->R;
+  const int Ls = st->Ls;
+
+  if (frames % R != 0)
+    return -1;
+
+  for (int base = 0; base < frames; base += R) {
+    // 1. Slide input history (hop is copied before out may overwrite it)
+    memmove(st->in_buf, st->in_buf + R, (size_t)(K - R) * sizeof(float));
+    memcpy(st->in_buf + K - R, in + base, (size_t)R * sizeof(float));
+
+    // 2. Analysis
+    for (int n = 0; n < K; n++)
+      st->time[n] = st->in_buf[n] * st->win_a[n];
+    le_rfft_forward(&st->plan, st->time, st->re, st->im);
+
+    // 3. Subband processing
+    if (band_fn)
+      band_fn(st->re, st->im, st->nb, user);
+
+    // 4. Synthesis: only the newest Ls samples carry synthesis weight
+    le_rfft_inverse(&st->plan, st->re, st->im, st->time);
+    const float *t = st->time + K - Ls;
+    for (int m = 0; m < Ls; m++)
+      st->ola[m] += t[m] * st->win_s[m];
+
+    memcpy(out + base, st->ola, (size_t)R * sizeof(float));
+    memmove(st->ola, st->ola + R, (size_t)(Ls - R) * sizeof(float));
+    memset(st->ola + Ls - R, 0, (size_t)R * sizeof(float));
+  }
+
+  return 0;
+}
@@ -0,0 +1,104 @@
+/**
+ * @file lowdelay_fb.h
+ * @brief Low-delay oversampled DFT (WOLA) analysis/synthesis filterbank
+ *
+ * Uses an asymmetric analysis/synthesis window pair: a long analysis window
+ * (frame_size samples) for frequency resolution, and a short synthesis
+ * window (synth_len samples) that only covers the newest part of the frame.
+ * The algorithmic group delay is synth_len - hop samples instead of a whole
+ * FFT frame, e.g. frame 256 / hop 32 / synth 64 gives 32 samples (2 ms at
+ * 16 kHz).
+ *
+ * Processing is block-synchronous: each call consumes and produces the same
+ * number of samples, which must be a multiple of the hop.
+ */
+
+#ifndef LOWDELAY_FB_H
+#define LOWDELAY_FB_H
+
+#include "le_fft.h"
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+  int frame_size; // Analysis frame / FFT size (power of 2)
+  int hop;        // Frame advance (oversampling = frame_size / hop)
+  int synth_len;  // Synthesis window length: multiple of hop, >= 2 * hop,
+                  // <= frame_size. Group delay = synth_len - hop.
+} LdfbConfig;
+
+/**
+ * Per-frame spectral processing callback.
+ * @param re       Real parts of bins 0..num_bins-1 (modify in place)
+ * @param im       Imaginary parts of bins 0..num_bins-1 (modify in place)
+ * @param num_bins frame_size / 2 + 1
+ * @param user     User pointer passed to ldfb_process
+ */
+typedef void (*LdfbBandFn)(float *re, float *im, int num_bins, void *user);
+
+typedef struct {
+  int K;  // Frame size
+  int R;  // Hop
+  int Ls; // Synthesis window length
+  int nb; // Bins (K/2 + 1)
+
+  LeRfftPlan plan;
+
+  // Arrays (pointers into provided memory)
+  float *win_a;  // [K] Analysis window
+  float *win_s;  // [Ls] Synthesis window (applies to the last Ls samples)
+  float *in_buf; // [K] Last K input samples
+  float *ola;    // [Ls] Overlap-add accumulator
+  float *time;   // [K] Frame scratch
+  float *re;     // [nb] Spectrum
+  float *im;     // [nb]
+} LdfbState;
+
+/**
+ * Memory required by ldfb_init.
+ * @return Size in bytes, or 0 if the configuration is invalid
+ */
+size_t ldfb_mem_bytes(const LdfbConfig *cfg);
+
+/**
+ * Initialize filterbank state.
+ * @param st: State structure
+ * @param cfg: Frame, hop and synthesis window length
+ * @param mem: Memory buffer provided by caller
+ * @param mem_size: Size of memory buffer in bytes
+ * @return 0 on success, -1 on invalid config or insufficient memory
+ */
+int ldfb_init(LdfbState *st, const LdfbConfig *cfg, void *mem,
+              size_t mem_size);
+
+/**
+ * Clear input history and overlap-add state.
+ */
+void ldfb_reset(LdfbState *st);
+
+/**
+ * Exact input-to-output group delay in samples (synth_len - hop).
+ */
+int ldfb_group_delay(const LdfbState *st);
+
+/**
+ * Analyze, call band_fn once per hop, and resynthesize.
+ * @param st: State structure
+ * @param in: Input block [frames]
+ * @param out: Output block [frames] (may alias in)
+ * @param frames: Block length, a multiple of the hop
+ * @param band_fn: Spectral callback, or NULL for pass-through
+ * @param user: Passed to band_fn
+ * @return 0 on success, -1 if frames is not a multiple of the hop
+ */
+int ldfb_process(LdfbState *st, const float *in, float *out, int frames,
+                 LdfbBandFn band_fn, void *user);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LOWDELAY_FB_H
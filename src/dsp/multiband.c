@@ -1,13 +1,29 @@
 #include "multiband.h"
 
 void multiband_init(MultibandState *st, float sample_rate) {
+  biquad_bank_init(&st->bank, MULTIBAND_NUM_BANDS, MULTIBAND_STAGES,
+                   st->bank_mem, sizeof(st->bank_mem));
+  st->tree_state = 0;
+
   // Crossover frequencies: 300Hz, 1000Hz, 4000Hz
-  biquad_lowpass(&st->lp1, sample_rate, 300.0f);
-  biquad_highpass(&st->hp1, sample_rate, 300.0f);
-  biquad_lowpass(&st->lp2, sample_rate, 1000.0f);
-  biquad_highpass(&st->hp2, sample_rate, 1000.0f);
-  biquad_lowpass(&st->lp3, sample_rate, 4000.0f);
-  biquad_highpass(&st->hp3, sample_rate, 4000.0f);
+  BiquadState lp1, hp1, lp2, hp2, lp3, hp3;
+  biquad_lowpass(&lp1, sample_rate, 300.0f);
+  biquad_highpass(&hp1, sample_rate, 300.0f);
+  biquad_lowpass(&lp2, sample_rate, 1000.0f);
+  biquad_highpass(&hp2, sample_rate, 1000.0f);
+  biquad_lowpass(&lp3, sample_rate, 4000.0f);
+  biquad_highpass(&hp3, sample_rate, 4000.0f);
+
+  // Unset sections pass through
+  biquad_bank_set(&st->bank, 0, BAND_LOW, &lp1);
+  biquad_bank_set(&st->bank, 0, BAND_VOICE_LOW, &hp1);
+  biquad_bank_set(&st->bank, 1, BAND_VOICE_LOW, &lp2);
+  biquad_bank_set(&st->bank, 0, BAND_VOICE_HIGH, &hp1);
+  biquad_bank_set(&st->bank, 1, BAND_VOICE_HIGH, &hp2);
+  biquad_bank_set(&st->bank, 2, BAND_VOICE_HIGH, &lp3);
+  biquad_bank_set(&st->bank, 0, BAND_HIGH, &hp1);
+  biquad_bank_set(&st->bank, 1, BAND_HIGH, &hp2);
+  biquad_bank_set(&st->bank, 2, BAND_HIGH, &hp3);
 
   // Default: voice enhancement preset
   multiband_preset_voice_enhance(st);
@@ -27,32 +43,100 @@ void multiband_set_gains(MultibandState *st, float g_low, float g_voice_low,
   st->gains[BAND_HIGH] = g_high;
 }
 
+// Apply gains and sum
+static inline float multiband_mix(const MultibandState *st, const float *b) {
+  return b[BAND_LOW] * st->gains[BAND_LOW] +
+         b[BAND_VOICE_LOW] * st->gains[BAND_VOICE_LOW] +
+         b[BAND_VOICE_HIGH] * st->gains[BAND_VOICE_HIGH] +
+         b[BAND_HIGH] * st->gains[BAND_HIGH];
+}
+
+// Row length of the bank (a constant, so sections are fixed offsets)
+#define MB_STRIDE BIQUAD_BANK_STRIDE(MULTIBAND_NUM_BANDS)
+
+// One section of the bank on its own state (the arithmetic of
+// biquad_process)
+static inline float multiband_section(BiquadBank *bk, int stage, int lane,
+                                      float x) {
+  const int S = MB_STRIDE;
+  const float *c = bk->coef + stage * 5 * S + lane;
+  float *z = bk->z + stage * 2 * S + lane;
+  float y = c[0] * x + z[0];
+  z[0] = c[S] * x - c[3 * S] * y + z[S];
+  z[S] = c[2 * S] * x - c[4 * S] * y;
+  return y;
+}
+
+// Copy the state of a section shared by several bands
+static inline void multiband_share(BiquadBank *bk, int stage, int from,
+                                   int to) {
+  float *z = bk->z + stage * 2 * bk->stride;
+  z[to] = z[from];
+  z[bk->stride + to] = z[bk->stride + from];
+}
+
+// Point the bank at this struct's own memory (the struct may have been
+// copied since init)
+static inline BiquadBank *multiband_bank(MultibandState *st) {
+  BiquadBank *bk = &st->bank;
+  bk->coef = st->bank_mem;
+  bk->z = st->bank_mem + 5 * MULTIBAND_STAGES * MB_STRIDE;
+  return bk;
+}
+
+// After per-sample calls: hand the shared sections' state to every band
+static void multiband_sync(MultibandState *st) {
+  BiquadBank *bk = &st->bank;
+  multiband_share(bk, 0, BAND_VOICE_LOW, BAND_VOICE_HIGH);
+  multiband_share(bk, 0, BAND_VOICE_LOW, BAND_HIGH);
+  multiband_share(bk, 1, BAND_VOICE_HIGH, BAND_HIGH);
+  st->tree_state = 0;
+}
+
 float multiband_process(MultibandState *st, float in) {
-  // Band splitting using Linkwitz-Riley style (LP + HP = original)
+  // Band splitting using Linkwitz-Riley style (LP + HP = original). One
+  // sample is too little work for the lanes: walk the crossover tree
+  // instead, running each shared section once on the state of the first
+  // band that uses it (the next block copies it to the others).
+  BiquadBank *bk = multiband_bank(st);
+  st->tree_state = 1;
+  float b[MULTIBAND_NUM_BANDS];
+
   // Band 0: Low (< 300 Hz)
-  float low = biquad_process(&st->lp1, in);
+  b[BAND_LOW] = multiband_section(bk, 0, BAND_LOW, in);
 
   // Remaining signal (> 300 Hz)
-  float mid_high = biquad_process(&st->hp1, in);
+  float mid_high = multiband_section(bk, 0, BAND_VOICE_LOW, in);
 
   // Band 1: Voice Low (300-1000 Hz)
-  float voice_low = biquad_process(&st->lp2, mid_high);
+  b[BAND_VOICE_LOW] = multiband_section(bk, 1, BAND_VOICE_LOW, mid_high);
 
   // Remaining (> 1000 Hz)
-  float high_part = biquad_process(&st->hp2, mid_high);
+  float high_part = multiband_section(bk, 1, BAND_VOICE_HIGH, mid_high);
 
-  // Band 2: Voice High (1000-4000 Hz)
-  float voice_high = biquad_process(&st->lp3, high_part);
+  // Band 2: Voice High (1000-4000 Hz), Band 3: High (> 4000 Hz)
+  b[BAND_VOICE_HIGH] = multiband_section(bk, 2, BAND_VOICE_HIGH, high_part);
+  b[BAND_HIGH] = multiband_section(bk, 2, BAND_HIGH, high_part);
 
-  // Band 3: High (> 4000 Hz)
-  float high = biquad_process(&st->hp3, high_part);
+  return multiband_mix(st, b);
+}
 
-  // Apply gains and sum
-  float out =
-      low * st->gains[BAND_LOW] + voice_low * st->gains[BAND_VOICE_LOW] +
-      voice_high * st->gains[BAND_VOICE_HIGH] + high * st->gains[BAND_HIGH];
+#define MULTIBAND_CHUNK 64
 
-  return out;
+void multiband_process_block(MultibandState *st, const float *in, float *out,
+                             int frames) {
+  float bands[MULTIBAND_CHUNK * MULTIBAND_NUM_BANDS];
+  multiband_bank(st);
+  if (st->tree_state)
+    multiband_sync(st);
+  for (int base = 0; base < frames; base += MULTIBAND_CHUNK) {
+    int n = frames - base;
+    if (n > MULTIBAND_CHUNK)
+      n = MULTIBAND_CHUNK;
+    biquad_bank_process(&st->bank, in + base, 0, bands, n);
+    for (int i = 0; i < n; i++)
+      out[base + i] = multiband_mix(st, &bands[i * MULTIBAND_NUM_BANDS]);
+  }
 }
 
 void multiband_preset_voice_enhance(MultibandState *st) {
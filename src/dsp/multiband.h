@@ -15,14 +15,23 @@ extern "C" {
 #define BAND_VOICE_HIGH 2 // 1000-4000 Hz (voice clarity)
 #define BAND_HIGH 3       // > 4000 Hz
 
+// Stages of the band cascades (the crossover tree flattened per band)
+#define MULTIBAND_STAGES 3
+
 typedef struct {
-  // Crossover filters (LP/HP pairs for band splitting)
-  BiquadState lp1; // 300 Hz lowpass
-  BiquadState hp1; // 300 Hz highpass
-  BiquadState lp2; // 1000 Hz lowpass
-  BiquadState hp2; // 1000 Hz highpass
-  BiquadState lp3; // 4000 Hz lowpass
-  BiquadState hp3; // 4000 Hz highpass
+  // One lane per band, all fed the same input (crossovers at 300, 1000 and
+  // 4000 Hz, LP/HP pairs; pass-through sections pad the shorter paths):
+  //   low:        lp300
+  //   voice low:  hp300 -> lp1000
+  //   voice high: hp300 -> hp1000 -> lp4000
+  //   high:       hp300 -> hp1000 -> hp4000
+  // The bank points into bank_mem and is rebound on every process call, so
+  // a copy of the struct is an independent snapshot of the filter state.
+  BiquadBank bank;
+  float bank_mem[BIQUAD_BANK_FLOATS(MULTIBAND_NUM_BANDS, MULTIBAND_STAGES)];
+  // Set by per-sample calls: a section shared by several bands (hp300,
+  // hp1000) only has its state in the first band's lane
+  int tree_state;
 
   // Per-band gains (linear, 0-2.0)
   float gains[MULTIBAND_NUM_BANDS];
@@ -41,6 +50,12 @@ void multiband_set_gains(MultibandState *st, float g_low, float g_voice_low,
 // Process one sample (O(1), ~30 cycles)
 float multiband_process(MultibandState *st, float in);
 
+// Process a block (out may alias in), all bands in one pass of the bank.
+// Same output as per-sample calls (to rounding with the FMA kernels), and
+// the two may be mixed.
+void multiband_process_block(MultibandState *st, const float *in, float *out,
+                             int frames);
+
 // Preset configurations
 void multiband_preset_voice_enhance(MultibandState *st); // Boost voice bands
 void multiband_preset_flat(MultibandState *st);          // All unity
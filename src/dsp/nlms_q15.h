@@ -0,0 +1,59 @@
+/**
+ * @file nlms_q15.h
+ * @brief Internal: Q15/Q31 NLMS loops shared by the fixed-point GSC and AEC
+ *
+ * Mixed precision: the adaptive weights are kept in Q31 so the leak and the
+ * small NLMS corrections are not lost to rounding, and mirrored into Q15
+ * copies that the filter reads (two taps per SMLAD on Cortex-M4, see
+ * optimize_arm.h). Signals are Q15, powers Q30 in 64 bits.
+ */
+
+#ifndef NLMS_Q15_H
+#define NLMS_Q15_H
+
+#include "fixed_point.h"
+#include "optimize_arm.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Fractional bits of the NLMS step (range +-8: the step mu * e / power is
+// not bounded by 1 when the window is nearly silent)
+#define NLMS_Q15_STEP_FRAC 28
+
+// sum w[k] * x[k] over [0, n) in Q30
+static inline int64_t nlms_q15_dot(const q15_t *w, const q15_t *x, int n) {
+  int64_t acc = 0;
+  int k = 0;
+  for (; k + 4 <= n; k += 4)
+    acc += dot4_q15_simd(&w[k], &x[k]);
+  for (; k < n; k++)
+    acc += (int32_t)w[k] * x[k];
+  return acc;
+}
+
+// mu * e / (power + eps) in Q28 (mu: Q31, e: Q15, power and eps: Q30)
+static inline q31_t nlms_q15_step(q31_t mu, q15_t e, int64_t power,
+                                  int64_t eps) {
+  int64_t num = (int64_t)mu * e; // Q46
+  return q31_sat(num * ((int64_t)1 << (58 - 46)) / (power + eps));
+}
+
+// w = leak * w + step * x, then refresh the Q15 copy
+// (w: Q31, leak: Q31, Q31_MAX: no leak, step: Q28, x: Q15)
+static inline void nlms_q15_update(q31_t *w, q15_t *w_q15, const q15_t *x,
+                                   int n, q31_t leak, q31_t step) {
+  const int shift = NLMS_Q15_STEP_FRAC + 15 - 31;
+  for (int k = 0; k < n; k++) {
+    int64_t v = (leak == Q31_MAX) ? w[k] : ((int64_t)leak * w[k]) >> 31;
+    w[k] = q31_sat(v + (((int64_t)step * x[k]) >> shift));
+    w_q15[k] = q15_sat((int32_t)q_round_shift(w[k], 16));
+  }
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NLMS_Q15_H
@@ -2,122 +2,38 @@
  * @file phase_align.c
  * @brief GCC-PHAT phase alignment implementation
  *
- * Uses a simple radix-2 FFT for cross-correlation computation.
+ * Uses the shared le_fft real FFT for cross-correlation computation.
  * Optimized for low-latency real-time processing.
  */
 
 #include "phase_align.h"
-#include "fast_math.h"
+#include "le_fft.h"
 #include <math.h>
 #include <stdlib.h>
 #include <string.h>
 
-#ifndef M_PI
-#define M_PI 3.14159265358979323846
-#endif
-
-// Maximum supported FFT size
-#define MAX_FFT_SIZE 2048
+// Maximum supported FFT size (latency measurement needs long windows)
+#define MAX_FFT_SIZE 32768
 
 struct PhaseAligner {
   int fft_size;
   int sample_rate;
   int num_channels;
 
-  // FFT buffers (real/imag interleaved)
+  // Half-spectrum buffers (real [n/2+1] followed by imag [n/2+1])
   float *fft_ref;     // Reference channel FFT
-  float *fft_target;  // Target channel FFT
-  float *fft_scratch; // Scratch buffer for IFFT result
+  float *fft_target;  // Target channel FFT / cross-spectrum
+  float *fft_scratch; // Time-domain buffer [n]: padded input, IFFT result
 
   // Smoothed offset estimates
   float *offsets;
   float alpha; // Smoothing factor
 
-  // Twiddle factors (precomputed)
-  float *twiddle_real;
-  float *twiddle_imag;
+  // Real FFT plan (bit-reverse table + twiddles, precomputed)
+  LeRfftPlan plan;
+  void *plan_mem;
 };
 
-// ============================================================================
-// Simple in-place radix-2 FFT (Cooley-Tukey)
-// ============================================================================
-
-static void fft_init_twiddle(float *real, float *imag, int n) {
-  for (int i = 0; i < n / 2; i++) {
-    float angle = -2.0f * (float)M_PI * (float)i / (float)n;
-    real[i] = fast_cosf(angle);
-    imag[i] = fast_sinf(angle);
-  }
-}
-
-static int bit_reverse(int x, int bits) {
-  int result = 0;
-  for (int i = 0; i < bits; i++) {
-    result = (result << 1) | (x & 1);
-    x >>= 1;
-  }
-  return result;
-}
-
-static void fft_reorder(float *data_r, float *data_i, int n) {
-  int bits = 0;
-  int temp = n;
-  while (temp > 1) {
-    bits++;
-    temp >>= 1;
-  }
-
-  for (int i = 0; i < n; i++) {
-    int j = bit_reverse(i, bits);
-    if (j > i) {
-      float tr = data_r[i];
-      float ti = data_i[i];
-      data_r[i] = data_r[j];
-      data_i[i] = data_i[j];
-      data_r[j] = tr;
-      data_i[j] = ti;
-    }
-  }
-}
-
-static void fft_compute(float *data_r, float *data_i, int n, const float *tw_r,
-                        const float *tw_i, int inverse) {
-  fft_reorder(data_r, data_i, n);
-
-  for (int size = 2; size <= n; size *= 2) {
-    int half = size / 2;
-    int step = n / size;
-
-    for (int i = 0; i < n; i += size) {
-      for (int k = 0; k < half; k++) {
-        int tw_idx = k * step;
-        float wr = tw_r[tw_idx];
-        float wi = inverse ? -tw_i[tw_idx] : tw_i[tw_idx];
-
-        int idx0 = i + k;
-        int idx1 = i + k + half;
-
-        float tr = data_r[idx1] * wr - data_i[idx1] * wi;
-        float ti = data_r[idx1] * wi + data_i[idx1] * wr;
-
-        data_r[idx1] = data_r[idx0] - tr;
-        data_i[idx1] = data_i[idx0] - ti;
-        data_r[idx0] = data_r[idx0] + tr;
-        data_i[idx0] = data_i[idx0] + ti;
-      }
-    }
-  }
-
-  // Normalize for inverse FFT
-  if (inverse) {
-    float scale = 1.0f / (float)n;
-    for (int i = 0; i < n; i++) {
-      data_r[i] *= scale;
-      data_i[i] *= scale;
-    }
-  }
-}
-
 // ============================================================================
 // Phase Aligner Implementation
 // ============================================================================
@@ -143,21 +59,25 @@ PhaseAligner *phase_align_create(int fft_size, int sample_rate,
   pa->alpha = 0.1f;
 
   // Allocate buffers
-  pa->fft_ref = (float *)calloc(fft_size * 2, sizeof(float)); // real + imag
-  pa->fft_target = (float *)calloc(fft_size * 2, sizeof(float));
-  pa->fft_scratch = (float *)calloc(fft_size * 2, sizeof(float));
+  int nb = fft_size / 2 + 1;
+  pa->fft_ref = (float *)calloc(nb * 2, sizeof(float)); // real + imag
+  pa->fft_target = (float *)calloc(nb * 2, sizeof(float));
+  pa->fft_scratch = (float *)calloc(fft_size, sizeof(float));
   pa->offsets = (float *)calloc(num_channels - 1, sizeof(float));
-  pa->twiddle_real = (float *)calloc(fft_size / 2, sizeof(float));
-  pa->twiddle_imag = (float *)calloc(fft_size / 2, sizeof(float));
+  size_t plan_bytes = le_rfft_plan_bytes(fft_size);
+  pa->plan_mem = calloc(1, plan_bytes);
 
   if (!pa->fft_ref || !pa->fft_target || !pa->fft_scratch || !pa->offsets ||
-      !pa->twiddle_real || !pa->twiddle_imag) {
+      !pa->plan_mem) {
     phase_align_destroy(pa);
     return NULL;
   }
 
-  // Initialize twiddle factors
-  fft_init_twiddle(pa->twiddle_real, pa->twiddle_imag, fft_size);
+  // Initialize FFT plan (bit-reverse table + twiddle factors)
+  if (le_rfft_plan_init(&pa->plan, fft_size, pa->plan_mem, plan_bytes) != 0) {
+    phase_align_destroy(pa);
+    return NULL;
+  }
 
   return pa;
 }
@@ -168,8 +88,7 @@ void phase_align_destroy(PhaseAligner *pa) {
     free(pa->fft_target);
     free(pa->fft_scratch);
     free(pa->offsets);
-    free(pa->twiddle_real);
-    free(pa->twiddle_imag);
+    free(pa->plan_mem);
     free(pa);
   }
 }
@@ -188,48 +107,44 @@ void phase_align_estimate(PhaseAligner *pa, const float *const *channels,
   int n = pa->fft_size;
   int samples_to_use = (num_samples < n) ? num_samples : n;
 
-  // Separate real/imag arrays for FFT
+  // Separate real/imag arrays for the half spectra
+  int nb = n / 2 + 1;
   float *ref_r = pa->fft_ref;
-  float *ref_i = pa->fft_ref + n;
+  float *ref_i = pa->fft_ref + nb;
   float *tgt_r = pa->fft_target;
-  float *tgt_i = pa->fft_target + n;
+  float *tgt_i = pa->fft_target + nb;
   float *corr_r = pa->fft_scratch;
-  float *corr_i = pa->fft_scratch + n;
-
-  // Copy and zero-pad reference channel
-  memset(ref_r, 0, n * sizeof(float));
-  memset(ref_i, 0, n * sizeof(float));
-  memcpy(ref_r, channels[0], samples_to_use * sizeof(float));
 
-  // FFT of reference
-  fft_compute(ref_r, ref_i, n, pa->twiddle_real, pa->twiddle_imag, 0);
+  // Copy and zero-pad reference channel, then FFT
+  memset(corr_r, 0, n * sizeof(float));
+  memcpy(corr_r, channels[0], samples_to_use * sizeof(float));
+  le_rfft_forward(&pa->plan, corr_r, ref_r, ref_i);
 
   // Process each target channel
   for (int ch = 1; ch < pa->num_channels; ch++) {
-    // Copy and zero-pad target channel
-    memset(tgt_r, 0, n * sizeof(float));
-    memset(tgt_i, 0, n * sizeof(float));
-    memcpy(tgt_r, channels[ch], samples_to_use * sizeof(float));
-
-    // FFT of target
-    fft_compute(tgt_r, tgt_i, n, pa->twiddle_real, pa->twiddle_imag, 0);
-
-    // GCC-PHAT: G(f) = R(f) * conj(T(f)) / |R * conj(T)|
-    for (int i = 0; i < n; i++) {
-      // Cross-spectrum: R * conj(T)
+    // Copy and zero-pad target channel, then FFT
+    memset(corr_r, 0, n * sizeof(float));
+    memcpy(corr_r, channels[ch], samples_to_use * sizeof(float));
+    le_rfft_forward(&pa->plan, corr_r, tgt_r, tgt_i);
+
+    // GCC-PHAT: G(f) = conj(R(f)) * T(f) / |conj(R) * T|
+    // (computed in place over the target spectrum). The correlation peaks
+    // at +d for a target delayed by d samples.
+    for (int i = 0; i < nb; i++) {
+      // Cross-spectrum: conj(R) * T
       float xr = ref_r[i] * tgt_r[i] + ref_i[i] * tgt_i[i];
-      float xi = ref_i[i] * tgt_r[i] - ref_r[i] * tgt_i[i];
+      float xi = ref_r[i] * tgt_i[i] - ref_i[i] * tgt_r[i];
 
       // Magnitude for PHAT normalization
       float mag = sqrtf(xr * xr + xi * xi) + 1e-10f;
 
       // Normalize (PHAT weighting)
-      corr_r[i] = xr / mag;
-      corr_i[i] = xi / mag;
+      tgt_r[i] = xr / mag;
+      tgt_i[i] = xi / mag;
     }
 
     // IFFT to get cross-correlation
-    fft_compute(corr_r, corr_i, n, pa->twiddle_real, pa->twiddle_imag, 1);
+    le_rfft_inverse(&pa->plan, tgt_r, tgt_i, corr_r);
 
     // Find peak in correlation
     float max_val = corr_r[0];
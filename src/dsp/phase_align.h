@@ -18,7 +18,8 @@ typedef struct PhaseAligner PhaseAligner;
 /**
  * Create a phase aligner instance.
  *
- * @param fft_size    FFT size for cross-correlation (e.g., 256, 512, 1024)
+ * @param fft_size    FFT size for cross-correlation (e.g., 256, 512, 1024;
+ *                    power of 2 up to 32768)
  * @param sample_rate Sample rate in Hz
  * @param num_channels Number of channels to align (including reference)
  * @return Pointer to PhaseAligner or NULL on failure
@@ -8,10 +8,13 @@
  * - Single producer, single consumer (SPSC)
  * - Cache-line aligned to avoid false sharing
  * - Power-of-2 sizing for fast modulo
+ * - RecordRing: fixed-size records with atomic positions, safe across threads
  */
 
+#include "../utils/atomic_compat.h"
 #include <stddef.h>
 #include <stdint.h>
+#include <string.h>
 
 
 #ifdef __cplusplus
@@ -144,6 +147,107 @@ static inline size_t ring_buffer_4ch_read_available(const RingBuffer4Ch *rb) {
   return min;
 }
 
+// ============================================================================
+// Record Ring (fixed-size records, producer and consumer on different threads)
+// ============================================================================
+
+// Positions are free-running counters published with release stores and
+// read with acquire loads, so a record is fully written before the consumer
+// can see it. Neither side ever blocks; a full ring rejects the new record.
+typedef struct {
+  unsigned char *buffer; // capacity * record_size bytes
+  size_t record_size;
+  unsigned int capacity; // Records, must be power of 2
+  unsigned int mask;     // capacity - 1
+
+  // Separate cache lines for producer and consumer
+  CACHE_ALIGNED le_atomic_int write_pos;
+  CACHE_ALIGNED le_atomic_int read_pos;
+} RecordRing;
+
+static inline int record_ring_init(RecordRing *rr, void *buffer,
+                                   size_t record_size, unsigned int capacity) {
+  if (capacity == 0 || (capacity & (capacity - 1)) != 0 || record_size == 0)
+    return -1;
+
+  rr->buffer = (unsigned char *)buffer;
+  rr->record_size = record_size;
+  rr->capacity = capacity;
+  rr->mask = capacity - 1;
+  le_atomic_store(&rr->write_pos, 0);
+  le_atomic_store(&rr->read_pos, 0);
+  return 0;
+}
+
+// Records waiting to be read (either side)
+static inline unsigned int record_ring_read_available(RecordRing *rr) {
+  return (unsigned int)le_atomic_load(&rr->write_pos) -
+         (unsigned int)le_atomic_load(&rr->read_pos);
+}
+
+// Producer: copy one record in. Returns 0, or -1 if the ring is full.
+static inline int record_ring_push(RecordRing *rr, const void *record) {
+  unsigned int w = (unsigned int)le_atomic_load(&rr->write_pos);
+  unsigned int r = (unsigned int)le_atomic_load(&rr->read_pos);
+  if (w - r >= rr->capacity)
+    return -1;
+  memcpy(rr->buffer + (size_t)(w & rr->mask) * rr->record_size, record,
+         rr->record_size);
+  le_atomic_store(&rr->write_pos, (int)(w + 1u));
+  return 0;
+}
+
+// Producer, zero-copy: pointer to the next free record, or NULL if the ring
+// is full. Fill it in place, then call record_ring_commit.
+static inline void *record_ring_reserve(RecordRing *rr) {
+  unsigned int w = (unsigned int)le_atomic_load(&rr->write_pos);
+  unsigned int r = (unsigned int)le_atomic_load(&rr->read_pos);
+  if (w - r >= rr->capacity)
+    return NULL;
+  return rr->buffer + (size_t)(w & rr->mask) * rr->record_size;
+}
+
+// Producer: publish the record returned by record_ring_reserve
+static inline void record_ring_commit(RecordRing *rr) {
+  unsigned int w = (unsigned int)le_atomic_load(&rr->write_pos);
+  le_atomic_store(&rr->write_pos, (int)(w + 1u));
+}
+
+// Consumer, zero-copy: pointer to the oldest record, or NULL if empty.
+// Valid until record_ring_release.
+static inline const void *record_ring_peek(RecordRing *rr) {
+  unsigned int r = (unsigned int)le_atomic_load(&rr->read_pos);
+  unsigned int w = (unsigned int)le_atomic_load(&rr->write_pos);
+  if (w == r)
+    return NULL;
+  return rr->buffer + (size_t)(r & rr->mask) * rr->record_size;
+}
+
+// Consumer: hand the record returned by record_ring_peek back to the producer
+static inline void record_ring_release(RecordRing *rr) {
+  unsigned int r = (unsigned int)le_atomic_load(&rr->read_pos);
+  le_atomic_store(&rr->read_pos, (int)(r + 1u));
+}
+
+// Consumer: copy up to max_records out. Returns the number read.
+static inline unsigned int record_ring_pop_batch(RecordRing *rr, void *out,
+                                                 unsigned int max_records) {
+  unsigned int r = (unsigned int)le_atomic_load(&rr->read_pos);
+  unsigned int w = (unsigned int)le_atomic_load(&rr->write_pos);
+  unsigned int count = w - r;
+  if (count > max_records)
+    count = max_records;
+
+  unsigned char *dst = (unsigned char *)out;
+  for (unsigned int i = 0; i < count; i++) {
+    memcpy(dst + (size_t)i * rr->record_size,
+           rr->buffer + (size_t)((r + i) & rr->mask) * rr->record_size,
+           rr->record_size);
+  }
+  le_atomic_store(&rr->read_pos, (int)(r + count));
+  return count;
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,262 @@
+/**
+ * @file scope_tap.c
+ * @brief Spectrum / waveform tap for the web UI
+ */
+
+#include "scope_tap.h"
+#include <math.h>
+#include <string.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+static int scope_valid(const ScopeConfig *cfg) {
+  if (!cfg || le_rfft_plan_bytes(cfg->fft_size) == 0 || cfg->fft_size < 16)
+    return 0;
+  return cfg->rate_hz > 0 && cfg->wave_points > 0 &&
+         cfg->wave_points <= cfg->fft_size / 2;
+}
+
+static size_t scope_float_count(const ScopeConfig *cfg) {
+  size_t K = (size_t)cfg->fft_size;
+  size_t nb = K / 2 + 1;
+  // win[K] + hist[C*K] + psd[C*nb] + time[K] + re/im[2*nb]
+  return 2 * K + SCOPE_CHANNELS * (K + nb) + 2 * nb;
+}
+
+size_t scope_tap_mem_bytes(const ScopeConfig *cfg) {
+  if (!scope_valid(cfg))
+    return 0;
+  return SCOPE_RING_BLOCKS * sizeof(ScopeBlock) +
+         le_rfft_plan_bytes(cfg->fft_size) +
+         scope_float_count(cfg) * sizeof(float);
+}
+
+int scope_tap_init(ScopeTap *st, const ScopeConfig *cfg, int sample_rate,
+                   void *mem, size_t mem_size) {
+  if (!st || !mem || !scope_valid(cfg) || sample_rate <= 0)
+    return -1;
+  if (mem_size < scope_tap_mem_bytes(cfg))
+    return -1;
+
+  int K = cfg->fft_size;
+  st->K = K;
+  st->nb = K / 2 + 1;
+  st->hop = K / 2;
+  st->wave_points = cfg->wave_points;
+  st->sample_rate = sample_rate;
+  st->interval = sample_rate / cfg->rate_hz;
+  if (st->interval < 1)
+    st->interval = 1;
+
+  char *p = (char *)mem;
+  st->blocks = (ScopeBlock *)p;
+  p += SCOPE_RING_BLOCKS * sizeof(ScopeBlock);
+  record_ring_init(&st->ring, st->blocks, sizeof(ScopeBlock),
+                   SCOPE_RING_BLOCKS);
+
+  size_t plan_bytes = le_rfft_plan_bytes(K);
+  if (le_rfft_plan_init(&st->plan, K, p, plan_bytes) != 0)
+    return -1;
+  p += plan_bytes;
+
+  float *f = (float *)p;
+  st->win = f;
+  f += K;
+  st->hist = f;
+  f += SCOPE_CHANNELS * K;
+  st->psd = f;
+  f += SCOPE_CHANNELS * st->nb;
+  st->time = f;
+  f += K;
+  st->re = f;
+  f += st->nb;
+  st->im = f;
+
+  double wsum = 0.0;
+  for (int n = 0; n < K; n++) {
+    st->win[n] = (float)(0.5 - 0.5 * cos(2.0 * M_PI * (double)n / (double)K));
+    wsum += st->win[n];
+  }
+  // A full-scale sine peaks at |X| = sum(w) / 2
+  st->norm = (float)(4.0 / (wsum * wsum));
+
+  memset(st->hist, 0, (size_t)SCOPE_CHANNELS * K * sizeof(float));
+  memset(st->psd, 0, (size_t)SCOPE_CHANNELS * st->nb * sizeof(float));
+  st->pos = 0;
+  st->since_frame = 0;
+  st->num_avg = 0;
+  return 0;
+}
+
+void scope_tap_push(ScopeTap *st, const float *in, const float *out,
+                    int frames, float beta) {
+  while (frames > 0) {
+    int n = frames < SCOPE_BLOCK_MAX ? frames : SCOPE_BLOCK_MAX;
+    ScopeBlock *blk = (ScopeBlock *)record_ring_reserve(&st->ring);
+    if (!blk)
+      return; // Consumer is behind: drop
+    blk->frames = (uint32_t)n;
+    blk->beta = beta;
+    memcpy(blk->in, in, (size_t)n * 3 * sizeof(float));
+    memcpy(blk->out, out, (size_t)n * sizeof(float));
+    record_ring_commit(&st->ring);
+    in += n * 3;
+    out += n;
+    frames -= n;
+  }
+}
+
+// Accumulate one Hann-windowed power spectrum per channel
+static void scope_analyze(ScopeTap *st) {
+  const int K = st->K;
+  const int nb = st->nb;
+  for (int ch = 0; ch < SCOPE_CHANNELS; ch++) {
+    const float *h = st->hist + ch * K;
+    for (int n = 0; n < K; n++)
+      st->time[n] = h[n] * st->win[n];
+    le_rfft_forward(&st->plan, st->time, st->re, st->im);
+    float *psd = st->psd + ch * nb;
+    for (int k = 0; k < nb; k++)
+      psd[k] += st->re[k] * st->re[k] + st->im[k] * st->im[k];
+  }
+  st->num_avg++;
+}
+
+static void scope_consume(ScopeTap *st, const ScopeBlock *blk) {
+  const int K = st->K;
+  const int hop = st->hop;
+  const float beta = blk->beta;
+
+  for (uint32_t i = 0; i < blk->frames; i++) {
+    float xL = blk->in[i * 3 + 0];
+    float xR = blk->in[i * 3 + 1];
+    float xB = blk->in[i * 3 + 2];
+    float v[SCOPE_CHANNELS] = {xL, xR, xB, blk->out[i], xL - xR,
+                               0.5f * (xL + xR) - beta * xB};
+    int idx = K - hop + st->pos;
+    for (int ch = 0; ch < SCOPE_CHANNELS; ch++)
+      st->hist[ch * K + idx] = v[ch];
+
+    if (++st->pos == hop) {
+      scope_analyze(st);
+      for (int ch = 0; ch < SCOPE_CHANNELS; ch++) {
+        float *h = st->hist + ch * K;
+        memmove(h, h + hop, (size_t)(K - hop) * sizeof(float));
+      }
+      st->pos = 0;
+    }
+  }
+  st->since_frame += (int)blk->frames;
+}
+
+static uint8_t *put_u16(uint8_t *p, uint32_t v) {
+  p[0] = (uint8_t)(v & 0xFF);
+  p[1] = (uint8_t)((v >> 8) & 0xFF);
+  return p + 2;
+}
+
+static uint8_t *put_u32(uint8_t *p, uint32_t v) {
+  p = put_u16(p, v & 0xFFFF);
+  return put_u16(p, v >> 16);
+}
+
+static uint8_t *put_f32(uint8_t *p, float f) {
+  uint32_t v;
+  memcpy(&v, &f, sizeof(v));
+  return put_u32(p, v);
+}
+
+// IEEE 754 binary16, round to nearest; overflow saturates to infinity
+static uint16_t float_to_half(float f) {
+  uint32_t x;
+  memcpy(&x, &f, sizeof(x));
+  uint32_t sign = (x >> 16) & 0x8000u;
+  int32_t exp = (int32_t)((x >> 23) & 0xFF) - 127 + 15;
+  uint32_t mant = x & 0x7FFFFFu;
+
+  if (exp <= 0) { // Subnormal or zero
+    if (exp < -10)
+      return (uint16_t)sign;
+    mant |= 0x800000u;
+    int shift = 14 - exp;
+    return (uint16_t)(sign | ((mant + (1u << (shift - 1))) >> shift));
+  }
+  if (exp >= 31)
+    return (uint16_t)(sign | 0x7C00u);
+  uint32_t h = sign | ((uint32_t)exp << 10) | (mant >> 13);
+  if (mant & 0x1000u)
+    h++; // Carry into the exponent is the correct rounding
+  return (uint16_t)h;
+}
+
+size_t scope_tap_frame_bytes(const ScopeTap *st) {
+  return SCOPE_HEADER_BYTES + (size_t)SCOPE_CHANNELS * st->nb +
+         (size_t)SCOPE_CHANNELS * st->wave_points * 2;
+}
+
+static size_t scope_pack(ScopeTap *st, uint8_t *frame) {
+  const int K = st->K;
+  const int nb = st->nb;
+  const float db_range = SCOPE_DB_MAX - SCOPE_DB_MIN;
+  const float scale = st->norm / (float)st->num_avg;
+
+  uint8_t *p = frame;
+  p[0] = SCOPE_FRAME_KIND;
+  p[1] = SCOPE_FRAME_VERSION;
+  p[2] = SCOPE_CHANNELS;
+  p[3] = 0;
+  p = put_u16(p + 4, (uint32_t)nb);
+  p = put_u16(p, (uint32_t)st->wave_points);
+  p = put_u32(p, (uint32_t)st->sample_rate);
+  p = put_f32(p, SCOPE_DB_MIN);
+  p = put_f32(p, SCOPE_DB_MAX);
+
+  for (int ch = 0; ch < SCOPE_CHANNELS; ch++) {
+    float *psd = st->psd + ch * nb;
+    for (int k = 0; k < nb; k++) {
+      float db = 10.0f * log10f(psd[k] * scale + 1e-20f);
+      float q = (db - SCOPE_DB_MIN) / db_range * 255.0f;
+      q = q < 0.0f ? 0.0f : (q > 255.0f ? 255.0f : q);
+      *p++ = (uint8_t)(q + 0.5f);
+      psd[k] = 0.0f;
+    }
+  }
+  st->num_avg = 0;
+
+  // Waveform: the newest K - hop samples, one peak (signed) per bucket
+  int span = K - st->hop;
+  for (int ch = 0; ch < SCOPE_CHANNELS; ch++) {
+    const float *h = st->hist + ch * K + st->pos;
+    for (int w = 0; w < st->wave_points; w++) {
+      int a = w * span / st->wave_points;
+      int b = (w + 1) * span / st->wave_points;
+      float peak = h[a];
+      for (int n = a + 1; n < b; n++) {
+        if (fabsf(h[n]) > fabsf(peak))
+          peak = h[n];
+      }
+      p = put_u16(p, float_to_half(peak));
+    }
+  }
+  return (size_t)(p - frame);
+}
+
+size_t scope_tap_poll(ScopeTap *st, uint8_t *frame, size_t frame_size) {
+  const ScopeBlock *blk;
+  while ((blk = (const ScopeBlock *)record_ring_peek(&st->ring)) != NULL) {
+    scope_consume(st, blk);
+    record_ring_release(&st->ring);
+  }
+
+  if (st->since_frame < st->interval || st->num_avg == 0)
+    return 0;
+  if (frame_size < scope_tap_frame_bytes(st))
+    return 0;
+  // Keep the average rate exact; after a stall, restart the schedule
+  st->since_frame -= st->interval;
+  if (st->since_frame >= st->interval)
+    st->since_frame = 0;
+  return scope_pack(st, frame);
+}
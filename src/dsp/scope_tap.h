@@ -0,0 +1,122 @@
+/**
+ * @file scope_tap.h
+ * @brief Spectrum / waveform tap for the web UI
+ *
+ * The audio thread only copies its input and beamformer output into a
+ * lock-free ring (scope_tap_push). Another thread drains the ring, forms the
+ * blocking-matrix references, averages Hann-windowed spectra and packs a
+ * compact frame at the configured rate (scope_tap_poll):
+ *
+ *   u8 kind (SCOPE_FRAME_KIND), u8 version, u8 channels, u8 reserved,
+ *   u16 bins, u16 wave_points, u32 sample_rate, f32 db_min, f32 db_max,
+ *   u8 spectrum[channels][bins]   (0..255 linear in dB over db_min..db_max)
+ *   f16 waveform[channels][wave_points]
+ *
+ * All fields little-endian. Channel order: L, R, B, out, U1, U2 with
+ * U1 = L - R and U2 = (L + R) / 2 - beta * B, as in the GSC.
+ */
+
+#ifndef SCOPE_TAP_H
+#define SCOPE_TAP_H
+
+#include "le_fft.h"
+#include "ring_buffer.h"
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SCOPE_CHANNELS 6
+#define SCOPE_BLOCK_MAX 512 // Frames per ring record; longer pushes split
+#define SCOPE_RING_BLOCKS 16
+#define SCOPE_FRAME_KIND 3
+#define SCOPE_FRAME_VERSION 1
+#define SCOPE_HEADER_BYTES 20
+#define SCOPE_DB_MIN -100.0f
+#define SCOPE_DB_MAX 0.0f // Full-scale sine
+
+typedef struct {
+  int fft_size;    // Spectrum resolution (power of 2, e.g. 512)
+  int rate_hz;     // Frames per second sent to clients (e.g. 10)
+  int wave_points; // Decimated waveform points per channel (<= fft_size)
+} ScopeConfig;
+
+// One ring record: a block as the audio thread saw it
+typedef struct {
+  uint32_t frames;
+  float beta;
+  float in[SCOPE_BLOCK_MAX * 3]; // Interleaved [xL, xR, xB]
+  float out[SCOPE_BLOCK_MAX];
+} ScopeBlock;
+
+typedef struct {
+  int K;           // FFT size
+  int nb;          // Bins (K/2 + 1)
+  int hop;         // K/2 (50% overlap)
+  int wave_points;
+  int sample_rate;
+  int interval;    // Samples between output frames
+  int pos;         // New samples since the last spectrum
+  int since_frame; // Samples since the last output frame
+  int num_avg;     // Spectra accumulated into psd
+  float norm;      // |X|^2 -> power relative to a full-scale sine
+
+  RecordRing ring;
+  LeRfftPlan plan;
+
+  // Arrays (pointers into provided memory)
+  ScopeBlock *blocks; // [SCOPE_RING_BLOCKS] Ring storage
+  float *win;         // [K] Hann window
+  float *hist;        // [SCOPE_CHANNELS * K] Newest K samples per channel
+  float *psd;         // [SCOPE_CHANNELS * nb] Accumulated power
+  float *time;        // [K] Windowed frame
+  float *re;          // [nb]
+  float *im;          // [nb]
+} ScopeTap;
+
+/**
+ * Memory required by scope_tap_init.
+ * @return Size in bytes, or 0 if the configuration is invalid
+ */
+size_t scope_tap_mem_bytes(const ScopeConfig *cfg);
+
+/**
+ * Initialize the tap.
+ * @param st: State structure
+ * @param cfg: FFT size, frame rate and waveform length
+ * @param sample_rate: Audio sample rate in Hz
+ * @param mem: Memory buffer provided by caller
+ * @param mem_size: Size of memory buffer in bytes
+ * @return 0 on success, -1 on invalid config or insufficient memory
+ */
+int scope_tap_init(ScopeTap *st, const ScopeConfig *cfg, int sample_rate,
+                   void *mem, size_t mem_size);
+
+/**
+ * Audio thread: copy one block into the ring. Wait-free; blocks are dropped
+ * while the ring is full.
+ * @param in: Interleaved [xL, xR, xB] frames (frames * 3 floats)
+ * @param out: Beamformer output (frames floats)
+ * @param beta: Current GSC beta (for U2)
+ */
+void scope_tap_push(ScopeTap *st, const float *in, const float *out,
+                    int frames, float beta);
+
+/**
+ * Consumer thread: drain the ring and, when a frame is due, pack it.
+ * @return Bytes written to frame, or 0 if no frame is due yet
+ */
+size_t scope_tap_poll(ScopeTap *st, uint8_t *frame, size_t frame_size);
+
+/**
+ * Size of a packed frame for this tap.
+ */
+size_t scope_tap_frame_bytes(const ScopeTap *st);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SCOPE_TAP_H
@@ -0,0 +1,285 @@
+/**
+ * @file simd_avx2.c
+ * @brief AVX2 + FMA kernel variants (built with -mavx2 -mfma or /arch:AVX2)
+ */
+
+#include "simd_kernels.h"
+
+#if defined(__AVX2__) && (defined(__FMA__) || defined(_MSC_VER))
+#include <immintrin.h>
+
+// Lane-by-lane horizontal sum
+static inline float avx2_hsum(__m256 v) {
+  float temp[8];
+  _mm256_storeu_ps(temp, v);
+  float acc = 0.0f;
+  for (int i = 0; i < 8; i++)
+    acc += temp[i];
+  return acc;
+}
+
+static float avx2_dot2(const float *w1, const float *u1, const float *w2,
+                       const float *u2, int M) {
+  int k = 0;
+  const int M_simd = M - (M % 8);
+  __m256 v_acc = _mm256_setzero_ps();
+  for (; k < M_simd; k += 8) {
+    v_acc = _mm256_fmadd_ps(_mm256_loadu_ps(&w1[k]), _mm256_loadu_ps(&u1[k]),
+                            v_acc);
+    v_acc = _mm256_fmadd_ps(_mm256_loadu_ps(&w2[k]), _mm256_loadu_ps(&u2[k]),
+                            v_acc);
+  }
+  return le_dot2_tail(avx2_hsum(v_acc), w1, u1, w2, u2, k, M);
+}
+
+static float avx2_energy2(const float *u1, const float *u2, int M) {
+  int k = 0;
+  const int M_simd = M - (M % 8);
+  __m256 v_acc = _mm256_setzero_ps();
+  for (; k < M_simd; k += 8) {
+    __m256 v_u1 = _mm256_loadu_ps(&u1[k]);
+    v_acc = _mm256_fmadd_ps(v_u1, v_u1, v_acc);
+    __m256 v_u2 = _mm256_loadu_ps(&u2[k]);
+    v_acc = _mm256_fmadd_ps(v_u2, v_u2, v_acc);
+  }
+  return le_energy2_tail(avx2_hsum(v_acc), u1, u2, k, M);
+}
+
+static void avx2_update2(float *w1, const float *u1, float *w2,
+                         const float *u2, int M, float leak, float factor) {
+  int k = 0;
+  const int M_simd = M - (M % 8);
+  __m256 v_factor = _mm256_set1_ps(factor);
+  __m256 v_leak = _mm256_set1_ps(leak);
+  for (; k < M_simd; k += 8) {
+    __m256 v_w1 = _mm256_loadu_ps(&w1[k]);
+    v_w1 = _mm256_fmadd_ps(v_leak, v_w1,
+                           _mm256_mul_ps(v_factor, _mm256_loadu_ps(&u1[k])));
+    _mm256_storeu_ps(&w1[k], v_w1);
+
+    __m256 v_w2 = _mm256_loadu_ps(&w2[k]);
+    v_w2 = _mm256_fmadd_ps(v_leak, v_w2,
+                           _mm256_mul_ps(v_factor, _mm256_loadu_ps(&u2[k])));
+    _mm256_storeu_ps(&w2[k], v_w2);
+  }
+  le_update2_tail(w1, u1, w2, u2, k, M, leak, factor);
+}
+
+static void avx2_cmac(float *acc_re, float *acc_im, const float *w_re,
+                      const float *w_im, const float *x_re, const float *x_im,
+                      int n) {
+  int k = 0;
+  const int n_simd = n - (n % 8);
+  for (; k < n_simd; k += 8) {
+    __m256 wr = _mm256_loadu_ps(&w_re[k]), wi = _mm256_loadu_ps(&w_im[k]);
+    __m256 xr = _mm256_loadu_ps(&x_re[k]), xi = _mm256_loadu_ps(&x_im[k]);
+    __m256 ar = _mm256_loadu_ps(&acc_re[k]);
+    __m256 ai = _mm256_loadu_ps(&acc_im[k]);
+    ar = _mm256_fnmadd_ps(wi, xi, _mm256_fmadd_ps(wr, xr, ar));
+    ai = _mm256_fmadd_ps(wi, xr, _mm256_fmadd_ps(wr, xi, ai));
+    _mm256_storeu_ps(&acc_re[k], ar);
+    _mm256_storeu_ps(&acc_im[k], ai);
+  }
+  le_cmac_tail(acc_re, acc_im, w_re, w_im, x_re, x_im, k, n);
+}
+
+static void avx2_cmac_conj(float *out_re, float *out_im, const float *w_re,
+                           const float *w_im, const float *x_re,
+                           const float *x_im, const float *e_re,
+                           const float *e_im, int n) {
+  int k = 0;
+  const int n_simd = n - (n % 8);
+  for (; k < n_simd; k += 8) {
+    __m256 xr = _mm256_loadu_ps(&x_re[k]), xi = _mm256_loadu_ps(&x_im[k]);
+    __m256 er = _mm256_loadu_ps(&e_re[k]), ei = _mm256_loadu_ps(&e_im[k]);
+    __m256 r = _mm256_fmadd_ps(
+        xi, ei, _mm256_fmadd_ps(xr, er, _mm256_loadu_ps(&w_re[k])));
+    __m256 i = _mm256_fnmadd_ps(
+        xi, er, _mm256_fmadd_ps(xr, ei, _mm256_loadu_ps(&w_im[k])));
+    _mm256_storeu_ps(&out_re[k], r);
+    _mm256_storeu_ps(&out_im[k], i);
+  }
+  le_cmac_conj_tail(out_re, out_im, w_re, w_im, x_re, x_im, e_re, e_im, k, n);
+}
+
+static void avx2_fft_radix4(float *re, float *im, int h, const float *tw) {
+  int k = 0;
+  const int h_simd = h - (h % 8);
+  for (; k < h_simd; k += 8) {
+    float *ra = re + k, *ia = im + k;
+    float *rb = ra + h, *ib = ia + h;
+    float *rc = rb + h, *ic = ib + h;
+    float *rd = rc + h, *id = ic + h;
+    __m256 w1r = _mm256_loadu_ps(tw + k);
+    __m256 w1i = _mm256_loadu_ps(tw + h + k);
+    __m256 w2r = _mm256_loadu_ps(tw + 2 * h + k);
+    __m256 w2i = _mm256_loadu_ps(tw + 3 * h + k);
+
+    __m256 xbr = _mm256_loadu_ps(rb), xbi = _mm256_loadu_ps(ib);
+    __m256 xdr = _mm256_loadu_ps(rd), xdi = _mm256_loadu_ps(id);
+    __m256 tbr = _mm256_fmsub_ps(xbr, w1r, _mm256_mul_ps(xbi, w1i));
+    __m256 tbi = _mm256_fmadd_ps(xbr, w1i, _mm256_mul_ps(xbi, w1r));
+    __m256 tdr = _mm256_fmsub_ps(xdr, w1r, _mm256_mul_ps(xdi, w1i));
+    __m256 tdi = _mm256_fmadd_ps(xdr, w1i, _mm256_mul_ps(xdi, w1r));
+
+    __m256 xar = _mm256_loadu_ps(ra), xai = _mm256_loadu_ps(ia);
+    __m256 xcr = _mm256_loadu_ps(rc), xci = _mm256_loadu_ps(ic);
+    __m256 a1r = _mm256_add_ps(xar, tbr), a1i = _mm256_add_ps(xai, tbi);
+    __m256 b1r = _mm256_sub_ps(xar, tbr), b1i = _mm256_sub_ps(xai, tbi);
+    __m256 c1r = _mm256_add_ps(xcr, tdr), c1i = _mm256_add_ps(xci, tdi);
+    __m256 d1r = _mm256_sub_ps(xcr, tdr), d1i = _mm256_sub_ps(xci, tdi);
+
+    __m256 tcr = _mm256_fmsub_ps(c1r, w2r, _mm256_mul_ps(c1i, w2i));
+    __m256 tci = _mm256_fmadd_ps(c1r, w2i, _mm256_mul_ps(c1i, w2r));
+    __m256 tr = _mm256_fmsub_ps(d1r, w2r, _mm256_mul_ps(d1i, w2i));
+    __m256 ti = _mm256_fmadd_ps(d1r, w2i, _mm256_mul_ps(d1i, w2r));
+
+    _mm256_storeu_ps(ra, _mm256_add_ps(a1r, tcr));
+    _mm256_storeu_ps(ia, _mm256_add_ps(a1i, tci));
+    _mm256_storeu_ps(rc, _mm256_sub_ps(a1r, tcr));
+    _mm256_storeu_ps(ic, _mm256_sub_ps(a1i, tci));
+    _mm256_storeu_ps(rb, _mm256_add_ps(b1r, ti));
+    _mm256_storeu_ps(ib, _mm256_sub_ps(b1i, tr));
+    _mm256_storeu_ps(rd, _mm256_sub_ps(b1r, ti));
+    _mm256_storeu_ps(id, _mm256_add_ps(b1i, tr));
+  }
+  le_fft_radix4_tail(re, im, h, k, tw);
+}
+
+// Up to LE_BIQUAD_GROUP stages on eight lanes, the sections in registers
+// for the whole block (G is a constant at every call)
+static inline void avx2_biquad_group8(const float *c, float *zs, int stride,
+                                      const float *src, int step, float *dst,
+                                      int lanes, int frames, const int G) {
+  __m256 b0[LE_BIQUAD_GROUP], b1[LE_BIQUAD_GROUP], b2[LE_BIQUAD_GROUP];
+  __m256 a1[LE_BIQUAD_GROUP], a2[LE_BIQUAD_GROUP];
+  __m256 z1[LE_BIQUAD_GROUP], z2[LE_BIQUAD_GROUP];
+  for (int s = 0; s < G; s++) {
+    const float *cs = c + s * 5 * stride;
+    b0[s] = _mm256_loadu_ps(cs);
+    b1[s] = _mm256_loadu_ps(cs + stride);
+    b2[s] = _mm256_loadu_ps(cs + 2 * stride);
+    a1[s] = _mm256_loadu_ps(cs + 3 * stride);
+    a2[s] = _mm256_loadu_ps(cs + 4 * stride);
+    z1[s] = _mm256_loadu_ps(zs + s * 2 * stride);
+    z2[s] = _mm256_loadu_ps(zs + s * 2 * stride + stride);
+  }
+  for (int n = 0; n < frames; n++) {
+    __m256 x =
+        step ? _mm256_loadu_ps(src + n * step) : _mm256_set1_ps(src[n]);
+    for (int s = 0; s < G; s++) {
+      __m256 y = _mm256_fmadd_ps(b0[s], x, z1[s]);
+      z1[s] = _mm256_fnmadd_ps(a1[s], y, _mm256_fmadd_ps(b1[s], x, z2[s]));
+      z2[s] = _mm256_fnmadd_ps(a2[s], y, _mm256_mul_ps(b2[s], x));
+      x = y;
+    }
+    _mm256_storeu_ps(dst + n * lanes, x);
+  }
+  for (int s = 0; s < G; s++) {
+    _mm256_storeu_ps(zs + s * 2 * stride, z1[s]);
+    _mm256_storeu_ps(zs + s * 2 * stride + stride, z2[s]);
+  }
+}
+
+// Four-lane remainder (the bands of one EQ, 4-mic pre-filters)
+static inline void avx2_biquad_group4(const float *c, float *zs, int stride,
+                                      const float *src, int step, float *dst,
+                                      int lanes, int frames, const int G) {
+  __m128 b0[LE_BIQUAD_GROUP], b1[LE_BIQUAD_GROUP], b2[LE_BIQUAD_GROUP];
+  __m128 a1[LE_BIQUAD_GROUP], a2[LE_BIQUAD_GROUP];
+  __m128 z1[LE_BIQUAD_GROUP], z2[LE_BIQUAD_GROUP];
+  for (int s = 0; s < G; s++) {
+    const float *cs = c + s * 5 * stride;
+    b0[s] = _mm_loadu_ps(cs);
+    b1[s] = _mm_loadu_ps(cs + stride);
+    b2[s] = _mm_loadu_ps(cs + 2 * stride);
+    a1[s] = _mm_loadu_ps(cs + 3 * stride);
+    a2[s] = _mm_loadu_ps(cs + 4 * stride);
+    z1[s] = _mm_loadu_ps(zs + s * 2 * stride);
+    z2[s] = _mm_loadu_ps(zs + s * 2 * stride + stride);
+  }
+  for (int n = 0; n < frames; n++) {
+    __m128 x = step ? _mm_loadu_ps(src + n * step) : _mm_set1_ps(src[n]);
+    for (int s = 0; s < G; s++) {
+      __m128 y = _mm_fmadd_ps(b0[s], x, z1[s]);
+      z1[s] = _mm_fnmadd_ps(a1[s], y, _mm_fmadd_ps(b1[s], x, z2[s]));
+      z2[s] = _mm_fnmadd_ps(a2[s], y, _mm_mul_ps(b2[s], x));
+      x = y;
+    }
+    _mm_storeu_ps(dst + n * lanes, x);
+  }
+  for (int s = 0; s < G; s++) {
+    _mm_storeu_ps(zs + s * 2 * stride, z1[s]);
+    _mm_storeu_ps(zs + s * 2 * stride + stride, z2[s]);
+  }
+}
+
+// One group of stages on lanes [l, l + w), w = 8 or 4
+static void avx2_biquad_groups(const float *c, float *zs, int stride,
+                               const float *src, int step, float *dst,
+                               int lanes, int frames, int w, int g) {
+  switch (w * 8 + g) {
+  case 8 * 8 + 1:
+    avx2_biquad_group8(c, zs, stride, src, step, dst, lanes, frames, 1);
+    break;
+  case 8 * 8 + 2:
+    avx2_biquad_group8(c, zs, stride, src, step, dst, lanes, frames, 2);
+    break;
+  case 8 * 8 + 3:
+    avx2_biquad_group8(c, zs, stride, src, step, dst, lanes, frames, 3);
+    break;
+  case 8 * 8 + 4:
+    avx2_biquad_group8(c, zs, stride, src, step, dst, lanes, frames, 4);
+    break;
+  case 4 * 8 + 1:
+    avx2_biquad_group4(c, zs, stride, src, step, dst, lanes, frames, 1);
+    break;
+  case 4 * 8 + 2:
+    avx2_biquad_group4(c, zs, stride, src, step, dst, lanes, frames, 2);
+    break;
+  case 4 * 8 + 3:
+    avx2_biquad_group4(c, zs, stride, src, step, dst, lanes, frames, 3);
+    break;
+  default:
+    avx2_biquad_group4(c, zs, stride, src, step, dst, lanes, frames, 4);
+    break;
+  }
+}
+
+static void avx2_biquad_bank(const float *coef, float *z, int stride,
+                             int lanes, int stages, const float *in,
+                             int in_stride, float *out, int frames) {
+  int l = 0;
+  while (l + 4 <= lanes) {
+    int w = (lanes - l >= 8) ? 8 : 4;
+    for (int s0 = 0; s0 < stages; s0 += LE_BIQUAD_GROUP) {
+      int g = stages - s0;
+      if (g > LE_BIQUAD_GROUP)
+        g = LE_BIQUAD_GROUP;
+      int step;
+      const float *src = le_biquad_src(in, in_stride, out, lanes, s0, l, &step);
+      avx2_biquad_groups(coef + s0 * 5 * stride + l, z + s0 * 2 * stride + l,
+                         stride, src, step, out + l, lanes, frames, w, g);
+    }
+    l += w;
+  }
+  le_biquad_bank_tail(coef, z, stride, lanes, stages, in, in_stride, out,
+                      frames, l);
+}
+
+static const LeSimdKernels k_avx2 = {.level = LE_SIMD_AVX2,
+                                     .dot2 = avx2_dot2,
+                                     .energy2 = avx2_energy2,
+                                     .update2 = avx2_update2,
+                                     .cmac = avx2_cmac,
+                                     .cmac_conj = avx2_cmac_conj,
+                                     .fft_radix4 = avx2_fft_radix4,
+                                     .biquad_bank = avx2_biquad_bank};
+
+const LeSimdKernels *le_simd_table_avx2(void) { return &k_avx2; }
+
+#else
+
+const LeSimdKernels *le_simd_table_avx2(void) { return NULL; }
+
+#endif
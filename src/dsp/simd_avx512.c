@@ -0,0 +1,191 @@
+/**
+ * @file simd_avx512.c
+ * @brief AVX-512F kernel variants (built with -mavx512f or /arch:AVX512)
+ *
+ * Tails use masked loads and stores instead of a scalar loop. FFT stages
+ * shorter than one vector (h < 16) go to the AVX2 butterflies, which the
+ * AVX-512 CPUs always have, and so do the biquad banks (rarely more than
+ * eight lanes).
+ */
+
+#include "simd_kernels.h"
+
+#if defined(__AVX512F__)
+#include <immintrin.h>
+
+// Lanes [0, n) of a 16-lane vector, n in [0, 16]
+static inline __mmask16 avx512_mask(int n) {
+  return (__mmask16)((n >= 16) ? 0xFFFFu : ((1u << n) - 1u));
+}
+
+static float avx512_dot2(const float *w1, const float *u1, const float *w2,
+                         const float *u2, int M) {
+  __m512 v_acc = _mm512_setzero_ps();
+  for (int k = 0; k < M; k += 16) {
+    __mmask16 m = avx512_mask(M - k);
+    v_acc = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(m, &w1[k]),
+                            _mm512_maskz_loadu_ps(m, &u1[k]), v_acc);
+    v_acc = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(m, &w2[k]),
+                            _mm512_maskz_loadu_ps(m, &u2[k]), v_acc);
+  }
+  return _mm512_reduce_add_ps(v_acc);
+}
+
+static float avx512_energy2(const float *u1, const float *u2, int M) {
+  __m512 v_acc = _mm512_setzero_ps();
+  for (int k = 0; k < M; k += 16) {
+    __mmask16 m = avx512_mask(M - k);
+    __m512 v_u1 = _mm512_maskz_loadu_ps(m, &u1[k]);
+    v_acc = _mm512_fmadd_ps(v_u1, v_u1, v_acc);
+    __m512 v_u2 = _mm512_maskz_loadu_ps(m, &u2[k]);
+    v_acc = _mm512_fmadd_ps(v_u2, v_u2, v_acc);
+  }
+  return _mm512_reduce_add_ps(v_acc);
+}
+
+static void avx512_update2(float *w1, const float *u1, float *w2,
+                           const float *u2, int M, float leak, float factor) {
+  __m512 v_factor = _mm512_set1_ps(factor);
+  __m512 v_leak = _mm512_set1_ps(leak);
+  for (int k = 0; k < M; k += 16) {
+    __mmask16 m = avx512_mask(M - k);
+    __m512 v_w1 = _mm512_maskz_loadu_ps(m, &w1[k]);
+    __m512 v_u1 = _mm512_maskz_loadu_ps(m, &u1[k]);
+    v_w1 = _mm512_fmadd_ps(v_leak, v_w1, _mm512_mul_ps(v_factor, v_u1));
+    _mm512_mask_storeu_ps(&w1[k], m, v_w1);
+
+    __m512 v_w2 = _mm512_maskz_loadu_ps(m, &w2[k]);
+    __m512 v_u2 = _mm512_maskz_loadu_ps(m, &u2[k]);
+    v_w2 = _mm512_fmadd_ps(v_leak, v_w2, _mm512_mul_ps(v_factor, v_u2));
+    _mm512_mask_storeu_ps(&w2[k], m, v_w2);
+  }
+}
+
+static void avx512_cmac(float *acc_re, float *acc_im, const float *w_re,
+                        const float *w_im, const float *x_re,
+                        const float *x_im, int n) {
+  for (int k = 0; k < n; k += 16) {
+    __mmask16 m = avx512_mask(n - k);
+    __m512 wr = _mm512_maskz_loadu_ps(m, &w_re[k]);
+    __m512 wi = _mm512_maskz_loadu_ps(m, &w_im[k]);
+    __m512 xr = _mm512_maskz_loadu_ps(m, &x_re[k]);
+    __m512 xi = _mm512_maskz_loadu_ps(m, &x_im[k]);
+    __m512 ar = _mm512_maskz_loadu_ps(m, &acc_re[k]);
+    __m512 ai = _mm512_maskz_loadu_ps(m, &acc_im[k]);
+    ar = _mm512_fnmadd_ps(wi, xi, _mm512_fmadd_ps(wr, xr, ar));
+    ai = _mm512_fmadd_ps(wi, xr, _mm512_fmadd_ps(wr, xi, ai));
+    _mm512_mask_storeu_ps(&acc_re[k], m, ar);
+    _mm512_mask_storeu_ps(&acc_im[k], m, ai);
+  }
+}
+
+static void avx512_cmac_conj(float *out_re, float *out_im, const float *w_re,
+                             const float *w_im, const float *x_re,
+                             const float *x_im, const float *e_re,
+                             const float *e_im, int n) {
+  for (int k = 0; k < n; k += 16) {
+    __mmask16 m = avx512_mask(n - k);
+    __m512 xr = _mm512_maskz_loadu_ps(m, &x_re[k]);
+    __m512 xi = _mm512_maskz_loadu_ps(m, &x_im[k]);
+    __m512 er = _mm512_maskz_loadu_ps(m, &e_re[k]);
+    __m512 ei = _mm512_maskz_loadu_ps(m, &e_im[k]);
+    __m512 r = _mm512_fmadd_ps(
+        xi, ei, _mm512_fmadd_ps(xr, er, _mm512_maskz_loadu_ps(m, &w_re[k])));
+    __m512 i = _mm512_fnmadd_ps(
+        xi, er, _mm512_fmadd_ps(xr, ei, _mm512_maskz_loadu_ps(m, &w_im[k])));
+    _mm512_mask_storeu_ps(&out_re[k], m, r);
+    _mm512_mask_storeu_ps(&out_im[k], m, i);
+  }
+}
+
+// Butterflies for spans below one vector: a masked 16-lane pass would do
+// the full work for a few lanes, so hand them to the AVX2 variant
+static void (*g_short_radix4)(float *re, float *im, int h, const float *tw);
+
+static void avx512_fft_radix4(float *re, float *im, int h, const float *tw) {
+  if (h < 16 && g_short_radix4) {
+    g_short_radix4(re, im, h, tw);
+    return;
+  }
+  for (int k = 0; k < h; k += 16) {
+    __mmask16 m = avx512_mask(h - k);
+    float *ra = re + k, *ia = im + k;
+    float *rb = ra + h, *ib = ia + h;
+    float *rc = rb + h, *ic = ib + h;
+    float *rd = rc + h, *id = ic + h;
+    __m512 w1r = _mm512_maskz_loadu_ps(m, tw + k);
+    __m512 w1i = _mm512_maskz_loadu_ps(m, tw + h + k);
+    __m512 w2r = _mm512_maskz_loadu_ps(m, tw + 2 * h + k);
+    __m512 w2i = _mm512_maskz_loadu_ps(m, tw + 3 * h + k);
+
+    __m512 xbr = _mm512_maskz_loadu_ps(m, rb);
+    __m512 xbi = _mm512_maskz_loadu_ps(m, ib);
+    __m512 xdr = _mm512_maskz_loadu_ps(m, rd);
+    __m512 xdi = _mm512_maskz_loadu_ps(m, id);
+    __m512 tbr = _mm512_fmsub_ps(xbr, w1r, _mm512_mul_ps(xbi, w1i));
+    __m512 tbi = _mm512_fmadd_ps(xbr, w1i, _mm512_mul_ps(xbi, w1r));
+    __m512 tdr = _mm512_fmsub_ps(xdr, w1r, _mm512_mul_ps(xdi, w1i));
+    __m512 tdi = _mm512_fmadd_ps(xdr, w1i, _mm512_mul_ps(xdi, w1r));
+
+    __m512 xar = _mm512_maskz_loadu_ps(m, ra);
+    __m512 xai = _mm512_maskz_loadu_ps(m, ia);
+    __m512 xcr = _mm512_maskz_loadu_ps(m, rc);
+    __m512 xci = _mm512_maskz_loadu_ps(m, ic);
+    __m512 a1r = _mm512_add_ps(xar, tbr), a1i = _mm512_add_ps(xai, tbi);
+    __m512 b1r = _mm512_sub_ps(xar, tbr), b1i = _mm512_sub_ps(xai, tbi);
+    __m512 c1r = _mm512_add_ps(xcr, tdr), c1i = _mm512_add_ps(xci, tdi);
+    __m512 d1r = _mm512_sub_ps(xcr, tdr), d1i = _mm512_sub_ps(xci, tdi);
+
+    __m512 tcr = _mm512_fmsub_ps(c1r, w2r, _mm512_mul_ps(c1i, w2i));
+    __m512 tci = _mm512_fmadd_ps(c1r, w2i, _mm512_mul_ps(c1i, w2r));
+    __m512 tr = _mm512_fmsub_ps(d1r, w2r, _mm512_mul_ps(d1i, w2i));
+    __m512 ti = _mm512_fmadd_ps(d1r, w2i, _mm512_mul_ps(d1i, w2r));
+
+    _mm512_mask_storeu_ps(ra, m, _mm512_add_ps(a1r, tcr));
+    _mm512_mask_storeu_ps(ia, m, _mm512_add_ps(a1i, tci));
+    _mm512_mask_storeu_ps(rc, m, _mm512_sub_ps(a1r, tcr));
+    _mm512_mask_storeu_ps(ic, m, _mm512_sub_ps(a1i, tci));
+    _mm512_mask_storeu_ps(rb, m, _mm512_add_ps(b1r, ti));
+    _mm512_mask_storeu_ps(ib, m, _mm512_sub_ps(b1i, tr));
+    _mm512_mask_storeu_ps(rd, m, _mm512_sub_ps(b1r, ti));
+    _mm512_mask_storeu_ps(id, m, _mm512_add_ps(b1i, tr));
+  }
+}
+
+// Biquad banks: the AVX2 variant (8 + 4 lanes per vector)
+static void (*g_biquad_bank)(const float *coef, float *z, int stride,
+                             int lanes, int stages, const float *in,
+                             int in_stride, float *out, int frames);
+
+static void avx512_biquad_bank(const float *coef, float *z, int stride,
+                               int lanes, int stages, const float *in,
+                               int in_stride, float *out, int frames) {
+  if (g_biquad_bank) {
+    g_biquad_bank(coef, z, stride, lanes, stages, in, in_stride, out, frames);
+    return;
+  }
+  le_biquad_bank_tail(coef, z, stride, lanes, stages, in, in_stride, out,
+                      frames, 0);
+}
+
+static const LeSimdKernels k_avx512 = {.level = LE_SIMD_AVX512,
+                                       .dot2 = avx512_dot2,
+                                       .energy2 = avx512_energy2,
+                                       .update2 = avx512_update2,
+                                       .cmac = avx512_cmac,
+                                       .cmac_conj = avx512_cmac_conj,
+                                       .fft_radix4 = avx512_fft_radix4,
+                                       .biquad_bank = avx512_biquad_bank};
+
+const LeSimdKernels *le_simd_table_avx512(void) {
+  const LeSimdKernels *avx2 = le_simd_table_avx2();
+  g_short_radix4 = avx2 ? avx2->fft_radix4 : NULL;
+  g_biquad_bank = avx2 ? avx2->biquad_bank : NULL;
+  return &k_avx512;
+}
+
+#else
+
+const LeSimdKernels *le_simd_table_avx512(void) { return NULL; }
+
+#endif
@@ -0,0 +1,191 @@
+/**
+ * @file simd_dispatch.c
+ * @brief CPU feature detection and kernel table selection
+ */
+
+#include "simd_dispatch.h"
+#include "../utils/atomic_compat.h"
+#include "simd_kernels.h"
+#include <string.h>
+
+static const char *const k_level_names[LE_SIMD_COUNT] = {
+    "scalar", "sse2", "avx2", "avx512", "neon"};
+
+// Preference order for le_simd_detect
+static const LeSimdLevel k_preference[] = {LE_SIMD_AVX512, LE_SIMD_AVX2,
+                                           LE_SIMD_SSE2, LE_SIMD_NEON,
+                                           LE_SIMD_SCALAR};
+
+// Active level + 1, 0: not detected yet. Modules initialized on worker
+// threads (batch, tuner) may be the first to ask, so the level and the
+// probed CPU features are published with release / acquire ordering.
+static le_atomic_int g_active_level = 0;
+
+// ============================================================================
+// CPU features
+// ============================================================================
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) ||            \
+    defined(_M_IX86)
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+
+static void le_cpuid(unsigned leaf, unsigned sub, unsigned r[4]) {
+  int regs[4];
+  __cpuidex(regs, (int)leaf, (int)sub);
+  for (int i = 0; i < 4; i++)
+    r[i] = (unsigned)regs[i];
+}
+
+static unsigned long long le_xgetbv(void) { return _xgetbv(0); }
+#else
+#include <cpuid.h>
+
+static void le_cpuid(unsigned leaf, unsigned sub, unsigned r[4]) {
+  __cpuid_count(leaf, sub, r[0], r[1], r[2], r[3]);
+}
+
+// Inline asm rather than _xgetbv, which would need -mxsave
+static unsigned long long le_xgetbv(void) {
+  unsigned lo, hi;
+  __asm__ __volatile__("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+  return ((unsigned long long)hi << 32) | lo;
+}
+#endif
+
+// Bits of the probed feature word (FEAT_PROBED: the word is valid)
+#define FEAT_PROBED 1
+#define FEAT_SSE2 2
+#define FEAT_AVX2 4
+#define FEAT_AVX512 8
+
+static le_atomic_int g_features = 0;
+
+static int le_cpu_probe(void) {
+  unsigned r[4];
+  le_cpuid(0, 0, r);
+  unsigned max_leaf = r[0];
+
+  le_cpuid(1, 0, r);
+  int sse2 = (r[3] >> 26) & 1;
+  int fma = (r[2] >> 12) & 1;
+  int osxsave = (r[2] >> 27) & 1;
+  int avx = (r[2] >> 28) & 1;
+
+  unsigned long long xcr0 = osxsave ? le_xgetbv() : 0;
+  int ymm_state = (xcr0 & 0x06) == 0x06; // XMM | YMM
+  int zmm_state = (xcr0 & 0xE6) == 0xE6; // + opmask, ZMM0-15, ZMM16-31
+
+  int avx2 = 0, avx512f = 0;
+  if (max_leaf >= 7) {
+    le_cpuid(7, 0, r);
+    avx2 = (r[1] >> 5) & 1;
+    avx512f = (r[1] >> 16) & 1;
+  }
+  int has_avx2 = avx && fma && avx2 && ymm_state;
+  int has_avx512 = has_avx2 && avx512f && zmm_state;
+  return FEAT_PROBED | (sse2 ? FEAT_SSE2 : 0) | (has_avx2 ? FEAT_AVX2 : 0) |
+         (has_avx512 ? FEAT_AVX512 : 0);
+}
+
+// The instruction set must be present AND its register state enabled by
+// the OS (XCR0), or the first vector instruction faults
+static int le_cpu_supports(LeSimdLevel level) {
+  // One word, so a reader sees either nothing or the whole probe. Threads
+  // racing through the first call store the same value.
+  int f = le_atomic_load(&g_features);
+  if (!f) {
+    f = le_cpu_probe();
+    le_atomic_store(&g_features, f);
+  }
+
+  switch (level) {
+  case LE_SIMD_SCALAR:
+    return 1;
+  case LE_SIMD_SSE2:
+    return (f & FEAT_SSE2) != 0;
+  case LE_SIMD_AVX2:
+    return (f & FEAT_AVX2) != 0;
+  case LE_SIMD_AVX512:
+    return (f & FEAT_AVX512) != 0;
+  default:
+    return 0;
+  }
+}
+
+#else
+
+// NEON is a compile-time property (AArch64 baseline, or -mfpu=neon)
+static int le_cpu_supports(LeSimdLevel level) {
+  return level == LE_SIMD_SCALAR || level == LE_SIMD_NEON;
+}
+
+#endif
+
+// ============================================================================
+// Public API
+// ============================================================================
+
+static const LeSimdKernels *le_simd_table(LeSimdLevel level) {
+  switch (level) {
+  case LE_SIMD_SCALAR:
+    return le_simd_table_scalar();
+  case LE_SIMD_SSE2:
+    return le_simd_table_sse2();
+  case LE_SIMD_AVX2:
+    return le_simd_table_avx2();
+  case LE_SIMD_AVX512:
+    return le_simd_table_avx512();
+  case LE_SIMD_NEON:
+    return le_simd_table_neon();
+  default:
+    return NULL;
+  }
+}
+
+const LeSimdKernels *le_simd_kernels_for(LeSimdLevel level) {
+  const LeSimdKernels *k = le_simd_table(level);
+  return (k && le_cpu_supports(level)) ? k : NULL;
+}
+
+LeSimdLevel le_simd_detect(void) {
+  for (size_t i = 0; i < sizeof(k_preference) / sizeof(k_preference[0]); i++) {
+    if (le_simd_kernels_for(k_preference[i]))
+      return k_preference[i];
+  }
+  return LE_SIMD_SCALAR;
+}
+
+void le_simd_init(void) {
+  if (!le_atomic_load(&g_active_level))
+    le_atomic_store(&g_active_level, (int)le_simd_detect() + 1);
+}
+
+const LeSimdKernels *le_simd_kernels(void) {
+  // Detection is deterministic, so two modules racing through their first
+  // init store the same level
+  le_simd_init();
+  return le_simd_table((LeSimdLevel)(le_atomic_load(&g_active_level) - 1));
+}
+
+int le_simd_set_level(LeSimdLevel level) {
+  if (!le_simd_kernels_for(level))
+    return -1;
+  le_atomic_store(&g_active_level, (int)level + 1);
+  return 0;
+}
+
+const char *le_simd_name(LeSimdLevel level) {
+  return (level >= 0 && level < LE_SIMD_COUNT) ? k_level_names[level] : "?";
+}
+
+int le_simd_parse(const char *name) {
+  if (!name)
+    return -1;
+  for (int i = 0; i < LE_SIMD_COUNT; i++) {
+    if (strcmp(name, k_level_names[i]) == 0)
+      return i;
+  }
+  return -1;
+}
@@ -0,0 +1,115 @@
+/**
+ * @file simd_dispatch.h
+ * @brief Runtime CPU dispatch for the SIMD DSP kernels
+ *
+ * The hot inner loops (GSC filter / power / NLMS update, the partitioned
+ * AEC spectrum multiply-accumulate, the radix-4 FFT butterflies and the
+ * multi-lane biquad cascades) exist
+ * in several variants, each built in its own translation unit with only
+ * the instruction set it needs. The best variant the CPU and OS support is
+ * picked once, from cpuid, by le_simd_init or the first module init
+ * (either is safe from any thread); modules keep a pointer to the chosen
+ * table, so the library itself is built for the baseline ISA and one
+ * binary runs on any x86-64 machine.
+ *
+ * x86: scalar, SSE2, AVX2 + FMA, AVX-512F. ARM: scalar, NEON (compile
+ * time, NEON is part of the AArch64 baseline).
+ */
+
+#ifndef SIMD_DISPATCH_H
+#define SIMD_DISPATCH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+  LE_SIMD_SCALAR = 0,
+  LE_SIMD_SSE2,
+  LE_SIMD_AVX2,   // AVX2 + FMA
+  LE_SIMD_AVX512, // AVX-512F
+  LE_SIMD_NEON,
+  LE_SIMD_COUNT
+} LeSimdLevel;
+
+// Kernel table. Views are linear (u[k] == u[n-k] for the GSC history);
+// complex arrays are split real / imaginary.
+typedef struct {
+  LeSimdLevel level;
+
+  // sum_k w1[k] u1[k] + w2[k] u2[k]
+  float (*dot2)(const float *w1, const float *u1, const float *w2,
+                const float *u2, int M);
+  // sum_k u1[k]^2 + u2[k]^2
+  float (*energy2)(const float *u1, const float *u2, int M);
+  // w = leak * w + factor * u, for both filters
+  void (*update2)(float *w1, const float *u1, float *w2, const float *u2,
+                  int M, float leak, float factor);
+
+  // acc += W * X
+  void (*cmac)(float *acc_re, float *acc_im, const float *w_re,
+               const float *w_im, const float *x_re, const float *x_im,
+               int n);
+  // out = W + conj(X) * E (out may alias W)
+  void (*cmac_conj)(float *out_re, float *out_im, const float *w_re,
+                    const float *w_im, const float *x_re, const float *x_im,
+                    const float *e_re, const float *e_im, int n);
+
+  // One radix-4 (two fused radix-2) pass over a group of 4h points with
+  // the stage twiddles tw (layout in le_fft.h)
+  void (*fft_radix4)(float *re, float *im, int h, const float *tw);
+
+  // Biquad cascades on independent lanes, in stage groups over the block
+  // (layout and in / out conventions in biquad.h, BiquadBank)
+  void (*biquad_bank)(const float *coef, float *z, int stride, int lanes,
+                      int stages, const float *in, int in_stride, float *out,
+                      int frames);
+} LeSimdKernels;
+
+/**
+ * Best level supported by both this build and the running CPU / OS.
+ */
+LeSimdLevel le_simd_detect(void);
+
+/**
+ * Kernel table for a level.
+ * @return The table, or NULL if the level is not built in or the CPU
+ *         cannot run it
+ */
+const LeSimdKernels *le_simd_kernels_for(LeSimdLevel level);
+
+/**
+ * Detect the CPU and select the active level, if not done yet. Programs
+ * call it at startup, before any threads; later calls are no-ops.
+ */
+void le_simd_init(void);
+
+/**
+ * Active kernel table (detected on the first call). Modules fetch it in
+ * their init functions, never per sample.
+ */
+const LeSimdKernels *le_simd_kernels(void);
+
+/**
+ * Override the active level (testing, or working around a bad CPU).
+ * Only modules initialized afterwards pick it up.
+ * @return 0 on success, -1 if the level is not available
+ */
+int le_simd_set_level(LeSimdLevel level);
+
+/**
+ * Short lowercase name ("scalar", "sse2", "avx2", "avx512", "neon").
+ */
+const char *le_simd_name(LeSimdLevel level);
+
+/**
+ * Parse a name as returned by le_simd_name.
+ * @return The level, or -1 if unknown
+ */
+int le_simd_parse(const char *name);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SIMD_DISPATCH_H
@@ -0,0 +1,189 @@
+/**
+ * @file simd_kernels.h
+ * @brief Internal: per-ISA kernel tables and the scalar loops they share
+ *
+ * Every simd_<isa>.c is always compiled; it provides its table only when
+ * the compiler was given the matching instruction set (per-file flags in
+ * CMake) and returns NULL otherwise. The scalar loops below are the
+ * reference semantics and finish the tails of the vector variants.
+ */
+
+#ifndef SIMD_KERNELS_H
+#define SIMD_KERNELS_H
+
+#include "simd_dispatch.h"
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+const LeSimdKernels *le_simd_table_scalar(void);
+const LeSimdKernels *le_simd_table_sse2(void);
+const LeSimdKernels *le_simd_table_avx2(void);
+const LeSimdKernels *le_simd_table_avx512(void);
+const LeSimdKernels *le_simd_table_neon(void);
+
+// ============================================================================
+// Scalar loops over [k0, n); reductions continue from acc
+// ============================================================================
+
+static inline float le_dot2_tail(float acc, const float *w1, const float *u1,
+                                 const float *w2, const float *u2, int k0,
+                                 int M) {
+  for (int k = k0; k < M; k++) {
+    acc += w1[k] * u1[k];
+    acc += w2[k] * u2[k];
+  }
+  return acc;
+}
+
+static inline float le_energy2_tail(float acc, const float *u1,
+                                    const float *u2, int k0, int M) {
+  for (int k = k0; k < M; k++) {
+    acc += u1[k] * u1[k];
+    acc += u2[k] * u2[k];
+  }
+  return acc;
+}
+
+static inline void le_update2_tail(float *w1, const float *u1, float *w2,
+                                   const float *u2, int k0, int M, float leak,
+                                   float factor) {
+  for (int k = k0; k < M; k++) {
+    w1[k] = leak * w1[k] + factor * u1[k];
+    w2[k] = leak * w2[k] + factor * u2[k];
+  }
+}
+
+static inline void le_cmac_tail(float *acc_re, float *acc_im,
+                                const float *w_re, const float *w_im,
+                                const float *x_re, const float *x_im, int k0,
+                                int n) {
+  for (int k = k0; k < n; k++) {
+    acc_re[k] += w_re[k] * x_re[k] - w_im[k] * x_im[k];
+    acc_im[k] += w_re[k] * x_im[k] + w_im[k] * x_re[k];
+  }
+}
+
+static inline void le_cmac_conj_tail(float *out_re, float *out_im,
+                                     const float *w_re, const float *w_im,
+                                     const float *x_re, const float *x_im,
+                                     const float *e_re, const float *e_im,
+                                     int k0, int n) {
+  for (int k = k0; k < n; k++) {
+    float r = w_re[k] + x_re[k] * e_re[k] + x_im[k] * e_im[k];
+    float i = w_im[k] + x_re[k] * e_im[k] - x_im[k] * e_re[k];
+    out_re[k] = r;
+    out_im[k] = i;
+  }
+}
+
+// Two fused radix-2 DIT stages (spans h and 2h) over one group of 4h points,
+// for k in [k0, h). Stage 1 pairs (a,b), (c,d) with w1 = W_2h^k; stage 2
+// pairs (a,c) with w2 = W_4h^k and (b,d) with W_4h^(k+h) = -j * w2.
+static inline void le_fft_radix4_tail(float *re, float *im, int h, int k0,
+                                      const float *tw) {
+  const float *w1r = tw;
+  const float *w1i = tw + h;
+  const float *w2r = tw + 2 * h;
+  const float *w2i = tw + 3 * h;
+
+  for (int k = k0; k < h; k++) {
+    int a = k;
+    int b = k + h;
+    int c = k + 2 * h;
+    int d = k + 3 * h;
+
+    float tbr = re[b] * w1r[k] - im[b] * w1i[k];
+    float tbi = re[b] * w1i[k] + im[b] * w1r[k];
+    float tdr = re[d] * w1r[k] - im[d] * w1i[k];
+    float tdi = re[d] * w1i[k] + im[d] * w1r[k];
+
+    float a1r = re[a] + tbr, a1i = im[a] + tbi;
+    float b1r = re[a] - tbr, b1i = im[a] - tbi;
+    float c1r = re[c] + tdr, c1i = im[c] + tdi;
+    float d1r = re[c] - tdr, d1i = im[c] - tdi;
+
+    float tcr = c1r * w2r[k] - c1i * w2i[k];
+    float tci = c1r * w2i[k] + c1i * w2r[k];
+    float tr = d1r * w2r[k] - d1i * w2i[k];
+    float ti = d1r * w2i[k] + d1i * w2r[k];
+
+    // -j * (tr + j ti) = ti - j tr
+    re[a] = a1r + tcr;
+    im[a] = a1i + tci;
+    re[c] = a1r - tcr;
+    im[c] = a1i - tci;
+    re[b] = b1r + ti;
+    im[b] = b1i - tr;
+    re[d] = b1r - ti;
+    im[d] = b1i + tr;
+  }
+}
+
+// Biquad bank stages run per frame in groups of up to this many, the state
+// of the group in registers: the recursion of one section is latency-bound,
+// consecutive sections of a cascade overlap
+#define LE_BIQUAD_GROUP 4
+
+// Source of the biquad bank stage group starting at s0 for the lanes from
+// l: stage 0 reads the input (step 0: the same in[n] for every lane), later
+// groups run in place on out
+static inline const float *le_biquad_src(const float *in, int in_stride,
+                                         const float *out, int lanes, int s0,
+                                         int l, int *step) {
+  if (s0 > 0) {
+    *step = lanes;
+    return out + l;
+  }
+  *step = in_stride;
+  return in_stride ? in + l : in;
+}
+
+// Biquad bank over lanes [l0, lanes), with the arithmetic of
+// biquad_process
+static inline void le_biquad_bank_tail(const float *coef, float *z,
+                                       int stride, int lanes, int stages,
+                                       const float *in, int in_stride,
+                                       float *out, int frames, int l0) {
+  for (int l = l0; l < lanes; l++) {
+    for (int s0 = 0; s0 < stages; s0 += LE_BIQUAD_GROUP) {
+      int g = stages - s0;
+      if (g > LE_BIQUAD_GROUP)
+        g = LE_BIQUAD_GROUP;
+      const float *c = coef + s0 * 5 * stride + l;
+      float *zs = z + s0 * 2 * stride + l;
+      float z1[LE_BIQUAD_GROUP], z2[LE_BIQUAD_GROUP];
+      for (int s = 0; s < g; s++) {
+        z1[s] = zs[s * 2 * stride];
+        z2[s] = zs[s * 2 * stride + stride];
+      }
+      int step;
+      const float *src = le_biquad_src(in, in_stride, out, lanes, s0, l, &step);
+      if (step == 0)
+        step = 1; // Mono input: in[n]
+      for (int n = 0; n < frames; n++) {
+        float x = src[n * step];
+        for (int s = 0; s < g; s++) {
+          const float *cs = c + s * 5 * stride;
+          float y = cs[0] * x + z1[s];
+          z1[s] = cs[stride] * x - cs[3 * stride] * y + z2[s];
+          z2[s] = cs[2 * stride] * x - cs[4 * stride] * y;
+          x = y;
+        }
+        out[n * lanes + l] = x;
+      }
+      for (int s = 0; s < g; s++) {
+        zs[s * 2 * stride] = z1[s];
+        zs[s * 2 * stride + stride] = z2[s];
+      }
+    }
+  }
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SIMD_KERNELS_H
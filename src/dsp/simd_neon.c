@@ -0,0 +1,216 @@
+/**
+ * @file simd_neon.c
+ * @brief NEON kernel variants (ARM, selected at compile time)
+ */
+
+#include "simd_kernels.h"
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+
+// Lane-by-lane horizontal sum
+static inline float neon_hsum(float32x4_t v) {
+  return ((vgetq_lane_f32(v, 0) + vgetq_lane_f32(v, 1)) +
+          vgetq_lane_f32(v, 2)) +
+         vgetq_lane_f32(v, 3);
+}
+
+static float neon_dot2(const float *w1, const float *u1, const float *w2,
+                       const float *u2, int M) {
+  int k = 0;
+  const int M_simd = M - (M % 4);
+  float32x4_t v_acc = vdupq_n_f32(0.0f);
+  for (; k < M_simd; k += 4) {
+    v_acc = vmlaq_f32(v_acc, vld1q_f32(&w1[k]), vld1q_f32(&u1[k]));
+    v_acc = vmlaq_f32(v_acc, vld1q_f32(&w2[k]), vld1q_f32(&u2[k]));
+  }
+  return le_dot2_tail(neon_hsum(v_acc), w1, u1, w2, u2, k, M);
+}
+
+static float neon_energy2(const float *u1, const float *u2, int M) {
+  int k = 0;
+  const int M_simd = M - (M % 4);
+  float32x4_t v_acc = vdupq_n_f32(0.0f);
+  for (; k < M_simd; k += 4) {
+    float32x4_t v_u1 = vld1q_f32(&u1[k]);
+    v_acc = vmlaq_f32(v_acc, v_u1, v_u1);
+    float32x4_t v_u2 = vld1q_f32(&u2[k]);
+    v_acc = vmlaq_f32(v_acc, v_u2, v_u2);
+  }
+  return le_energy2_tail(neon_hsum(v_acc), u1, u2, k, M);
+}
+
+static void neon_update2(float *w1, const float *u1, float *w2,
+                         const float *u2, int M, float leak, float factor) {
+  int k = 0;
+  const int M_simd = M - (M % 4);
+  float32x4_t v_factor = vdupq_n_f32(factor);
+  float32x4_t v_leak = vdupq_n_f32(leak);
+  for (; k < M_simd; k += 4) {
+    float32x4_t v_w1 = vmulq_f32(v_leak, vld1q_f32(&w1[k]));
+    vst1q_f32(&w1[k], vmlaq_f32(v_w1, v_factor, vld1q_f32(&u1[k])));
+    float32x4_t v_w2 = vmulq_f32(v_leak, vld1q_f32(&w2[k]));
+    vst1q_f32(&w2[k], vmlaq_f32(v_w2, v_factor, vld1q_f32(&u2[k])));
+  }
+  le_update2_tail(w1, u1, w2, u2, k, M, leak, factor);
+}
+
+static void neon_cmac(float *acc_re, float *acc_im, const float *w_re,
+                      const float *w_im, const float *x_re, const float *x_im,
+                      int n) {
+  int k = 0;
+  const int n_simd = n - (n % 4);
+  for (; k < n_simd; k += 4) {
+    float32x4_t wr = vld1q_f32(&w_re[k]), wi = vld1q_f32(&w_im[k]);
+    float32x4_t xr = vld1q_f32(&x_re[k]), xi = vld1q_f32(&x_im[k]);
+    float32x4_t ar = vmlaq_f32(vld1q_f32(&acc_re[k]), wr, xr);
+    float32x4_t ai = vmlaq_f32(vld1q_f32(&acc_im[k]), wr, xi);
+    vst1q_f32(&acc_re[k], vmlsq_f32(ar, wi, xi));
+    vst1q_f32(&acc_im[k], vmlaq_f32(ai, wi, xr));
+  }
+  le_cmac_tail(acc_re, acc_im, w_re, w_im, x_re, x_im, k, n);
+}
+
+static void neon_cmac_conj(float *out_re, float *out_im, const float *w_re,
+                           const float *w_im, const float *x_re,
+                           const float *x_im, const float *e_re,
+                           const float *e_im, int n) {
+  int k = 0;
+  const int n_simd = n - (n % 4);
+  for (; k < n_simd; k += 4) {
+    float32x4_t xr = vld1q_f32(&x_re[k]), xi = vld1q_f32(&x_im[k]);
+    float32x4_t er = vld1q_f32(&e_re[k]), ei = vld1q_f32(&e_im[k]);
+    float32x4_t r = vmlaq_f32(vmlaq_f32(vld1q_f32(&w_re[k]), xr, er), xi, ei);
+    float32x4_t i = vmlsq_f32(vmlaq_f32(vld1q_f32(&w_im[k]), xr, ei), xi, er);
+    vst1q_f32(&out_re[k], r);
+    vst1q_f32(&out_im[k], i);
+  }
+  le_cmac_conj_tail(out_re, out_im, w_re, w_im, x_re, x_im, e_re, e_im, k, n);
+}
+
+static void neon_fft_radix4(float *re, float *im, int h, const float *tw) {
+  int k = 0;
+  const int h_simd = h - (h % 4);
+  for (; k < h_simd; k += 4) {
+    float *ra = re + k, *ia = im + k;
+    float *rb = ra + h, *ib = ia + h;
+    float *rc = rb + h, *ic = ib + h;
+    float *rd = rc + h, *id = ic + h;
+    float32x4_t w1r = vld1q_f32(tw + k);
+    float32x4_t w1i = vld1q_f32(tw + h + k);
+    float32x4_t w2r = vld1q_f32(tw + 2 * h + k);
+    float32x4_t w2i = vld1q_f32(tw + 3 * h + k);
+
+    float32x4_t xbr = vld1q_f32(rb), xbi = vld1q_f32(ib);
+    float32x4_t xdr = vld1q_f32(rd), xdi = vld1q_f32(id);
+    float32x4_t tbr = vmlsq_f32(vmulq_f32(xbr, w1r), xbi, w1i);
+    float32x4_t tbi = vmlaq_f32(vmulq_f32(xbr, w1i), xbi, w1r);
+    float32x4_t tdr = vmlsq_f32(vmulq_f32(xdr, w1r), xdi, w1i);
+    float32x4_t tdi = vmlaq_f32(vmulq_f32(xdr, w1i), xdi, w1r);
+
+    float32x4_t xar = vld1q_f32(ra), xai = vld1q_f32(ia);
+    float32x4_t xcr = vld1q_f32(rc), xci = vld1q_f32(ic);
+    float32x4_t a1r = vaddq_f32(xar, tbr), a1i = vaddq_f32(xai, tbi);
+    float32x4_t b1r = vsubq_f32(xar, tbr), b1i = vsubq_f32(xai, tbi);
+    float32x4_t c1r = vaddq_f32(xcr, tdr), c1i = vaddq_f32(xci, tdi);
+    float32x4_t d1r = vsubq_f32(xcr, tdr), d1i = vsubq_f32(xci, tdi);
+
+    float32x4_t tcr = vmlsq_f32(vmulq_f32(c1r, w2r), c1i, w2i);
+    float32x4_t tci = vmlaq_f32(vmulq_f32(c1r, w2i), c1i, w2r);
+    float32x4_t tr = vmlsq_f32(vmulq_f32(d1r, w2r), d1i, w2i);
+    float32x4_t ti = vmlaq_f32(vmulq_f32(d1r, w2i), d1i, w2r);
+
+    vst1q_f32(ra, vaddq_f32(a1r, tcr));
+    vst1q_f32(ia, vaddq_f32(a1i, tci));
+    vst1q_f32(rc, vsubq_f32(a1r, tcr));
+    vst1q_f32(ic, vsubq_f32(a1i, tci));
+    vst1q_f32(rb, vaddq_f32(b1r, ti));
+    vst1q_f32(ib, vsubq_f32(b1i, tr));
+    vst1q_f32(rd, vsubq_f32(b1r, ti));
+    vst1q_f32(id, vaddq_f32(b1i, tr));
+  }
+  le_fft_radix4_tail(re, im, h, k, tw);
+}
+
+// Up to LE_BIQUAD_GROUP stages on four lanes, the sections in registers
+// for the whole block (G is a constant at every call)
+static inline void neon_biquad_group(const float *c, float *zs, int stride,
+                                     const float *src, int step, float *dst,
+                                     int lanes, int frames, const int G) {
+  float32x4_t b0[LE_BIQUAD_GROUP], b1[LE_BIQUAD_GROUP], b2[LE_BIQUAD_GROUP];
+  float32x4_t a1[LE_BIQUAD_GROUP], a2[LE_BIQUAD_GROUP];
+  float32x4_t z1[LE_BIQUAD_GROUP], z2[LE_BIQUAD_GROUP];
+  for (int s = 0; s < G; s++) {
+    const float *cs = c + s * 5 * stride;
+    b0[s] = vld1q_f32(cs);
+    b1[s] = vld1q_f32(cs + stride);
+    b2[s] = vld1q_f32(cs + 2 * stride);
+    a1[s] = vld1q_f32(cs + 3 * stride);
+    a2[s] = vld1q_f32(cs + 4 * stride);
+    z1[s] = vld1q_f32(zs + s * 2 * stride);
+    z2[s] = vld1q_f32(zs + s * 2 * stride + stride);
+  }
+  for (int n = 0; n < frames; n++) {
+    float32x4_t x = step ? vld1q_f32(src + n * step) : vdupq_n_f32(src[n]);
+    for (int s = 0; s < G; s++) {
+      float32x4_t y = vmlaq_f32(z1[s], b0[s], x);
+      z1[s] = vaddq_f32(vmlsq_f32(vmulq_f32(b1[s], x), a1[s], y), z2[s]);
+      z2[s] = vmlsq_f32(vmulq_f32(b2[s], x), a2[s], y);
+      x = y;
+    }
+    vst1q_f32(dst + n * lanes, x);
+  }
+  for (int s = 0; s < G; s++) {
+    vst1q_f32(zs + s * 2 * stride, z1[s]);
+    vst1q_f32(zs + s * 2 * stride + stride, z2[s]);
+  }
+}
+
+static void neon_biquad_bank(const float *coef, float *z, int stride,
+                             int lanes, int stages, const float *in,
+                             int in_stride, float *out, int frames) {
+  int l = 0;
+  for (; l + 4 <= lanes; l += 4) {
+    for (int s0 = 0; s0 < stages; s0 += LE_BIQUAD_GROUP) {
+      int step;
+      const float *src = le_biquad_src(in, in_stride, out, lanes, s0, l, &step);
+      const float *c = coef + s0 * 5 * stride + l;
+      float *zs = z + s0 * 2 * stride + l;
+      float *dst = out + l;
+      switch (stages - s0) {
+      case 1:
+        neon_biquad_group(c, zs, stride, src, step, dst, lanes, frames, 1);
+        break;
+      case 2:
+        neon_biquad_group(c, zs, stride, src, step, dst, lanes, frames, 2);
+        break;
+      case 3:
+        neon_biquad_group(c, zs, stride, src, step, dst, lanes, frames, 3);
+        break;
+      default:
+        neon_biquad_group(c, zs, stride, src, step, dst, lanes, frames,
+                          LE_BIQUAD_GROUP);
+        break;
+      }
+    }
+  }
+  le_biquad_bank_tail(coef, z, stride, lanes, stages, in, in_stride, out,
+                      frames, l);
+}
+
+static const LeSimdKernels k_neon = {.level = LE_SIMD_NEON,
+                                     .dot2 = neon_dot2,
+                                     .energy2 = neon_energy2,
+                                     .update2 = neon_update2,
+                                     .cmac = neon_cmac,
+                                     .cmac_conj = neon_cmac_conj,
+                                     .fft_radix4 = neon_fft_radix4,
+                                     .biquad_bank = neon_biquad_bank};
+
+const LeSimdKernels *le_simd_table_neon(void) { return &k_neon; }
+
+#else
+
+const LeSimdKernels *le_simd_table_neon(void) { return NULL; }
+
+#endif
@@ -0,0 +1,55 @@
+/**
+ * @file simd_scalar.c
+ * @brief Portable kernel variants (no SIMD)
+ */
+
+#include "simd_kernels.h"
+
+static float scalar_dot2(const float *w1, const float *u1, const float *w2,
+                         const float *u2, int M) {
+  return le_dot2_tail(0.0f, w1, u1, w2, u2, 0, M);
+}
+
+static float scalar_energy2(const float *u1, const float *u2, int M) {
+  return le_energy2_tail(0.0f, u1, u2, 0, M);
+}
+
+static void scalar_update2(float *w1, const float *u1, float *w2,
+                           const float *u2, int M, float leak, float factor) {
+  le_update2_tail(w1, u1, w2, u2, 0, M, leak, factor);
+}
+
+static void scalar_cmac(float *acc_re, float *acc_im, const float *w_re,
+                        const float *w_im, const float *x_re,
+                        const float *x_im, int n) {
+  le_cmac_tail(acc_re, acc_im, w_re, w_im, x_re, x_im, 0, n);
+}
+
+static void scalar_cmac_conj(float *out_re, float *out_im, const float *w_re,
+                             const float *w_im, const float *x_re,
+                             const float *x_im, const float *e_re,
+                             const float *e_im, int n) {
+  le_cmac_conj_tail(out_re, out_im, w_re, w_im, x_re, x_im, e_re, e_im, 0, n);
+}
+
+static void scalar_fft_radix4(float *re, float *im, int h, const float *tw) {
+  le_fft_radix4_tail(re, im, h, 0, tw);
+}
+
+static void scalar_biquad_bank(const float *coef, float *z, int stride,
+                               int lanes, int stages, const float *in,
+                               int in_stride, float *out, int frames) {
+  le_biquad_bank_tail(coef, z, stride, lanes, stages, in, in_stride, out,
+                      frames, 0);
+}
+
+static const LeSimdKernels k_scalar = {.level = LE_SIMD_SCALAR,
+                                       .dot2 = scalar_dot2,
+                                       .energy2 = scalar_energy2,
+                                       .update2 = scalar_update2,
+                                       .cmac = scalar_cmac,
+                                       .cmac_conj = scalar_cmac_conj,
+                                       .fft_radix4 = scalar_fft_radix4,
+                                       .biquad_bank = scalar_biquad_bank};
+
+const LeSimdKernels *le_simd_table_scalar(void) { return &k_scalar; }
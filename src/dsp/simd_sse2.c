@@ -0,0 +1,231 @@
+/**
+ * @file simd_sse2.c
+ * @brief SSE2 kernel variants (x86-64 baseline, no FMA)
+ */
+
+#include "simd_kernels.h"
+
+#if defined(__SSE2__) || defined(_M_X64) ||                                    \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+
+// Lane-by-lane horizontal sum
+static inline float sse2_hsum(__m128 v) {
+  float temp[4];
+  _mm_storeu_ps(temp, v);
+  return ((temp[0] + temp[1]) + temp[2]) + temp[3];
+}
+
+static float sse2_dot2(const float *w1, const float *u1, const float *w2,
+                       const float *u2, int M) {
+  int k = 0;
+  const int M_simd = M - (M % 4);
+  __m128 v_acc = _mm_setzero_ps();
+  for (; k < M_simd; k += 4) {
+    v_acc = _mm_add_ps(v_acc,
+                       _mm_mul_ps(_mm_loadu_ps(&w1[k]), _mm_loadu_ps(&u1[k])));
+    v_acc = _mm_add_ps(v_acc,
+                       _mm_mul_ps(_mm_loadu_ps(&w2[k]), _mm_loadu_ps(&u2[k])));
+  }
+  return le_dot2_tail(sse2_hsum(v_acc), w1, u1, w2, u2, k, M);
+}
+
+static float sse2_energy2(const float *u1, const float *u2, int M) {
+  int k = 0;
+  const int M_simd = M - (M % 4);
+  __m128 v_acc = _mm_setzero_ps();
+  for (; k < M_simd; k += 4) {
+    __m128 v_u1 = _mm_loadu_ps(&u1[k]);
+    v_acc = _mm_add_ps(v_acc, _mm_mul_ps(v_u1, v_u1));
+    __m128 v_u2 = _mm_loadu_ps(&u2[k]);
+    v_acc = _mm_add_ps(v_acc, _mm_mul_ps(v_u2, v_u2));
+  }
+  return le_energy2_tail(sse2_hsum(v_acc), u1, u2, k, M);
+}
+
+static void sse2_update2(float *w1, const float *u1, float *w2,
+                         const float *u2, int M, float leak, float factor) {
+  int k = 0;
+  const int M_simd = M - (M % 4);
+  __m128 v_factor = _mm_set1_ps(factor);
+  __m128 v_leak = _mm_set1_ps(leak);
+  for (; k < M_simd; k += 4) {
+    __m128 v_w1 = _mm_mul_ps(v_leak, _mm_loadu_ps(&w1[k]));
+    v_w1 = _mm_add_ps(v_w1, _mm_mul_ps(v_factor, _mm_loadu_ps(&u1[k])));
+    _mm_storeu_ps(&w1[k], v_w1);
+
+    __m128 v_w2 = _mm_mul_ps(v_leak, _mm_loadu_ps(&w2[k]));
+    v_w2 = _mm_add_ps(v_w2, _mm_mul_ps(v_factor, _mm_loadu_ps(&u2[k])));
+    _mm_storeu_ps(&w2[k], v_w2);
+  }
+  le_update2_tail(w1, u1, w2, u2, k, M, leak, factor);
+}
+
+static void sse2_cmac(float *acc_re, float *acc_im, const float *w_re,
+                      const float *w_im, const float *x_re, const float *x_im,
+                      int n) {
+  int k = 0;
+  const int n_simd = n - (n % 4);
+  for (; k < n_simd; k += 4) {
+    __m128 wr = _mm_loadu_ps(&w_re[k]), wi = _mm_loadu_ps(&w_im[k]);
+    __m128 xr = _mm_loadu_ps(&x_re[k]), xi = _mm_loadu_ps(&x_im[k]);
+    __m128 pr = _mm_sub_ps(_mm_mul_ps(wr, xr), _mm_mul_ps(wi, xi));
+    __m128 pi = _mm_add_ps(_mm_mul_ps(wr, xi), _mm_mul_ps(wi, xr));
+    _mm_storeu_ps(&acc_re[k], _mm_add_ps(_mm_loadu_ps(&acc_re[k]), pr));
+    _mm_storeu_ps(&acc_im[k], _mm_add_ps(_mm_loadu_ps(&acc_im[k]), pi));
+  }
+  le_cmac_tail(acc_re, acc_im, w_re, w_im, x_re, x_im, k, n);
+}
+
+static void sse2_cmac_conj(float *out_re, float *out_im, const float *w_re,
+                           const float *w_im, const float *x_re,
+                           const float *x_im, const float *e_re,
+                           const float *e_im, int n) {
+  int k = 0;
+  const int n_simd = n - (n % 4);
+  for (; k < n_simd; k += 4) {
+    __m128 xr = _mm_loadu_ps(&x_re[k]), xi = _mm_loadu_ps(&x_im[k]);
+    __m128 er = _mm_loadu_ps(&e_re[k]), ei = _mm_loadu_ps(&e_im[k]);
+    __m128 r = _mm_add_ps(_mm_loadu_ps(&w_re[k]),
+                          _mm_add_ps(_mm_mul_ps(xr, er), _mm_mul_ps(xi, ei)));
+    __m128 i = _mm_add_ps(_mm_loadu_ps(&w_im[k]),
+                          _mm_sub_ps(_mm_mul_ps(xr, ei), _mm_mul_ps(xi, er)));
+    _mm_storeu_ps(&out_re[k], r);
+    _mm_storeu_ps(&out_im[k], i);
+  }
+  le_cmac_conj_tail(out_re, out_im, w_re, w_im, x_re, x_im, e_re, e_im, k, n);
+}
+
+// (ar + j ai) * (br + j bi)
+#define SSE2_CMUL_RE(ar, ai, br, bi)                                           \
+  _mm_sub_ps(_mm_mul_ps(ar, br), _mm_mul_ps(ai, bi))
+#define SSE2_CMUL_IM(ar, ai, br, bi)                                           \
+  _mm_add_ps(_mm_mul_ps(ar, bi), _mm_mul_ps(ai, br))
+
+static void sse2_fft_radix4(float *re, float *im, int h, const float *tw) {
+  int k = 0;
+  const int h_simd = h - (h % 4);
+  for (; k < h_simd; k += 4) {
+    float *ra = re + k, *ia = im + k;
+    float *rb = ra + h, *ib = ia + h;
+    float *rc = rb + h, *ic = ib + h;
+    float *rd = rc + h, *id = ic + h;
+    __m128 w1r = _mm_loadu_ps(tw + k);
+    __m128 w1i = _mm_loadu_ps(tw + h + k);
+    __m128 w2r = _mm_loadu_ps(tw + 2 * h + k);
+    __m128 w2i = _mm_loadu_ps(tw + 3 * h + k);
+
+    __m128 xbr = _mm_loadu_ps(rb), xbi = _mm_loadu_ps(ib);
+    __m128 xdr = _mm_loadu_ps(rd), xdi = _mm_loadu_ps(id);
+    __m128 tbr = SSE2_CMUL_RE(xbr, xbi, w1r, w1i);
+    __m128 tbi = SSE2_CMUL_IM(xbr, xbi, w1r, w1i);
+    __m128 tdr = SSE2_CMUL_RE(xdr, xdi, w1r, w1i);
+    __m128 tdi = SSE2_CMUL_IM(xdr, xdi, w1r, w1i);
+
+    __m128 xar = _mm_loadu_ps(ra), xai = _mm_loadu_ps(ia);
+    __m128 xcr = _mm_loadu_ps(rc), xci = _mm_loadu_ps(ic);
+    __m128 a1r = _mm_add_ps(xar, tbr), a1i = _mm_add_ps(xai, tbi);
+    __m128 b1r = _mm_sub_ps(xar, tbr), b1i = _mm_sub_ps(xai, tbi);
+    __m128 c1r = _mm_add_ps(xcr, tdr), c1i = _mm_add_ps(xci, tdi);
+    __m128 d1r = _mm_sub_ps(xcr, tdr), d1i = _mm_sub_ps(xci, tdi);
+
+    __m128 tcr = SSE2_CMUL_RE(c1r, c1i, w2r, w2i);
+    __m128 tci = SSE2_CMUL_IM(c1r, c1i, w2r, w2i);
+    __m128 tr = SSE2_CMUL_RE(d1r, d1i, w2r, w2i);
+    __m128 ti = SSE2_CMUL_IM(d1r, d1i, w2r, w2i);
+
+    _mm_storeu_ps(ra, _mm_add_ps(a1r, tcr));
+    _mm_storeu_ps(ia, _mm_add_ps(a1i, tci));
+    _mm_storeu_ps(rc, _mm_sub_ps(a1r, tcr));
+    _mm_storeu_ps(ic, _mm_sub_ps(a1i, tci));
+    _mm_storeu_ps(rb, _mm_add_ps(b1r, ti));
+    _mm_storeu_ps(ib, _mm_sub_ps(b1i, tr));
+    _mm_storeu_ps(rd, _mm_sub_ps(b1r, ti));
+    _mm_storeu_ps(id, _mm_add_ps(b1i, tr));
+  }
+  le_fft_radix4_tail(re, im, h, k, tw);
+}
+
+// Up to LE_BIQUAD_GROUP stages on four lanes, the sections in registers
+// for the whole block (G is a constant at every call)
+static inline void sse2_biquad_group(const float *c, float *zs, int stride,
+                                     const float *src, int step, float *dst,
+                                     int lanes, int frames, const int G) {
+  __m128 b0[LE_BIQUAD_GROUP], b1[LE_BIQUAD_GROUP], b2[LE_BIQUAD_GROUP];
+  __m128 a1[LE_BIQUAD_GROUP], a2[LE_BIQUAD_GROUP];
+  __m128 z1[LE_BIQUAD_GROUP], z2[LE_BIQUAD_GROUP];
+  for (int s = 0; s < G; s++) {
+    const float *cs = c + s * 5 * stride;
+    b0[s] = _mm_loadu_ps(cs);
+    b1[s] = _mm_loadu_ps(cs + stride);
+    b2[s] = _mm_loadu_ps(cs + 2 * stride);
+    a1[s] = _mm_loadu_ps(cs + 3 * stride);
+    a2[s] = _mm_loadu_ps(cs + 4 * stride);
+    z1[s] = _mm_loadu_ps(zs + s * 2 * stride);
+    z2[s] = _mm_loadu_ps(zs + s * 2 * stride + stride);
+  }
+  for (int n = 0; n < frames; n++) {
+    __m128 x = step ? _mm_loadu_ps(src + n * step) : _mm_set1_ps(src[n]);
+    for (int s = 0; s < G; s++) {
+      __m128 y = _mm_add_ps(_mm_mul_ps(b0[s], x), z1[s]);
+      z1[s] = _mm_add_ps(
+          _mm_sub_ps(_mm_mul_ps(b1[s], x), _mm_mul_ps(a1[s], y)), z2[s]);
+      z2[s] = _mm_sub_ps(_mm_mul_ps(b2[s], x), _mm_mul_ps(a2[s], y));
+      x = y;
+    }
+    _mm_storeu_ps(dst + n * lanes, x);
+  }
+  for (int s = 0; s < G; s++) {
+    _mm_storeu_ps(zs + s * 2 * stride, z1[s]);
+    _mm_storeu_ps(zs + s * 2 * stride + stride, z2[s]);
+  }
+}
+
+static void sse2_biquad_bank(const float *coef, float *z, int stride,
+                             int lanes, int stages, const float *in,
+                             int in_stride, float *out, int frames) {
+  int l = 0;
+  for (; l + 4 <= lanes; l += 4) {
+    for (int s0 = 0; s0 < stages; s0 += LE_BIQUAD_GROUP) {
+      int step;
+      const float *src = le_biquad_src(in, in_stride, out, lanes, s0, l, &step);
+      const float *c = coef + s0 * 5 * stride + l;
+      float *zs = z + s0 * 2 * stride + l;
+      float *dst = out + l;
+      switch (stages - s0) {
+      case 1:
+        sse2_biquad_group(c, zs, stride, src, step, dst, lanes, frames, 1);
+        break;
+      case 2:
+        sse2_biquad_group(c, zs, stride, src, step, dst, lanes, frames, 2);
+        break;
+      case 3:
+        sse2_biquad_group(c, zs, stride, src, step, dst, lanes, frames, 3);
+        break;
+      default:
+        sse2_biquad_group(c, zs, stride, src, step, dst, lanes, frames,
+                          LE_BIQUAD_GROUP);
+        break;
+      }
+    }
+  }
+  le_biquad_bank_tail(coef, z, stride, lanes, stages, in, in_stride, out,
+                      frames, l);
+}
+
+static const LeSimdKernels k_sse2 = {.level = LE_SIMD_SSE2,
+                                     .dot2 = sse2_dot2,
+                                     .energy2 = sse2_energy2,
+                                     .update2 = sse2_update2,
+                                     .cmac = sse2_cmac,
+                                     .cmac_conj = sse2_cmac_conj,
+                                     .fft_radix4 = sse2_fft_radix4,
+                                     .biquad_bank = sse2_biquad_bank};
+
+const LeSimdKernels *le_simd_table_sse2(void) { return &k_sse2; }
+
+#else
+
+const LeSimdKernels *le_simd_table_sse2(void) { return NULL; }
+
+#endif
@@ -87,10 +87,8 @@ void spatial_spectral_batch(const Mic4Batch *in, OutputBatch *out,
   // Step 1: Batch beamforming
   steer_batch_process(in, out, theta_idx, count);
 
-  // Step 2: Apply multiband EQ to each sample
-  for (int i = 0; i < count; i++) {
-    out->out[i] = multiband_process(mb, out->out[i]);
-  }
+  // Step 2: Apply multiband EQ to the whole batch (bands in parallel)
+  multiband_process_block(mb, out->out, out->out, count);
 }
 
 void perf_reset(PerfMetrics *m) {
@@ -99,10 +97,11 @@ void perf_reset(PerfMetrics *m) {
   m->avg_cycles_per_sample = 0;
 }
 
-void perf_update(PerfMetrics *m, uint32_t samples, uint32_t cycles) {
+void perf_update(PerfMetrics *m, uint64_t samples, uint64_t cycles) {
   m->samples_processed += samples;
   m->total_cycles += cycles;
   if (m->samples_processed > 0) {
-    m->avg_cycles_per_sample = (float)m->total_cycles / m->samples_processed;
+    m->avg_cycles_per_sample =
+        (float)((double)m->total_cycles / (double)m->samples_processed);
   }
 }
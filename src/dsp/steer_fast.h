@@ -127,14 +127,16 @@ void spatial_spectral_batch(const Mic4Batch *in, OutputBatch *out,
 // Performance Metrics
 // ============================================================================
 
+// 64-bit totals: 32-bit cycle counts wrap after about two seconds at GHz
+// rates (the pipeline stage profiler accumulates for the whole run)
 typedef struct {
-  uint32_t samples_processed;
-  uint32_t total_cycles;
+  uint64_t samples_processed;
+  uint64_t total_cycles;
   float avg_cycles_per_sample;
 } PerfMetrics;
 
 void perf_reset(PerfMetrics *m);
-void perf_update(PerfMetrics *m, uint32_t samples, uint32_t cycles);
+void perf_update(PerfMetrics *m, uint64_t samples, uint64_t cycles);
 
 #ifdef __cplusplus
 }
@@ -1,158 +1,367 @@
+#include "app/batch.h"
+#include "app/latency_probe.h"
+#include "app/offline.h"
+#include "app/pipeline.h"
+#include "app/tuner.h"
 #include "audio/audio_io.h"
-#include "dsp/aec.h"
-#include "dsp/agc.h"
-#include "dsp/gsc.h"
-#include "dsp/noise_gate.h"
+#include "dsp/simd_dispatch.h"
 #include "platform/platform.h"
 #include "server/web_server.h"
 #include "utils/config.h"
-#include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
-// Context wrapper for callback
-typedef struct {
-  GscState st;
-  GscConfig cfg;
-  float *gsc_mem;
-
-  // DSP States
-  AecState aec;
-  AgcState agc;
-  NoiseGateState ng;
-
-  // DSP Buffers
-  float *aec_mem;
-
-  // Controls
-  int aec_on;
-  int agc_on;
-  int ng_on;
-
-  // History
-  float last_ref_sample; // For AEC loopback
-} AppContext;
-
-// GSC Processing Callback
-int process_audio(const float *in, float *out, int frames, void *user) {
-  AppContext *ctx = (AppContext *)user;
-
-  // Check for control updates
-  float ctrl_alpha, ctrl_leak, ctrl_mu_max;
-
-  // We check both getters
-  int params_updated = 0;
-  if (server_get_ctrl_params(&ctrl_alpha, &ctrl_leak, &ctrl_mu_max)) {
-    ctx->cfg.alpha = ctrl_alpha;
-    ctx->cfg.leak_lambda = ctrl_leak;
-    ctx->cfg.mu_max = ctrl_mu_max;
-    params_updated = 1;
-  }
-
-  int aec_on, agc_on, ng_on;
-  float agc_target, ng_thresh;
-  if (server_get_dsp_params(&aec_on, &agc_on, &ng_on, &agc_target,
-                            &ng_thresh)) {
-    ctx->aec_on = aec_on;
-    ctx->agc_on = agc_on;
-    ctx->ng_on = ng_on;
-
-    // Update internal params if needed (re-init or setters? For now re-init is
-    // heavy, maybe just direct struct access or specific setters) Since our
-    // simple DSP libs expose structs:
-    if (agc_on) {
-      // Re-calc target RMS from dB?
-      // agc_target is in dB.
-      ctx->agc.target_rms = powf(10.0f, agc_target / 20.0f);
-    }
-    if (ng_on) {
-      ctx->ng.threshold_linear = powf(10.0f, ng_thresh / 20.0f);
-    }
-    params_updated = 1;
-  }
-
-  if (params_updated) {
-    // Logging could be verbose here, minimizing
-  }
-
-  float sum_l = 0, sum_r = 0, sum_b = 0, sum_e = 0;
-
-  // Profiling
-  double start_us = platform_time_us();
-
-  for (int i = 0; i < frames; i++) {
-    float xL = in[i * 3 + 0];
-    float xR = in[i * 3 + 1];
-    float xB = in[i * 3 + 2];
+static void print_usage(const char *prog) {
+  printf("Usage: %s [--list-devices]\n"
+         "       %s --offline <in.wav|in.raw> [out.wav] [--raw <channels>]\n"
+         "          [--rate <hz>]\n"
+         "       %s --batch <dir|manifest> [--out-dir <dir>] [--jobs <n>]\n"
+         "          [--csv <results.csv>] [--raw <channels>] [--rate <hz>]\n"
+         "       %s --tune <manifest> [--tune-method grid|adaptive]\n"
+         "          [--trials <n>] [--jobs <n>] [--tune-out <gsc.json>]\n"
+         "       %s --latency [--latency-repeats <n>] [--latency-channel "
+         "L|R|B]\n"
+         "       %s [--monitor-interval <s>]   (0: no deadline log)\n"
+         "          [--beam front|back|left|right]   (4-mic devices)\n"
+         "          [--mic-hpf <hz>]   (per-mic DC blocker, 0: off)\n"
+         "Any mode: [--simd scalar|sse2|avx2|avx512|neon] (default: best "
+         "the CPU supports)\n",
+         prog, prog, prog, prog, prog, prog);
+}
 
-    // 1. GSC (Beamforming)
-    float y = gsc_process_sample(&ctx->st, &ctx->cfg, xL, xR, xB);
+// Deadline summary of the last interval, printed from the polling loop
+static void log_monitor(DeadlineMonitor *m, DeadlineStats *prev,
+                        double interval_s) {
+  DeadlineStats now, d;
+  deadline_monitor_snapshot(m, &now);
+  deadline_stats_diff(&now, prev, &d);
+  *prev = now;
+  if (d.blocks == 0)
+    return;
+  printf("DSP Load: %.1f%% over %lld blocks (p50 %.0f us, p99 %.0f us, max "
+         "%.0f us), overruns %lld, xruns %lld",
+         100.0 * deadline_stats_load(&d), d.blocks,
+         deadline_stats_quantile_us(&d, 0.5),
+         deadline_stats_quantile_us(&d, 0.99),
+         deadline_stats_quantile_us(&d, 1.0), d.overruns,
+         deadline_stats_xruns(&d));
+#ifdef LE_COUNT_DENORMALS
+  printf(", denormals %lld", d.denormals);
+#endif
+  printf(" [%.0f s]\n", interval_s);
+}
 
-    // 2. AEC (Remove echo of PREVIOUS output from CURRENT input)
-    // Ref: ctx->last_ref_sample
-    if (ctx->aec_on) {
-      // AEC returns the error signal (echo removed)
-      y = aec_process(&ctx->aec, y, ctx->last_ref_sample);
-    }
+// Headless mode: run the same pipeline over a file as fast as possible
+static int run_offline(const OfflineOptions *opts, const PipelineConfig *cfg) {
+  OfflineStats stats;
+  printf("Offline: %s -> %s\n", opts->in_path,
+         opts->out_path ? opts->out_path : "(discarded)");
+  if (offline_run(opts, cfg, &stats) != 0)
+    return 1;
+  printf("Processed %ld frames (%.2f s of audio) in %.2f ms\n", stats.frames,
+         (double)stats.frames / stats.sample_rate, stats.wall_us / 1000.0);
+  printf("Throughput: %.0f samples/s, real-time factor %.4f (%.1fx "
+         "real-time)\n",
+         stats.samples_per_sec, stats.rtf,
+         stats.rtf > 0.0 ? 1.0 / stats.rtf : 0.0);
+  return 0;
+}
 
-    // 3. AGC
-    if (ctx->agc_on) {
-      y = agc_process(&ctx->agc, y);
-    }
+#ifdef LE_PROFILE_STAGES
+// Where the DSP time goes, per stage of the chain
+static void print_profile(StageProfile *profile) {
+  StageProfileStats s;
+  stage_profile_snapshot(profile, &s);
+  printf("Stage profile (%lld blocks, %.0f ticks/us):\n", s.blocks,
+         s.ticks_per_us);
+  double total = 0.0;
+  for (int i = 0; i < PIPE_STAGE_COUNT; i++)
+    total += (double)s.stage[i].total_cycles;
+  for (int i = 0; i < PIPE_STAGE_COUNT; i++) {
+    const PerfMetrics *m = &s.stage[i];
+    printf("  %-6s %9.1f ticks/sample %9.2f us/block %5.1f%%\n",
+           stage_profile_name((PipelineStage)i), m->avg_cycles_per_sample,
+           stage_profile_us_per_block(&s, (PipelineStage)i),
+           total > 0.0 ? 100.0 * (double)m->total_cycles / total : 0.0);
+  }
+}
+#endif
 
-    // 4. Noise Gate
-    if (ctx->ng_on) {
-      y = noise_gate_process(&ctx->ng, y);
-    }
+// Headless batch mode: many recordings in parallel, aggregated metrics
+static int run_batch(const char *source, const char *out_dir, int jobs,
+                     const char *csv, const OfflineOptions *base,
+                     const PipelineConfig *cfg) {
+  BatchList list;
+  if (batch_collect(source, out_dir, &list) != 0) {
+    fprintf(stderr, "Cannot read batch source: %s\n", source);
+    batch_list_free(&list);
+    return 1;
+  }
+  BatchResult *results = calloc(list.count > 0 ? list.count : 1,
+                                sizeof(BatchResult));
+  if (!results) {
+    batch_list_free(&list);
+    return 1;
+  }
 
-    // Stats accumulation (using y as 'e' - enhanced)
-    sum_l += xL * xL;
-    sum_r += xR * xR;
-    sum_b += xB * xB;
-    sum_e += y * y;
+  BatchSummary sum;
+  batch_run(list.jobs, list.count, base, cfg, jobs, results, &sum);
+  for (int i = 0; i < list.count; i++) {
+    const BatchResult *r = &results[i];
+    if (r->status != 0)
+      printf("  FAILED  %s\n", list.jobs[i].in_path);
+    else
+      printf("  %-40s %7.1f s  rms %.4f -> %.4f  beta %+.3f  conv %.2f s\n",
+             list.jobs[i].in_path, (double)r->frames / r->sample_rate,
+             r->rms_in, r->rms_out, r->beta_final, r->convergence_s);
+  }
+  printf("Batch: %d files (%d failed) on %d threads, %.1f s of audio in "
+         "%.2f s (%.0fx real-time, DSP %.2f s)\n",
+         sum.files, sum.failed, sum.threads, sum.audio_s, sum.wall_s,
+         sum.speedup, sum.dsp_s);
+  printf("Mean output RMS %.4f, mean convergence %.2f s\n", sum.mean_rms_out,
+         sum.mean_convergence_s);
+
+  int rc = sum.failed > 0 ? 1 : 0;
+  if (csv && batch_write_csv(csv, list.jobs, results, list.count) != 0) {
+    fprintf(stderr, "Cannot write %s\n", csv);
+    rc = 1;
+  }
+  free(results);
+  batch_list_free(&list);
+  return rc;
+}
 
-    // Output
-    out[i * 2 + 0] = y;
-    out[i * 2 + 1] = y;
+// Parameter search: score GscConfig candidates over a labelled corpus and
+// write the best one as a "gsc" config section
+static int run_tune(const char *manifest, const char *out_path,
+                    const TuneOptions *opts, const int channel_map[3],
+                    const PipelineConfig *cfg) {
+  TuneCorpus corpus;
+  memset(&corpus, 0, sizeof(corpus));
+  if (tune_corpus_load(&corpus, manifest, channel_map) != 0 ||
+      corpus.count == 0) {
+    fprintf(stderr, "No usable corpus items in %s\n", manifest);
+    tune_corpus_free(&corpus);
+    return 1;
+  }
 
-    // Update reference for next sample
-    ctx->last_ref_sample = y;
+  double t0 = platform_time_us();
+  TuneResult best;
+  int evaluated = 0;
+  int rc = tune_run(&corpus, cfg, opts, &best, NULL, 0, &evaluated);
+  double wall_s = (platform_time_us() - t0) * 1e-6;
+  int items = corpus.count;
+  tune_corpus_free(&corpus);
+  if (rc != 0) {
+    fprintf(stderr, "Tuning failed\n");
+    return 1;
   }
 
-  double end_us = platform_time_us();
-  double elapsed_us = end_us - start_us;
+  printf("Tune: %d candidates x %d items (%s) in %.2f s\n", evaluated,
+         items, opts->method == TUNE_METHOD_GRID ? "grid" : "adaptive",
+         wall_s);
+  printf("Best: score %.2f, SI-SNR gain %+.2f dB, convergence %.2f s\n",
+         best.score, best.snr_gain_db, best.convergence_s);
+  printf("  alpha %g mu_max %g eta_max %g leak_lambda %g g_lo %g g_hi %g\n",
+         best.gsc.alpha, best.gsc.mu_max, best.gsc.eta_max,
+         best.gsc.leak_lambda, best.gsc.g_lo, best.gsc.g_hi);
+  if (config_save_gsc(out_path, &best.gsc) != 0) {
+    fprintf(stderr, "Cannot write %s\n", out_path);
+    return 1;
+  }
+  printf("Wrote %s\n", out_path);
+  return 0;
+}
 
-  static double max_us = 0;
-  static long long call_count = 0;
+// Value below which a fraction q of the histogram lies (bin upper edge)
+static double timing_percentile(const long long *hist, long long total,
+                                double q) {
+  long long acc = 0;
+  for (int i = 0; i < AUDIO_TIMING_BINS; i++) {
+    acc += hist[i];
+    if (acc >= q * total)
+      return (i + 1) * AUDIO_TIMING_BIN_MS;
+  }
+  return AUDIO_TIMING_BINS * AUDIO_TIMING_BIN_MS;
+}
 
-  if (elapsed_us > max_us)
-    max_us = elapsed_us;
-  call_count++;
+static void print_timing(const char *what, const long long *hist,
+                         long long total) {
+  printf("  %-6s p1 %6.1f  p50 %6.1f  p99 %6.1f  max %6.1f ms\n", what,
+         timing_percentile(hist, total, 0.01),
+         timing_percentile(hist, total, 0.5),
+         timing_percentile(hist, total, 0.99),
+         timing_percentile(hist, total, 1.0));
+}
 
-  if (call_count % 100 == 0) {
-    printf("DSP Load: %.2f us / block (Max: %.2f us)\n", elapsed_us, max_us);
-    max_us = 0;
+// Round-trip measurement: MLS on the outputs, correlated on one input.
+// Needs a loopback cable or a speaker the microphone can hear.
+static int run_latency(const AudioConfig *audio_cfg, int repeats,
+                       int channel) {
+  LatencyProbeConfig pcfg;
+  latency_probe_default_config(&pcfg, audio_cfg->sample_rate);
+  pcfg.output_channels = audio_cfg->output_channels;
+  pcfg.input_channels = audio_mic_count(audio_cfg);
+  pcfg.channel = channel;
+  if (repeats > 0)
+    pcfg.repeats = repeats;
+  LatencyProbe *lp = latency_probe_create(&pcfg);
+  if (!lp) {
+    fprintf(stderr, "Invalid latency probe settings\n");
+    return 1;
   }
 
-  // Update Server Stats
-  if (frames > 0) {
-    server_update_rms(sqrtf(sum_l / frames), sqrtf(sum_r / frames),
-                      sqrtf(sum_b / frames), sqrtf(sum_e / frames));
-    server_update_params(ctx->st.beta, ctx->st.last_mu);
+  AudioIO *aio = NULL;
+  if (audio_open(&aio, audio_cfg, latency_probe_process, lp) != 0 ||
+      audio_start(aio) != 0) {
+    fprintf(stderr, "Failed to start audio\n");
+    if (aio)
+      audio_close(aio);
+    latency_probe_destroy(lp);
+    return 1;
+  }
+  double run_s =
+      (double)(pcfg.repeats + 1) * pcfg.fft_size / audio_cfg->sample_rate;
+  printf("Latency probe: %d x %.2f s on input %c, output -> input loopback "
+         "required\n",
+         pcfg.repeats, (double)pcfg.fft_size / audio_cfg->sample_rate,
+         "LRB"[channel]);
+
+  // Twice the expected time before giving up on a stalled stream
+  double deadline = platform_time_us() + 2e6 * run_s + 2e6;
+  int rt_reported = 0;
+  while (!latency_probe_done(lp) && platform_time_us() < deadline) {
+    if (!rt_reported)
+      rt_reported = audio_report_rt_status(aio);
+    platform_sleep_ms(50);
+  }
+  int done = latency_probe_done(lp);
+
+  double in_s = 0.0, out_s = 0.0;
+  int have_latency = audio_get_latency(aio, &in_s, &out_s) == 0;
+  AudioTimingStats timing;
+  int have_timing = audio_get_timing(aio, &timing) == 0;
+  audio_stop(aio);
+  audio_close(aio);
+
+  LatencyResult res;
+  int rc = 0;
+  if (!done || latency_probe_analyze(lp, &res) != 0) {
+    fprintf(stderr, "Stream stalled, no measurement\n");
+    rc = 1;
+  } else if (res.input_rms < 1e-4f) {
+    fprintf(stderr, "No signal on input %c (RMS %.2g): check the loopback\n",
+            "LRB"[channel], res.input_rms);
+    rc = 1;
+  } else {
+    double ms_per_sample = 1000.0 / audio_cfg->sample_rate;
+    printf("Round trip: %.2f ms (%.1f samples), spread %.2f ms over %d "
+           "measurements\n",
+           res.median_ms, res.median_samples,
+           (res.max_samples - res.min_samples) * ms_per_sample, res.count);
+    if (res.max_samples - res.min_samples > 0.001f * audio_cfg->sample_rate)
+      printf("Warning: measurements disagree, check level and noise\n");
+    if (have_latency) {
+      double reported_ms = 1000.0 * (in_s + out_s);
+      printf("Reported: input %.2f ms + output %.2f ms = %.2f ms, "
+             "unaccounted %.2f ms (converters, path)\n",
+             1000.0 * in_s, 1000.0 * out_s, reported_ms,
+             res.median_ms - reported_ms);
+    }
   }
 
-  return 0; // Continue
+  if (have_timing && timing.callbacks > 0) {
+    printf("Per-callback latency from host timestamps (%lld callbacks):\n",
+           timing.callbacks);
+    print_timing("input", timing.input_ms, timing.callbacks);
+    print_timing("output", timing.output_ms, timing.callbacks);
+  } else if (have_timing) {
+    printf("Host API provided no callback timestamps\n");
+  }
+  latency_probe_destroy(lp);
+  return rc;
 }
 
 int main(int argc, char **argv) {
   // Initialize platform subsystem
   platform_init();
-  // Check for --list-devices
+  le_simd_init(); // Before any thread: --simd and module inits build on it
+
+  OfflineOptions offline;
+  offline_default_options(&offline);
+  const char *batch_src = NULL, *batch_out = NULL, *batch_csv = NULL;
+  int batch_jobs = 0; // One worker per core
+  const char *tune_manifest = NULL, *tune_out = "tuned_gsc.json";
+  TuneOptions tune;
+  tune_default_options(&tune);
+  int latency_mode = 0, latency_repeats = 0, latency_channel = 0;
+  double monitor_interval_s = 10.0;
+  BeamDirection beam_dir = BEAM_DIR_FRONT;
+  float mic_hpf_hz = 0.0f;
   for (int i = 1; i < argc; i++) {
     if (strcmp(argv[i], "--list-devices") == 0) {
       audio_print_devices();
       return 0;
+    } else if (strcmp(argv[i], "--offline") == 0 && i + 1 < argc) {
+      offline.in_path = argv[++i];
+      if (i + 1 < argc && argv[i + 1][0] != '-')
+        offline.out_path = argv[++i];
+    } else if (strcmp(argv[i], "--batch") == 0 && i + 1 < argc) {
+      batch_src = argv[++i];
+    } else if (strcmp(argv[i], "--out-dir") == 0 && i + 1 < argc) {
+      batch_out = argv[++i];
+    } else if (strcmp(argv[i], "--jobs") == 0 && i + 1 < argc) {
+      batch_jobs = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--csv") == 0 && i + 1 < argc) {
+      batch_csv = argv[++i];
+    } else if (strcmp(argv[i], "--tune") == 0 && i + 1 < argc) {
+      tune_manifest = argv[++i];
+    } else if (strcmp(argv[i], "--tune-method") == 0 && i + 1 < argc) {
+      i++;
+      tune.method = strcmp(argv[i], "grid") == 0 ? TUNE_METHOD_GRID
+                                                 : TUNE_METHOD_ADAPTIVE;
+    } else if (strcmp(argv[i], "--trials") == 0 && i + 1 < argc) {
+      tune.trials = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--tune-out") == 0 && i + 1 < argc) {
+      tune_out = argv[++i];
+    } else if (strcmp(argv[i], "--latency") == 0) {
+      latency_mode = 1;
+    } else if (strcmp(argv[i], "--latency-repeats") == 0 && i + 1 < argc) {
+      latency_repeats = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--latency-channel") == 0 && i + 1 < argc) {
+      const char *c = argv[++i];
+      latency_channel = c[0] == 'R' ? 1 : c[0] == 'B' ? 2 : 0;
+    } else if (strcmp(argv[i], "--monitor-interval") == 0 && i + 1 < argc) {
+      monitor_interval_s = atof(argv[++i]);
+    } else if (strcmp(argv[i], "--beam") == 0 && i + 1 < argc) {
+      const char *b = argv[++i];
+      beam_dir = b[0] == 'b'   ? BEAM_DIR_BACK
+                 : b[0] == 'l' ? BEAM_DIR_LEFT
+                 : b[0] == 'r' ? BEAM_DIR_RIGHT
+                               : BEAM_DIR_FRONT;
+    } else if (strcmp(argv[i], "--mic-hpf") == 0 && i + 1 < argc) {
+      mic_hpf_hz = (float)atof(argv[++i]);
+    } else if (strcmp(argv[i], "--simd") == 0 && i + 1 < argc) {
+      // Before any DSP module is initialized: they latch the table at init
+      const char *level = argv[++i];
+      if (le_simd_set_level((LeSimdLevel)le_simd_parse(level)) != 0) {
+        fprintf(stderr, "SIMD level '%s' is not available on this CPU\n",
+                level);
+        return 1;
+      }
+    } else if (strcmp(argv[i], "--raw") == 0 && i + 1 < argc) {
+      offline.raw_channels = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--rate") == 0 && i + 1 < argc) {
+      offline.raw_rate = atoi(argv[++i]);
+      if (offline.raw_rate <= 0) {
+        fprintf(stderr, "--rate needs a sample rate in Hz\n");
+        return 1;
+      }
+    } else {
+      print_usage(argv[0]);
+      return 1;
     }
   }
 
@@ -165,10 +374,14 @@ int main(int argc, char **argv) {
           64, // Optimization: Reduced to 4ms (64 samples @ 16kHz)
       .input_device_id = -1,
       .output_device_id = -1,
-      .channel_map = {0, 1, 2} // Default: Phy0->L, Phy1->R, Phy2->B
+      .channel_map = {0, 1, 2, 3}, // Default: Phy0->L, Phy1->R, Phy2->B
+                                   // (4 mics: TL, TR, BL, BR)
+      .rt = {.policy = PLATFORM_SCHED_OTHER, .cpu = -1}, // "audio.realtime"
+      .file = {.loop = 1}                                // "audio.file"
   };
 
   printf("LombardEar Phase 4: GSC Integration\n");
+  printf("SIMD kernels: %s\n", le_simd_name(le_simd_kernels()->level));
   printf("Loading audio config/default.json...\n");
   if (config_load("config/default.json", &audio_cfg) == 0) {
     printf("Audio Config loaded. Devices: In=%d, Out=%d\n",
@@ -176,71 +389,99 @@ int main(int argc, char **argv) {
   } else {
     printf("Failed to load audio config. Using defaults.\n");
   }
+  // A 4-channel device is a 4-mic headset unless "mics" says otherwise
+  if (audio_cfg.mics == 0)
+    audio_cfg.mics = audio_cfg.input_channels == 4 ? 4 : 3;
 
   // FORCE 16kHz for GSC consistency for now (unless we made GSC rate-agnostic?
   // GSC is mostly rate agnostic but filters might need tuning).
   // Let's respect what's in local variable if config didn't override, or
   // override it to 16000 if needed. Ideally config.json should specify it. For
   // now, let's overwrite to ensure stability.
-  audio_cfg.sample_rate = 16000;
-  audio_cfg.frames_per_buffer =
-      480; // Relaxed to 480 (30ms) for stability check
-
-  printf("Initializing GSC...\n");
-  AppContext ctx;
-  ctx.cfg.M = 64;
-  ctx.cfg.alpha = 0.01f; // Much slower adaptation
-  ctx.cfg.eps = 1e-6f;
-  ctx.cfg.mu_max = 0.01f; // Much conservative max step size
-  ctx.cfg.eta_max = 0.001f;
-  ctx.cfg.leak_lambda = 0.0001f;
-  ctx.cfg.g_lo = 0.1f;
-  ctx.cfg.g_hi = 0.3f;
-  ctx.cfg.beta_min = -2.0f;
-  ctx.cfg.beta_max = 2.0f;
-
-  size_t mem_size = 4 * ctx.cfg.M * sizeof(float);
-  ctx.gsc_mem = malloc(mem_size);
-  if (!ctx.gsc_mem) {
-    fprintf(stderr, "Failed to allocate GSC memory\n");
-    return 1;
+  // The native ALSA backend runs at the configured rate and period: short
+  // periods are its point, and the pipeline is sized from them below.
+  if (audio_cfg.backend != AUDIO_BACKEND_ALSA_MMAP) {
+    audio_cfg.sample_rate = 16000;
+    audio_cfg.frames_per_buffer =
+        480; // Relaxed to 480 (30ms) for stability check
   }
 
-  if (gsc_init(&ctx.st, &ctx.cfg, ctx.gsc_mem, mem_size) != 0) {
-    fprintf(stderr, "Failed to init GSC state\n");
-    free(ctx.gsc_mem);
-    return 1;
+  PipelineConfig pl_cfg;
+  pipeline_default_config(&pl_cfg);
+  pl_cfg.sample_rate = audio_cfg.sample_rate;
+  pl_cfg.block_frames = audio_cfg.frames_per_buffer;
+  // Beamformer coefficients come from the config file (e.g. a tuner result)
+  config_load_gsc("config/default.json", &pl_cfg.gsc);
+  // Optional subband beamformer ("gsc.mode": "subband")
+  config_load_gsc_mode("config/default.json", &pl_cfg.gsc_mode,
+                       &pl_cfg.subband);
+
+#ifdef LE_PROFILE_STAGES
+  static StageProfile profile;
+  stage_profile_init(&profile);
+#endif
+
+  if (offline.in_path || batch_src || tune_manifest) {
+    memcpy(offline.channel_map, audio_cfg.channel_map,
+           sizeof(offline.channel_map));
+#ifdef LE_PROFILE_STAGES
+    offline.profile = &profile;
+#endif
+    tune.threads = batch_jobs;
+    int rc;
+    if (tune_manifest)
+      rc = run_tune(tune_manifest, tune_out, &tune, audio_cfg.channel_map,
+                    &pl_cfg);
+    else if (batch_src)
+      rc = run_batch(batch_src, batch_out, batch_jobs, batch_csv, &offline,
+                     &pl_cfg);
+    else
+      rc = run_offline(&offline, &pl_cfg);
+#ifdef LE_PROFILE_STAGES
+    if (rc == 0 && !tune_manifest)
+      print_profile(&profile);
+#endif
+    platform_cleanup();
+    return rc;
   }
 
-  // Init AEC
-  // Filter length 512 samples (~32ms @ 16kHz) to cover system loopback latency
-  // Need to fine-tune M based on Measured Loopback Latency.
-  // For WASAPI Exclusive 4ms buffer, latency might be ~10ms. 512 is plenty.
-  int aec_M = 1024;
-  size_t aec_mem_size = 2 * aec_M * sizeof(float);
-  ctx.aec_mem = malloc(aec_mem_size);
-  if (!ctx.aec_mem) {
-    fprintf(stderr, "Failed to allocate AEC memory\n");
-    free(ctx.gsc_mem);
-    return 1;
+  if (latency_mode) {
+    int rc = run_latency(&audio_cfg, latency_repeats, latency_channel);
+    platform_cleanup();
+    return rc;
   }
-  aec_init(&ctx.aec, aec_M, ctx.aec_mem, aec_mem_size);
 
-  // Init AGC
-  // target -20dB, attack 10ms, release 500ms, max +30dB
-  agc_init(&ctx.agc, -30.0f, 10.0f, 500.0f, 20.0f, audio_cfg.sample_rate);
+  // Live input only: the file, batch and tuning runners read 3-mic files
+  pl_cfg.mics = audio_mic_count(&audio_cfg);
+  pl_cfg.beam_dir = beam_dir;
+  pl_cfg.mic_hpf_hz = mic_hpf_hz;
 
-  // Init Noise Gate
-  // thresh -50dB, hold 200ms, release 100ms
-  noise_gate_init(&ctx.ng, -50.0f, 200.0f, 100.0f, audio_cfg.sample_rate);
+  printf("Initializing GSC...\n");
+  Pipeline ctx;
+  if (pipeline_init(&ctx, &pl_cfg) != 0) {
+    fprintf(stderr, "Failed to initialize DSP pipeline\n");
+    return 1;
+  }
+  // Callback deadline counters: written by the audio thread, read by the
+  // polling loop below and the web server
+  static DeadlineMonitor monitor;
+  deadline_monitor_init(&monitor);
+  ctx.monitor = &monitor;
+  audio_cfg.monitor = &monitor;
+#ifdef LE_PROFILE_STAGES
+  ctx.profile = &profile;
+#endif
+  if (ctx.gsc_mode == GSC_MODE_SUBBAND) {
+    printf("Subband GSC: K=%d hop=%d (%d samples delay)\n",
+           pl_cfg.subband.fft_size, pl_cfg.subband.hop,
+           gsc_subband_latency(&ctx.sb));
+  }
 
-  // Defaults
-  ctx.aec_on = 0; // Off by default to isolate GSC stability
-  ctx.agc_on = 0; // Off by default
-  ctx.ng_on = 0;  // Off by default
-  ctx.last_ref_sample = 0.0f;
+  printf("Initializing %dch Input -> 2ch Output with GSC + DSP Chain...\n",
+         ctx.mics);
 
-  printf("Initializing 3ch Input -> 2ch Output with GSC + DSP Chain...\n");
+  // Web UI spectrum/waveform tap (NULL scope_mem: disabled)
+  void *scope_mem = NULL;
 
 // Start Web Server
 #ifdef LE_WITH_WEBSOCKETS
@@ -263,14 +504,40 @@ int main(int argc, char **argv) {
     server_set_device_list(dev_json);
     printf("Registered %d output devices for Web UI\n", n_devs);
   }
+  server_set_param_mailbox(&ctx.params);
+  server_set_deadline_monitor(&monitor);
+#ifdef LE_PROFILE_STAGES
+  server_set_stage_profile(&profile);
+#endif
+  ctx.telemetry = server_push_telemetry;
+
+  // Spectrum/waveform streaming ("ws.scope")
+  {
+    static ScopeTap scope;
+    ScopeConfig scope_cfg = {
+        .fft_size = 512, .rate_hz = 10, .wave_points = 256};
+    config_load_scope("config/default.json", &scope_cfg);
+    size_t scope_size = scope_tap_mem_bytes(&scope_cfg);
+    scope_mem = scope_size ? malloc(scope_size) : NULL;
+    if (scope_mem && scope_tap_init(&scope, &scope_cfg, audio_cfg.sample_rate,
+                                    scope_mem, scope_size) == 0) {
+      ctx.scope = &scope;
+      server_set_scope_tap(&scope);
+    } else {
+      fprintf(stderr, "Invalid scope config, spectrum view disabled\n");
+      free(scope_mem);
+      scope_mem = NULL;
+    }
+  }
   server_init(8000);
 #endif
 
   AudioIO *aio = NULL;
   // Pass address of ctx struct as user_data
-  if (audio_open(&aio, &audio_cfg, process_audio, &ctx) != 0) {
+  if (audio_open(&aio, &audio_cfg, pipeline_process, &ctx) != 0) {
     fprintf(stderr, "Failed to initialize Audio IO\n");
-    free(ctx.gsc_mem);
+    pipeline_free(&ctx);
+    free(scope_mem);
     return 1;
   }
 
@@ -278,7 +545,8 @@ int main(int argc, char **argv) {
   if (audio_start(aio) != 0) {
     fprintf(stderr, "Failed to start audio stream\n");
     audio_close(aio);
-    free(ctx.gsc_mem);
+    pipeline_free(&ctx);
+    free(scope_mem);
     return 1;
   }
 
@@ -286,6 +554,10 @@ int main(int argc, char **argv) {
 
   // Polling loop for device switching and exit
   int running = 1;
+  int rt_reported = 0; // Realtime setup warnings printed for this stream
+  DeadlineStats monitor_prev;
+  deadline_monitor_snapshot(&monitor, &monitor_prev);
+  double monitor_last_us = platform_time_us();
   while (running) {
     // Check for Enter key (non-blocking, cross-platform)
     if (platform_kbhit()) {
@@ -306,7 +578,7 @@ int main(int argc, char **argv) {
 
       audio_cfg.output_device_id = new_device_id;
 
-      if (audio_open(&aio, &audio_cfg, process_audio, &ctx) != 0) {
+      if (audio_open(&aio, &audio_cfg, pipeline_process, &ctx) != 0) {
         fprintf(stderr, "Failed to re-open audio with new device\n");
         running = 0;
       } else if (audio_start(aio) != 0) {
@@ -314,10 +586,23 @@ int main(int argc, char **argv) {
         running = 0;
       } else {
         printf("Audio output switched successfully.\n");
+        rt_reported = 0;
       }
     }
 #endif
 
+    // The audio thread configures itself on its first block and must not
+    // print: its realtime setup is reported from here
+    if (aio && !rt_reported)
+      rt_reported = audio_report_rt_status(aio);
+
+    double now_us = platform_time_us();
+    if (monitor_interval_s > 0.0 &&
+        now_us - monitor_last_us >= monitor_interval_s * 1e6) {
+      log_monitor(&monitor, &monitor_prev, (now_us - monitor_last_us) * 1e-6);
+      monitor_last_us = now_us;
+    }
+
     platform_sleep_ms(100); // 100ms polling interval
   }
 
@@ -326,9 +611,11 @@ int main(int argc, char **argv) {
     audio_stop(aio);
     audio_close(aio);
   }
-  free(ctx.gsc_mem);
-  if (ctx.aec_mem)
-    free(ctx.aec_mem);
+#ifdef LE_PROFILE_STAGES
+  print_profile(&profile);
+#endif
+  pipeline_free(&ctx);
+  free(scope_mem);
   platform_cleanup();
   printf("Done.\n");
 
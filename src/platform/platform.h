@@ -9,8 +9,11 @@ extern "C" {
  * Platform abstraction layer for LombardEar.
  * Provides cross-platform APIs for:
  * - Non-blocking keyboard input
- * - High-resolution timing
+ * - High-resolution timing and a cycle counter (profiling)
  * - Sleep functions
+ * - Worker threads and directory listing (offline batch processing)
+ * - Realtime scheduling, CPU pinning and memory locking (audio callback)
+ * - Floating-point environment (denormal flushing)
  */
 
 // Initialize platform subsystem (call once at startup)
@@ -28,9 +31,79 @@ int platform_getch(void);
 // Sleep for specified milliseconds
 void platform_sleep_ms(int ms);
 
-// Get high-resolution time in microseconds (for profiling)
+// Get high-resolution time in microseconds (for profiling). Monotonic:
+// only differences are meaningful.
 double platform_time_us(void);
 
+// Sleep until platform_time_us() reaches deadline_us (returns at once if it
+// already has). Resolution is that of the OS timer.
+void platform_sleep_until_us(double deadline_us);
+
+// Cycle-resolution counter for profiling short sections of code: the time
+// stamp counter on x86, the virtual counter on AArch64, otherwise
+// CLOCK_MONOTONIC_RAW (QueryPerformanceCounter on Windows). Only differences
+// taken on the same thread are meaningful.
+unsigned long long platform_ticks(void);
+
+// platform_ticks() rate in ticks per microsecond. Calibrated against
+// platform_time_us() on x86, which takes 10 ms: call once at setup.
+double platform_ticks_per_us(void);
+
+// Worker threads for offline batch processing (never used on the audio path)
+typedef struct PlatformThread PlatformThread;
+typedef void (*PlatformThreadFn)(void *arg);
+
+// Start a thread running fn(arg). Returns NULL on failure.
+PlatformThread *platform_thread_start(PlatformThreadFn fn, void *arg);
+
+// Wait for the thread to finish and release it
+void platform_thread_join(PlatformThread *t);
+
+// Number of online CPU cores (at least 1)
+int platform_cpu_count(void);
+
+// Call fn(name, user) for each regular file in dir (name without the
+// directory). Returns the number of files, or -1 if dir cannot be opened.
+typedef void (*PlatformDirFn)(const char *name, void *user);
+int platform_list_dir(const char *dir, PlatformDirFn fn, void *user);
+
+// Realtime settings for the audio callback thread
+typedef enum {
+  PLATFORM_SCHED_OTHER = 0, // Leave scheduling to the OS / audio library
+  PLATFORM_SCHED_FIFO,
+  PLATFORM_SCHED_RR
+} PlatformSchedPolicy;
+
+typedef struct {
+  PlatformSchedPolicy policy;
+  int priority;          // 1 - 99, clamped to the range of the policy
+  int cpu;               // Pin the thread to this CPU, -1: no pinning
+  int lock_memory;       // Lock current and future pages (no page faults)
+  int prefault_stack_kb; // Stack touched on entry, 0: none
+} PlatformRtConfig;
+
+// platform_rt_enter result bits (0: everything requested was applied)
+#define PLATFORM_RT_SCHED_FAILED 1
+#define PLATFORM_RT_AFFINITY_FAILED 2
+
+// Lock all current and future pages of the process into RAM (mlockall).
+// Call from a normal thread before the stream starts.
+// Returns 0 on success, -1 if unsupported or not permitted.
+int platform_rt_lock_memory(void);
+
+// Apply policy, priority and affinity to the calling thread and prefault
+// its stack. Meant for the first entry of the audio callback.
+// Returns a mask of PLATFORM_RT_*_FAILED bits.
+int platform_rt_enter(const PlatformRtConfig *cfg);
+
+// Flush denormals to zero on the calling thread (x86: MXCSR FTZ + DAZ,
+// ARM: FPCR/FPSCR FZ). Per-thread state; cheap enough to call per block.
+// Returns 0 on success, -1 if the architecture has no such control.
+int platform_fp_flush_denormals(void);
+
+// Non-zero if denormal flushing is active on the calling thread
+int platform_fp_denormals_flushed(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,57 @@
+/**
+ * Floating-point environment control (architecture-specific, shared by the
+ * Unix and Windows builds).
+ */
+
+#include "platform.h"
+
+#if defined(__SSE__) || defined(_M_X64) ||                                     \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define LE_FP_SSE 1
+#define MXCSR_DAZ 0x0040 // Denormal inputs are read as zero
+#define MXCSR_FTZ 0x8000 // Denormal results are written as zero
+#elif defined(__aarch64__) && (defined(__GNUC__) || defined(__clang__))
+#define LE_FP_AARCH64 1
+#define FPCR_FZ (1u << 24) // Flush-to-zero (inputs and results)
+#elif defined(__arm__) && defined(__ARM_FP) &&                                 \
+    (defined(__GNUC__) || defined(__clang__))
+#define LE_FP_ARM32 1
+#define FPSCR_FZ (1u << 24)
+#endif
+
+int platform_fp_flush_denormals(void) {
+#if defined(LE_FP_SSE)
+  _mm_setcsr(_mm_getcsr() | MXCSR_DAZ | MXCSR_FTZ);
+  return 0;
+#elif defined(LE_FP_AARCH64)
+  unsigned long fpcr;
+  __asm__ __volatile__("mrs %0, fpcr" : "=r"(fpcr));
+  __asm__ __volatile__("msr fpcr, %0" : : "r"(fpcr | FPCR_FZ));
+  return 0;
+#elif defined(LE_FP_ARM32)
+  unsigned int fpscr;
+  __asm__ __volatile__("vmrs %0, fpscr" : "=r"(fpscr));
+  __asm__ __volatile__("vmsr fpscr, %0" : : "r"(fpscr | FPSCR_FZ));
+  return 0;
+#else
+  return -1;
+#endif
+}
+
+int platform_fp_denormals_flushed(void) {
+#if defined(LE_FP_SSE)
+  unsigned int mask = MXCSR_DAZ | MXCSR_FTZ;
+  return (_mm_getcsr() & mask) == mask;
+#elif defined(LE_FP_AARCH64)
+  unsigned long fpcr;
+  __asm__ __volatile__("mrs %0, fpcr" : "=r"(fpcr));
+  return (fpcr & FPCR_FZ) != 0;
+#elif defined(LE_FP_ARM32)
+  unsigned int fpscr;
+  __asm__ __volatile__("vmrs %0, fpscr" : "=r"(fpscr));
+  return (fpscr & FPSCR_FZ) != 0;
+#else
+  return 0;
+#endif
+}
@@ -0,0 +1,74 @@
+/**
+ * Cycle counter for profiling (architecture-specific, shared by the Unix and
+ * Windows builds).
+ */
+
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE // clock_gettime, CLOCK_MONOTONIC_RAW
+#endif
+
+#include "platform.h"
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) ||            \
+    defined(_M_IX86)
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#define LE_TICKS_TSC 1
+#elif defined(__aarch64__) && (defined(__GNUC__) || defined(__clang__))
+#define LE_TICKS_CNTVCT 1
+#elif defined(_WIN32)
+#include <windows.h>
+#define LE_TICKS_QPC 1
+#else
+#include <time.h>
+#endif
+
+unsigned long long platform_ticks(void) {
+#if defined(LE_TICKS_TSC)
+  return __rdtsc();
+#elif defined(LE_TICKS_CNTVCT)
+  unsigned long long v;
+  __asm__ __volatile__("mrs %0, cntvct_el0" : "=r"(v));
+  return v;
+#elif defined(LE_TICKS_QPC)
+  LARGE_INTEGER counter;
+  QueryPerformanceCounter(&counter);
+  return (unsigned long long)counter.QuadPart;
+#else
+  // Raw: not slewed by NTP, so short intervals are not stretched
+  struct timespec ts;
+#ifdef CLOCK_MONOTONIC_RAW
+  clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+#else
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+#endif
+  return (unsigned long long)ts.tv_sec * 1000000000ull +
+         (unsigned long long)ts.tv_nsec;
+#endif
+}
+
+double platform_ticks_per_us(void) {
+#if defined(LE_TICKS_TSC)
+  // The TSC rate is not exposed architecturally: count it over 10 ms of the
+  // monotonic clock (the TSC is invariant on all current x86 CPUs)
+  double t0 = platform_time_us();
+  unsigned long long c0 = __rdtsc();
+  double t1;
+  while ((t1 = platform_time_us()) - t0 < 10000.0) {
+  }
+  return (double)(__rdtsc() - c0) / (t1 - t0);
+#elif defined(LE_TICKS_CNTVCT)
+  unsigned long long freq;
+  __asm__ __volatile__("mrs %0, cntfrq_el0" : "=r"(freq));
+  return (double)freq * 1e-6;
+#elif defined(LE_TICKS_QPC)
+  LARGE_INTEGER freq;
+  QueryPerformanceFrequency(&freq);
+  return (double)freq.QuadPart * 1e-6;
+#else
+  return 1000.0; // Nanoseconds
+#endif
+}
@@ -5,10 +5,23 @@
 
 #if !defined(_WIN32)
 
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE // pthread_setaffinity_np, CPU_SET
+#endif
+
 #include "platform.h"
+#include <dirent.h>
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/mman.h>
 #include <sys/select.h>
+#include <sys/stat.h>
 #include <sys/time.h>
 #include <termios.h>
+#include <time.h>
 #include <unistd.h>
 
 static struct termios g_orig_termios;
@@ -56,9 +69,143 @@ int platform_getch(void) {
 void platform_sleep_ms(int ms) { usleep(ms * 1000); }
 
 double platform_time_us(void) {
-  struct timeval tv;
-  gettimeofday(&tv, NULL);
-  return (double)tv.tv_sec * 1000000.0 + (double)tv.tv_usec;
+  // Monotonic, so long-running timers are not disturbed by clock steps
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec * 1000000.0 + (double)ts.tv_nsec * 1e-3;
+}
+
+void platform_sleep_until_us(double deadline_us) {
+#ifdef __linux__
+  // Absolute deadline on the same clock: no drift from the wake-up latency
+  // and no recomputation after a signal
+  struct timespec ts;
+  ts.tv_sec = (time_t)(deadline_us * 1e-6);
+  ts.tv_nsec = (long)((deadline_us - (double)ts.tv_sec * 1e6) * 1e3);
+  if (ts.tv_nsec >= 1000000000L) {
+    ts.tv_sec++;
+    ts.tv_nsec -= 1000000000L;
+  }
+  while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR)
+    ;
+#else
+  double wait_us;
+  while ((wait_us = deadline_us - platform_time_us()) > 0.0) {
+    struct timespec ts;
+    ts.tv_sec = (time_t)(wait_us * 1e-6);
+    ts.tv_nsec = (long)((wait_us - (double)ts.tv_sec * 1e6) * 1e3);
+    if (nanosleep(&ts, NULL) == 0)
+      break;
+  }
+#endif
+}
+
+struct PlatformThread {
+  pthread_t handle;
+  PlatformThreadFn fn;
+  void *arg;
+};
+
+static void *thread_entry(void *arg) {
+  PlatformThread *t = (PlatformThread *)arg;
+  t->fn(t->arg);
+  return NULL;
+}
+
+PlatformThread *platform_thread_start(PlatformThreadFn fn, void *arg) {
+  PlatformThread *t = (PlatformThread *)calloc(1, sizeof(PlatformThread));
+  if (!t)
+    return NULL;
+  t->fn = fn;
+  t->arg = arg;
+  if (pthread_create(&t->handle, NULL, thread_entry, t) != 0) {
+    free(t);
+    return NULL;
+  }
+  return t;
+}
+
+void platform_thread_join(PlatformThread *t) {
+  if (!t)
+    return;
+  pthread_join(t->handle, NULL);
+  free(t);
+}
+
+int platform_cpu_count(void) {
+  long n = sysconf(_SC_NPROCESSORS_ONLN);
+  return n > 0 ? (int)n : 1;
+}
+
+int platform_list_dir(const char *dir, PlatformDirFn fn, void *user) {
+  DIR *d = opendir(dir);
+  if (!d)
+    return -1;
+  int count = 0;
+  struct dirent *e;
+  char path[4096];
+  while ((e = readdir(d)) != NULL) {
+    struct stat sb;
+    snprintf(path, sizeof(path), "%s/%s", dir, e->d_name);
+    if (stat(path, &sb) != 0 || !S_ISREG(sb.st_mode))
+      continue;
+    fn(e->d_name, user);
+    count++;
+  }
+  closedir(d);
+  return count;
+}
+
+int platform_rt_lock_memory(void) {
+  return mlockall(MCL_CURRENT | MCL_FUTURE) == 0 ? 0 : -1;
+}
+
+#define RT_STACK_MAX_KB 512 // Stay well inside the default thread stack
+
+// Touch one byte per page so the stack pages are mapped before they are
+// needed on the audio path. noinline: the frame must really be this deep.
+__attribute__((noinline)) static void prefault_stack(int kb) {
+  size_t n = (size_t)kb * 1024;
+  volatile unsigned char buf[n];
+  for (size_t i = n; i >= 4096; i -= 4096) // Top-down, like stack growth
+    buf[i - 1] = 0;
+  (void)buf;
+}
+
+int platform_rt_enter(const PlatformRtConfig *cfg) {
+  int failed = 0;
+
+  if (cfg->policy != PLATFORM_SCHED_OTHER) {
+    int policy = cfg->policy == PLATFORM_SCHED_RR ? SCHED_RR : SCHED_FIFO;
+    int lo = sched_get_priority_min(policy);
+    int hi = sched_get_priority_max(policy);
+    struct sched_param sp;
+    sp.sched_priority = cfg->priority < lo ? lo
+                        : cfg->priority > hi ? hi
+                                             : cfg->priority;
+    // Needs CAP_SYS_NICE or an rtprio limit (/etc/security/limits.conf)
+    if (pthread_setschedparam(pthread_self(), policy, &sp) != 0)
+      failed |= PLATFORM_RT_SCHED_FAILED;
+  }
+
+  if (cfg->cpu >= 0) {
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cfg->cpu, &set);
+    if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0)
+      failed |= PLATFORM_RT_AFFINITY_FAILED;
+#else
+    failed |= PLATFORM_RT_AFFINITY_FAILED; // No hard affinity on macOS
+#endif
+  }
+
+  if (cfg->prefault_stack_kb > 0) {
+    prefault_stack(cfg->prefault_stack_kb < RT_STACK_MAX_KB
+                       ? cfg->prefault_stack_kb
+                       : RT_STACK_MAX_KB);
+  }
+  return failed;
 }
 
 #endif // !_WIN32
@@ -6,6 +6,9 @@
 
 #include "platform.h"
 #include <conio.h>
+#include <malloc.h>
+#include <stdio.h>
+#include <stdlib.h>
 #include <windows.h>
 
 static LARGE_INTEGER g_frequency;
@@ -30,9 +33,110 @@ int platform_getch(void) { return _getch(); }
 void platform_sleep_ms(int ms) { Sleep((DWORD)ms); }
 
 double platform_time_us(void) {
+  if (!g_timer_initialized)
+    platform_init(); // Offline tools may not call platform_init
   LARGE_INTEGER counter;
   QueryPerformanceCounter(&counter);
   return (double)counter.QuadPart * 1000000.0 / (double)g_frequency.QuadPart;
 }
 
+void platform_sleep_until_us(double deadline_us) {
+  // Sleep() rounds up to the system timer tick (1 - 15.6 ms): sleep while
+  // more than two milliseconds remain, then yield until the deadline
+  double wait_us;
+  while ((wait_us = deadline_us - platform_time_us()) > 0.0) {
+    if (wait_us > 2000.0)
+      Sleep((DWORD)(wait_us * 1e-3) - 1);
+    else
+      SwitchToThread();
+  }
+}
+
+struct PlatformThread {
+  HANDLE handle;
+  PlatformThreadFn fn;
+  void *arg;
+};
+
+static DWORD WINAPI thread_entry(LPVOID arg) {
+  PlatformThread *t = (PlatformThread *)arg;
+  t->fn(t->arg);
+  return 0;
+}
+
+PlatformThread *platform_thread_start(PlatformThreadFn fn, void *arg) {
+  PlatformThread *t = (PlatformThread *)calloc(1, sizeof(PlatformThread));
+  if (!t)
+    return NULL;
+  t->fn = fn;
+  t->arg = arg;
+  t->handle = CreateThread(NULL, 0, thread_entry, t, 0, NULL);
+  if (!t->handle) {
+    free(t);
+    return NULL;
+  }
+  return t;
+}
+
+void platform_thread_join(PlatformThread *t) {
+  if (!t)
+    return;
+  WaitForSingleObject(t->handle, INFINITE);
+  CloseHandle(t->handle);
+  free(t);
+}
+
+int platform_cpu_count(void) {
+  SYSTEM_INFO si;
+  GetSystemInfo(&si);
+  return si.dwNumberOfProcessors > 0 ? (int)si.dwNumberOfProcessors : 1;
+}
+
+int platform_list_dir(const char *dir, PlatformDirFn fn, void *user) {
+  char pattern[MAX_PATH];
+  snprintf(pattern, sizeof(pattern), "%s\\*", dir);
+  WIN32_FIND_DATAA fd;
+  HANDLE h = FindFirstFileA(pattern, &fd);
+  if (h == INVALID_HANDLE_VALUE)
+    return -1;
+  int count = 0;
+  do {
+    if (fd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+      continue;
+    fn(fd.cFileName, user);
+    count++;
+  } while (FindNextFileA(h, &fd));
+  FindClose(h);
+  return count;
+}
+
+int platform_rt_lock_memory(void) {
+  // No mlockall equivalent; VirtualLock covers explicit ranges only
+  return -1;
+}
+
+int platform_rt_enter(const PlatformRtConfig *cfg) {
+  int failed = 0;
+
+  // No FIFO/RR classes: both map to the highest thread priority
+  if (cfg->policy != PLATFORM_SCHED_OTHER &&
+      !SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL))
+    failed |= PLATFORM_RT_SCHED_FAILED;
+
+  if (cfg->cpu >= 0) {
+    if (cfg->cpu >= (int)(sizeof(DWORD_PTR) * 8) ||
+        !SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)1 << cfg->cpu))
+      failed |= PLATFORM_RT_AFFINITY_FAILED;
+  }
+
+  if (cfg->prefault_stack_kb > 0) {
+    // Touch one byte per page (top-down, past the guard page in order)
+    size_t n = (size_t)cfg->prefault_stack_kb * 1024;
+    volatile unsigned char *buf = (volatile unsigned char *)_alloca(n);
+    for (size_t i = n; i >= 4096; i -= 4096)
+      buf[i - 1] = 0;
+  }
+  return failed;
+}
+
 #endif // _WIN32
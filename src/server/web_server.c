@@ -1,88 +1,73 @@
 #include "web_server.h"
+#include "ws_protocol.h"
+#include "../dsp/ring_buffer.h"
 #include "../third_party/mongoose/mongoose.h"
 #include <process.h> /* for _beginthread on Windows */
+#include <stddef.h>
 #include <stdio.h>
-// #include <stdlib.h>
+#include <stdlib.h>
 #include <string.h>
 
-// Shared stats (volatile for simple thread-safe "latest value" semantics)
-static volatile float s_rms_l = 0.0f;
-static volatile float s_rms_r = 0.0f;
-static volatile float s_rms_b = 0.0f;
-static volatile float s_rms_err = 0.0f;
-static volatile float s_beta = 0.0f;
-static volatile float s_mu = 0.0f;
-
-// Shared control params (initialized to defaults, main.c should init these too
-// if needed)
-static volatile float s_ctrl_alpha = 0.05f;
-static volatile float s_ctrl_leak_lambda = 0.0001f;
-static volatile float s_ctrl_mu_max = 0.05f;
-static volatile int s_ctrl_updated = 0; // Flag to indicate new params available
-
-// DSP Params
-static volatile int s_dsp_aec_on = 1;
-static volatile int s_dsp_agc_on = 0;
-static volatile int s_dsp_ng_on = 0;
-static volatile float s_dsp_agc_target = -20.0f;
-static volatile float s_dsp_ng_thresh = -50.0f;
-
-// ... existing code ...
-
-// Called by main thread to get latest control params
-// Returns 1 if updated, 0 otherwise
-// (Removed duplicates)
+// Per-block telemetry from the audio thread (SPSC: audio -> server thread)
+#define TELEMETRY_RING_RECORDS 256 // ~8 s of 480-frame blocks at 16 kHz
+#define TELEMETRY_BATCH_MAX 64     // Records per WebSocket frame
+static TelemetryRecord s_telemetry_storage[TELEMETRY_RING_RECORDS];
+static RecordRing s_telemetry;
+static le_atomic_int s_telemetry_dropped; // Rejected because the ring was full
+
+// Spectrum/waveform tap (audio thread pushes, server thread analyzes)
+static ScopeTap *s_scope = NULL;
+static uint8_t *s_scope_frame = NULL;
+static size_t s_scope_frame_size = 0;
+
+// Control params are published to the audio thread as whole snapshots
+// (see server_set_param_mailbox)
+static ParamMailbox *s_params = NULL;
+
+// Callback deadline counters (audio thread writes, server thread reads).
+// The last interval is kept for GET /api/monitor.
+#define MONITOR_PERIOD_MS 1000
+#define MONITOR_JSON_BYTES 4096
+static DeadlineMonitor *s_monitor = NULL;
+static DeadlineStats s_monitor_prev;
+static DeadlineStats s_monitor_interval;
+static double s_monitor_interval_s = 0.0;
+static uint64_t s_monitor_last_ms = 0;
+
+// Per-stage DSP ticks (LE_PROFILE_STAGES builds), sent with the monitor
+#define PROFILE_JSON_BYTES 1024
+static StageProfile *s_profile = NULL;
+static StageProfileStats s_profile_prev;
+
 static char s_device_list_json[4096] = "[]";
 
 // Pending output device change
 static volatile int s_pending_output_device = -1; // -1 means no change pending
 
-// Jitter buffer statistics (from audio thread)
-static volatile float s_jitter_delay_ms = 0.0f;
-static volatile float s_jitter_mean_ms = 0.0f;
-static volatile float s_jitter_std_ms = 0.0f;
-static volatile float s_jitter_fill = 0.0f;
-
-// Phase alignment offsets (from DSP thread)
-#define MAX_PHASE_CHANNELS 4
-static volatile float s_phase_offsets[MAX_PHASE_CHANNELS] = {0};
-static volatile int s_phase_num_channels = 0;
-
-void server_update_rms(float l, float r, float b, float err) {
-  s_rms_l = l;
-  s_rms_r = r;
-  s_rms_b = b;
-  s_rms_err = err;
+void server_push_telemetry(const TelemetryRecord *rec) {
+  if (record_ring_push(&s_telemetry, rec) != 0)
+    le_atomic_fetch_add(&s_telemetry_dropped, 1);
 }
 
-void server_update_params(float beta, float mu) {
-  s_beta = beta;
-  s_mu = mu;
+void server_set_param_mailbox(ParamMailbox *mb) { s_params = mb; }
+
+void server_set_scope_tap(ScopeTap *tap) {
+  s_scope_frame_size = tap ? scope_tap_frame_bytes(tap) : 0;
+  s_scope_frame = tap ? (uint8_t *)malloc(s_scope_frame_size) : NULL;
+  s_scope = s_scope_frame ? tap : NULL;
 }
 
-// Called by main thread to get latest control params
-// Returns 1 if updated, 0 otherwise
-int server_get_ctrl_params(float *alpha, float *leak_lambda, float *mu_max) {
-  // We return current values. Flag handling is tricky if split.
-  // Let's just return values. Main loop checks optimization flag if it wants,
-  // but for 3 floats it's cheap to just copy.
-  *alpha = s_ctrl_alpha;
-  *leak_lambda = s_ctrl_leak_lambda;
-  *mu_max = s_ctrl_mu_max;
-  return s_ctrl_updated;
+void server_set_deadline_monitor(DeadlineMonitor *m) {
+  s_monitor = m;
+  if (m)
+    deadline_monitor_snapshot(m, &s_monitor_prev);
+  memset(&s_monitor_interval, 0, sizeof(s_monitor_interval));
 }
 
-int server_get_dsp_params(int *aec_on, int *agc_on, int *ng_on,
-                          float *agc_target, float *ng_thresh) {
-  *aec_on = s_dsp_aec_on;
-  *agc_on = s_dsp_agc_on;
-  *ng_on = s_dsp_ng_on;
-  *agc_target = s_dsp_agc_target;
-  *ng_thresh = s_dsp_ng_thresh;
-
-  int ret = s_ctrl_updated;
-  s_ctrl_updated = 0; // Clear it here
-  return ret;
+void server_set_stage_profile(StageProfile *p) {
+  s_profile = p;
+  if (p)
+    stage_profile_snapshot(p, &s_profile_prev);
 }
 
 void server_set_device_list(const char *devices_json) {
@@ -99,68 +84,225 @@ int server_get_pending_output_device(int *new_device_id) {
   return 0;
 }
 
-void server_update_jitter_stats(float delay_ms, float jitter_mean_ms,
-                                float jitter_std_ms, float fill_ratio) {
-  s_jitter_delay_ms = delay_ms;
-  s_jitter_mean_ms = jitter_mean_ms;
-  s_jitter_std_ms = jitter_std_ms;
-  s_jitter_fill = fill_ratio;
-}
-
-void server_update_phase_offsets(const float *offsets, int num_channels) {
-  if (num_channels > MAX_PHASE_CHANNELS)
-    num_channels = MAX_PHASE_CHANNELS;
-  s_phase_num_channels = num_channels;
-  for (int i = 0; i < num_channels; i++) {
-    s_phase_offsets[i] = offsets[i];
-  }
-}
-
 static struct mg_mgr mgr;
 static int g_port = 8000;
 
-static void broadcast_stats(struct mg_mgr *m) {
-  char json[1024];
-
-  // Build phase offsets array string
-  char phase_str[128] = "[]";
-  if (s_phase_num_channels > 0) {
-    int pos = 0;
-    pos += snprintf(phase_str + pos, sizeof(phase_str) - pos, "[");
-    for (int i = 0; i < s_phase_num_channels; i++) {
-      pos += snprintf(phase_str + pos, sizeof(phase_str) - pos, "%.2f%s",
-                      s_phase_offsets[i],
-                      (i < s_phase_num_channels - 1) ? "," : "");
+// Per-connection protocol, stored in mg_connection::data[0]
+#define WS_CONN_BINARY 'B' // Negotiated WS_SUBPROTOCOL
+#define WS_CONN_JSON 'J'   // Fallback
+
+// Drain the telemetry ring. Binary clients get every record in batches;
+// JSON clients get the newest record once per poll, formatted only once.
+// Runs on the server thread only.
+static void broadcast_telemetry(struct mg_mgr *m) {
+  static TelemetryRecord batch[TELEMETRY_BATCH_MAX];
+  static uint8_t frame[TELEMETRY_HEADER_BYTES +
+                       TELEMETRY_BATCH_MAX * TELEMETRY_RECORD_BYTES];
+
+  int have_json = 0;
+  for (struct mg_connection *c = m->conns; c; c = c->next) {
+    if (c->is_websocket && c->data[0] == WS_CONN_JSON)
+      have_json = 1;
+  }
+
+  TelemetryRecord last;
+  int have_last = 0;
+  unsigned int count;
+  while ((count = record_ring_pop_batch(&s_telemetry, batch,
+                                        TELEMETRY_BATCH_MAX)) > 0) {
+    uint32_t dropped = (uint32_t)le_atomic_load(&s_telemetry_dropped);
+    size_t len =
+        telemetry_pack_batch(batch, (int)count, dropped, frame, sizeof(frame));
+    for (struct mg_connection *c = m->conns; c; c = c->next) {
+      if (c->is_websocket && c->data[0] == WS_CONN_BINARY) {
+        mg_ws_send(c, frame, len, WEBSOCKET_OP_BINARY);
+      }
     }
-    snprintf(phase_str + pos, sizeof(phase_str) - pos, "]");
+    last = batch[count - 1];
+    have_last = 1;
   }
 
-  // Extended JSON with jitter and phase stats
-  int len = snprintf(json, sizeof(json),
-                     "{\"l\": %.4f, \"r\": %.4f, \"b\": %.4f, \"e\": %.4f, "
-                     "\"beta\": %.4f, \"mu\": %.6f, "
-                     "\"jitter\": {\"delay\": %.1f, \"mean\": %.2f, \"std\": "
-                     "%.2f, \"fill\": %.2f}, "
-                     "\"phase\": %s}",
-                     s_rms_l, s_rms_r, s_rms_b, s_rms_err, s_beta, s_mu,
-                     s_jitter_delay_ms, s_jitter_mean_ms, s_jitter_std_ms,
-                     s_jitter_fill, phase_str);
-
-  if (len > 0) {
+  if (have_json && have_last) {
+    char json[512];
+    size_t len = ws_format_stats_json(&last, json, sizeof(json));
     for (struct mg_connection *c = m->conns; c; c = c->next) {
-      if (c->is_websocket) {
+      if (len > 0 && c->is_websocket && c->data[0] == WS_CONN_JSON) {
         mg_ws_send(c, json, len, WEBSOCKET_OP_TEXT);
       }
     }
   }
 }
 
+// Run the scope analysis and send a frame to binary clients when one is due.
+// The ring is drained even when nobody is listening.
+static void broadcast_scope(struct mg_mgr *m) {
+  if (!s_scope)
+    return;
+  size_t len = scope_tap_poll(s_scope, s_scope_frame, s_scope_frame_size);
+  if (len == 0)
+    return;
+  for (struct mg_connection *c = m->conns; c; c = c->next) {
+    if (c->is_websocket && c->data[0] == WS_CONN_BINARY) {
+      mg_ws_send(c, s_scope_frame, len, WEBSOCKET_OP_BINARY);
+    }
+  }
+}
+
+// Stage breakdown of the last second, on the monitor timer
+static void broadcast_profile(struct mg_mgr *m) {
+  StageProfileStats now, d;
+  stage_profile_snapshot(s_profile, &now);
+  stage_profile_diff(&now, &s_profile_prev, &d);
+  s_profile_prev = now;
+
+  char json[PROFILE_JSON_BYTES];
+  size_t len = stage_profile_format_json(&d, json, sizeof(json));
+  for (struct mg_connection *c = m->conns; c; c = c->next) {
+    if (len > 0 && c->is_websocket) {
+      mg_ws_send(c, json, len, WEBSOCKET_OP_TEXT);
+    }
+  }
+}
+
+// Once per MONITOR_PERIOD_MS: difference the deadline counters and send the
+// summary to every WebSocket client as a {"type":"monitor"} text message
+static void broadcast_monitor(struct mg_mgr *m) {
+  if (!s_monitor)
+    return;
+  uint64_t now_ms = mg_millis();
+  if (s_monitor_last_ms == 0)
+    s_monitor_last_ms = now_ms;
+  if (now_ms - s_monitor_last_ms < MONITOR_PERIOD_MS)
+    return;
+
+  DeadlineStats now;
+  deadline_monitor_snapshot(s_monitor, &now);
+  deadline_stats_diff(&now, &s_monitor_prev, &s_monitor_interval);
+  s_monitor_prev = now;
+  s_monitor_interval_s = (double)(now_ms - s_monitor_last_ms) * 1e-3;
+  s_monitor_last_ms = now_ms;
+
+  static char json[MONITOR_JSON_BYTES];
+  size_t len = deadline_monitor_format_json(
+      &now, &s_monitor_interval, s_monitor_interval_s, json, sizeof(json));
+  for (struct mg_connection *c = m->conns; c; c = c->next) {
+    if (len > 0 && c->is_websocket) {
+      mg_ws_send(c, json, len, WEBSOCKET_OP_TEXT);
+    }
+  }
+  if (s_profile)
+    broadcast_profile(m);
+}
+
+// True if a comma-separated header value lists `token`
+static int header_has_token(struct mg_str value, const char *token) {
+  size_t n = strlen(token);
+  size_t i = 0;
+  while (i < value.len) {
+    while (i < value.len && (value.buf[i] == ' ' || value.buf[i] == ','))
+      i++;
+    size_t start = i;
+    while (i < value.len && value.buf[i] != ',' && value.buf[i] != ' ')
+      i++;
+    if (i - start == n && memcmp(value.buf + start, token, n) == 0)
+      return 1;
+  }
+  return 0;
+}
+
+// JSON fallback control: {"alpha": 0.01, "leak": 0.001, "mu_max": 0.1, ...}
+// Returns the number of fields changed.
+static int apply_json_control(struct mg_str msg, DspParams *p,
+                              int *output_device) {
+  static const struct {
+    const char *path;
+    size_t offset;
+  } floats[] = {
+      {"$.alpha", offsetof(DspParams, gsc.alpha)},
+      {"$.leak", offsetof(DspParams, gsc.leak_lambda)},
+      {"$.mu_max", offsetof(DspParams, gsc.mu_max)},
+      {"$.eta_max", offsetof(DspParams, gsc.eta_max)},
+      {"$.g_lo", offsetof(DspParams, gsc.g_lo)},
+      {"$.g_hi", offsetof(DspParams, gsc.g_hi)},
+      {"$.agc_target", offsetof(DspParams, agc_target_db)},
+      {"$.ng_thresh", offsetof(DspParams, ng_thresh_db)},
+  };
+  static const struct {
+    const char *path;
+    size_t offset;
+  } flags[] = {
+      {"$.aec_on", offsetof(DspParams, aec_on)},
+      {"$.agc_on", offsetof(DspParams, agc_on)},
+      {"$.ng_on", offsetof(DspParams, ng_on)},
+  };
+
+  double v;
+  int changed = 0;
+  for (size_t i = 0; i < sizeof(floats) / sizeof(floats[0]); i++) {
+    if (mg_json_get_num(msg, floats[i].path, &v)) {
+      *(float *)((char *)p + floats[i].offset) = (float)v;
+      changed++;
+    }
+  }
+  for (size_t i = 0; i < sizeof(flags) / sizeof(flags[0]); i++) {
+    if (mg_json_get_num(msg, flags[i].path, &v)) {
+      *(int *)((char *)p + flags[i].offset) = (int)v;
+      changed++;
+    }
+  }
+  if (mg_json_get_num(msg, "$.set_output_device", &v)) {
+    *output_device = (int)v;
+  }
+  return changed;
+}
+
 // Mongoose v7.20 callback signature: 3 args
 static void fn(struct mg_connection *c, int ev, void *ev_data) {
   if (ev == MG_EV_HTTP_MSG) {
     struct mg_http_message *hm = (struct mg_http_message *)ev_data;
     if (mg_match(hm->uri, mg_str("/ws"), NULL)) {
-      mg_ws_upgrade(c, hm, NULL);
+      // Binary protocol if the client offers it, JSON otherwise
+      struct mg_str *proto = mg_http_get_header(hm, "Sec-WebSocket-Protocol");
+      if (proto && header_has_token(*proto, WS_SUBPROTOCOL)) {
+        mg_ws_upgrade(c, hm, "Sec-WebSocket-Protocol: %s\r\n",
+                      WS_SUBPROTOCOL);
+        c->data[0] = WS_CONN_BINARY;
+      } else {
+        mg_ws_upgrade(c, hm, NULL);
+        c->data[0] = WS_CONN_JSON;
+      }
+    } else if (mg_match(hm->uri, mg_str("/api/monitor"), NULL)) {
+      // Totals now, interval values from the last broadcast period
+      static char json[MONITOR_JSON_BYTES];
+      size_t len = 0;
+      if (s_monitor) {
+        DeadlineStats now;
+        deadline_monitor_snapshot(s_monitor, &now);
+        len = deadline_monitor_format_json(&now, &s_monitor_interval,
+                                           s_monitor_interval_s, json,
+                                           sizeof(json));
+      }
+      if (len > 0) {
+        mg_http_reply(c, 200, "Content-Type: application/json\r\n", "%.*s",
+                      (int)len, json);
+      } else {
+        mg_http_reply(c, 404, "", "Deadline monitor disabled\n");
+      }
+    } else if (mg_match(hm->uri, mg_str("/api/profile"), NULL)) {
+      // Cumulative per-stage totals since the stream started
+      char json[PROFILE_JSON_BYTES];
+      size_t len = 0;
+      if (s_profile) {
+        StageProfileStats now;
+        stage_profile_snapshot(s_profile, &now);
+        len = stage_profile_format_json(&now, json, sizeof(json));
+      }
+      if (len > 0) {
+        mg_http_reply(c, 200, "Content-Type: application/json\r\n", "%.*s",
+                      (int)len, json);
+      } else {
+        mg_http_reply(c, 404, "", "Stage profile disabled\n");
+      }
     } else {
       // Serve static files from "web" directory
       struct mg_http_serve_opts opts = {.root_dir = "web"};
@@ -176,57 +318,27 @@ static void fn(struct mg_connection *c, int ev, void *ev_data) {
     }
   } else if (ev == MG_EV_WS_MSG) {
     struct mg_ws_message *wm = (struct mg_ws_message *)ev_data;
-    // Parse JSON command: {"alpha": 0.01, "leak": 0.001, "mu_max": 0.1}
-    // We use mg_json_get_num for simple parsing if available, or just parsing
-    // manually/cJSON. Since we don't assume cJSON headers are easy to include
-    // here without path issues, let's use Mongoose's helper if possible or
-    // simple string searching for now to strictly avoid dependency hell in this
-    // file. Actually, we can use mg_json_get_num.
-
-    double v;
-    int updated = 0;
-    if (mg_json_get_num(wm->data, "$.alpha", &v)) {
-      s_ctrl_alpha = (float)v;
-      updated = 1;
-    }
-    if (mg_json_get_num(wm->data, "$.leak", &v)) {
-      s_ctrl_leak_lambda = (float)v;
-      updated = 1;
-    }
-    if (mg_json_get_num(wm->data, "$.mu_max", &v)) {
-      s_ctrl_mu_max = (float)v;
-      updated = 1;
-    }
-
-    // DSP Controls
-    if (mg_json_get_num(wm->data, "$.aec_on", &v)) {
-      s_dsp_aec_on = (int)v;
-      updated = 1;
-    }
-    if (mg_json_get_num(wm->data, "$.agc_on", &v)) {
-      s_dsp_agc_on = (int)v;
-      updated = 1;
-    }
-    if (mg_json_get_num(wm->data, "$.ng_on", &v)) {
-      s_dsp_ng_on = (int)v;
-      updated = 1;
-    }
-    if (mg_json_get_num(wm->data, "$.agc_target", &v)) {
-      s_dsp_agc_target = (float)v;
-      updated = 1;
-    }
-    if (mg_json_get_num(wm->data, "$.ng_thresh", &v)) {
-      s_dsp_ng_thresh = (float)v;
-      updated = 1;
+    int binary = (wm->flags & 0x0F) == WEBSOCKET_OP_BINARY;
+    int device = -1;
+    int changed;
+
+    // All fields of one message land in the same snapshot. A malformed
+    // binary frame is rejected whole, before anything is modified.
+    DspParams scratch;
+    DspParams *p = s_params ? param_mailbox_edit(s_params) : &scratch;
+    if (binary) {
+      changed = ws_control_apply((const uint8_t *)wm->data.buf, wm->data.len,
+                                 p, &device);
+    } else {
+      changed = apply_json_control(wm->data, p, &device);
     }
-
-    if (updated) {
-      s_ctrl_updated = 1;
+    if (changed > 0 && s_params) {
+      param_mailbox_publish(s_params);
     }
 
     // Check for set_output_device command
-    if (mg_json_get_num(wm->data, "$.set_output_device", &v)) {
-      s_pending_output_device = (int)v;
+    if (device >= 0) {
+      s_pending_output_device = device;
       printf("Server: Output device change requested: %d\n",
              s_pending_output_device);
     }
@@ -245,7 +357,9 @@ static void server_thread(void *arg) {
 
   while (1) {
     mg_mgr_poll(&mgr, 40); // 40ms poll ~ 25fps response
-    broadcast_stats(&mgr); // Broadcast every loop (approx 25Hz)
+    broadcast_telemetry(&mgr); // Every block since the last loop (~25Hz)
+    broadcast_scope(&mgr);     // At the configured scope rate
+    broadcast_monitor(&mgr);   // Once per second
   }
 
   mg_mgr_free(&mgr);
@@ -253,6 +367,8 @@ static void server_thread(void *arg) {
 
 void server_init(int port) {
   g_port = port;
+  record_ring_init(&s_telemetry, s_telemetry_storage, sizeof(TelemetryRecord),
+                   TELEMETRY_RING_RECORDS);
   if (_beginthread(server_thread, 0, NULL) == -1L) {
     fprintf(stderr, "Failed to create server thread\n");
   }
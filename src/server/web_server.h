@@ -1,6 +1,12 @@
 #ifndef WEB_SERVER_H
 #define WEB_SERVER_H
 
+#include "../app/stage_profile.h"
+#include "../dsp/scope_tap.h"
+#include "../utils/deadline_monitor.h"
+#include "../utils/param_mailbox.h"
+#include "../utils/telemetry.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -8,20 +14,29 @@ extern "C" {
 /// Initialize the background web server thread on the specified port.
 void server_init(int port);
 
-/// Update the audio RMS levels (safe to call from audio thread).
-void server_update_rms(float l, float r, float b, float err);
+/// Queue one per-block telemetry record (audio thread; wait-free, no
+/// formatting). Records are dropped and counted if the server falls behind.
+/// Call server_init first.
+void server_push_telemetry(const TelemetryRecord *rec);
+
+/// Attach the parameter mailbox the web UI publishes into (call before
+/// server_init). The server is the only writer; the audio thread polls it.
+void server_set_param_mailbox(ParamMailbox *mb);
 
-/// Update the GSC internal parameters (beta, mu).
-/// Update the GSC internal parameters (beta, mu).
-void server_update_params(float beta, float mu);
+/// Attach the spectrum/waveform tap (call before server_init). The audio
+/// thread pushes into it; the server thread analyzes it and streams frames
+/// to binary-protocol clients.
+void server_set_scope_tap(ScopeTap *tap);
 
-/// Get the latest control parameters from the web client.
-/// Returns 1 if parameters were updated, 0 otherwise.
-int server_get_ctrl_params(float *alpha, float *leak_lambda, float *mu_max);
+/// Attach the callback deadline monitor (call before server_init). The
+/// server sends a {"type":"monitor"} summary to WebSocket clients once per
+/// second and serves the latest one at GET /api/monitor.
+void server_set_deadline_monitor(DeadlineMonitor *m);
 
-/// Get DSP module parameters. Returns 1 if updated.
-int server_get_dsp_params(int *aec_on, int *agc_on, int *ng_on,
-                          float *agc_target, float *ng_thresh);
+/// Attach the per-stage profile (LE_PROFILE_STAGES builds; call before
+/// server_init). Sent as a {"type":"profile"} message with every monitor
+/// message (last second) and served cumulatively at GET /api/profile.
+void server_set_stage_profile(StageProfile *p);
 
 /// Set the list of available output devices (called once at startup).
 /// devices: JSON string of device array, e.g. [{"id":0,"name":"Speakers"},...]
@@ -31,20 +46,6 @@ void server_set_device_list(const char *devices_json);
 /// set.
 int server_get_pending_output_device(int *new_device_id);
 
-/// Update jitter buffer statistics (called from audio thread).
-/// @param delay_ms Current buffer delay
-/// @param jitter_mean_ms Mean jitter (EWMA)
-/// @param jitter_std_ms Jitter standard deviation
-/// @param fill_ratio Buffer fill ratio [0, 1]
-void server_update_jitter_stats(float delay_ms, float jitter_mean_ms,
-                                float jitter_std_ms, float fill_ratio);
-
-/// Update phase alignment offsets (called from DSP thread).
-/// @param offsets Array of phase offsets in samples (ch1, ch2, ch3 relative to
-/// ch0)
-/// @param num_channels Number of offset values (typically 3 for 4-ch system)
-void server_update_phase_offsets(const float *offsets, int num_channels);
-
 #ifdef __cplusplus
 }
 #endif
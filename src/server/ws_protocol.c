@@ -0,0 +1,143 @@
+#include "ws_protocol.h"
+#include <stdio.h>
+#include <string.h>
+
+static uint32_t get_u32(const uint8_t *p) {
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) |
+         ((uint32_t)p[3] << 24);
+}
+
+static float get_f32(const uint8_t *p) {
+  uint32_t v = get_u32(p);
+  float f;
+  memcpy(&f, &v, sizeof(f));
+  return f;
+}
+
+static size_t put_tlv(uint8_t *out, size_t out_size, size_t pos, uint8_t tag,
+                      uint32_t v, uint8_t len) {
+  if (pos < 2 || pos + 2 + len > out_size)
+    return 0;
+  out[pos] = tag;
+  out[pos + 1] = len;
+  for (uint8_t i = 0; i < len; i++)
+    out[pos + 2 + i] = (uint8_t)((v >> (8 * i)) & 0xFF);
+  return pos + 2 + len;
+}
+
+size_t ws_control_begin(uint8_t *out, size_t out_size) {
+  if (out_size < 2)
+    return 0;
+  out[0] = WS_KIND_CONTROL;
+  out[1] = WS_PROTOCOL_VERSION;
+  return 2;
+}
+
+size_t ws_control_put_f32(uint8_t *out, size_t out_size, size_t pos,
+                          uint8_t tag, float v) {
+  uint32_t u;
+  memcpy(&u, &v, sizeof(u));
+  return put_tlv(out, out_size, pos, tag, u, 4);
+}
+
+size_t ws_control_put_u8(uint8_t *out, size_t out_size, size_t pos,
+                         uint8_t tag, uint8_t v) {
+  return put_tlv(out, out_size, pos, tag, v, 1);
+}
+
+size_t ws_control_put_i32(uint8_t *out, size_t out_size, size_t pos,
+                          uint8_t tag, int32_t v) {
+  return put_tlv(out, out_size, pos, tag, (uint32_t)v, 4);
+}
+
+int ws_control_apply(const uint8_t *data, size_t len, DspParams *p,
+                     int *output_device) {
+  if (len < 2 || data[0] != WS_KIND_CONTROL || data[1] != WS_PROTOCOL_VERSION)
+    return -1;
+
+  // Validate the whole frame first so a truncated one changes nothing
+  size_t pos = 2;
+  while (pos < len) {
+    if (pos + 2 > len || pos + 2 + data[pos + 1] > len)
+      return -1;
+    pos += 2 + (size_t)data[pos + 1];
+  }
+
+  int changed = 0;
+  for (pos = 2; pos < len; pos += 2 + (size_t)data[pos + 1]) {
+    uint8_t tag = data[pos];
+    uint8_t n = data[pos + 1];
+    const uint8_t *v = data + pos + 2;
+    float *f32 = NULL;
+    int *flag = NULL;
+
+    switch (tag) {
+    case WS_TAG_ALPHA:
+      f32 = &p->gsc.alpha;
+      break;
+    case WS_TAG_LEAK:
+      f32 = &p->gsc.leak_lambda;
+      break;
+    case WS_TAG_MU_MAX:
+      f32 = &p->gsc.mu_max;
+      break;
+    case WS_TAG_ETA_MAX:
+      f32 = &p->gsc.eta_max;
+      break;
+    case WS_TAG_G_LO:
+      f32 = &p->gsc.g_lo;
+      break;
+    case WS_TAG_G_HI:
+      f32 = &p->gsc.g_hi;
+      break;
+    case WS_TAG_AGC_TARGET:
+      f32 = &p->agc_target_db;
+      break;
+    case WS_TAG_NG_THRESH:
+      f32 = &p->ng_thresh_db;
+      break;
+    case WS_TAG_AEC_ON:
+      flag = &p->aec_on;
+      break;
+    case WS_TAG_AGC_ON:
+      flag = &p->agc_on;
+      break;
+    case WS_TAG_NG_ON:
+      flag = &p->ng_on;
+      break;
+    case WS_TAG_OUTPUT_DEVICE:
+      if (n == 4 && output_device)
+        *output_device = (int)(int32_t)get_u32(v);
+      break;
+    default:
+      break; // Unknown tag: skip
+    }
+
+    if (f32 && n == 4) {
+      *f32 = get_f32(v);
+      changed++;
+    } else if (flag && n == 1) {
+      *flag = v[0] ? 1 : 0;
+      changed++;
+    }
+  }
+  return changed;
+}
+
+size_t ws_format_stats_json(const TelemetryRecord *rec, char *out,
+                            size_t out_size) {
+  int len = snprintf(out, out_size,
+                     "{\"l\": %.4f, \"r\": %.4f, \"b\": %.4f, \"e\": %.4f, "
+                     "\"beta\": %.4f, \"mu\": %.6f, "
+                     "\"jitter\": {\"delay\": %.1f, \"mean\": %.2f, \"std\": "
+                     "%.2f, \"fill\": %.2f}, "
+                     "\"phase\": [%.2f,%.2f,%.2f]}",
+                     rec->rms_l, rec->rms_r, rec->rms_b, rec->rms_out,
+                     rec->beta, rec->mu, rec->jitter_delay_ms,
+                     rec->jitter_mean_ms, rec->jitter_std_ms,
+                     rec->jitter_fill, rec->phase[0], rec->phase[1],
+                     rec->phase[2]);
+  if (len < 0 || (size_t)len >= out_size)
+    return 0;
+  return (size_t)len;
+}
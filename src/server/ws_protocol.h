@@ -0,0 +1,87 @@
+#ifndef WS_PROTOCOL_H
+#define WS_PROTOCOL_H
+
+/**
+ * WebSocket wire protocol between the server and the web UI.
+ *
+ * Clients that offer the subprotocol WS_SUBPROTOCOL get binary frames:
+ *   Every frame starts with u8 kind, u8 version.
+ *   kind 1 (server -> client): telemetry batch, see telemetry.h
+ *   kind 2 (client -> server): control, followed by TLV entries
+ *     u8 tag, u8 len, len bytes of little-endian payload
+ *   kind 3 (server -> client): spectrum/waveform frame, see scope_tap.h
+ *   Unknown tags are skipped by length so older servers accept newer UIs.
+ *
+ * Clients without the subprotocol fall back to JSON text: one stats object
+ * per server poll and {"alpha": ..., "aec_on": ...} style control messages.
+ */
+
+#include "../dsp/scope_tap.h"
+#include "../utils/param_mailbox.h"
+#include "../utils/telemetry.h"
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define WS_SUBPROTOCOL "lombardear.bin.v1"
+#define WS_PROTOCOL_VERSION TELEMETRY_FRAME_VERSION
+
+#define WS_KIND_TELEMETRY TELEMETRY_FRAME_KIND
+#define WS_KIND_CONTROL 2
+#define WS_KIND_SCOPE SCOPE_FRAME_KIND
+
+// Control TLV tags (f32 unless noted)
+typedef enum {
+  WS_TAG_ALPHA = 1,
+  WS_TAG_LEAK = 2,
+  WS_TAG_MU_MAX = 3,
+  WS_TAG_AEC_ON = 4, // u8
+  WS_TAG_AGC_ON = 5, // u8
+  WS_TAG_NG_ON = 6,  // u8
+  WS_TAG_AGC_TARGET = 7,
+  WS_TAG_NG_THRESH = 8,
+  WS_TAG_OUTPUT_DEVICE = 9, // i32
+  WS_TAG_ETA_MAX = 10,
+  WS_TAG_G_LO = 11,
+  WS_TAG_G_HI = 12
+} WsControlTag;
+
+// Start a control frame. Returns bytes written (2), or 0 if out is too small.
+size_t ws_control_begin(uint8_t *out, size_t out_size);
+
+// Append one TLV entry at offset pos. Return the new frame length, or 0 if
+// the entry does not fit.
+size_t ws_control_put_f32(uint8_t *out, size_t out_size, size_t pos,
+                          uint8_t tag, float v);
+size_t ws_control_put_u8(uint8_t *out, size_t out_size, size_t pos,
+                         uint8_t tag, uint8_t v);
+size_t ws_control_put_i32(uint8_t *out, size_t out_size, size_t pos,
+                          uint8_t tag, int32_t v);
+
+/**
+ * Apply a binary control frame to a parameter snapshot.
+ * @param data: Frame bytes (starting with kind/version)
+ * @param len: Frame length
+ * @param p: Parameters to update (only tags present are changed)
+ * @param output_device: Set to the requested device id, or left unchanged
+ * @return Number of DspParams fields changed, or -1 if the frame is malformed
+ *         or not a control frame of a supported version
+ */
+int ws_control_apply(const uint8_t *data, size_t len, DspParams *p,
+                     int *output_device);
+
+/**
+ * Format one record as the JSON stats object used by fallback clients.
+ * @return Length written (excluding NUL), or 0 if out is too small
+ */
+size_t ws_format_stats_json(const TelemetryRecord *rec, char *out,
+                            size_t out_size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // WS_PROTOCOL_H
@@ -0,0 +1,99 @@
+#ifndef ATOMIC_COMPAT_H
+#define ATOMIC_COMPAT_H
+
+/**
+ * Minimal portable atomics for sharing state with the audio thread.
+ *
+ * The project is built as C99, so <stdatomic.h> is not assumed. GCC/Clang
+ * use the __atomic builtins on plain ints; MSVC uses the Interlocked
+ * intrinsics. Loads are acquire and stores are release, which is all the
+ * single-producer/single-consumer handoffs in this project need.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+
+#include <intrin.h>
+
+typedef volatile long le_atomic_int;
+
+// Aligned loads are acquire on x86/x64; the barrier stops compiler reordering
+static inline int le_atomic_load(le_atomic_int *a) {
+  long v = *a;
+  _ReadWriteBarrier();
+  return (int)v;
+}
+
+static inline void le_atomic_store(le_atomic_int *a, int v) {
+  _InterlockedExchange(a, (long)v);
+}
+
+static inline int le_atomic_exchange(le_atomic_int *a, int v) {
+  return (int)_InterlockedExchange(a, (long)v);
+}
+
+static inline int le_atomic_fetch_add(le_atomic_int *a, int v) {
+  return (int)_InterlockedExchangeAdd(a, (long)v);
+}
+
+// 64-bit counters (statistics that must not wrap on long runs)
+typedef volatile __int64 le_atomic_i64;
+
+static inline long long le_atomic_load64(le_atomic_i64 *a) {
+  // A plain 64-bit load is not atomic on 32-bit x86: use a no-op CAS
+  return (long long)_InterlockedCompareExchange64(a, 0, 0);
+}
+
+static inline long long le_atomic_fetch_add64(le_atomic_i64 *a, long long v) {
+  return (long long)_InterlockedExchangeAdd64(a, (__int64)v);
+}
+
+static inline void le_atomic_store64(le_atomic_i64 *a, long long v) {
+  _InterlockedExchange64(a, (__int64)v);
+}
+
+#else
+
+typedef int le_atomic_int;
+
+static inline int le_atomic_load(le_atomic_int *a) {
+  return __atomic_load_n(a, __ATOMIC_ACQUIRE);
+}
+
+static inline void le_atomic_store(le_atomic_int *a, int v) {
+  __atomic_store_n(a, v, __ATOMIC_RELEASE);
+}
+
+static inline int le_atomic_exchange(le_atomic_int *a, int v) {
+  return __atomic_exchange_n(a, v, __ATOMIC_ACQ_REL);
+}
+
+static inline int le_atomic_fetch_add(le_atomic_int *a, int v) {
+  return __atomic_fetch_add(a, v, __ATOMIC_ACQ_REL);
+}
+
+// 64-bit counters (statistics that must not wrap on long runs)
+typedef long long le_atomic_i64;
+
+static inline long long le_atomic_load64(le_atomic_i64 *a) {
+  return __atomic_load_n(a, __ATOMIC_ACQUIRE);
+}
+
+static inline long long le_atomic_fetch_add64(le_atomic_i64 *a, long long v) {
+  return __atomic_fetch_add(a, v, __ATOMIC_ACQ_REL);
+}
+
+static inline void le_atomic_store64(le_atomic_i64 *a, long long v) {
+  __atomic_store_n(a, v, __ATOMIC_RELEASE);
+}
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ATOMIC_COMPAT_H
@@ -1,15 +1,16 @@
 #include "config.h"
 #include "../audio/audio_io.h"
 #include <cJSON.h>
+#include <stddef.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
-
-int config_load(const char *filename, AudioConfig *cfg) {
+// Read and parse a JSON file. Returns NULL on error; caller deletes.
+static cJSON *config_parse_file(const char *filename) {
   FILE *f = fopen(filename, "rb");
   if (!f)
-    return -1;
+    return NULL;
 
   fseek(f, 0, SEEK_END);
   long len = ftell(f);
@@ -18,7 +19,7 @@ int config_load(const char *filename, AudioConfig *cfg) {
   char *data = (char *)malloc(len + 1);
   if (!data) {
     fclose(f);
-    return -1;
+    return NULL;
   }
 
   size_t read_bytes = fread(data, 1, len, f);
@@ -32,13 +33,20 @@ int config_load(const char *filename, AudioConfig *cfg) {
   cJSON *json = cJSON_Parse(data);
   free(data);
   if (!json)
-    return -1;
+    return NULL;
 
   // Safety check: verify parse result
   if (cJSON_IsInvalid(json)) {
     cJSON_Delete(json);
-    return -1;
+    return NULL;
   }
+  return json;
+}
+
+int config_load(const char *filename, AudioConfig *cfg) {
+  cJSON *json = config_parse_file(filename);
+  if (!json)
+    return -1;
 
   cJSON *audio_obj = cJSON_GetObjectItem(json, "audio");
   if (!audio_obj) {
@@ -70,9 +78,15 @@ int config_load(const char *filename, AudioConfig *cfg) {
   if (cJSON_IsNumber(item))
     cfg->output_channels = item->valueint;
 
+  // "mics": 4 selects the 4-mic layout; a 4-channel device implies it
+  item = cJSON_GetObjectItem(audio_obj, "mics");
+  if (cJSON_IsNumber(item))
+    cfg->mics = item->valueint;
+
   cJSON *map = cJSON_GetObjectItem(audio_obj, "channel_map");
   if (cJSON_IsArray(map) && cJSON_GetArraySize(map) >= 3) {
-    for (int i = 0; i < 3; i++) {
+    int n = cJSON_GetArraySize(map);
+    for (int i = 0; i < n && i < AUDIO_MAX_MICS; i++) {
       cJSON *val = cJSON_GetArrayItem(map, i);
       if (cJSON_IsNumber(val)) {
         cfg->channel_map[i] = val->valueint;
@@ -95,10 +109,247 @@ int config_load(const char *filename, AudioConfig *cfg) {
       cfg->backend = AUDIO_BACKEND_ALSA;
     else if (strcmp(s, "jack") == 0)
       cfg->backend = AUDIO_BACKEND_JACK;
+    else if (strcmp(s, "alsa_mmap") == 0)
+      cfg->backend = AUDIO_BACKEND_ALSA_MMAP;
+    else if (strcmp(s, "file") == 0)
+      cfg->backend = AUDIO_BACKEND_FILE;
+    else if (strcmp(s, "null") == 0)
+      cfg->backend = AUDIO_BACKEND_NULL;
     else
       cfg->backend = AUDIO_BACKEND_DEFAULT;
   }
 
+  // Native ALSA devices (backend "alsa_mmap")
+  cJSON *alsa = cJSON_GetObjectItem(audio_obj, "alsa");
+  if (cJSON_IsObject(alsa)) {
+    item = cJSON_GetObjectItem(alsa, "capture");
+    if (cJSON_IsString(item))
+      snprintf(cfg->alsa.capture, sizeof(cfg->alsa.capture), "%s",
+               item->valuestring);
+
+    item = cJSON_GetObjectItem(alsa, "playback");
+    if (cJSON_IsString(item))
+      snprintf(cfg->alsa.playback, sizeof(cfg->alsa.playback), "%s",
+               item->valuestring);
+
+    item = cJSON_GetObjectItem(alsa, "periods");
+    if (cJSON_IsNumber(item))
+      cfg->alsa.periods = item->valueint;
+  }
+
+  // Simulated device (backend "file" / "null")
+  cJSON *file = cJSON_GetObjectItem(audio_obj, "file");
+  if (cJSON_IsObject(file)) {
+    item = cJSON_GetObjectItem(file, "input");
+    if (cJSON_IsString(item))
+      snprintf(cfg->file.input, sizeof(cfg->file.input), "%s",
+               item->valuestring);
+
+    item = cJSON_GetObjectItem(file, "output");
+    if (cJSON_IsString(item))
+      snprintf(cfg->file.output, sizeof(cfg->file.output), "%s",
+               item->valuestring);
+
+    item = cJSON_GetObjectItem(file, "loop");
+    if (cJSON_IsBool(item))
+      cfg->file.loop = cJSON_IsTrue(item);
+
+    item = cJSON_GetObjectItem(file, "jitter_ms");
+    if (cJSON_IsNumber(item))
+      cfg->file.jitter_ms = (float)item->valuedouble;
+
+    item = cJSON_GetObjectItem(file, "stall_ms");
+    if (cJSON_IsNumber(item))
+      cfg->file.stall_ms = (float)item->valuedouble;
+
+    item = cJSON_GetObjectItem(file, "stall_prob");
+    if (cJSON_IsNumber(item))
+      cfg->file.stall_prob = (float)item->valuedouble;
+
+    item = cJSON_GetObjectItem(file, "drift_ppm");
+    if (cJSON_IsNumber(item))
+      cfg->file.drift_ppm = (float)item->valuedouble;
+
+    item = cJSON_GetObjectItem(file, "seed");
+    if (cJSON_IsNumber(item))
+      cfg->file.seed = (unsigned int)item->valuedouble;
+  }
+
+  // Callback thread scheduling
+  cJSON *rt = cJSON_GetObjectItem(audio_obj, "realtime");
+  if (cJSON_IsObject(rt)) {
+    item = cJSON_GetObjectItem(rt, "policy");
+    if (cJSON_IsString(item)) {
+      const char *s = item->valuestring;
+      if (strcmp(s, "fifo") == 0)
+        cfg->rt.policy = PLATFORM_SCHED_FIFO;
+      else if (strcmp(s, "rr") == 0)
+        cfg->rt.policy = PLATFORM_SCHED_RR;
+      else
+        cfg->rt.policy = PLATFORM_SCHED_OTHER;
+    }
+
+    item = cJSON_GetObjectItem(rt, "priority");
+    if (cJSON_IsNumber(item))
+      cfg->rt.priority = item->valueint;
+
+    item = cJSON_GetObjectItem(rt, "cpu");
+    if (cJSON_IsNumber(item))
+      cfg->rt.cpu = item->valueint;
+
+    item = cJSON_GetObjectItem(rt, "lock_memory");
+    if (cJSON_IsBool(item))
+      cfg->rt.lock_memory = cJSON_IsTrue(item);
+
+    item = cJSON_GetObjectItem(rt, "prefault_stack_kb");
+    if (cJSON_IsNumber(item))
+      cfg->rt.prefault_stack_kb = item->valueint;
+  }
+
+  cJSON_Delete(json);
+  return 0;
+}
+
+// GscConfig fields by JSON key (M is handled separately: it is an int)
+typedef struct {
+  const char *key;
+  size_t offset;
+} GscFloatField;
+
+static const GscFloatField k_gsc_fields[] = {
+    {"alpha", offsetof(GscConfig, alpha)},
+    {"eps", offsetof(GscConfig, eps)},
+    {"mu_max", offsetof(GscConfig, mu_max)},
+    {"eta_max", offsetof(GscConfig, eta_max)},
+    {"leak_lambda", offsetof(GscConfig, leak_lambda)},
+    {"g_lo", offsetof(GscConfig, g_lo)},
+    {"g_hi", offsetof(GscConfig, g_hi)},
+    {"beta_min", offsetof(GscConfig, beta_min)},
+    {"beta_max", offsetof(GscConfig, beta_max)},
+};
+#define GSC_FIELD_COUNT (sizeof(k_gsc_fields) / sizeof(k_gsc_fields[0]))
+
+int config_load_gsc(const char *filename, GscConfig *gsc) {
+  cJSON *json = config_parse_file(filename);
+  if (!json)
+    return -1;
+
+  cJSON *gsc_obj = cJSON_GetObjectItem(json, "gsc");
+  if (!gsc_obj) {
+    cJSON_Delete(json);
+    return -1;
+  }
+
+  cJSON *item = cJSON_GetObjectItem(gsc_obj, "M");
+  if (cJSON_IsNumber(item))
+    gsc->M = item->valueint;
+
+  for (size_t i = 0; i < GSC_FIELD_COUNT; i++) {
+    item = cJSON_GetObjectItem(gsc_obj, k_gsc_fields[i].key);
+    if (cJSON_IsNumber(item))
+      *(float *)((char *)gsc + k_gsc_fields[i].offset) =
+          (float)item->valuedouble;
+  }
+
+  cJSON_Delete(json);
+  return 0;
+}
+
+int config_save_gsc(const char *filename, const GscConfig *gsc) {
+  cJSON *json = cJSON_CreateObject();
+  cJSON *gsc_obj = cJSON_AddObjectToObject(json, "gsc");
+  if (!gsc_obj) {
+    cJSON_Delete(json);
+    return -1;
+  }
+  cJSON_AddNumberToObject(gsc_obj, "M", gsc->M);
+  for (size_t i = 0; i < GSC_FIELD_COUNT; i++) {
+    float v = *(const float *)((const char *)gsc + k_gsc_fields[i].offset);
+    cJSON_AddNumberToObject(gsc_obj, k_gsc_fields[i].key, v);
+  }
+
+  char *text = cJSON_Print(json);
+  cJSON_Delete(json);
+  if (!text)
+    return -1;
+  FILE *f = fopen(filename, "w");
+  int ret = -1;
+  if (f) {
+    ret = fputs(text, f) >= 0 && fputc('\n', f) != EOF ? 0 : -1;
+    if (fclose(f) != 0)
+      ret = -1;
+  }
+  cJSON_free(text);
+  return ret;
+}
+
+int config_load_gsc_mode(const char *filename, GscMode *mode,
+                         GscSubbandConfig *sb) {
+  cJSON *json = config_parse_file(filename);
+  if (!json)
+    return -1;
+
+  cJSON *gsc_obj = cJSON_GetObjectItem(json, "gsc");
+  if (!gsc_obj) {
+    cJSON_Delete(json);
+    return -1;
+  }
+
+  cJSON *item = cJSON_GetObjectItem(gsc_obj, "mode");
+  if (cJSON_IsString(item)) {
+    if (strcmp(item->valuestring, "subband") == 0)
+      *mode = GSC_MODE_SUBBAND;
+    else
+      *mode = GSC_MODE_TIME;
+  }
+
+  cJSON *sb_obj = cJSON_GetObjectItem(gsc_obj, "subband");
+  if (sb_obj) {
+    item = cJSON_GetObjectItem(sb_obj, "fft_size");
+    if (cJSON_IsNumber(item))
+      sb->fft_size = item->valueint;
+
+    item = cJSON_GetObjectItem(sb_obj, "hop");
+    if (cJSON_IsNumber(item))
+      sb->hop = item->valueint;
+
+    item = cJSON_GetObjectItem(sb_obj, "mu");
+    if (cJSON_IsNumber(item))
+      sb->mu = (float)item->valuedouble;
+
+    item = cJSON_GetObjectItem(sb_obj, "power_alpha");
+    if (cJSON_IsNumber(item))
+      sb->power_alpha = (float)item->valuedouble;
+  }
+
+  cJSON_Delete(json);
+  return 0;
+}
+
+int config_load_scope(const char *filename, ScopeConfig *scope) {
+  cJSON *json = config_parse_file(filename);
+  if (!json)
+    return -1;
+
+  cJSON *ws_obj = cJSON_GetObjectItem(json, "ws");
+  cJSON *scope_obj = ws_obj ? cJSON_GetObjectItem(ws_obj, "scope") : NULL;
+  if (!scope_obj) {
+    cJSON_Delete(json);
+    return -1;
+  }
+
+  cJSON *item = cJSON_GetObjectItem(scope_obj, "fft_size");
+  if (cJSON_IsNumber(item))
+    scope->fft_size = item->valueint;
+
+  item = cJSON_GetObjectItem(scope_obj, "rate_hz");
+  if (cJSON_IsNumber(item))
+    scope->rate_hz = item->valueint;
+
+  item = cJSON_GetObjectItem(scope_obj, "wave_points");
+  if (cJSON_IsNumber(item))
+    scope->wave_points = item->valueint;
+
   cJSON_Delete(json);
   return 0;
 }
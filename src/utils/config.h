@@ -2,6 +2,8 @@
 #define CONFIG_H
 
 #include "../audio/audio_io.h"
+#include "../dsp/gsc_subband.h"
+#include "../dsp/scope_tap.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -11,6 +13,28 @@ extern "C" {
 // Returns 0 on success, -1 on error.
 int config_load(const char *filename, AudioConfig *cfg);
 
+// Load the beamformer coefficients ("gsc": M, alpha, eps, mu_max, eta_max,
+// leak_lambda, g_lo, g_hi, beta_min, beta_max). Fields missing from the
+// file keep their values.
+// Returns 0 on success, -1 on error.
+int config_load_gsc(const char *filename, GscConfig *gsc);
+
+// Write {"gsc": {...}} with every GscConfig field, readable by
+// config_load_gsc (used by the tuner to emit the best candidate).
+// Returns 0 on success, -1 on error.
+int config_save_gsc(const char *filename, const GscConfig *gsc);
+
+// Load the beamformer mode ("gsc.mode": "time" | "subband") and the
+// "gsc.subband" parameters. Fields missing from the file keep their values.
+// Returns 0 on success, -1 on error.
+int config_load_gsc_mode(const char *filename, GscMode *mode,
+                         GscSubbandConfig *sb);
+
+// Load the web UI spectrum/waveform tap settings ("ws.scope"). Fields
+// missing from the file keep their values.
+// Returns 0 on success, -1 on error.
+int config_load_scope(const char *filename, ScopeConfig *scope);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,153 @@
+#include "deadline_monitor.h"
+#include <stdio.h>
+#include <string.h>
+
+void deadline_monitor_init(DeadlineMonitor *m) { memset(m, 0, sizeof(*m)); }
+
+int deadline_monitor_bin(double us) {
+  if (!(us >= 1.0)) // Also catches NaN
+    return 0;
+  if (us >= 4194304.0) // 2^22 us
+    return DEADLINE_HIST_BINS - 1;
+  unsigned long v = (unsigned long)us;
+  if (v < 4)
+    return (int)v;
+  // Octave e (bit index of the top bit) and the next two bits below it
+  int e = 0;
+  while ((v >> (e + 1)) != 0)
+    e++;
+  int bin = 4 * (e - 1) + (int)((v >> (e - 2)) & 3u);
+  return bin < DEADLINE_HIST_BINS ? bin : DEADLINE_HIST_BINS - 1;
+}
+
+double deadline_monitor_bin_upper_us(int bin) {
+  if (bin < 4)
+    return (double)(bin + 1);
+  int e = bin / 4 + 1;
+  int sub = bin % 4;
+  return (double)(5 + sub) * (double)(1ul << (e - 2));
+}
+
+void deadline_monitor_record(DeadlineMonitor *m, double dsp_us,
+                             double budget_us) {
+  long long ns = (long long)(dsp_us * 1000.0);
+  le_atomic_fetch_add64(&m->hist[deadline_monitor_bin(dsp_us)], 1);
+  le_atomic_fetch_add64(&m->busy_ns, ns);
+  le_atomic_fetch_add64(&m->budget_ns, (long long)(budget_us * 1000.0));
+  if (dsp_us > budget_us)
+    le_atomic_fetch_add64(&m->overruns, 1);
+  // Single writer: a plain compare is enough
+  if (ns > le_atomic_load64(&m->max_ns))
+    le_atomic_store64(&m->max_ns, ns);
+  le_atomic_fetch_add64(&m->blocks, 1); // Last: readers see whole blocks
+}
+
+void deadline_monitor_xrun(DeadlineMonitor *m, DeadlineXrun kind) {
+  if (kind >= 0 && kind < DEADLINE_XRUN_KINDS)
+    le_atomic_fetch_add64(&m->xruns[kind], 1);
+}
+
+void deadline_monitor_add_denormals(DeadlineMonitor *m, long long count) {
+  le_atomic_fetch_add64(&m->denormals, count);
+}
+
+void deadline_monitor_snapshot(DeadlineMonitor *m, DeadlineStats *s) {
+  s->blocks = le_atomic_load64(&m->blocks);
+  for (int i = 0; i < DEADLINE_HIST_BINS; i++)
+    s->hist[i] = le_atomic_load64(&m->hist[i]);
+  s->overruns = le_atomic_load64(&m->overruns);
+  s->busy_ns = le_atomic_load64(&m->busy_ns);
+  s->budget_ns = le_atomic_load64(&m->budget_ns);
+  s->max_ns = le_atomic_load64(&m->max_ns);
+  for (int k = 0; k < DEADLINE_XRUN_KINDS; k++)
+    s->xruns[k] = le_atomic_load64(&m->xruns[k]);
+  s->denormals = le_atomic_load64(&m->denormals);
+}
+
+void deadline_stats_diff(const DeadlineStats *now, const DeadlineStats *prev,
+                         DeadlineStats *out) {
+  for (int i = 0; i < DEADLINE_HIST_BINS; i++)
+    out->hist[i] = now->hist[i] - prev->hist[i];
+  out->blocks = now->blocks - prev->blocks;
+  out->overruns = now->overruns - prev->overruns;
+  out->busy_ns = now->busy_ns - prev->busy_ns;
+  out->budget_ns = now->budget_ns - prev->budget_ns;
+  out->max_ns = now->max_ns;
+  for (int k = 0; k < DEADLINE_XRUN_KINDS; k++)
+    out->xruns[k] = now->xruns[k] - prev->xruns[k];
+  out->denormals = now->denormals - prev->denormals;
+}
+
+double deadline_stats_quantile_us(const DeadlineStats *s, double q) {
+  long long total = 0;
+  for (int i = 0; i < DEADLINE_HIST_BINS; i++)
+    total += s->hist[i];
+  if (total == 0)
+    return 0.0;
+  long long acc = 0;
+  int last = 0;
+  for (int i = 0; i < DEADLINE_HIST_BINS; i++) {
+    if (s->hist[i] == 0)
+      continue;
+    acc += s->hist[i];
+    last = i;
+    if ((double)acc >= q * (double)total)
+      break;
+  }
+  return deadline_monitor_bin_upper_us(last);
+}
+
+double deadline_stats_load(const DeadlineStats *s) {
+  return s->budget_ns > 0 ? (double)s->busy_ns / (double)s->budget_ns : 0.0;
+}
+
+long long deadline_stats_xruns(const DeadlineStats *s) {
+  long long n = 0;
+  for (int k = 0; k < DEADLINE_XRUN_KINDS; k++)
+    n += s->xruns[k];
+  return n;
+}
+
+size_t deadline_monitor_format_json(const DeadlineStats *total,
+                                    const DeadlineStats *interval,
+                                    double interval_s, char *out,
+                                    size_t out_size) {
+  const long long *x = interval->xruns;
+  int n = snprintf(
+      out, out_size,
+      "{\"type\":\"monitor\",\"blocks\":%lld,\"overruns\":%lld,"
+      "\"xruns\":%lld,\"max_us\":%.1f,\"load\":%.4f,\"denormals\":%lld,"
+      "\"interval\":{\"seconds\":%.2f,\"blocks\":%lld,\"load\":%.4f,"
+      "\"p50_us\":%.0f,\"p99_us\":%.0f,\"max_us\":%.0f,\"overruns\":%lld,"
+      "\"input_underflow\":%lld,\"input_overflow\":%lld,"
+      "\"output_underflow\":%lld,\"output_overflow\":%lld,\"hist\":[",
+      total->blocks, total->overruns, deadline_stats_xruns(total),
+      (double)total->max_ns * 1e-3, deadline_stats_load(total),
+      total->denormals, interval_s, interval->blocks,
+      deadline_stats_load(interval),
+      deadline_stats_quantile_us(interval, 0.5),
+      deadline_stats_quantile_us(interval, 0.99),
+      deadline_stats_quantile_us(interval, 1.0), interval->overruns,
+      x[DEADLINE_XRUN_INPUT_UNDERFLOW], x[DEADLINE_XRUN_INPUT_OVERFLOW],
+      x[DEADLINE_XRUN_OUTPUT_UNDERFLOW], x[DEADLINE_XRUN_OUTPUT_OVERFLOW]);
+  if (n < 0 || (size_t)n >= out_size)
+    return 0;
+  size_t pos = (size_t)n;
+
+  // Non-empty buckets only: [upper edge in us, blocks]
+  int first = 1;
+  for (int i = 0; i < DEADLINE_HIST_BINS; i++) {
+    if (interval->hist[i] == 0)
+      continue;
+    n = snprintf(out + pos, out_size - pos, "%s[%.0f,%lld]", first ? "" : ",",
+                 deadline_monitor_bin_upper_us(i), interval->hist[i]);
+    if (n < 0 || (size_t)n >= out_size - pos)
+      return 0;
+    pos += (size_t)n;
+    first = 0;
+  }
+  n = snprintf(out + pos, out_size - pos, "]}}");
+  if (n < 0 || (size_t)n >= out_size - pos)
+    return 0;
+  return pos + (size_t)n;
+}
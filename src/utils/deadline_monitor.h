@@ -0,0 +1,103 @@
+#ifndef DEADLINE_MONITOR_H
+#define DEADLINE_MONITOR_H
+
+#include "atomic_compat.h"
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Callback deadline instrumentation shared by the audio thread and readers.
+ *
+ * The audio thread is the only writer: it records the DSP time of every
+ * block against the block budget (frames / sample rate) and the xruns the
+ * backend reports. Every field is a cumulative 64-bit counter, so any number
+ * of readers (console log, web server) take snapshots and difference them
+ * over their own interval without resetting anything. Recording is a few
+ * atomic adds: no locks, no formatting, no I/O.
+ *
+ * DSP times go into a log-bucket histogram with four buckets per octave
+ * (at most 25% wide) from 1 us to about 4 s.
+ */
+
+#define DEADLINE_HIST_BINS 84
+
+typedef enum {
+  DEADLINE_XRUN_INPUT_UNDERFLOW = 0, // Input missing (paInputUnderflow)
+  DEADLINE_XRUN_INPUT_OVERFLOW,      // Input lost (paInputOverflow, overrun)
+  DEADLINE_XRUN_OUTPUT_UNDERFLOW,    // Output late (paOutputUnderflow)
+  DEADLINE_XRUN_OUTPUT_OVERFLOW,     // Output dropped (paOutputOverflow)
+  DEADLINE_XRUN_KINDS
+} DeadlineXrun;
+
+typedef struct {
+  le_atomic_i64 hist[DEADLINE_HIST_BINS]; // Blocks per DSP time bucket
+  le_atomic_i64 blocks;
+  le_atomic_i64 overruns;  // Blocks whose DSP time exceeded the budget
+  le_atomic_i64 busy_ns;   // Sum of DSP time
+  le_atomic_i64 budget_ns; // Sum of block budgets
+  le_atomic_i64 max_ns;    // Longest block since init
+  le_atomic_i64 xruns[DEADLINE_XRUN_KINDS];
+  le_atomic_i64 denormals; // Subnormal values seen (LE_COUNT_DENORMALS)
+} DeadlineMonitor;
+
+// Plain copy of the counters (a snapshot, or the difference of two)
+typedef struct {
+  long long hist[DEADLINE_HIST_BINS];
+  long long blocks;
+  long long overruns;
+  long long busy_ns;
+  long long budget_ns;
+  long long max_ns; // Snapshots only: not meaningful in a difference
+  long long xruns[DEADLINE_XRUN_KINDS];
+  long long denormals;
+} DeadlineStats;
+
+// Zero all counters. Not thread-safe; call before the stream starts.
+void deadline_monitor_init(DeadlineMonitor *m);
+
+// Audio thread: one processed block. budget_us is the block duration.
+void deadline_monitor_record(DeadlineMonitor *m, double dsp_us,
+                             double budget_us);
+
+// Audio thread: one xrun reported by the backend
+void deadline_monitor_xrun(DeadlineMonitor *m, DeadlineXrun kind);
+
+// Audio thread: subnormal values found in the DSP state
+void deadline_monitor_add_denormals(DeadlineMonitor *m, long long count);
+
+// Any thread: copy the counters
+void deadline_monitor_snapshot(DeadlineMonitor *m, DeadlineStats *s);
+
+// out = now - prev (counters only; max_ns is taken from now)
+void deadline_stats_diff(const DeadlineStats *now, const DeadlineStats *prev,
+                         DeadlineStats *out);
+
+// Histogram bucket of a DSP time, and the upper edge of a bucket (us)
+int deadline_monitor_bin(double us);
+double deadline_monitor_bin_upper_us(int bin);
+
+// Upper edge of the bucket holding quantile q (0 - 1) of the blocks, 0 if
+// the histogram is empty
+double deadline_stats_quantile_us(const DeadlineStats *s, double q);
+
+// Mean DSP time over mean budget (0 if no blocks)
+double deadline_stats_load(const DeadlineStats *s);
+
+// Total xruns of all kinds
+long long deadline_stats_xruns(const DeadlineStats *s);
+
+// JSON object {"type":"monitor", ...} with cumulative totals and the values
+// of the last interval. Returns the length, or 0 if out is too small.
+size_t deadline_monitor_format_json(const DeadlineStats *total,
+                                    const DeadlineStats *interval,
+                                    double interval_s, char *out,
+                                    size_t out_size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DEADLINE_MONITOR_H
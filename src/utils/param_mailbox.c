@@ -0,0 +1,50 @@
+#include "param_mailbox.h"
+#include <math.h>
+
+// Set in "latest" when it holds a snapshot the reader has not taken yet
+#define PARAM_MAILBOX_FRESH 4
+#define PARAM_MAILBOX_INDEX 3
+
+static void dsp_params_derive(DspParams *p) {
+  p->agc_target_rms = powf(10.0f, p->agc_target_db / 20.0f);
+  p->ng_thresh_linear = powf(10.0f, p->ng_thresh_db / 20.0f);
+}
+
+void param_mailbox_init(ParamMailbox *mb, const DspParams *initial) {
+  mb->pending = *initial;
+  mb->pending.version = 0;
+  mb->version = 0;
+  dsp_params_derive(&mb->pending);
+  for (int i = 0; i < 3; i++)
+    mb->slot[i] = mb->pending;
+
+  mb->read_idx = 0;
+  mb->write_idx = 1;
+  le_atomic_store(&mb->latest, 2);
+}
+
+DspParams *param_mailbox_edit(ParamMailbox *mb) { return &mb->pending; }
+
+void param_mailbox_publish(ParamMailbox *mb) {
+  mb->pending.version = ++mb->version;
+  dsp_params_derive(&mb->pending);
+  mb->slot[mb->write_idx] = mb->pending;
+
+  // Release the filled slot, take back whichever slot was "latest"
+  int prev = le_atomic_exchange(&mb->latest, mb->write_idx | PARAM_MAILBOX_FRESH);
+  mb->write_idx = prev & PARAM_MAILBOX_INDEX;
+}
+
+int param_mailbox_poll(ParamMailbox *mb, const DspParams **params) {
+  int changed = 0;
+  if (le_atomic_load(&mb->latest) & PARAM_MAILBOX_FRESH) {
+    // Only the reader clears FRESH, so the exchange always returns a fresh
+    // slot (possibly a newer one than the load saw)
+    int prev = le_atomic_exchange(&mb->latest, mb->read_idx);
+    mb->read_idx = prev & PARAM_MAILBOX_INDEX;
+    changed = 1;
+  }
+  if (params)
+    *params = &mb->slot[mb->read_idx];
+  return changed;
+}
@@ -0,0 +1,63 @@
+#ifndef PARAM_MAILBOX_H
+#define PARAM_MAILBOX_H
+
+#include "../dsp/gsc.h"
+#include "atomic_compat.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Complete set of runtime-adjustable DSP parameters. Always handed over as
+// one snapshot so the audio thread never sees a half-applied update.
+typedef struct {
+  unsigned int version; // Incremented on every publish
+
+  GscConfig gsc; // M is informational; the filter length is fixed at init
+
+  int aec_on;
+  int agc_on;
+  int ng_on;
+  float agc_target_db; // AGC target level (dB)
+  float ng_thresh_db;  // Noise gate threshold (dB)
+
+  // Derived by param_mailbox_publish so the audio thread never calls powf
+  float agc_target_rms;   // 10^(agc_target_db / 20)
+  float ng_thresh_linear; // 10^(ng_thresh_db / 20)
+} DspParams;
+
+// Single-writer / single-reader triple buffer of DspParams.
+// The writer fills a private slot and swaps it with the shared "latest"
+// slot; the reader swaps its slot with "latest" only when a new snapshot
+// was published. Both sides are wait-free.
+typedef struct {
+  DspParams slot[3];
+  le_atomic_int latest; // Slot index | PARAM_MAILBOX_FRESH (shared)
+  int write_idx;        // Slot owned by the writer
+  int read_idx;         // Slot owned by the reader
+  DspParams pending;    // Writer's working copy (see param_mailbox_edit)
+  unsigned int version; // Last published version (writer)
+} ParamMailbox;
+
+// Initialize all slots with `initial` (version 0). Not thread-safe; call
+// before the writer or the reader starts.
+void param_mailbox_init(ParamMailbox *mb, const DspParams *initial);
+
+// Writer side: working copy holding the last published values. Modify the
+// fields, then call param_mailbox_publish.
+DspParams *param_mailbox_edit(ParamMailbox *mb);
+
+// Writer side: derive the linear values, bump the version and hand the
+// working copy to the reader.
+void param_mailbox_publish(ParamMailbox *mb);
+
+// Reader side (audio thread): take the newest snapshot if one was published.
+// params: Set to the reader's current snapshot (valid until the next poll).
+// Returns 1 if the snapshot changed since the previous poll, 0 otherwise.
+int param_mailbox_poll(ParamMailbox *mb, const DspParams **params);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PARAM_MAILBOX_H
@@ -0,0 +1,58 @@
+#include "telemetry.h"
+#include <string.h>
+
+static uint8_t *put_u32(uint8_t *p, uint32_t v) {
+  p[0] = (uint8_t)(v & 0xFF);
+  p[1] = (uint8_t)((v >> 8) & 0xFF);
+  p[2] = (uint8_t)((v >> 16) & 0xFF);
+  p[3] = (uint8_t)((v >> 24) & 0xFF);
+  return p + 4;
+}
+
+static uint8_t *put_f32(uint8_t *p, float f) {
+  uint32_t v;
+  memcpy(&v, &f, sizeof(v));
+  return put_u32(p, v);
+}
+
+size_t telemetry_batch_bytes(int count) {
+  return TELEMETRY_HEADER_BYTES + (size_t)count * TELEMETRY_RECORD_BYTES;
+}
+
+size_t telemetry_pack_batch(const TelemetryRecord *recs, int count,
+                            uint32_t dropped, uint8_t *out, size_t out_size) {
+  if (count < 0 || count > 0xFFFF)
+    return 0;
+  size_t bytes = telemetry_batch_bytes(count);
+  if (bytes > out_size)
+    return 0;
+
+  uint8_t *p = out;
+  p[0] = TELEMETRY_FRAME_KIND;
+  p[1] = TELEMETRY_FRAME_VERSION;
+  p[2] = (uint8_t)(count & 0xFF);
+  p[3] = (uint8_t)((count >> 8) & 0xFF);
+  p = put_u32(p + 4, dropped);
+
+  // Field order must match TelemetryRecord and the decoder in script.js
+  for (int i = 0; i < count; i++) {
+    const TelemetryRecord *r = &recs[i];
+    p = put_u32(p, r->seq);
+    p = put_u32(p, r->frames);
+    p = put_f32(p, r->rms_l);
+    p = put_f32(p, r->rms_r);
+    p = put_f32(p, r->rms_b);
+    p = put_f32(p, r->rms_out);
+    p = put_f32(p, r->beta);
+    p = put_f32(p, r->mu);
+    p = put_f32(p, r->gamma);
+    p = put_f32(p, r->dsp_us);
+    p = put_f32(p, r->jitter_delay_ms);
+    p = put_f32(p, r->jitter_mean_ms);
+    p = put_f32(p, r->jitter_std_ms);
+    p = put_f32(p, r->jitter_fill);
+    for (int k = 0; k < TELEMETRY_MAX_PHASE; k++)
+      p = put_f32(p, r->phase[k]);
+  }
+  return bytes;
+}
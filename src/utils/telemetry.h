@@ -0,0 +1,55 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TELEMETRY_MAX_PHASE 3
+
+// Per-callback record pushed by the audio thread. Only 4-byte fields, so the
+// packed wire layout is the struct layout in little-endian order.
+typedef struct {
+  uint32_t seq;    // Callback counter (gaps mean records were dropped)
+  uint32_t frames; // Frames in the callback block
+  float rms_l;
+  float rms_r;
+  float rms_b;
+  float rms_out; // Enhanced output
+  float beta;
+  float mu;
+  float gamma;
+  float dsp_us; // Processing time of the block
+  float jitter_delay_ms;
+  float jitter_mean_ms;
+  float jitter_std_ms;
+  float jitter_fill;
+  float phase[TELEMETRY_MAX_PHASE]; // ch1..ch3 relative to ch0 (samples)
+} TelemetryRecord;
+
+#define TELEMETRY_RECORD_FIELDS 17
+#define TELEMETRY_RECORD_BYTES (TELEMETRY_RECORD_FIELDS * 4)
+
+// Batch frame: 8-byte header followed by `count` records
+//   u8 kind (TELEMETRY_FRAME_KIND), u8 version (TELEMETRY_FRAME_VERSION),
+//   u16 count, u32 dropped (records rejected by a full ring so far)
+#define TELEMETRY_FRAME_KIND 1
+#define TELEMETRY_FRAME_VERSION 1
+#define TELEMETRY_HEADER_BYTES 8
+
+// Bytes needed to pack `count` records
+size_t telemetry_batch_bytes(int count);
+
+// Serialize records into a little-endian batch frame.
+// Returns the number of bytes written, or 0 if `out` is too small.
+size_t telemetry_pack_batch(const TelemetryRecord *recs, int count,
+                            uint32_t dropped, uint8_t *out, size_t out_size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TELEMETRY_H
@@ -0,0 +1,276 @@
+/**
+ * @file wav_io.c
+ * @brief Minimal multichannel WAV / raw float file I/O
+ */
+
+#include "wav_io.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define WAV_FORMAT_PCM 1
+#define WAV_FORMAT_FLOAT 3
+#define WAV_FORMAT_EXTENSIBLE 0xFFFE
+
+#define WAV_CHUNK_FRAMES 1024 // Frames converted per fread
+
+struct WavReader {
+  FILE *f;
+  int channels;
+  int format;          // WAV_FORMAT_PCM or WAV_FORMAT_FLOAT
+  int bytes_per_sample;
+  long frames_left;
+  uint8_t *raw; // [WAV_CHUNK_FRAMES * channels * bytes_per_sample]
+};
+
+struct WavWriter {
+  FILE *f;
+  int channels;
+  long frames;
+  int error;
+};
+
+static uint32_t rd_u32(const uint8_t *p) {
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) |
+         ((uint32_t)p[3] << 24);
+}
+
+static uint16_t rd_u16(const uint8_t *p) {
+  return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static void wr_u32(uint8_t *p, uint32_t v) {
+  p[0] = (uint8_t)(v & 0xFF);
+  p[1] = (uint8_t)((v >> 8) & 0xFF);
+  p[2] = (uint8_t)((v >> 16) & 0xFF);
+  p[3] = (uint8_t)((v >> 24) & 0xFF);
+}
+
+static void wr_u16(uint8_t *p, uint16_t v) {
+  p[0] = (uint8_t)(v & 0xFF);
+  p[1] = (uint8_t)(v >> 8);
+}
+
+static WavReader *reader_alloc(FILE *f, int channels, int format,
+                               int bytes_per_sample, long frames) {
+  WavReader *wr = (WavReader *)calloc(1, sizeof(WavReader));
+  if (!wr)
+    return NULL;
+  wr->f = f;
+  wr->channels = channels;
+  wr->format = format;
+  wr->bytes_per_sample = bytes_per_sample;
+  wr->frames_left = frames;
+  wr->raw = (uint8_t *)malloc((size_t)WAV_CHUNK_FRAMES * channels *
+                              bytes_per_sample);
+  if (!wr->raw) {
+    free(wr);
+    return NULL;
+  }
+  return wr;
+}
+
+WavReader *wav_open_read(const char *path, WavInfo *info) {
+  FILE *f = fopen(path, "rb");
+  if (!f)
+    return NULL;
+
+  uint8_t hdr[12];
+  if (fread(hdr, 1, 12, f) != 12 || memcmp(hdr, "RIFF", 4) != 0 ||
+      memcmp(hdr + 8, "WAVE", 4) != 0) {
+    fclose(f);
+    return NULL;
+  }
+
+  int format = 0, channels = 0, rate = 0, bits = 0;
+  for (;;) {
+    uint8_t ch[8];
+    if (fread(ch, 1, 8, f) != 8)
+      break;
+    uint32_t size = rd_u32(ch + 4);
+
+    if (memcmp(ch, "fmt ", 4) == 0) {
+      uint8_t fmt[40];
+      uint32_t n = size < sizeof(fmt) ? size : (uint32_t)sizeof(fmt);
+      if (size < 16 || fread(fmt, 1, n, f) != n)
+        break;
+      format = rd_u16(fmt);
+      channels = rd_u16(fmt + 2);
+      rate = (int)rd_u32(fmt + 4);
+      bits = rd_u16(fmt + 14);
+      // Extensible: the sub-format GUID starts with the real format tag
+      if (format == WAV_FORMAT_EXTENSIBLE && n >= 26)
+        format = rd_u16(fmt + 24);
+      if (size > n)
+        fseek(f, (long)(size - n), SEEK_CUR);
+    } else if (memcmp(ch, "data", 4) == 0) {
+      int bps = bits / 8;
+      int ok = channels > 0 && rate > 0 &&
+               ((format == WAV_FORMAT_PCM && (bps == 2 || bps == 3 ||
+                                              bps == 4)) ||
+                (format == WAV_FORMAT_FLOAT && bps == 4));
+      if (!ok)
+        break;
+      long frames = (long)(size / (uint32_t)(channels * bps));
+      WavReader *wr = reader_alloc(f, channels, format, bps, frames);
+      if (!wr)
+        break;
+      info->sample_rate = rate;
+      info->channels = channels;
+      info->frames = frames;
+      return wr;
+    } else {
+      fseek(f, (long)(size + (size & 1)), SEEK_CUR); // Chunks are 2-aligned
+    }
+  }
+
+  fclose(f);
+  return NULL;
+}
+
+WavReader *wav_open_raw(const char *path, int channels, int sample_rate,
+                        WavInfo *info) {
+  if (channels <= 0 || sample_rate <= 0)
+    return NULL;
+  FILE *f = fopen(path, "rb");
+  if (!f)
+    return NULL;
+
+  fseek(f, 0, SEEK_END);
+  long bytes = ftell(f);
+  fseek(f, 0, SEEK_SET);
+  long frames = bytes / (long)(channels * sizeof(float));
+
+  WavReader *wr = reader_alloc(f, channels, WAV_FORMAT_FLOAT, 4, frames);
+  if (!wr) {
+    fclose(f);
+    return NULL;
+  }
+  info->sample_rate = sample_rate;
+  info->channels = channels;
+  info->frames = frames;
+  return wr;
+}
+
+long wav_read_frames(WavReader *wr, float *buf, long frames) {
+  long total = 0;
+  const int C = wr->channels;
+  const int bps = wr->bytes_per_sample;
+
+  while (total < frames && wr->frames_left > 0) {
+    long n = frames - total;
+    if (n > WAV_CHUNK_FRAMES)
+      n = WAV_CHUNK_FRAMES;
+    if (n > wr->frames_left)
+      n = wr->frames_left;
+
+    size_t got = fread(wr->raw, (size_t)(C * bps), (size_t)n, wr->f);
+    if (got == 0)
+      break;
+
+    size_t count = got * (size_t)C;
+    float *dst = buf + total * C;
+    const uint8_t *src = wr->raw;
+    for (size_t i = 0; i < count; i++, src += bps) {
+      if (wr->format == WAV_FORMAT_FLOAT) {
+        uint32_t v = rd_u32(src);
+        memcpy(&dst[i], &v, sizeof(float));
+      } else if (bps == 2) {
+        dst[i] = (float)(int16_t)rd_u16(src) * (1.0f / 32768.0f);
+      } else if (bps == 3) {
+        int32_t v = (int32_t)((uint32_t)src[0] << 8 | (uint32_t)src[1] << 16 |
+                              (uint32_t)src[2] << 24);
+        dst[i] = (float)(v >> 8) * (1.0f / 8388608.0f);
+      } else {
+        dst[i] = (float)((double)(int32_t)rd_u32(src) * (1.0 / 2147483648.0));
+      }
+    }
+    total += (long)got;
+    wr->frames_left -= (long)got;
+  }
+  return total;
+}
+
+void wav_close_read(WavReader *wr) {
+  if (!wr)
+    return;
+  fclose(wr->f);
+  free(wr->raw);
+  free(wr);
+}
+
+// 44-byte header for IEEE float data of the given size
+static void wav_header(uint8_t *h, int sample_rate, int channels,
+                       uint32_t data_bytes) {
+  memcpy(h, "RIFF", 4);
+  wr_u32(h + 4, 36 + data_bytes);
+  memcpy(h + 8, "WAVE", 4);
+  memcpy(h + 12, "fmt ", 4);
+  wr_u32(h + 16, 16);
+  wr_u16(h + 20, WAV_FORMAT_FLOAT);
+  wr_u16(h + 22, (uint16_t)channels);
+  wr_u32(h + 24, (uint32_t)sample_rate);
+  wr_u32(h + 28, (uint32_t)(sample_rate * channels * 4));
+  wr_u16(h + 32, (uint16_t)(channels * 4));
+  wr_u16(h + 34, 32);
+  memcpy(h + 36, "data", 4);
+  wr_u32(h + 40, data_bytes);
+}
+
+WavWriter *wav_open_write(const char *path, int sample_rate, int channels) {
+  if (channels <= 0 || sample_rate <= 0)
+    return NULL;
+  FILE *f = fopen(path, "wb");
+  if (!f)
+    return NULL;
+
+  uint8_t h[44];
+  wav_header(h, sample_rate, channels, 0);
+  WavWriter *ww = (WavWriter *)calloc(1, sizeof(WavWriter));
+  if (!ww || fwrite(h, 1, sizeof(h), f) != sizeof(h)) {
+    free(ww);
+    fclose(f);
+    return NULL;
+  }
+  ww->f = f;
+  ww->channels = channels;
+  return ww;
+}
+
+int wav_write_frames(WavWriter *ww, const float *buf, long frames) {
+  uint8_t tmp[4 * 256];
+  long count = frames * ww->channels;
+  for (long i = 0; i < count; i += 256) {
+    long n = count - i < 256 ? count - i : 256;
+    for (long k = 0; k < n; k++) {
+      uint32_t v;
+      memcpy(&v, &buf[i + k], sizeof(v));
+      wr_u32(tmp + 4 * k, v);
+    }
+    if (fwrite(tmp, 4, (size_t)n, ww->f) != (size_t)n) {
+      ww->error = 1;
+      return -1;
+    }
+  }
+  ww->frames += frames;
+  return 0;
+}
+
+int wav_close_write(WavWriter *ww) {
+  if (!ww)
+    return -1;
+  int ret = ww->error ? -1 : 0;
+
+  uint8_t h[44];
+  uint32_t data_bytes = (uint32_t)(ww->frames * ww->channels * 4);
+  wav_header(h, 0, ww->channels, data_bytes);
+  // Keep the rate written at open time: only patch the two size fields
+  if (fseek(ww->f, 4, SEEK_SET) != 0 || fwrite(h + 4, 1, 4, ww->f) != 4 ||
+      fseek(ww->f, 40, SEEK_SET) != 0 || fwrite(h + 40, 1, 4, ww->f) != 4)
+    ret = -1;
+  if (fclose(ww->f) != 0)
+    ret = -1;
+  free(ww);
+  return ret;
+}
@@ -0,0 +1,73 @@
+/**
+ * @file wav_io.h
+ * @brief Minimal multichannel WAV / raw float file I/O
+ *
+ * Reads PCM 16/24/32-bit and IEEE float 32-bit WAV (including
+ * WAVE_FORMAT_EXTENSIBLE) and headerless little-endian float32 files, always
+ * returning interleaved floats in [-1, 1). Writes IEEE float 32-bit WAV.
+ */
+
+#ifndef WAV_IO_H
+#define WAV_IO_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+  int sample_rate;
+  int channels;
+  long frames; // Total frames in the file
+} WavInfo;
+
+typedef struct WavReader WavReader;
+typedef struct WavWriter WavWriter;
+
+/**
+ * Open a WAV file for reading.
+ * @param path        File path
+ * @param info        Output: format of the file
+ * @return Reader or NULL on error (missing file, unsupported format)
+ */
+WavReader *wav_open_read(const char *path, WavInfo *info);
+
+/**
+ * Open a headerless interleaved float32 file for reading.
+ * @param path        File path
+ * @param channels    Channels per frame
+ * @param sample_rate Sample rate reported in info
+ * @param info        Output: format of the file
+ */
+WavReader *wav_open_raw(const char *path, int channels, int sample_rate,
+                        WavInfo *info);
+
+/**
+ * Read up to `frames` interleaved frames.
+ * @return Frames read (0 at end of file)
+ */
+long wav_read_frames(WavReader *wr, float *buf, long frames);
+
+void wav_close_read(WavReader *wr);
+
+/**
+ * Create a float32 WAV file. The header is finalized by wav_close_write.
+ */
+WavWriter *wav_open_write(const char *path, int sample_rate, int channels);
+
+/**
+ * Append interleaved frames.
+ * @return 0 on success, -1 on write error
+ */
+int wav_write_frames(WavWriter *ww, const float *buf, long frames);
+
+/**
+ * Patch the header sizes and close.
+ * @return 0 on success, -1 on error
+ */
+int wav_close_write(WavWriter *ww);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // WAV_IO_H
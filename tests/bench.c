@@ -0,0 +1,197 @@
+/**
+ * @file bench.c
+ * @brief Micro-benchmark harness (see bench.h)
+ */
+
+#include "bench.h"
+#include "../src/platform/platform.h"
+#include <stdlib.h>
+#include <string.h>
+
+void bench_default_options(BenchOptions *opt) {
+  opt->repetitions = 15;
+  opt->min_rep_ms = 20.0;
+  opt->filter = NULL;
+}
+
+// Serial multiply-add chain: fixed work that no compiler can vectorize,
+// used to normalize results across machines
+static void reference_kernel(void *ctx, long iters) {
+  volatile float *sink = (volatile float *)ctx;
+  float a = *sink; // Unknown to the compiler: nothing to constant-fold
+  for (long i = 0; i < iters; i++) {
+    for (int k = 0; k < 256; k++)
+      a = a * 0.999f + 0.001f;
+  }
+  *sink = a;
+}
+
+static int cmp_double(const void *a, const void *b) {
+  double x = *(const double *)a, y = *(const double *)b;
+  return (x > y) - (x < y);
+}
+
+static double elapsed_ns(const BenchSuite *s, BenchFn fn, void *ctx,
+                         long iters) {
+  unsigned long long t0 = platform_ticks();
+  fn(ctx, iters);
+  return (double)(platform_ticks() - t0) / s->ticks_per_ns;
+}
+
+// Time fn into r (name and items set by the caller)
+static void measure(const BenchSuite *s, BenchFn fn, void *ctx,
+                    BenchResult *r) {
+  // Grow the iteration count until one repetition is long enough; this is
+  // also the warm-up (caches, branch predictors, frequency ramp)
+  const double min_ns = s->opt.min_rep_ms * 1e6;
+  long iters = 1;
+  double t;
+  while ((t = elapsed_ns(s, fn, ctx, iters)) < min_ns && iters < (1L << 40)) {
+    double scale = t > 0.0 ? 1.2 * min_ns / t : 10.0;
+    if (scale > 10.0)
+      scale = 10.0;
+    long next = (long)(iters * scale);
+    iters = next > iters ? next : iters + 1;
+  }
+
+  int reps = s->opt.repetitions;
+  if (reps < 1)
+    reps = 1;
+  if (reps > BENCH_MAX_REPS)
+    reps = BENCH_MAX_REPS;
+  double per_iter[BENCH_MAX_REPS];
+  for (int k = 0; k < reps; k++)
+    per_iter[k] = elapsed_ns(s, fn, ctx, iters) / (double)iters;
+  qsort(per_iter, (size_t)reps, sizeof(double), cmp_double);
+
+  int p99 = (int)(0.99 * reps + 0.999999) - 1; // Nearest rank
+  r->iters = iters;
+  r->reps = reps;
+  r->median_ns = (reps & 1) ? per_iter[reps / 2]
+                            : 0.5 * (per_iter[reps / 2 - 1] +
+                                     per_iter[reps / 2]);
+  r->p99_ns = per_iter[p99 < 0 ? 0 : p99];
+  r->min_ns = per_iter[0];
+}
+
+void bench_suite_init(BenchSuite *s, const BenchOptions *opt) {
+  memset(s, 0, sizeof(*s));
+  s->opt = *opt;
+  s->ticks_per_ns = platform_ticks_per_us() * 1e-3;
+
+  volatile float sink = 0.5f;
+  BenchResult ref;
+  measure(s, reference_kernel, (void *)&sink, &ref);
+  s->reference_ns = ref.median_ns;
+}
+
+const BenchResult *bench_run(BenchSuite *s, const char *name, BenchFn fn,
+                             void *ctx, double items, double budget_ns) {
+  if (s->opt.filter && !strstr(name, s->opt.filter))
+    return NULL;
+  if (s->count >= BENCH_MAX_RESULTS)
+    return NULL;
+  BenchResult *r = &s->results[s->count];
+  memset(r, 0, sizeof(*r));
+  strncpy(r->name, name, BENCH_NAME_MAX - 1);
+  r->items = items;
+  r->budget_ns = budget_ns;
+  measure(s, fn, ctx, r);
+  r->rel = s->reference_ns > 0.0 ? r->median_ns / s->reference_ns : 0.0;
+  s->count++;
+  return r;
+}
+
+void bench_print(const BenchSuite *s, FILE *f) {
+  fprintf(f, "%-44s %12s %12s %10s %8s\n", "benchmark", "median", "p99",
+           "ns/item", "load");
+  for (int i = 0; i < s->count; i++) {
+    const BenchResult *r = &s->results[i];
+    char load[16] = "-";
+    if (r->budget_ns > 0.0)
+      snprintf(load, sizeof(load), "%.2f%%", 100.0 * r->median_ns /
+                                                 r->budget_ns);
+    fprintf(f, "%-44s %9.1f ns %9.1f ns %10.2f %8s\n", r->name, r->median_ns,
+            r->p99_ns, r->items > 0.0 ? r->median_ns / r->items : 0.0, load);
+  }
+}
+
+int bench_write_json(const BenchSuite *s, const char *path) {
+  FILE *f = fopen(path, "w");
+  if (!f)
+    return -1;
+  fprintf(f, "{\n  \"ticks_per_ns\": %.4f,\n  \"reference_ns\": %.3f,\n"
+             "  \"results\": [\n",
+          s->ticks_per_ns, s->reference_ns);
+  for (int i = 0; i < s->count; i++) {
+    const BenchResult *r = &s->results[i];
+    fprintf(f,
+            "    {\"name\": \"%s\", \"iters\": %ld, \"reps\": %d, "
+            "\"median_ns\": %.3f, \"p99_ns\": %.3f, \"min_ns\": %.3f, "
+            "\"ns_per_item\": %.4f, \"load\": %.6f, \"rel\": %.6f}%s\n",
+            r->name, r->iters, r->reps, r->median_ns, r->p99_ns, r->min_ns,
+            r->items > 0.0 ? r->median_ns / r->items : 0.0,
+            r->budget_ns > 0.0 ? r->median_ns / r->budget_ns : 0.0, r->rel,
+            i + 1 < s->count ? "," : "");
+  }
+  fprintf(f, "  ]\n}\n");
+  return fclose(f) == 0 ? 0 : -1;
+}
+
+// Name and "rel" of one result line written by bench_write_json
+static int parse_result(const char *line, char *name, double *rel) {
+  const char *p = strstr(line, "\"name\": \"");
+  const char *q = strstr(line, "\"rel\": ");
+  if (!p || !q)
+    return -1;
+  p += 9;
+  const char *end = strchr(p, '"');
+  if (!end || end - p >= BENCH_NAME_MAX)
+    return -1;
+  memcpy(name, p, (size_t)(end - p));
+  name[end - p] = '\0';
+  return sscanf(q + 7, "%lf", rel) == 1 ? 0 : -1;
+}
+
+int bench_compare(const BenchSuite *s, const char *baseline_path,
+                  double tolerance, FILE *f) {
+  FILE *in = fopen(baseline_path, "r");
+  if (!in)
+    return -1;
+
+  int seen[BENCH_MAX_RESULTS] = {0};
+  int regressions = 0, compared = 0;
+  char line[512], name[BENCH_NAME_MAX];
+  double base_rel;
+  while (fgets(line, sizeof(line), in)) {
+    if (parse_result(line, name, &base_rel) != 0)
+      continue;
+    int i = 0;
+    while (i < s->count && strcmp(s->results[i].name, name) != 0)
+      i++;
+    if (i == s->count) {
+      if (!s->opt.filter || strstr(name, s->opt.filter))
+        fprintf(f, "  %-44s missing from this run\n", name);
+      continue;
+    }
+    seen[i] = 1;
+    compared++;
+    double change = base_rel > 0.0 ? s->results[i].rel / base_rel - 1.0 : 0.0;
+    if (change > tolerance) {
+      fprintf(f, "  %-44s REGRESSION %+.1f%%\n", name, 100.0 * change);
+      regressions++;
+    } else if (change < -tolerance) {
+      fprintf(f, "  %-44s faster %+.1f%% (update the baseline)\n", name,
+              100.0 * change);
+    }
+  }
+  fclose(in);
+
+  for (int i = 0; i < s->count; i++) {
+    if (!seen[i])
+      fprintf(f, "  %-44s not in the baseline\n", s->results[i].name);
+  }
+  fprintf(f, "%d benchmarks compared, %d regressions (tolerance %.0f%%)\n",
+          compared, regressions, 100.0 * tolerance);
+  return regressions;
+}
@@ -0,0 +1,91 @@
+/**
+ * @file bench.h
+ * @brief Micro-benchmark harness: repetitions, robust statistics, JSON
+ *        results and regression checks against a stored baseline
+ *
+ * A benchmark is a function that runs its kernel `iters` times. The harness
+ * picks `iters` so that one repetition lasts at least the configured time,
+ * times every repetition with the cycle counter (platform_ticks, converted
+ * to ns) and keeps the median, p99 and minimum time per iteration.
+ *
+ * Results are normalized to a fixed reference kernel timed in the same run
+ * ("rel"), so a baseline recorded on one machine still flags a relative
+ * slowdown of one kernel on a faster or slower machine of the same kind.
+ */
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define BENCH_NAME_MAX 96
+#define BENCH_MAX_RESULTS 256
+#define BENCH_MAX_REPS 101
+
+// Runs the kernel iters times; ctx is the benchmark's own state
+typedef void (*BenchFn)(void *ctx, long iters);
+
+typedef struct {
+  int repetitions;    // Timed repetitions (odd keeps the median exact)
+  double min_rep_ms;  // Minimum duration of one repetition
+  const char *filter; // Only names containing this substring, NULL: all
+} BenchOptions;
+
+typedef struct {
+  char name[BENCH_NAME_MAX]; // "kernel/param=value/..."
+  long iters;                // Iterations per repetition
+  int reps;
+  double median_ns; // Per iteration
+  double p99_ns;
+  double min_ns;
+  double items;    // Items (samples, frames) per iteration, 0: none
+  double budget_ns; // Real-time budget per iteration, 0: none
+  double rel;       // median_ns / reference median_ns
+} BenchResult;
+
+typedef struct {
+  BenchOptions opt;
+  double ticks_per_ns;
+  double reference_ns; // Median of the reference kernel
+  BenchResult results[BENCH_MAX_RESULTS];
+  int count;
+} BenchSuite;
+
+// Default options: 15 repetitions of at least 20 ms
+void bench_default_options(BenchOptions *opt);
+
+// Calibrate the clock and time the reference kernel
+void bench_suite_init(BenchSuite *s, const BenchOptions *opt);
+
+/**
+ * Time one benchmark and append its result (skipped if the name does not
+ * match the filter). items and budget_ns describe one iteration.
+ * @return The result, or NULL if skipped or the suite is full
+ */
+const BenchResult *bench_run(BenchSuite *s, const char *name, BenchFn fn,
+                             void *ctx, double items, double budget_ns);
+
+// Human-readable table of all results
+void bench_print(const BenchSuite *s, FILE *f);
+
+// JSON results, one result object per line (the baseline format)
+int bench_write_json(const BenchSuite *s, const char *path);
+
+/**
+ * Compare with a baseline written by bench_write_json. A benchmark whose
+ * normalized time grew by more than tolerance (0.10: 10%) is a regression.
+ * Benchmarks missing from either side are reported and ignored.
+ * @return Number of regressions, -1 if the baseline cannot be read
+ */
+int bench_compare(const BenchSuite *s, const char *baseline_path,
+                  double tolerance, FILE *f);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BENCH_H
@@ -1,272 +1,622 @@
 /**
- * DSP Benchmark Tool
+ * DSP Benchmark Suite
  *
- * Measures processing time for each DSP module.
- * Usage: benchmark_dsp.exe
+ * Times every DSP module over a parameter matrix (filter length, block
+ * size, sample rate, channel count) with the harness in bench.c, prints a
+ * table and optionally writes JSON results and checks them against a
+ * stored baseline.
+ *
+ * Usage: benchmark_dsp [--quick] [--filter <substr>] [--reps <n>]
+ *                      [--min-ms <ms>] [--json <out.json>]
+ *                      [--baseline <base.json>] [--tolerance <0.10>]
+ * Exit status: 0, or 1 on a regression or an unreadable baseline.
  */
 
+#include "../src/audio/jitter_buffer.h"
+#include "../src/dsp/aec.h"
+#include "../src/dsp/aec_fd.h"
 #include "../src/dsp/biquad.h"
 #include "../src/dsp/doa.h"
 #include "../src/dsp/fast_math.h"
+#include "../src/dsp/gsc.h"
+#include "../src/dsp/gsc_subband.h"
+#include "../src/dsp/le_fft.h"
 #include "../src/dsp/multiband.h"
+#include "../src/dsp/phase_align.h"
+#include "../src/dsp/simd_dispatch.h"
 #include "../src/dsp/steer_fast.h"
+#include "../src/platform/platform.h"
+#include "bench.h"
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
-#ifdef _WIN32
-#include <windows.h>
-static double get_time_us(void) {
-  LARGE_INTEGER freq, counter;
-  QueryPerformanceFrequency(&freq);
-  QueryPerformanceCounter(&counter);
-  return (double)counter.QuadPart * 1000000.0 / (double)freq.QuadPart;
-}
-#else
-#include <sys/time.h>
-static double get_time_us(void) {
-  struct timeval tv;
-  gettimeofday(&tv, NULL);
-  return tv.tv_sec * 1000000.0 + tv.tv_usec;
-}
-#endif
+#define MAX_BLOCK 480
+#define MAX_FFT 2048
+#define MAX_CH 4
+#define SIGNAL_LEN 4096 // Test signal per channel, blocks wrap around it
 
-#define WARMUP_ITERS 1000
-#define BENCH_ITERS 100000
-#define SAMPLE_RATE 48000
-
-// Test data
-static float test_samples[BATCH_SIZE * 4];
+static float g_signal[MAX_CH][SIGNAL_LEN];
+static float g_interleaved[SIGNAL_LEN * MAX_CH];
 
 static void fill_test_data(void) {
-  for (int i = 0; i < BATCH_SIZE * 4; i++) {
-    test_samples[i] = ((float)rand() / RAND_MAX) * 2.0f - 1.0f;
+  unsigned int seed = 12345u;
+  for (int c = 0; c < MAX_CH; c++) {
+    for (int i = 0; i < SIGNAL_LEN; i++) {
+      seed = seed * 1664525u + 1013904223u;
+      g_signal[c][i] = (float)(seed >> 8) / 8388608.0f - 1.0f;
+      g_interleaved[i * MAX_CH + c] = g_signal[c][i];
+    }
   }
 }
 
-// Benchmark: Fast Sin/Cos LUT
-static void bench_fast_sincos(void) {
-  float sum = 0;
-  double t0, t1;
+// Interleave `ch` channels of block k into out
+static const float *block_in(float *out, int ch, int n, long k) {
+  int start = (int)((k * n) % (SIGNAL_LEN - n));
+  for (int i = 0; i < n; i++)
+    for (int c = 0; c < ch; c++)
+      out[i * ch + c] = g_signal[c][start + i];
+  return out;
+}
 
-  // Warmup
-  for (int i = 0; i < WARMUP_ITERS; i++) {
-    sum += fast_sinf(i * 0.01f);
-  }
+static volatile float g_sink;
+
+// ---------------------------------------------------------------------------
+// Per-sample kernels (legacy 4-mic chain)
+// ---------------------------------------------------------------------------
+
+static void run_fast_sincos(void *ctx, long iters) {
+  (void)ctx;
+  float sum = 0.0f;
+  for (long i = 0; i < iters; i++)
+    sum += fast_sinf((float)(i & 1023) * 0.01f) +
+           fast_cosf((float)(i & 1023) * 0.01f);
+  g_sink = sum;
+}
 
-  t0 = get_time_us();
-  for (int i = 0; i < BENCH_ITERS; i++) {
-    sum += fast_sinf(i * 0.01f);
-    sum += fast_cosf(i * 0.01f);
+static void run_steer_fast(void *ctx, long iters) {
+  (void)ctx;
+  float sum = 0.0f;
+  for (long i = 0; i < iters; i++) {
+    int k = (int)(i % SIGNAL_LEN);
+    sum += steer_beam_fast(g_signal[0][k], g_signal[1][k], g_signal[2][k],
+                           g_signal[3][k], (int)(i % 360));
   }
-  t1 = get_time_us();
+  g_sink = sum;
+}
 
-  double time_per_call = (t1 - t0) / (BENCH_ITERS * 2);
-  printf("fast_sinf/cosf:   %.3f us/call (%.0f calls/sec)\n", time_per_call,
-         1000000.0 / time_per_call);
-  (void)sum;
+static void run_steer_batch(void *ctx, long iters) {
+  Mic4Batch *in = (Mic4Batch *)ctx;
+  OutputBatch out;
+  for (long i = 0; i < iters; i++)
+    steer_batch_process(in, &out, (int)(i % 360), BATCH_SIZE);
+  g_sink = out.out[0];
 }
 
-// Benchmark: Beam Steering (LUT)
-static void bench_steer_fast(void) {
-  float sum = 0;
-  double t0, t1;
+static void run_biquad(void *ctx, long iters) {
+  BiquadState *bq = (BiquadState *)ctx;
+  float sum = 0.0f;
+  for (long i = 0; i < iters; i++)
+    sum += biquad_process(bq, g_signal[0][i % SIGNAL_LEN]);
+  g_sink = sum;
+}
+
+static void run_multiband(void *ctx, long iters) {
+  MultibandState *mb = (MultibandState *)ctx;
+  float sum = 0.0f;
+  for (long i = 0; i < iters; i++)
+    sum += multiband_process(mb, g_signal[0][i % SIGNAL_LEN]);
+  g_sink = sum;
+}
 
-  // Warmup
-  for (int i = 0; i < WARMUP_ITERS; i++) {
-    sum += steer_beam_fast(0.1f, 0.2f, -0.1f, -0.2f, i % 360);
+#define MB_BLOCK 64
+
+static void run_multiband_block(void *ctx, long iters) {
+  MultibandState *mb = (MultibandState *)ctx;
+  float out[MB_BLOCK];
+  for (long i = 0; i < iters; i++) {
+    int start = (int)((i * MB_BLOCK) % (SIGNAL_LEN - MB_BLOCK));
+    multiband_process_block(mb, &g_signal[0][start], out, MB_BLOCK);
   }
+  g_sink = out[0];
+}
 
-  t0 = get_time_us();
-  for (int i = 0; i < BENCH_ITERS; i++) {
-    float xTL = test_samples[i % BATCH_SIZE];
-    float xTR = test_samples[(i + 64) % BATCH_SIZE];
-    float xBL = test_samples[(i + 128) % BATCH_SIZE];
-    float xBR = test_samples[(i + 192) % BATCH_SIZE];
-    sum += steer_beam_fast(xTL, xTR, xBL, xBR, i % 360);
+// Per-mic pre-filters: one lane per channel of the interleaved signal
+typedef struct {
+  BiquadBank bk;
+  float mem[BIQUAD_BANK_FLOATS(MAX_CH, 2)];
+  int n;
+  float out[MAX_BLOCK * MAX_CH];
+} BankBench;
+
+static void run_biquad_bank(void *ctx, long iters) {
+  BankBench *b = (BankBench *)ctx;
+  for (long i = 0; i < iters; i++) {
+    int start = (int)((i * b->n) % (SIGNAL_LEN - b->n));
+    biquad_bank_process(&b->bk, &g_interleaved[start * MAX_CH], MAX_CH,
+                        b->out, b->n);
   }
-  t1 = get_time_us();
-
-  double time_per_sample = (t1 - t0) / BENCH_ITERS;
-  double samples_per_sec = 1000000.0 / time_per_sample;
-  printf("steer_beam_fast:  %.3f us/sample (%.0f samples/sec = %.1fx realtime "
-         "@%dHz)\n",
-         time_per_sample, samples_per_sec, samples_per_sec / SAMPLE_RATE,
-         SAMPLE_RATE);
-  (void)sum;
+  g_sink = b->out[0];
 }
 
-// Benchmark: Batch Steering
-static void bench_steer_batch(void) {
-  Mic4Batch in;
-  OutputBatch out;
-  double t0, t1;
-
-  // Fill input
-  for (int i = 0; i < BATCH_SIZE; i++) {
-    in.xTL[i] = test_samples[i];
-    in.xTR[i] = test_samples[i + 64];
-    in.xBL[i] = test_samples[i + 128];
-    in.xBR[i] = test_samples[i + 192];
+static void run_doa(void *ctx, long iters) {
+  DoaState *doa = (DoaState *)ctx;
+  float theta = 0.0f;
+  for (long i = 0; i < iters; i++) {
+    int k = (int)(i % SIGNAL_LEN);
+    theta = doa_update(doa, g_signal[0][k], g_signal[1][k], g_signal[2][k],
+                       g_signal[3][k]);
   }
+  g_sink = theta;
+}
 
-  // Warmup
-  for (int i = 0; i < WARMUP_ITERS; i++) {
-    steer_batch_process(&in, &out, 45, BATCH_SIZE);
+typedef struct {
+  DoaState doa;
+  MultibandState mb;
+} Chain4;
+
+static void run_chain4(void *ctx, long iters) {
+  Chain4 *c = (Chain4 *)ctx;
+  float sum = 0.0f;
+  for (long i = 0; i < iters; i++) {
+    int k = (int)(i % SIGNAL_LEN);
+    float xTL = g_signal[0][k], xTR = g_signal[1][k];
+    float xBL = g_signal[2][k], xBR = g_signal[3][k];
+    float theta = doa_update(&c->doa, xTL, xTR, xBL, xBR);
+    float steered =
+        steer_beam_fast(xTL, xTR, xBL, xBR, steer_deg_to_idx(theta));
+    sum += multiband_process(&c->mb, steered);
   }
+  g_sink = sum;
+}
 
-  int batch_iters = BENCH_ITERS / BATCH_SIZE;
-  t0 = get_time_us();
-  for (int i = 0; i < batch_iters; i++) {
-    steer_batch_process(&in, &out, i % 360, BATCH_SIZE);
+// ---------------------------------------------------------------------------
+// GSC
+// ---------------------------------------------------------------------------
+
+typedef struct {
+  GscState st;
+  GscConfig cfg;
+  void *mem;
+  int n;
+  float in[MAX_BLOCK * 4];
+  float out[MAX_BLOCK];
+} GscBench;
+
+static int gsc_bench_init(GscBench *b, int M, int n, int ch) {
+  memset(b, 0, sizeof(*b));
+  b->cfg.M = M;
+  b->cfg.alpha = 0.01f;
+  b->cfg.eps = 1e-6f;
+  b->cfg.mu_max = 0.01f;
+  b->cfg.eta_max = 0.001f;
+  b->cfg.leak_lambda = 0.0001f;
+  b->cfg.g_lo = 0.1f;
+  b->cfg.g_hi = 0.3f;
+  b->cfg.beta_min = -2.0f;
+  b->cfg.beta_max = 2.0f;
+  size_t bytes = gsc_mem_bytes(&b->cfg);
+  b->mem = malloc(bytes);
+  if (!b->mem || gsc_init(&b->st, &b->cfg, b->mem, bytes) != 0)
+    return -1;
+  gsc_set_power_mode(&b->st, GSC_POWER_RUNNING); // As in the app
+  b->n = n;
+  block_in(b->in, ch, n, 0);
+  return 0;
+}
+
+static void run_gsc_sample(void *ctx, long iters) {
+  GscBench *b = (GscBench *)ctx;
+  float sum = 0.0f;
+  for (long i = 0; i < iters; i++) {
+    int k = (int)(i % SIGNAL_LEN);
+    sum += gsc_process_sample(&b->st, &b->cfg, g_signal[0][k], g_signal[1][k],
+                              g_signal[2][k]);
   }
-  t1 = get_time_us();
-
-  double time_per_batch = (t1 - t0) / batch_iters;
-  double time_per_sample = time_per_batch / BATCH_SIZE;
-  double samples_per_sec = 1000000.0 / time_per_sample;
-  printf("steer_batch (%d): %.3f us/batch, %.4f us/sample (%.0f samples/sec = "
-         "%.1fx realtime)\n",
-         BATCH_SIZE, time_per_batch, time_per_sample, samples_per_sec,
-         samples_per_sec / SAMPLE_RATE);
+  g_sink = sum;
 }
 
-// Benchmark: Biquad Filter
-static void bench_biquad(void) {
-  BiquadState bq;
-  biquad_lowpass(&bq, 48000.0f, 1000.0f);
+static void run_gsc_block(void *ctx, long iters) {
+  GscBench *b = (GscBench *)ctx;
+  for (long i = 0; i < iters; i++)
+    gsc_process_block(&b->st, &b->cfg, b->in, b->out, b->n);
+  g_sink = b->out[0];
+}
 
-  float sum = 0;
-  double t0, t1;
+static void run_gsc_block_4ch(void *ctx, long iters) {
+  GscBench *b = (GscBench *)ctx;
+  for (long i = 0; i < iters; i++)
+    gsc_process_block_4ch(&b->st, &b->cfg, b->in, b->out, b->n,
+                          BEAM_DIR_FRONT);
+  g_sink = b->out[0];
+}
 
-  // Warmup
-  for (int i = 0; i < WARMUP_ITERS; i++) {
-    sum += biquad_process(&bq, test_samples[i % BATCH_SIZE]);
-  }
+typedef struct {
+  GscSubbandState st;
+  GscConfig cfg;
+  void *mem;
+  int n;
+  float in[MAX_BLOCK * 3];
+  float out[MAX_BLOCK];
+} SubbandBench;
+
+static void run_gsc_subband(void *ctx, long iters) {
+  SubbandBench *b = (SubbandBench *)ctx;
+  for (long i = 0; i < iters; i++)
+    gsc_subband_process_block(&b->st, &b->cfg, b->in, b->out, b->n);
+  g_sink = b->out[0];
+}
 
-  t0 = get_time_us();
-  for (int i = 0; i < BENCH_ITERS; i++) {
-    sum += biquad_process(&bq, test_samples[i % BATCH_SIZE]);
+// ---------------------------------------------------------------------------
+// AEC
+// ---------------------------------------------------------------------------
+
+typedef struct {
+  AecState st;
+  float *mem;
+} AecBench;
+
+static void run_aec_sample(void *ctx, long iters) {
+  AecBench *b = (AecBench *)ctx;
+  float sum = 0.0f;
+  for (long i = 0; i < iters; i++) {
+    int k = (int)(i % SIGNAL_LEN);
+    sum += aec_process(&b->st, g_signal[0][k], g_signal[1][k]);
   }
-  t1 = get_time_us();
-
-  double time_per_sample = (t1 - t0) / BENCH_ITERS;
-  printf("biquad_process:   %.3f us/sample (%.0f samples/sec)\n",
-         time_per_sample, 1000000.0 / time_per_sample);
-  (void)sum;
+  g_sink = sum;
 }
 
-// Benchmark: Multiband EQ
-static void bench_multiband(void) {
-  MultibandState mb;
-  multiband_init(&mb, 48000.0f);
+typedef struct {
+  AecFdState st;
+  void *mem;
+  float out[MAX_BLOCK];
+} AecFdBench;
+
+static void run_aec_fd(void *ctx, long iters) {
+  AecFdBench *b = (AecFdBench *)ctx;
+  const int n = b->st.L;
+  for (long i = 0; i < iters; i++) {
+    int start = (int)((i * n) % (SIGNAL_LEN - n));
+    aec_fd_process(&b->st, g_signal[0] + start, g_signal[1] + start, b->out);
+  }
+  g_sink = b->out[0];
+}
 
-  float sum = 0;
-  double t0, t1;
+// ---------------------------------------------------------------------------
+// Phase alignment, jitter buffer, FFT
+// ---------------------------------------------------------------------------
+
+typedef struct {
+  PhaseAligner *pa;
+  int n;
+  int ch;
+} PhaseBench;
+
+static void run_phase_align(void *ctx, long iters) {
+  PhaseBench *b = (PhaseBench *)ctx;
+  const float *chans[MAX_CH];
+  float offsets[MAX_CH];
+  for (long i = 0; i < iters; i++) {
+    int start = (int)((i * 64) % (SIGNAL_LEN - b->n));
+    for (int c = 0; c < b->ch; c++)
+      chans[c] = g_signal[c] + start;
+    phase_align_estimate(b->pa, chans, b->n, offsets);
+  }
+  g_sink = offsets[0];
+}
 
-  // Warmup
-  for (int i = 0; i < WARMUP_ITERS; i++) {
-    sum += multiband_process(&mb, test_samples[i % BATCH_SIZE]);
+typedef struct {
+  JitterBuffer *jb;
+  int n;
+  int ch;
+  float out[MAX_BLOCK * MAX_CH];
+} JitterBench;
+
+static void run_jitter(void *ctx, long iters) {
+  JitterBench *b = (JitterBench *)ctx;
+  for (long i = 0; i < iters; i++) {
+    jitter_buffer_write(b->jb, g_interleaved, b->n, 0);
+    jitter_buffer_read(b->jb, b->out, b->n);
   }
+  g_sink = b->out[0];
+}
 
-  t0 = get_time_us();
-  for (int i = 0; i < BENCH_ITERS; i++) {
-    sum += multiband_process(&mb, test_samples[i % BATCH_SIZE]);
+typedef struct {
+  LeFftPlan plan;
+  LeRfftPlan rplan;
+  float *mem;
+  int n;
+  float re[MAX_FFT], im[MAX_FFT], x[MAX_FFT];
+} FftBench;
+
+static void run_fft_complex(void *ctx, long iters) {
+  FftBench *b = (FftBench *)ctx;
+  for (long i = 0; i < iters; i++) {
+    memcpy(b->re, b->x, b->n * sizeof(float));
+    memset(b->im, 0, b->n * sizeof(float));
+    le_fft_complex(&b->plan, b->re, b->im, 0);
+    le_fft_complex(&b->plan, b->re, b->im, 1);
   }
-  t1 = get_time_us();
+  g_sink = b->re[0];
+}
 
-  double time_per_sample = (t1 - t0) / BENCH_ITERS;
-  printf("multiband (4band): %.3f us/sample (%.0f samples/sec)\n",
-         time_per_sample, 1000000.0 / time_per_sample);
-  (void)sum;
+static void run_rfft(void *ctx, long iters) {
+  FftBench *b = (FftBench *)ctx;
+  for (long i = 0; i < iters; i++) {
+    le_rfft_forward(&b->rplan, b->x, b->re, b->im);
+    le_rfft_inverse(&b->rplan, b->re, b->im, b->x);
+  }
+  g_sink = b->x[0];
 }
 
-// Benchmark: DOA Estimation
-static void bench_doa(void) {
-  DoaState doa;
-  doa_init(&doa, 0.02f, 5.0f); // alpha=0.02, slew_rate=5 deg/sample
+// ---------------------------------------------------------------------------
+// Suite
+// ---------------------------------------------------------------------------
 
-  float theta;
-  double t0, t1;
+static const int k_rates[] = {16000, 48000};
+static const int k_blocks[] = {64, 480};
+#define COUNT(a) ((int)(sizeof(a) / sizeof((a)[0])))
 
-  // Warmup
-  for (int i = 0; i < WARMUP_ITERS; i++) {
-    theta = doa_update(&doa, 0.1f, 0.2f, -0.1f, -0.2f);
-  }
+static void bench_legacy(BenchSuite *s) {
+  bench_run(s, "fast_sincos", run_fast_sincos, NULL, 2.0, 0.0);
+  bench_run(s, "steer_beam_fast/ch=4", run_steer_fast, NULL, 1.0,
+            1e9 / 48000.0);
 
-  t0 = get_time_us();
-  for (int i = 0; i < BENCH_ITERS; i++) {
-    float xTL = test_samples[i % BATCH_SIZE];
-    float xTR = test_samples[(i + 64) % BATCH_SIZE];
-    float xBL = test_samples[(i + 128) % BATCH_SIZE];
-    float xBR = test_samples[(i + 192) % BATCH_SIZE];
-    theta = doa_update(&doa, xTL, xTR, xBL, xBR);
-  }
-  t1 = get_time_us();
+  Mic4Batch batch;
+  memcpy(batch.xTL, g_signal[0], sizeof(batch.xTL));
+  memcpy(batch.xTR, g_signal[1], sizeof(batch.xTR));
+  memcpy(batch.xBL, g_signal[2], sizeof(batch.xBL));
+  memcpy(batch.xBR, g_signal[3], sizeof(batch.xBR));
+  bench_run(s, "steer_batch/ch=4/N=64", run_steer_batch, &batch, BATCH_SIZE,
+            BATCH_SIZE * 1e9 / 48000.0);
 
-  double time_per_sample = (t1 - t0) / BENCH_ITERS;
-  printf("doa_update:       %.3f us/sample (%.0f samples/sec)\n",
-         time_per_sample, 1000000.0 / time_per_sample);
-  (void)theta;
-}
+  BiquadState bq;
+  biquad_lowpass(&bq, 48000.0f, 1000.0f);
+  bench_run(s, "biquad", run_biquad, &bq, 1.0, 1e9 / 48000.0);
 
-// Full Pipeline Benchmark
-static void bench_full_pipeline(void) {
-  DoaState doa;
   MultibandState mb;
-  doa_init(&doa, 0.02f, 5.0f);
   multiband_init(&mb, 48000.0f);
+  bench_run(s, "multiband/bands=4", run_multiband, &mb, 1.0, 1e9 / 48000.0);
+  multiband_init(&mb, 48000.0f);
+  bench_run(s, "multiband_block/bands=4/N=64", run_multiband_block, &mb,
+            MB_BLOCK, MB_BLOCK * 1e9 / 48000.0);
+
+  // DC blocker, then DC blocker + lowpass, on every mic
+  static BankBench bank;
+  bank.n = MAX_BLOCK;
+  for (int stages = 1; stages <= 2; stages++) {
+    char name[64];
+    BiquadState dc, lp;
+    biquad_dc_block(&dc, 48000.0f, 20.0f);
+    biquad_lowpass(&lp, 48000.0f, 8000.0f);
+    biquad_bank_init(&bank.bk, MAX_CH, stages, bank.mem, sizeof(bank.mem));
+    for (int c = 0; c < MAX_CH; c++) {
+      biquad_bank_set(&bank.bk, 0, c, &dc);
+      if (stages > 1)
+        biquad_bank_set(&bank.bk, 1, c, &lp);
+    }
+    snprintf(name, sizeof(name), "biquad_bank/ch=%d/stages=%d/N=%d", MAX_CH,
+             stages, bank.n);
+    bench_run(s, name, run_biquad_bank, &bank, bank.n,
+              bank.n * 1e9 / 48000.0);
+  }
+
+  DoaState doa;
+  doa_init(&doa, 0.02f, 5.0f);
+  bench_run(s, "doa/ch=4", run_doa, &doa, 1.0, 1e9 / 48000.0);
+
+  Chain4 chain;
+  doa_init(&chain.doa, 0.02f, 5.0f);
+  multiband_init(&chain.mb, 48000.0f);
+  bench_run(s, "chain_doa_steer_eq/ch=4", run_chain4, &chain, 1.0,
+            1e9 / 48000.0);
+}
+
+static void bench_gsc(BenchSuite *s) {
+  static const int k_taps[] = {32, 64, 128};
+  static GscBench b; // Large buffers: keep off the stack
+  char name[BENCH_NAME_MAX];
+
+  if (gsc_bench_init(&b, 64, 1, 3) == 0)
+    bench_run(s, "gsc_sample/ch=3/M=64", run_gsc_sample, &b, 1.0,
+              1e9 / 16000.0);
+  free(b.mem);
+
+  for (int m = 0; m < COUNT(k_taps); m++) {
+    for (int nb = 0; nb < COUNT(k_blocks); nb++) {
+      for (int r = 0; r < COUNT(k_rates); r++) {
+        int n = k_blocks[nb], fs = k_rates[r];
+        if (gsc_bench_init(&b, k_taps[m], n, 3) == 0) {
+          snprintf(name, sizeof(name), "gsc_block/ch=3/M=%d/N=%d/fs=%d",
+                   k_taps[m], n, fs);
+          bench_run(s, name, run_gsc_block, &b, n, n * 1e9 / fs);
+        }
+        free(b.mem);
+        if (gsc_bench_init(&b, k_taps[m], n, 4) == 0) {
+          snprintf(name, sizeof(name), "gsc_block/ch=4/M=%d/N=%d/fs=%d",
+                   k_taps[m], n, fs);
+          bench_run(s, name, run_gsc_block_4ch, &b, n, n * 1e9 / fs);
+        }
+        free(b.mem);
+      }
+    }
+  }
 
-  float sum = 0;
-  double t0, t1;
+  static SubbandBench sb;
+  GscSubbandConfig sc = {256, 128, 0.5f, 0.8f};
+  GscBench tmp;
+  if (gsc_bench_init(&tmp, 64, 1, 3) == 0) {
+    sb.cfg = tmp.cfg;
+    sb.n = 480;
+    size_t bytes = gsc_subband_mem_bytes(&sc);
+    sb.mem = malloc(bytes);
+    block_in(sb.in, 3, sb.n, 0);
+    if (sb.mem && gsc_subband_init(&sb.st, &sc, sb.mem, bytes) == 0)
+      bench_run(s, "gsc_subband/ch=3/K=256/N=480/fs=16000", run_gsc_subband,
+                &sb, sb.n, sb.n * 1e9 / 16000.0);
+    free(sb.mem);
+  }
+  free(tmp.mem);
+}
 
-  t0 = get_time_us();
-  for (int i = 0; i < BENCH_ITERS; i++) {
-    float xTL = test_samples[i % BATCH_SIZE];
-    float xTR = test_samples[(i + 64) % BATCH_SIZE];
-    float xBL = test_samples[(i + 128) % BATCH_SIZE];
-    float xBR = test_samples[(i + 192) % BATCH_SIZE];
+static void bench_aec(BenchSuite *s) {
+  static const int k_lens[] = {256, 1024};
+  char name[BENCH_NAME_MAX];
+  for (int l = 0; l < COUNT(k_lens); l++) {
+    AecBench b;
+    size_t bytes = 2 * (size_t)k_lens[l] * sizeof(float);
+    b.mem = (float *)malloc(bytes);
+    if (b.mem && aec_init(&b.st, k_lens[l], b.mem, bytes) == 0) {
+      snprintf(name, sizeof(name), "aec_sample/taps=%d", k_lens[l]);
+      bench_run(s, name, run_aec_sample, &b, 1.0, 1e9 / 16000.0);
+    }
+    free(b.mem);
+  }
+
+  // Partitioned FDAF covering a 120 ms tail, as in the pipeline
+  for (int nb = 0; nb < COUNT(k_blocks); nb++) {
+    for (int r = 0; r < COUNT(k_rates); r++) {
+      int n = k_blocks[nb], fs = k_rates[r];
+      int P = (fs * 120 / 1000 + n - 1) / n;
+      static AecFdBench b;
+      size_t bytes = aec_fd_mem_bytes(n, P);
+      b.mem = bytes ? malloc(bytes) : NULL;
+      if (b.mem && aec_fd_init(&b.st, n, P, b.mem, bytes) == 0) {
+        snprintf(name, sizeof(name), "aec_fd/tail=120ms/N=%d/fs=%d", n, fs);
+        bench_run(s, name, run_aec_fd, &b, n, n * 1e9 / fs);
+      }
+      free(b.mem);
+    }
+  }
+}
 
-    // DOA estimation
-    float theta = doa_update(&doa, xTL, xTR, xBL, xBR);
-    int theta_idx = steer_deg_to_idx(theta);
+static void bench_phase_jitter(BenchSuite *s) {
+  static const int k_sizes[] = {512, 2048};
+  char name[BENCH_NAME_MAX];
+  for (int f = 0; f < COUNT(k_sizes); f++) {
+    for (int ch = 2; ch <= MAX_CH; ch++) {
+      PhaseBench b = {phase_align_create(k_sizes[f], 48000, ch), k_sizes[f],
+                      ch};
+      if (!b.pa)
+        continue;
+      snprintf(name, sizeof(name), "phase_align/ch=%d/fft=%d/fs=48000", ch,
+               k_sizes[f]);
+      bench_run(s, name, run_phase_align, &b, b.n, b.n * 1e9 / 48000.0);
+      phase_align_destroy(b.pa);
+    }
+  }
 
-    // Beam steering
-    float steered = steer_beam_fast(xTL, xTR, xBL, xBR, theta_idx);
+  for (int nb = 0; nb < COUNT(k_blocks); nb++) {
+    for (int ch = 2; ch <= 3; ch++) {
+      static JitterBench b;
+      b.n = k_blocks[nb];
+      b.ch = ch;
+      b.jb = jitter_buffer_create(48000, ch, 20);
+      if (!b.jb)
+        continue;
+      snprintf(name, sizeof(name), "jitter_buffer/ch=%d/N=%d/fs=48000", ch,
+               b.n);
+      bench_run(s, name, run_jitter, &b, b.n, b.n * 1e9 / 48000.0);
+      jitter_buffer_destroy(b.jb);
+    }
+  }
+}
 
-    // Multiband EQ
-    sum += multiband_process(&mb, steered);
+static void bench_fft(BenchSuite *s) {
+  static const int k_sizes[] = {256, 512, 1024, 2048};
+  static FftBench b;
+  char name[BENCH_NAME_MAX];
+  for (int f = 0; f < COUNT(k_sizes); f++) {
+    int n = k_sizes[f];
+    size_t cb = le_fft_plan_bytes(n), rb = le_rfft_plan_bytes(n);
+    b.mem = (float *)malloc(cb + rb);
+    b.n = n;
+    memcpy(b.x, g_signal[0], n * sizeof(float));
+    if (!b.mem || le_fft_plan_init(&b.plan, n, b.mem, cb) != 0 ||
+        le_rfft_plan_init(&b.rplan, n, (char *)b.mem + cb, rb) != 0) {
+      free(b.mem);
+      continue;
+    }
+    snprintf(name, sizeof(name), "fft_complex_fwd_inv/n=%d", n);
+    bench_run(s, name, run_fft_complex, &b, n, 0.0);
+    snprintf(name, sizeof(name), "rfft_fwd_inv/n=%d", n);
+    bench_run(s, name, run_rfft, &b, n, 0.0);
+    free(b.mem);
   }
-  t1 = get_time_us();
-
-  double time_per_sample = (t1 - t0) / BENCH_ITERS;
-  double samples_per_sec = 1000000.0 / time_per_sample;
-  printf("\n=== FULL PIPELINE (DOA + Steer + Multiband) ===\n");
-  printf("Time per sample:  %.3f us\n", time_per_sample);
-  printf("Throughput:       %.0f samples/sec\n", samples_per_sec);
-  printf("Realtime factor:  %.1fx @ 48kHz\n", samples_per_sec / 48000.0);
-  printf("Latency budget:   %.1f%% used @ 64-sample buffer\n",
-         (time_per_sample * 64) / (64.0 / 48000.0 * 1000000.0) * 100.0);
-  (void)sum;
 }
 
-int main(void) {
-  printf("=== LombardEar DSP Benchmark ===\n");
-  printf("Iterations: %d, Sample rate: %d Hz\n\n", BENCH_ITERS, SAMPLE_RATE);
+int main(int argc, char **argv) {
+  BenchOptions opt;
+  bench_default_options(&opt);
+  const char *json = NULL, *baseline = NULL;
+  double tolerance = 0.10;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--quick") == 0) {
+      opt.repetitions = 5;
+      opt.min_rep_ms = 2.0;
+    } else if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+      opt.filter = argv[++i];
+    } else if (strcmp(argv[i], "--reps") == 0 && i + 1 < argc) {
+      opt.repetitions = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--min-ms") == 0 && i + 1 < argc) {
+      opt.min_rep_ms = atof(argv[++i]);
+    } else if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+      json = argv[++i];
+    } else if (strcmp(argv[i], "--baseline") == 0 && i + 1 < argc) {
+      baseline = argv[++i];
+    } else if (strcmp(argv[i], "--tolerance") == 0 && i + 1 < argc) {
+      tolerance = atof(argv[++i]);
+    } else if (strcmp(argv[i], "--simd") == 0 && i + 1 < argc) {
+      if (le_simd_set_level((LeSimdLevel)le_simd_parse(argv[++i])) != 0) {
+        fprintf(stderr, "SIMD level %s not available\n", argv[i]);
+        return 1;
+      }
+    } else {
+      fprintf(stderr,
+              "Usage: %s [--quick] [--filter <substr>] [--reps <n>] "
+              "[--min-ms <ms>]\n"
+              "          [--json <out.json>] [--baseline <base.json>] "
+              "[--tolerance <0.10>]\n"
+              "          [--simd scalar|sse2|avx2|avx512|neon]\n",
+              argv[0]);
+      return 1;
+    }
+  }
 
-  // Initialize
-  srand(12345);
   fill_test_data();
   fast_math_init();
   steer_lut_init();
+  // Same FP environment as the audio callback: a kernel replaying one block
+  // can decay its state into subnormals and would time the slow path
+  platform_fp_flush_denormals();
 
-  // Run benchmarks
-  bench_fast_sincos();
-  bench_steer_fast();
-  bench_steer_batch();
-  bench_biquad();
-  bench_multiband();
-  bench_doa();
-  bench_full_pipeline();
-
+  static BenchSuite suite; // Results table: keep off the stack
+  bench_suite_init(&suite, &opt);
+  printf("=== LombardEar DSP Benchmark ===\n");
+  printf("%d repetitions of >= %.0f ms, reference kernel %.1f ns, "
+         "SIMD %s\n\n",
+         opt.repetitions, opt.min_rep_ms, suite.reference_ns,
+         le_simd_name(le_simd_kernels()->level));
+
+  bench_legacy(&suite);
+  bench_gsc(&suite);
+  bench_aec(&suite);
+  bench_phase_jitter(&suite);
+  bench_fft(&suite);
+  bench_print(&suite, stdout);
+
+  if (json && bench_write_json(&suite, json) != 0) {
+    fprintf(stderr, "Cannot write %s\n", json);
+    return 1;
+  }
+  if (baseline) {
+    printf("\nBaseline %s:\n", baseline);
+    int regressions = bench_compare(&suite, baseline, tolerance, stdout);
+    if (regressions < 0) {
+      fprintf(stderr, "Cannot read baseline %s\n", baseline);
+      return 1;
+    }
+    return regressions > 0 ? 1 : 0;
+  }
   return 0;
 }
@@ -0,0 +1,201 @@
+/**
+ * @file test_audio_file.c
+ * @brief Simulated audio device: looping WAV input with channel remapping,
+ *        WAV output, real-time pacing, injected jitter, callback stop,
+ *        realtime setup status
+ */
+
+#include "../src/audio/audio_backend.h"
+#include "../src/platform/platform.h"
+#include "../src/utils/atomic_compat.h"
+#include "../src/utils/wav_io.h"
+#include <stdio.h>
+#include <string.h>
+
+#define FS 16000
+#define N 160 // 10 ms
+#define IN_FRAMES 1000 // Not a multiple of N: blocks straddle the loop
+#define MAX_CALLS 256
+
+static const char *k_in_path = "test_audio_file_in.wav";
+static const char *k_out_path = "test_audio_file_out.wav";
+
+typedef struct {
+  le_atomic_int calls;
+  int stop_after; // Return non-zero on this call (0: never)
+  int rt_before;  // rt_status before start and while running
+  int rt_running;
+  double t[MAX_CALLS];
+} Probe;
+
+// Logical L and B to the two outputs
+static int probe_fn(const float *in, float *out, int frames, void *user) {
+  Probe *p = (Probe *)user;
+  int n = le_atomic_load(&p->calls);
+  if (n < MAX_CALLS)
+    p->t[n] = platform_time_us();
+  for (int i = 0; i < frames; i++) {
+    out[i * 2 + 0] = in[i * 3 + 0];
+    out[i * 2 + 1] = in[i * 3 + 2];
+  }
+  le_atomic_store(&p->calls, n + 1);
+  return p->stop_after && n + 1 >= p->stop_after;
+}
+
+// Physical channel c of input frame i
+static float in_sample(long i, int c) {
+  return (float)((i % IN_FRAMES) * 3 + c) / 4096.0f;
+}
+
+static AudioConfig base_config(void) {
+  AudioConfig cfg;
+  memset(&cfg, 0, sizeof(cfg));
+  cfg.sample_rate = FS;
+  cfg.input_channels = 3;
+  cfg.output_channels = 2;
+  cfg.frames_per_buffer = N;
+  cfg.input_device_id = -1;
+  cfg.output_device_id = -1;
+  cfg.channel_map[0] = 1; // Phy0 -> R
+  cfg.channel_map[1] = 0; // Phy1 -> L
+  cfg.channel_map[2] = 2;
+  cfg.rt.cpu = -1;
+  cfg.file.loop = 1;
+  return cfg;
+}
+
+// Run for run_ms; returns the number of callbacks, -1 on error
+static int run(const AudioBackendOps *ops, const AudioConfig *cfg, Probe *p,
+               int run_ms, double *elapsed_us) {
+  void *impl = ops->open(cfg, probe_fn, p);
+  if (!impl)
+    return -1;
+  p->rt_before = ops->rt_status(impl);
+  double t0 = platform_time_us();
+  if (ops->start(impl) != 0) {
+    ops->close(impl);
+    return -1;
+  }
+  platform_sleep_ms(run_ms);
+  p->rt_running = ops->rt_status(impl);
+  ops->stop(impl);
+  *elapsed_us = platform_time_us() - t0;
+  ops->close(impl);
+  return le_atomic_load(&p->calls);
+}
+
+int main(void) {
+  printf("Testing simulated audio device...\n");
+  int failures = 0;
+  double elapsed;
+
+  WavWriter *ww = wav_open_write(k_in_path, FS, 3);
+  if (!ww) {
+    printf("FAIL: cannot create %s\n", k_in_path);
+    return 1;
+  }
+  for (long i = 0; i < IN_FRAMES; i++) {
+    float frame[3] = {in_sample(i, 0), in_sample(i, 1), in_sample(i, 2)};
+    wav_write_frames(ww, frame, 1);
+  }
+  wav_close_write(ww);
+
+  // 1. File device: paced at the block rate, never ahead of real time
+  AudioConfig cfg = base_config();
+  snprintf(cfg.file.input, sizeof(cfg.file.input), "%s", k_in_path);
+  snprintf(cfg.file.output, sizeof(cfg.file.output), "%s", k_out_path);
+  static Probe p1;
+  int calls = run(&audio_file_ops, &cfg, &p1, 300, &elapsed);
+  double expect = elapsed / (1e6 * N / FS);
+  printf("File device: %d blocks in %.1f ms (%.1f expected)\n", calls,
+         elapsed * 1e-3, expect);
+  if (calls < 0) {
+    printf("FAIL: cannot run the file device\n");
+    return 1;
+  }
+  if (calls > expect + 1.0 || calls < expect / 2) {
+    printf("FAIL: not paced at the block rate\n");
+    failures++;
+  }
+  // Nothing requested (SCHED_OTHER, no pinning): nothing fails
+  if (p1.rt_before != -1 || p1.rt_running != 0) {
+    printf("FAIL: rt status %d before start, %d running\n", p1.rt_before,
+           p1.rt_running);
+    failures++;
+  }
+
+  // 2. Output: every processed block, remapped, input looping
+  WavInfo info;
+  WavReader *wr = wav_open_read(k_out_path, &info);
+  if (!wr || info.channels != 2 || info.frames != (long)calls * N) {
+    printf("FAIL: output has %ld frames, %d expected\n", wr ? info.frames : -1,
+           calls * N);
+    failures++;
+  } else {
+    long bad = 0;
+    float frame[2];
+    for (long i = 0; i < info.frames; i++) {
+      wav_read_frames(wr, frame, 1);
+      // Logical L is physical 1, B is physical 2
+      bad += frame[0] != in_sample(i, 1) || frame[1] != in_sample(i, 2);
+    }
+    if (bad) {
+      printf("FAIL: %ld output frames differ from the looped input\n", bad);
+      failures++;
+    }
+  }
+  if (wr)
+    wav_close_read(wr);
+
+  // 3. Null device with jitter: wake-ups spread, long-term rate kept
+  cfg = base_config();
+  cfg.file.jitter_ms = 6.0f;
+  cfg.file.seed = 7;
+  static Probe p2;
+  calls = run(&audio_null_ops, &cfg, &p2, 300, &elapsed);
+  expect = elapsed / (1e6 * N / FS);
+  if (calls < 3 || calls > expect + 1.0 || calls < expect / 2) {
+    printf("FAIL: jittered device ran %d blocks (%.1f expected)\n", calls,
+           expect);
+    failures++;
+  } else {
+    double lo = 1e30, hi = -1e30;
+    for (int k = 0; k < calls && k < MAX_CALLS; k++) {
+      double off = p2.t[k] - p2.t[0] - k * (1e6 * N / FS);
+      lo = off < lo ? off : lo;
+      hi = off > hi ? off : hi;
+    }
+    printf("Jittered wake-ups: spread %.2f ms\n", (hi - lo) * 1e-3);
+    if (hi - lo < 1000.0) {
+      printf("FAIL: no jitter injected\n");
+      failures++;
+    }
+  }
+
+  // 4. A non-zero return stops the device
+  cfg = base_config();
+  static Probe p3;
+  p3.stop_after = 3;
+  calls = run(&audio_null_ops, &cfg, &p3, 150, &elapsed);
+  if (calls != 3) {
+    printf("FAIL: %d callbacks after stop request at 3\n", calls);
+    failures++;
+  }
+
+  // 5. Missing input is an open error
+  cfg = base_config();
+  snprintf(cfg.file.input, sizeof(cfg.file.input), "does_not_exist.wav");
+  if (audio_file_ops.open(&cfg, probe_fn, &p3) != NULL) {
+    printf("FAIL: opened a missing input file\n");
+    failures++;
+  }
+
+  remove(k_in_path);
+  remove(k_out_path);
+  if (failures == 0) {
+    printf("PASS\n");
+    return 0;
+  }
+  printf("FAIL (%d)\n", failures);
+  return 1;
+}
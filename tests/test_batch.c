@@ -0,0 +1,234 @@
+/**
+ * @file test_batch.c
+ * @brief Batch runner: parallel results match single-threaded and per-file
+ *        offline runs, arena reuse is exact, metrics and failures, WAV and
+ *        raw inputs in one run
+ */
+
+#include "../src/app/batch.h"
+#include "../src/utils/wav_io.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#define FS 16000
+#define NUM_FILES 7
+#define MANIFEST "test_batch_manifest.txt"
+#define RAW_IN "test_batch_in_0.raw"
+
+static void make_name(char *buf, size_t size, const char *kind, int i) {
+  snprintf(buf, size, "test_batch_%s_%d.wav", kind, i);
+}
+
+// Each file: different length, interferer level and direction
+static int write_session(const char *path, int i) {
+  long frames = FS + 1000L * i + 37 * i;
+  float *buf = malloc((size_t)frames * 3 * sizeof(float));
+  if (!buf)
+    return -1;
+  double g = 0.1 + 0.05 * i;
+  for (long n = 0; n < frames; n++) {
+    double t = (double)n / FS;
+    double s = 0.2 * sin(2.0 * M_PI * (300.0 + 40.0 * i) * t);
+    double v = g * sin(2.0 * M_PI * 1300.0 * t);
+    buf[n * 3 + 0] = (float)(s + 0.4 * v);
+    buf[n * 3 + 1] = (float)(s + 0.2 * v);
+    buf[n * 3 + 2] = (float)v;
+  }
+  WavWriter *ww = wav_open_write(path, FS, 3);
+  int ret = (ww && wav_write_frames(ww, buf, frames) == 0) ? 0 : -1;
+  if (wav_close_write(ww) != 0)
+    ret = -1;
+  free(buf);
+  return ret;
+}
+
+// Headerless float32 copy of a WAV file
+static int wav_to_raw(const char *wav, const char *raw) {
+  WavInfo info;
+  WavReader *wr = wav_open_read(wav, &info);
+  FILE *f = fopen(raw, "wb");
+  int ret = (wr && f) ? 0 : -1;
+  float frame[8];
+  while (ret == 0 && info.channels <= 8 && wav_read_frames(wr, frame, 1) == 1)
+    if (fwrite(frame, sizeof(float), info.channels, f) != (size_t)info.channels)
+      ret = -1;
+  if (wr)
+    wav_close_read(wr);
+  if (f)
+    fclose(f);
+  return ret;
+}
+
+static int same_file(const char *a, const char *b) {
+  FILE *fa = fopen(a, "rb"), *fb = fopen(b, "rb");
+  int same = fa && fb;
+  while (same) {
+    int ca = fgetc(fa), cb = fgetc(fb);
+    if (ca != cb)
+      same = 0;
+    if (ca == EOF || cb == EOF)
+      break;
+  }
+  if (fa)
+    fclose(fa);
+  if (fb)
+    fclose(fb);
+  return same;
+}
+
+int main(void) {
+  printf("Testing batch runner...\n");
+  int failures = 0;
+
+  char in[NUM_FILES][64], out[NUM_FILES][64], ref[NUM_FILES][64];
+  FILE *mf = fopen(MANIFEST, "w");
+  fprintf(mf, "# session list\n\n");
+  for (int i = 0; i < NUM_FILES; i++) {
+    make_name(in[i], sizeof(in[i]), "in", i);
+    make_name(ref[i], sizeof(ref[i]), "ref", i);
+    if (write_session(in[i], i) != 0) {
+      printf("FAIL: cannot write input\n");
+      return 1;
+    }
+    fprintf(mf, "%s\n", in[i]);
+  }
+  fprintf(mf, "test_batch_missing.wav\n");
+  fclose(mf);
+
+  PipelineConfig cfg;
+  pipeline_default_config(&cfg);
+  cfg.aec_on = 1;
+  cfg.agc_on = 1;
+
+  // Manifest parsing: comments and blank lines skipped, outputs in out_dir
+  BatchList list;
+  if (batch_collect(MANIFEST, ".", &list) != 0 ||
+      list.count != NUM_FILES + 1) {
+    printf("FAIL: manifest\n");
+    return 1;
+  }
+  for (int i = 0; i < NUM_FILES; i++) {
+    // Same name as the input in out_dir "." would overwrite it
+    char *op = (char *)list.jobs[i].out_path;
+    char *p = strstr(op, "_in_");
+    if (p)
+      memcpy(p, "_ot_", 4);
+    snprintf(out[i], sizeof(out[i]), "%s", op);
+  }
+
+  OfflineOptions base;
+  offline_default_options(&base);
+
+  // Reference: one fresh pipeline per file
+  OfflineStats ref_stats[NUM_FILES];
+  for (int i = 0; i < NUM_FILES; i++) {
+    OfflineOptions o = base;
+    o.in_path = in[i];
+    o.out_path = ref[i];
+    if (offline_run(&o, &cfg, &ref_stats[i]) != 0) {
+      printf("FAIL: offline_run %d\n", i);
+      failures++;
+    }
+  }
+
+  // Parallel run: outputs bit-identical to the references
+  BatchResult par[NUM_FILES + 1], seq[NUM_FILES + 1];
+  BatchSummary sum;
+  int failed = batch_run(list.jobs, list.count, &base, &cfg, 4, par, &sum);
+  printf("Parallel: %d files, %d failed, %d threads, %.1f s audio in %.3f s "
+         "(%.0fx)\n",
+         sum.files, sum.failed, sum.threads, sum.audio_s, sum.wall_s,
+         sum.speedup);
+  if (failed != 1 || sum.failed != 1 || par[NUM_FILES].status != -1 ||
+      sum.threads != 4) {
+    printf("FAIL: missing file not reported\n");
+    failures++;
+  }
+  for (int i = 0; i < NUM_FILES; i++) {
+    if (par[i].status != 0 || par[i].frames != ref_stats[i].frames ||
+        !same_file(out[i], ref[i])) {
+      printf("FAIL: file %d differs from offline_run\n", i);
+      failures++;
+    }
+  }
+
+  // Single worker reuses one arena for every file: same results
+  batch_run(list.jobs, list.count, &base, &cfg, 1, seq, NULL);
+  for (int i = 0; i < NUM_FILES; i++) {
+    if (seq[i].rms_out != par[i].rms_out ||
+        seq[i].beta_final != par[i].beta_final ||
+        seq[i].convergence_s != par[i].convergence_s ||
+        memcmp(seq[i].beta, par[i].beta, sizeof(seq[i].beta)) != 0 ||
+        !same_file(out[i], ref[i])) {
+      printf("FAIL: arena reuse changed file %d\n", i);
+      failures++;
+    }
+  }
+
+  // Metrics are populated and consistent with the trajectory
+  for (int i = 0; i < NUM_FILES; i++) {
+    const BatchResult *r = &par[i];
+    if (i == 0)
+      printf("File 0: rms %.4f -> %.4f, beta %.3f, conv %.2f s, %d points\n",
+             r->rms_in, r->rms_out, r->beta_final, r->convergence_s,
+             r->beta_points);
+    float dur = (float)r->frames / FS;
+    if (!(r->rms_in > 0.0f) || !(r->rms_out > 0.0f) ||
+        r->beta_points != BATCH_BETA_POINTS ||
+        r->beta[BATCH_BETA_POINTS - 1] != r->beta_final ||
+        r->convergence_s < 0.0f || r->convergence_s > dur) {
+      printf("FAIL: metrics of file %d\n", i);
+      failures++;
+    }
+  }
+
+  // Mixed WAV and raw inputs with a raw format: each file gets its reader
+  {
+    BatchJob mixed[2] = {{in[0], NULL}, {RAW_IN, NULL}};
+    BatchResult mr[2];
+    OfflineOptions raw_base = base;
+    raw_base.raw_channels = 3;
+    if (wav_to_raw(in[0], RAW_IN) != 0 ||
+        batch_run(mixed, 2, &raw_base, &cfg, 2, mr, NULL) != 0 ||
+        mr[0].frames != par[0].frames || mr[1].frames != par[0].frames ||
+        mr[0].rms_out != par[0].rms_out || mr[1].rms_out != par[0].rms_out) {
+      printf("FAIL: mixed WAV / raw inputs\n");
+      failures++;
+    }
+    // Without a raw format the raw file is refused, the WAV still runs
+    if (batch_run(mixed, 2, &base, &cfg, 1, mr, NULL) != 1 ||
+        mr[0].status != 0 || mr[1].status != -1) {
+      printf("FAIL: raw input without a raw format\n");
+      failures++;
+    }
+    remove(RAW_IN);
+  }
+
+  if (batch_write_csv("test_batch_results.csv", list.jobs, par,
+                      list.count) != 0) {
+    printf("FAIL: CSV\n");
+    failures++;
+  }
+
+  for (int i = 0; i < NUM_FILES; i++) {
+    remove(in[i]);
+    remove(out[i]);
+    remove(ref[i]);
+  }
+  batch_list_free(&list);
+  remove(MANIFEST);
+  remove("test_batch_results.csv");
+
+  if (failures == 0) {
+    printf("PASS\n");
+    return 0;
+  }
+  printf("FAIL (%d)\n", failures);
+  return 1;
+}
@@ -0,0 +1,216 @@
+/**
+ * @file test_biquad_bank.c
+ * @brief Biquad bank: every lane matches a chain of single sections (bit
+ *        for bit with the scalar kernels), the multiband EQ block and
+ *        per-sample paths match the crossover tree, copies of a multiband
+ *        state are independent, the DC blocker
+ */
+
+#include "../src/dsp/biquad.h"
+#include "../src/dsp/multiband.h"
+#include "../src/dsp/simd_dispatch.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define PI 3.14159265358979323846f
+#define FS 16000.0f
+#define LANES 5
+#define STAGES 3
+#define NS 4000
+
+static float randf(void) {
+  return ((float)rand() / (float)RAND_MAX) * 2.0f - 1.0f;
+}
+
+// Largest difference relative to the reference peak (at least 1)
+static float rel_diff(const float *ref, const float *x, int n) {
+  float d = 0.0f, p = 1.0f;
+  for (int i = 0; i < n; i++) {
+    d = fmaxf(d, fabsf(x[i] - ref[i]));
+    p = fmaxf(p, fabsf(ref[i]));
+  }
+  return d / p;
+}
+
+// Designed sections, a different cascade on every lane
+static void design(BiquadState sec[STAGES][LANES]) {
+  for (int l = 0; l < LANES; l++) {
+    float fc = 200.0f * (float)(l + 1);
+    biquad_lowpass(&sec[0][l], FS, 4.0f * fc);
+    biquad_highpass(&sec[1][l], FS, fc);
+    biquad_bandpass(&sec[2][l], FS, 2.0f * fc, fc);
+  }
+}
+
+// 1. Interleaved lanes vs BiquadState chains, uneven blocks
+static int test_bank(const char *name, int exact) {
+  static float in[NS * LANES], ref[NS * LANES], out[NS * LANES];
+  BiquadState sec[STAGES][LANES];
+  design(sec);
+  for (int i = 0; i < NS * LANES; i++)
+    in[i] = randf();
+  for (int n = 0; n < NS; n++) {
+    for (int l = 0; l < LANES; l++) {
+      float x = in[n * LANES + l];
+      for (int s = 0; s < STAGES; s++)
+        x = biquad_process(&sec[s][l], x);
+      ref[n * LANES + l] = x;
+    }
+  }
+
+  BiquadBank bk;
+  float mem[BIQUAD_BANK_FLOATS(LANES, STAGES)];
+  if (biquad_bank_init(&bk, LANES, STAGES, mem, sizeof(mem)) != 0 ||
+      biquad_bank_init(&bk, LANES, STAGES, mem, sizeof(mem) - 1) != -1 ||
+      biquad_bank_init(&bk, 0, STAGES, mem, sizeof(mem)) != -1 ||
+      biquad_bank_init(&bk, LANES, STAGES, mem, sizeof(mem)) != 0) {
+    printf("FAIL: %s bank init\n", name);
+    return 1;
+  }
+  design(sec); // Fresh sections (the state is not loaded anyway)
+  for (int s = 0; s < STAGES; s++) {
+    for (int l = 0; l < LANES; l++)
+      biquad_bank_set(&bk, s, l, &sec[s][l]);
+  }
+
+  // In place, blocks of 1..97 frames
+  memcpy(out, in, sizeof(in));
+  for (int i = 0, n = 1; i < NS; i += n, n = n % 97 + 13) {
+    int frames = (i + n <= NS) ? n : NS - i;
+    biquad_bank_process(&bk, &out[i * LANES], LANES, &out[i * LANES],
+                        frames);
+  }
+  float d = rel_diff(ref, out, NS * LANES);
+  printf("  %-6s bank vs sections: %.2e\n", name, d);
+  if (exact ? memcmp(ref, out, sizeof(out)) != 0 : d > 1e-5f) {
+    printf("FAIL: %s bank differs from single sections\n", name);
+    return 1;
+  }
+
+  // Reset: the same output again
+  biquad_bank_reset(&bk);
+  biquad_bank_process(&bk, in, LANES, out, NS);
+  if (rel_diff(ref, out, NS * LANES) > (exact ? 0.0f : 1e-5f)) {
+    printf("FAIL: %s bank reset\n", name);
+    return 1;
+  }
+  return 0;
+}
+
+// 2. Multiband EQ: per-sample == crossover tree of single sections, block
+//    == per-sample
+static int test_multiband(const char *name, int exact) {
+  static float in[NS], ref[NS], out[NS];
+  BiquadState lp1, hp1, lp2, hp2, lp3, hp3;
+  biquad_lowpass(&lp1, FS, 300.0f);
+  biquad_highpass(&hp1, FS, 300.0f);
+  biquad_lowpass(&lp2, FS, 1000.0f);
+  biquad_highpass(&hp2, FS, 1000.0f);
+  biquad_lowpass(&lp3, FS, 4000.0f);
+  biquad_highpass(&hp3, FS, 4000.0f);
+
+  MultibandState mb;
+  multiband_init(&mb, FS);
+  const float *g = mb.gains;
+  for (int i = 0; i < NS; i++) {
+    in[i] = randf();
+    float low = biquad_process(&lp1, in[i]);
+    float mid_high = biquad_process(&hp1, in[i]);
+    float voice_low = biquad_process(&lp2, mid_high);
+    float high_part = biquad_process(&hp2, mid_high);
+    float voice_high = biquad_process(&lp3, high_part);
+    float high = biquad_process(&hp3, high_part);
+    ref[i] = low * g[BAND_LOW] + voice_low * g[BAND_VOICE_LOW] +
+             voice_high * g[BAND_VOICE_HIGH] + high * g[BAND_HIGH];
+  }
+
+  int failures = 0;
+  for (int i = 0; i < NS; i++)
+    out[i] = multiband_process(&mb, in[i]);
+  if (memcmp(ref, out, sizeof(out)) != 0) {
+    printf("FAIL: %s multiband per-sample differs from the tree\n", name);
+    failures++;
+  }
+
+  // Block (in place, across the chunk size), then per-sample again: the
+  // two paths leave the bank in the same state
+  multiband_init(&mb, FS);
+  memcpy(out, in, sizeof(in));
+  multiband_process_block(&mb, out, out, NS / 2 + 3);
+  for (int i = NS / 2 + 3; i < NS; i++)
+    out[i] = multiband_process(&mb, in[i]);
+  float d = rel_diff(ref, out, NS);
+  printf("  %-6s multiband block vs tree: %.2e\n", name, d);
+  if (exact ? memcmp(ref, out, sizeof(out)) != 0 : d > 1e-5f) {
+    printf("FAIL: %s multiband block differs from per-sample\n", name);
+    failures++;
+  }
+
+  // A copy taken mid-stream runs on its own state: it and the original
+  // produce the same output from the same input, whichever runs first
+  static float a[NS], b[NS];
+  MultibandState copy = mb;
+  for (int i = 0; i < NS / 2; i++)
+    a[i] = multiband_process(&copy, in[i]);
+  multiband_process_block(&copy, in + NS / 2, a + NS / 2, NS / 2);
+  for (int i = 0; i < NS / 2; i++)
+    b[i] = multiband_process(&mb, in[i]);
+  multiband_process_block(&mb, in + NS / 2, b + NS / 2, NS / 2);
+  if (memcmp(a, b, sizeof(a)) != 0) {
+    printf("FAIL: %s multiband copy shares state with the original\n", name);
+    failures++;
+  }
+  return failures;
+}
+
+// 3. DC blocker: removes an offset, passes speech frequencies
+static int test_dc_block(void) {
+  BiquadState dc;
+  biquad_dc_block(&dc, FS, 20.0f);
+  double mean = 0.0, p_in = 0.0, p_out = 0.0;
+  for (int i = 0; i < 2 * NS; i++) {
+    float s = sinf(2.0f * PI * 1000.0f * (float)i / FS);
+    float y = biquad_process(&dc, 0.5f + s);
+    if (i >= NS) { // Settled (time constant ~8 ms)
+      mean += y;
+      p_in += (double)s * s;
+      p_out += (double)y * y;
+    }
+  }
+  mean /= NS;
+  double gain_db = 10.0 * log10(p_out / p_in);
+  printf("  dc block: residual offset %.2e, 1 kHz gain %.2f dB\n", mean,
+         gain_db);
+  if (fabs(mean) > 1e-3 || fabs(gain_db) > 0.1) {
+    printf("FAIL: DC blocker\n");
+    return 1;
+  }
+  return 0;
+}
+
+int main(void) {
+  printf("Testing biquad bank...\n");
+  int failures = 0;
+
+  // Every variant the CPU runs (modules latch the table at init); only the
+  // scalar kernels round exactly like biquad_process
+  for (int l = 0; l < LE_SIMD_COUNT; l++) {
+    if (le_simd_set_level((LeSimdLevel)l) != 0)
+      continue;
+    const char *name = le_simd_name((LeSimdLevel)l);
+    int exact = (l == LE_SIMD_SCALAR);
+    failures += test_bank(name, exact);
+    failures += test_multiband(name, exact);
+  }
+  le_simd_set_level(le_simd_detect());
+  failures += test_dc_block();
+
+  if (failures == 0) {
+    printf("PASS\n");
+    return 0;
+  }
+  printf("FAIL (%d)\n", failures);
+  return 1;
+}
@@ -0,0 +1,213 @@
+/**
+ * @file test_deadline_monitor.c
+ * @brief Deadline monitor: histogram buckets, quantiles, interval
+ *        differences, JSON export and a concurrent writer/reader
+ */
+
+#include "../src/utils/deadline_monitor.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+#define NUM_BLOCKS 200000
+#define BUDGET_US 30000.0 // 480 frames at 16 kHz
+
+static DeadlineMonitor g_mon;
+static le_atomic_int g_writer_done;
+
+static int test_bins(void) {
+  // Buckets are contiguous and monotonic, and each value lands in the
+  // bucket whose range holds it
+  double lower = 0.0;
+  for (int b = 0; b < DEADLINE_HIST_BINS - 1; b++) {
+    double upper = deadline_monitor_bin_upper_us(b);
+    if (upper <= lower || upper > 1.25 * lower + 1.0) {
+      printf("FAIL: bucket %d range (%.1f, %.1f]\n", b, lower, upper);
+      return 1;
+    }
+    double probes[3] = {lower, 0.5 * (lower + upper), upper - 0.01};
+    for (int i = 0; i < 3; i++) {
+      if (deadline_monitor_bin(probes[i]) != b) {
+        printf("FAIL: %.2f us in bucket %d, expected %d\n", probes[i],
+               deadline_monitor_bin(probes[i]), b);
+        return 1;
+      }
+    }
+    lower = upper;
+  }
+  if (deadline_monitor_bin(-5.0) != 0 || deadline_monitor_bin(NAN) != 0 ||
+      deadline_monitor_bin(1e12) != DEADLINE_HIST_BINS - 1) {
+    printf("FAIL: out-of-range values not clamped\n");
+    return 1;
+  }
+  printf("Buckets: OK (last edge %.0f us)\n",
+         deadline_monitor_bin_upper_us(DEADLINE_HIST_BINS - 2));
+  return 0;
+}
+
+static int test_stats(void) {
+  DeadlineMonitor m;
+  deadline_monitor_init(&m);
+  DeadlineStats s0, s1, d;
+  deadline_monitor_snapshot(&m, &s0);
+  if (deadline_stats_quantile_us(&s0, 0.5) != 0.0 ||
+      deadline_stats_load(&s0) != 0.0) {
+    printf("FAIL: empty monitor\n");
+    return 1;
+  }
+
+  // 98 fast blocks, one slow one, one overrun
+  for (int i = 0; i < 98; i++)
+    deadline_monitor_record(&m, 100.0, 1000.0);
+  deadline_monitor_record(&m, 700.0, 1000.0);
+  deadline_monitor_record(&m, 1500.0, 1000.0);
+  deadline_monitor_xrun(&m, DEADLINE_XRUN_OUTPUT_UNDERFLOW);
+  deadline_monitor_xrun(&m, DEADLINE_XRUN_INPUT_OVERFLOW);
+  deadline_monitor_xrun(&m, DEADLINE_XRUN_KINDS); // Ignored
+  deadline_monitor_snapshot(&m, &s1);
+
+  double p50 = deadline_stats_quantile_us(&s1, 0.5);
+  double p99 = deadline_stats_quantile_us(&s1, 0.99);
+  double pmax = deadline_stats_quantile_us(&s1, 1.0);
+  double load = deadline_stats_load(&s1);
+  if (p50 < 100.0 || p50 > 125.0 || p99 < 700.0 || p99 > 875.0 ||
+      pmax < 1500.0 || pmax > 1875.0 || s1.overruns != 1 ||
+      fabs(load - (9800.0 + 700.0 + 1500.0) / 100000.0) > 1e-6 ||
+      deadline_stats_xruns(&s1) != 2 || s1.max_ns != 1500000) {
+    printf("FAIL: p50 %.0f p99 %.0f max %.0f load %.4f overruns %lld\n", p50,
+           p99, pmax, load, s1.overruns);
+    return 1;
+  }
+
+  // An interval only sees what happened after the previous snapshot
+  for (int i = 0; i < 10; i++)
+    deadline_monitor_record(&m, 3000.0, 2000.0);
+  DeadlineStats s2;
+  deadline_monitor_snapshot(&m, &s2);
+  deadline_stats_diff(&s2, &s1, &d);
+  if (d.blocks != 10 || d.overruns != 10 || deadline_stats_xruns(&d) != 0 ||
+      fabs(deadline_stats_load(&d) - 1.5) > 1e-9 ||
+      deadline_stats_quantile_us(&d, 0.5) < 3000.0) {
+    printf("FAIL: interval difference\n");
+    return 1;
+  }
+
+  char json[4096];
+  size_t len = deadline_monitor_format_json(&s2, &d, 1.0, json, sizeof(json));
+  if (len == 0 || len != strlen(json) ||
+      strncmp(json, "{\"type\":\"monitor\"", 17) != 0 ||
+      !strstr(json, "\"blocks\":110") || !strstr(json, "\"load\":1.5000") ||
+      !strstr(json, "\"output_underflow\":0") ||
+      json[len - 1] != '}' || json[len - 2] != '}') {
+    printf("FAIL: JSON: %s\n", json);
+    return 1;
+  }
+  // Too small a buffer is reported, not truncated
+  if (deadline_monitor_format_json(&s2, &d, 1.0, json, 64) != 0) {
+    printf("FAIL: truncated JSON accepted\n");
+    return 1;
+  }
+  printf("Stats: OK (p50 %.0f us, p99 %.0f us, load %.3f)\n", p50, p99, load);
+  return 0;
+}
+
+// Records like the audio thread: a fixed pattern so totals are known
+static void writer_body(void) {
+  for (int k = 0; k < NUM_BLOCKS; k++) {
+    deadline_monitor_record(&g_mon, (double)(100 + k % 900), BUDGET_US);
+    if (k % 1000 == 0)
+      deadline_monitor_xrun(&g_mon, DEADLINE_XRUN_INPUT_UNDERFLOW);
+  }
+  le_atomic_store(&g_writer_done, 1);
+}
+
+#ifdef _WIN32
+static DWORD WINAPI writer_thread(LPVOID arg) {
+  (void)arg;
+  writer_body();
+  return 0;
+}
+#else
+static void *writer_thread(void *arg) {
+  (void)arg;
+  writer_body();
+  return NULL;
+}
+#endif
+
+static int test_concurrent(void) {
+  deadline_monitor_init(&g_mon);
+  le_atomic_store(&g_writer_done, 0);
+
+#ifdef _WIN32
+  HANDLE th = CreateThread(NULL, 0, writer_thread, NULL, 0, NULL);
+#else
+  pthread_t th;
+  pthread_create(&th, NULL, writer_thread, NULL);
+#endif
+
+  // The reader's intervals must add up to the total and never go backwards
+  DeadlineStats prev, now, d;
+  memset(&prev, 0, sizeof(prev));
+  long long sum_blocks = 0, sum_hist = 0, behind = 0;
+  long snapshots = 0;
+  for (;;) {
+    int done = le_atomic_load(&g_writer_done);
+    deadline_monitor_snapshot(&g_mon, &now);
+    deadline_stats_diff(&now, &prev, &d);
+    long long hist = 0, total = 0;
+    for (int i = 0; i < DEADLINE_HIST_BINS; i++) {
+      if (d.hist[i] < 0)
+        behind++;
+      hist += d.hist[i];
+      total += now.hist[i];
+    }
+    // Blocks is bumped last, so the histogram never shows fewer
+    if (d.blocks < 0 || total < now.blocks)
+      behind++;
+    sum_blocks += d.blocks;
+    sum_hist += hist;
+    prev = now;
+    snapshots++;
+    if (done)
+      break;
+  }
+
+#ifdef _WIN32
+  WaitForSingleObject(th, INFINITE);
+  CloseHandle(th);
+#else
+  pthread_join(th, NULL);
+#endif
+
+  printf("Concurrent: %d blocks, %ld snapshots, %lld inconsistent\n",
+         NUM_BLOCKS, snapshots, behind);
+  if (behind || sum_blocks != NUM_BLOCKS || sum_hist != NUM_BLOCKS ||
+      deadline_stats_xruns(&now) != NUM_BLOCKS / 1000 ||
+      now.max_ns != 999000 || now.overruns != 0) {
+    printf("FAIL: lost or inconsistent counts\n");
+    return 1;
+  }
+  return 0;
+}
+
+int main(void) {
+  printf("Testing deadline monitor...\n");
+  int failures = 0;
+  failures += test_bins();
+  failures += test_stats();
+  failures += test_concurrent();
+
+  if (failures == 0) {
+    printf("PASS\n");
+    return 0;
+  }
+  printf("FAIL (%d)\n", failures);
+  return 1;
+}
@@ -0,0 +1,99 @@
+/**
+ * @file test_denormal.c
+ * @brief Denormal flushing: FTZ/DAZ take effect, and decaying pipeline state
+ *        settles to exact zeros in silence instead of subnormals
+ */
+
+#include "../src/app/pipeline.h"
+#include "../src/platform/platform.h"
+#include <float.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#define FS 16000
+#define N 480
+
+static int count_subnormal(const float *x, int n) {
+  int count = 0;
+  for (int i = 0; i < n; i++)
+    count += fpclassify(x[i]) == FP_SUBNORMAL;
+  return count;
+}
+
+int main(void) {
+  printf("Testing denormal flushing...\n");
+  int failures = 0;
+
+  if (platform_fp_flush_denormals() != 0) {
+    printf("SKIP: no FP environment control on this architecture\n");
+    return 0;
+  }
+  if (!platform_fp_denormals_flushed()) {
+    printf("FAIL: flag not set\n");
+    failures++;
+  }
+
+  // 1. Results and inputs in the subnormal range read as zero
+  volatile float tiny = FLT_MIN;
+  volatile float sub = FLT_MIN / 8.0f; // Constant-folded: a real subnormal
+  if (tiny * 0.25f != 0.0f || sub * 2.0f != 0.0f) {
+    printf("FAIL: subnormals not flushed\n");
+    failures++;
+  }
+
+  // 2. Burst then silence through the full chain. With a strong leak the
+  // AIC weights decay by ~1e-2 per block, into the subnormal range within
+  // the run; AGC and gate envelopes/gains decay in the silence too.
+  PipelineConfig cfg;
+  pipeline_default_config(&cfg);
+  cfg.gsc.leak_lambda = 1e-2f;
+  cfg.agc_on = 1;
+  cfg.ng_on = 1;
+  Pipeline pl;
+  if (pipeline_init(&pl, &cfg) != 0) {
+    printf("FAIL: pipeline_init\n");
+    return 1;
+  }
+
+  float in[N * 3], out[N * 2];
+  int subnormal_out = 0, subnormal_state = 0;
+  for (int b = 0; b < 200; b++) {
+    for (int i = 0; i < N; i++) {
+      double t = (double)(b * N + i) / FS;
+      float v = b < 10 ? (float)(0.3 * sin(2.0 * M_PI * 700.0 * t)) : 0.0f;
+      in[i * 3 + 0] = v;
+      in[i * 3 + 1] = 0.5f * v;
+      in[i * 3 + 2] = 0.8f * v;
+    }
+    pipeline_process(in, out, N, &pl);
+    subnormal_out += count_subnormal(out, N * 2);
+
+    // Checked every block: the decay passes through the range on its way
+    const float gains[4] = {pl.agc.envelope, pl.agc.gain, pl.ng.envelope,
+                            pl.ng.gain};
+    subnormal_state += count_subnormal(pl.st.w1, pl.st.M) +
+                       count_subnormal(pl.st.w2, pl.st.M) +
+                       count_subnormal(gains, 4);
+  }
+
+  printf("Subnormal values after silence: state %d, output %d\n",
+         subnormal_state, subnormal_out);
+  if (subnormal_state != 0 || subnormal_out != 0) {
+    printf("FAIL: subnormals in pipeline state or output\n");
+    failures++;
+  }
+  pipeline_free(&pl);
+
+  if (failures == 0) {
+    printf("PASS\n");
+    return 0;
+  }
+  printf("FAIL (%d)\n", failures);
+  return 1;
+}
@@ -0,0 +1,175 @@
+/**
+ * @file test_fft.c
+ * @brief le_fft complex and real transforms against a direct DFT (every bin
+ *        up to DFT_MAX_N, spot bins above), round trip and Parseval
+ */
+
+#include "../src/dsp/le_fft.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#define MAX_N 4096
+#define DFT_MAX_N 1024 // Larger sizes: spot bins only (the DFT is O(n^2))
+#define SPOT_BINS 37
+
+static float randf(void) {
+  return ((float)rand() / (float)RAND_MAX) * 2.0f - 1.0f;
+}
+
+// Direct DFT in double precision of the bins k = 0, step, 2 * step, ...
+// below `bins` (the others are left untouched)
+static void dft(const float *xr, const float *xi, double *yr, double *yi,
+                int n, int bins, int step) {
+  for (int k = 0; k < bins; k += step) {
+    double sr = 0.0, si = 0.0;
+    for (int t = 0; t < n; t++) {
+      double a = -2.0 * M_PI * (double)((long long)k * t % n) / (double)n;
+      sr += xr[t] * cos(a) - xi[t] * sin(a);
+      si += xr[t] * sin(a) + xi[t] * cos(a);
+    }
+    yr[k] = sr;
+    yi[k] = si;
+  }
+}
+
+// Relative error tolerance for float transforms of these sizes
+static const double TOL = 1e-5;
+
+// Bin stride of the DFT reference: every bin, or SPOT_BINS spread ones
+// (odd stride, so they do not all sit on the coarse twiddles)
+static int dft_step(int n) {
+  return n <= DFT_MAX_N ? 1 : (n / SPOT_BINS) | 1;
+}
+
+// |sum |X|^2 / (n sum |x|^2) - 1|
+static double parseval_err(double time_energy, double freq_energy, int n) {
+  return fabs(freq_energy / ((double)n * time_energy) - 1.0);
+}
+
+static int test_complex(int n) {
+  static float re[MAX_N], im[MAX_N], xr[MAX_N], xi[MAX_N];
+  static double yr[MAX_N], yi[MAX_N];
+  static float mem[MAX_N * 3];
+
+  LeFftPlan plan;
+  if (le_fft_plan_init(&plan, n, mem, sizeof(mem)) != 0) {
+    printf("FAIL: complex plan init n=%d\n", n);
+    return 1;
+  }
+
+  double ref_norm = 0.0, e_time = 0.0, e_freq = 0.0;
+  for (int i = 0; i < n; i++) {
+    xr[i] = re[i] = randf();
+    xi[i] = im[i] = randf();
+    e_time += (double)xr[i] * xr[i] + (double)xi[i] * xi[i];
+  }
+  const int step = dft_step(n);
+  dft(xr, xi, yr, yi, n, n, step);
+  le_fft_complex(&plan, re, im, 0);
+
+  double err = 0.0;
+  for (int k = 0; k < n; k++) {
+    e_freq += (double)re[k] * re[k] + (double)im[k] * im[k];
+    if (k % step)
+      continue;
+    err = fmax(err, fabs(re[k] - yr[k]));
+    err = fmax(err, fabs(im[k] - yi[k]));
+    ref_norm = fmax(ref_norm, sqrt(yr[k] * yr[k] + yi[k] * yi[k]));
+  }
+  double pe = parseval_err(e_time, e_freq, n);
+
+  le_fft_complex(&plan, re, im, 1);
+  double rt = 0.0;
+  for (int i = 0; i < n; i++) {
+    rt = fmax(rt, fabs(re[i] - xr[i]));
+    rt = fmax(rt, fabs(im[i] - xi[i]));
+  }
+
+  if (err > TOL * ref_norm || rt > TOL || pe > TOL) {
+    printf("FAIL: complex n=%d (dft err %.3g, roundtrip err %.3g, parseval "
+           "err %.3g)\n",
+           n, err, rt, pe);
+    return 1;
+  }
+  return 0;
+}
+
+static int test_real(int n) {
+  static float x[MAX_N], zero[MAX_N], out[MAX_N];
+  static float re[MAX_N / 2 + 1], im[MAX_N / 2 + 1];
+  static double yr[MAX_N], yi[MAX_N];
+  static float mem[MAX_N * 3];
+
+  LeRfftPlan plan;
+  if (le_rfft_plan_init(&plan, n, mem, sizeof(mem)) != 0) {
+    printf("FAIL: real plan init n=%d\n", n);
+    return 1;
+  }
+
+  double e_time = 0.0, e_freq = 0.0;
+  for (int i = 0; i < n; i++) {
+    x[i] = randf();
+    zero[i] = 0.0f;
+    e_time += (double)x[i] * x[i];
+  }
+  const int step = dft_step(n);
+  dft(x, zero, yr, yi, n, n / 2 + 1, step);
+  le_rfft_forward(&plan, x, re, im);
+
+  double err = 0.0, ref_norm = 0.0;
+  for (int k = 0; k <= n / 2; k++) {
+    // Bins 1 .. n/2 - 1 stand for their mirror images too
+    double p = (double)re[k] * re[k] + (double)im[k] * im[k];
+    e_freq += (k == 0 || k == n / 2) ? p : 2.0 * p;
+    if (k % step)
+      continue;
+    err = fmax(err, fabs(re[k] - yr[k]));
+    err = fmax(err, fabs(im[k] - yi[k]));
+    ref_norm = fmax(ref_norm, sqrt(yr[k] * yr[k] + yi[k] * yi[k]));
+  }
+  double pe = parseval_err(e_time, e_freq, n);
+
+  le_rfft_inverse(&plan, re, im, out);
+  double rt = 0.0;
+  for (int i = 0; i < n; i++)
+    rt = fmax(rt, fabs(out[i] - x[i]));
+
+  if (err > TOL * ref_norm || rt > TOL || pe > TOL) {
+    printf("FAIL: real n=%d (dft err %.3g, roundtrip err %.3g, parseval err "
+           "%.3g)\n",
+           n, err, rt, pe);
+    return 1;
+  }
+  return 0;
+}
+
+int main(void) {
+  printf("Testing le_fft...\n");
+  srand(2024);
+
+  int failures = 0;
+  for (int n = 2; n <= MAX_N; n *= 2) {
+    failures += test_complex(n);
+    if (n >= 4)
+      failures += test_real(n);
+  }
+
+  // Invalid sizes must be rejected
+  if (le_fft_plan_bytes(0) != 0 || le_fft_plan_bytes(48) != 0 ||
+      le_rfft_plan_bytes(2) != 0) {
+    printf("FAIL: invalid sizes accepted\n");
+    failures++;
+  }
+
+  if (failures == 0) {
+    printf("PASS: complex and real transforms, n = 2..%d\n", MAX_N);
+    return 0;
+  }
+  printf("FAIL (%d)\n", failures);
+  return 1;
+}
@@ -0,0 +1,234 @@
+/**
+ * @file test_fixed_point.c
+ * @brief Q15/Q31 GSC and AEC against the float versions on the host, block
+ *        vs per-sample equivalence, and a golden checksum so a Cortex-M4
+ *        build can be checked for bit-exactness against the host
+ */
+
+#include "../src/dsp/aec.h"
+#include "../src/dsp/aec_q15.h"
+#include "../src/dsp/gsc.h"
+#include "../src/dsp/gsc_q15.h"
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define NS 32000
+
+// Integer LCG: the same inputs on every target (rand() is not portable)
+static uint32_t g_seed = 12345u;
+static float lcgf(void) {
+  g_seed = g_seed * 1664525u + 1013904223u;
+  return (float)(int32_t)g_seed / 2147483648.0f;
+}
+
+// Output error relative to the output power, in dB
+static double err_db(const float *ref, const float *x, int n) {
+  double se = 0.0, sr = 0.0;
+  for (int i = 0; i < n; i++) {
+    double d = (double)x[i] - ref[i];
+    se += d * d;
+    sr += (double)ref[i] * ref[i];
+  }
+  return 10.0 * log10((se + 1e-20) / (sr + 1e-20));
+}
+
+// FNV-1a over the output samples
+static uint32_t fnv1a(const q15_t *x, int n) {
+  uint32_t h = 2166136261u;
+  for (int i = 0; i < n; i++) {
+    uint16_t v = (uint16_t)x[i];
+    h = (h ^ (v & 0xFFu)) * 16777619u;
+    h = (h ^ (v >> 8)) * 16777619u;
+  }
+  return h;
+}
+
+// One source in all three mics plus independent noise (as in
+// test_simd_dispatch), so beta converges and the NLMS filter adapts
+static void make_gsc_scene(float *in, q15_t *in_q, int n) {
+  for (int i = 0; i < n; i++) {
+    float src = lcgf();
+    for (int c = 0; c < 3; c++) {
+      // Round through Q15 so both versions see the same samples
+      in_q[3 * i + c] = float_to_q15(0.2f * (src + 0.3f * lcgf()));
+      in[3 * i + c] = q15_to_float(in_q[3 * i + c]);
+    }
+  }
+}
+
+static int test_gsc(void) {
+  int failures = 0;
+  GscConfig cfg = {.M = 64,
+                   .alpha = 0.005f,
+                   .eps = 1e-6f,
+                   .mu_max = 0.05f,
+                   .eta_max = 0.001f,
+                   .leak_lambda = 0.0001f,
+                   .g_lo = 0.1f,
+                   .g_hi = 0.3f,
+                   .beta_min = -2.0f,
+                   .beta_max = 2.0f};
+
+  static float in[3 * NS], out_f[NS], out_q[NS];
+  static q15_t in_q[3 * NS], y_q[NS], y_s[NS];
+  make_gsc_scene(in, in_q, NS);
+
+  GscState st;
+  GscQ15State sq;
+  size_t bytes = gsc_mem_bytes(&cfg);
+  size_t q_bytes = gsc_q15_mem_bytes(&cfg);
+  void *mem = malloc(bytes);
+  void *q_mem = malloc(q_bytes);
+  if (q_bytes != 20 * (size_t)cfg.M || gsc_init(&st, &cfg, mem, bytes) ||
+      gsc_q15_init(&sq, &cfg, q_mem, q_bytes) ||
+      gsc_q15_init(&sq, &cfg, q_mem, q_bytes - 1) != -1) {
+    printf("FAIL: GSC init\n");
+    free(mem);
+    free(q_mem);
+    return 1;
+  }
+  gsc_q15_init(&sq, &cfg, q_mem, q_bytes);
+
+  // 1. Q15 vs float, sample by sample
+  float w_max = 0.0f;
+  for (int i = 0; i < NS; i++) {
+    out_f[i] = gsc_process_sample(&st, &cfg, in[3 * i], in[3 * i + 1],
+                                  in[3 * i + 2]);
+    y_s[i] = gsc_q15_process_sample(&sq, in_q[3 * i], in_q[3 * i + 1],
+                                    in_q[3 * i + 2]);
+    out_q[i] = q15_to_float(y_s[i]);
+  }
+  for (int k = 0; k < cfg.M; k++)
+    w_max = fmaxf(w_max, fmaxf(fabsf(st.w1[k]), fabsf(st.w2[k])));
+  double e_db = err_db(out_f, out_q, NS);
+  float beta_q = (float)sq.beta / (float)(1 << GSC_Q15_BETA_FRAC);
+  printf("  gsc: error %.1f dB, beta float %.4f / q %.4f, |w|max %.3f\n",
+         e_db, st.beta, beta_q, w_max);
+  // Q31 weights cover the float range
+  if (e_db > -30.0 || fabsf(beta_q - st.beta) > 0.02f || w_max >= 1.0f) {
+    printf("FAIL: Q15 GSC deviates from float\n");
+    failures++;
+  }
+
+  // 2. Block == per-sample, bit for bit (uneven block sizes)
+  gsc_q15_reset(&sq);
+  for (int i = 0, n = 1; i < NS; i += n, n = n % 97 + 13) {
+    int frames = (i + n <= NS) ? n : NS - i;
+    gsc_q15_process_block(&sq, &in_q[3 * i], &y_q[i], frames);
+  }
+  if (memcmp(y_q, y_s, sizeof(y_q)) != 0) {
+    printf("FAIL: GSC block differs from per-sample\n");
+    failures++;
+  }
+
+  // 3. Golden output: a target build must reproduce the host bit for bit
+  uint32_t h = fnv1a(y_q, NS);
+  printf("  gsc: checksum 0x%08x\n", (unsigned)h);
+  if (h != 0x5745ffa5u) {
+    printf("FAIL: GSC checksum changed\n");
+    failures++;
+  }
+
+  free(mem);
+  free(q_mem);
+  return failures;
+}
+
+static int test_aec(void) {
+  int failures = 0;
+  const int M = 256;
+  static float mic[NS], ref[NS], out_f[NS], out_q[NS];
+  static q15_t mic_q[NS], ref_q[NS], y_q[NS], y_s[NS];
+
+  // Far-end noise through a short echo path (delay, decaying taps)
+  for (int i = 0; i < NS; i++) {
+    ref_q[i] = float_to_q15(0.4f * lcgf());
+    ref[i] = q15_to_float(ref_q[i]);
+  }
+  for (int i = 0; i < NS; i++) {
+    float echo = 0.0f;
+    for (int k = 0; k < 4; k++) {
+      int j = i - 10 - 7 * k;
+      if (j >= 0)
+        echo += ref[j] * 0.5f / (float)(1 << k);
+    }
+    mic_q[i] = float_to_q15(echo);
+    mic[i] = q15_to_float(mic_q[i]);
+  }
+
+  AecState st;
+  AecQ15State sq;
+  size_t q_bytes = aec_q15_mem_bytes(M);
+  float *mem = malloc(2 * M * sizeof(float));
+  void *q_mem = malloc(q_bytes);
+  if (q_bytes != 10 * (size_t)M ||
+      aec_init(&st, M, mem, 2 * M * sizeof(float)) ||
+      aec_q15_init(&sq, M, q_mem, q_bytes)) {
+    printf("FAIL: AEC init\n");
+    free(mem);
+    free(q_mem);
+    return 1;
+  }
+
+  // 1. Q15 vs float, and the echo is actually cancelled
+  double p_mic = 0.0, p_err = 0.0;
+  for (int i = 0; i < NS; i++) {
+    out_f[i] = aec_process(&st, mic[i], ref[i]);
+    y_s[i] = aec_q15_process(&sq, mic_q[i], ref_q[i]);
+    out_q[i] = q15_to_float(y_s[i]);
+    if (i >= NS - 4000) {
+      p_mic += (double)mic[i] * mic[i];
+      p_err += (double)out_q[i] * out_q[i];
+    }
+  }
+  // Compare the echo estimates (mic - e): the residuals are both tiny
+  for (int i = 0; i < NS; i++) {
+    out_f[i] = mic[i] - out_f[i];
+    out_q[i] = mic[i] - out_q[i];
+  }
+  double e_db = err_db(out_f, out_q, NS);
+  double erle = 10.0 * log10(p_mic / (p_err + 1e-20));
+  printf("  aec: echo estimate error %.1f dB, ERLE %.1f dB\n", e_db, erle);
+  if (e_db > -30.0 || erle < 30.0) {
+    printf("FAIL: Q15 AEC deviates from float\n");
+    failures++;
+  }
+
+  // 2. Block (in place) == per-sample
+  aec_q15_reset(&sq);
+  memcpy(y_q, mic_q, sizeof(y_q));
+  for (int i = 0; i < NS; i += 160)
+    aec_q15_process_block(&sq, &y_q[i], &ref_q[i], &y_q[i], 160);
+  if (memcmp(y_q, y_s, sizeof(y_q)) != 0) {
+    printf("FAIL: AEC block differs from per-sample\n");
+    failures++;
+  }
+
+  // 3. Golden output
+  uint32_t h = fnv1a(y_q, NS);
+  printf("  aec: checksum 0x%08x\n", (unsigned)h);
+  if (h != 0x038d906du) {
+    printf("FAIL: AEC checksum changed\n");
+    failures++;
+  }
+
+  free(mem);
+  free(q_mem);
+  return failures;
+}
+
+int main(void) {
+  printf("Testing fixed-point GSC / AEC...\n");
+  int failures = test_gsc();
+  failures += test_aec();
+
+  if (failures == 0) {
+    printf("PASS\n");
+    return 0;
+  }
+  printf("FAIL (%d)\n", failures);
+  return 1;
+}
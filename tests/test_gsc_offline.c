@@ -24,7 +24,7 @@ int main() {
                    .beta_max = 2.0f};
 
   // Allocate state
-  size_t mem_size = 4 * cfg.M * sizeof(float);
+  size_t mem_size = gsc_mem_bytes(&cfg);
   void *mem = malloc(mem_size);
   GscState st;
   if (gsc_init(&st, &cfg, mem, mem_size) != 0) {
@@ -115,7 +115,88 @@ int main() {
     printf("Final SNR for %s: %.2f dB\n", dir_names[dir_idx], final_snr);
   }
 
-  free(mem);
   printf("\n=== 4-Channel GSC Test Complete ===\n");
+
+  // Running-power normalization must track the exact window power.
+  // Raise the soft-control thresholds so the AIC keeps adapting (mu > 0).
+  printf("\n=== Running vs Exact NLMS Power ===\n");
+  GscConfig cfg_adapt = cfg;
+  cfg_adapt.g_lo = 0.95f;
+  cfg_adapt.g_hi = 0.99f;
+  void *mem_run = malloc(mem_size);
+  GscState st_run;
+  gsc_init(&st_run, &cfg, mem_run, mem_size);
+  gsc_reset(&st);
+  gsc_set_power_mode(&st_run, GSC_POWER_RUNNING);
+
+  srand(4321);
+  float max_diff = 0.0f;
+  for (int i = 0; i < num_samples; i++) {
+    float t = (float)i / sample_rate;
+    float target = sinf(2.0f * PI * 300.0f * t);
+    float noise = ((float)rand() / RAND_MAX) * 2.0f - 1.0f;
+    float xL = target + 0.3f * noise;
+    float xR = target - 0.2f * noise;
+    float xB = 0.2f * target + noise;
+
+    float y_exact = gsc_process_sample(&st, &cfg_adapt, xL, xR, xB);
+    float y_run = gsc_process_sample(&st_run, &cfg_adapt, xL, xR, xB);
+    float diff = fabsf(y_exact - y_run);
+    if (diff > max_diff)
+      max_diff = diff;
+  }
+  printf("Max |exact - running| output difference: %.3e\n", max_diff);
+  if (max_diff > 1e-3f) {
+    printf("FAIL: running power diverged from exact power\n");
+    free(mem_run);
+    free(mem);
+    return 1;
+  }
+  printf("PASS: running power matches exact power\n");
+
+  // The 4-channel block entry point is the per-sample path, frame by frame,
+  // in any block size and for every steering direction
+  printf("\n=== 4-Channel Block vs Per-Sample ===\n");
+  enum { BLOCK_4CH = 160 };
+  float in4[BLOCK_4CH * 4], out4[BLOCK_4CH];
+  float max_diff_4ch = 0.0f;
+  int adapted = 1;
+  srand(99);
+  for (int dir_idx = 0; dir_idx < 4; dir_idx++) {
+    BeamDirection dir = (BeamDirection)dir_idx;
+    gsc_init(&st, &cfg_adapt, mem, mem_size);
+    gsc_init(&st_run, &cfg_adapt, mem_run, mem_size);
+    for (int b = 0; b < num_samples / BLOCK_4CH; b++) {
+      int n = BLOCK_4CH - (b % 7) * 13; // Block sizes vary
+      for (int i = 0; i < n; i++) {
+        float src = ((float)rand() / RAND_MAX) * 2.0f - 1.0f;
+        for (int c = 0; c < 4; c++) {
+          float noise = ((float)rand() / RAND_MAX) * 2.0f - 1.0f;
+          in4[i * 4 + c] = src + 0.3f * noise;
+        }
+      }
+      gsc_process_block_4ch(&st_run, &cfg_adapt, in4, out4, n, dir);
+      for (int i = 0; i < n; i++) {
+        const float *x = &in4[i * 4];
+        float y = gsc_process_sample_4ch(&st, &cfg_adapt, x[0], x[1], x[2],
+                                         x[3], dir);
+        float diff = fabsf(y - out4[i]);
+        if (diff > max_diff_4ch)
+          max_diff_4ch = diff;
+      }
+    }
+    if (st_run.last_mu <= 0.0f)
+      adapted = 0;
+  }
+  printf("Max |block - per-sample| output difference: %.3e\n", max_diff_4ch);
+
+  free(mem_run);
+  free(mem);
+
+  if (max_diff_4ch > 1e-5f || !adapted) {
+    printf("FAIL: 4-channel block path differs from per-sample path\n");
+    return 1;
+  }
+  printf("PASS: 4-channel block path matches per-sample path\n");
   return 0;
 }
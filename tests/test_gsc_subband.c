@@ -0,0 +1,197 @@
+#include "../src/dsp/gsc.h"
+#include "../src/dsp/gsc_subband.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define PI 3.1415926535f
+#define FS 16000
+#define NUM_SAMPLES (FS * 4)
+#define BLOCK 64
+#define MAX_DELAY 8
+
+// Same config as tests/test_gsc_offline.c with the M=96 default filter.
+// The soft-control thresholds are raised so both AICs keep adapting (the
+// target also reaches u2 = D - beta * B, which would otherwise freeze them).
+static const GscConfig base_cfg = {.M = 96,
+                                   .alpha = 0.005f,
+                                   .eps = 1e-6f,
+                                   .mu_max = 0.05f,
+                                   .eta_max = 0.001f,
+                                   .leak_lambda = 0.0001f,
+                                   .g_lo = 0.95f,
+                                   .g_hi = 0.99f,
+                                   .beta_min = -2.0f,
+                                   .beta_max = 2.0f};
+
+static const GscSubbandConfig sb_cfg = {
+    .fft_size = 256, .hop = 128, .mu = 0.5f, .power_alpha = 0.8f};
+
+static float *g_in;     // Interleaved [xL, xR, xB]
+static float *g_target; // Clean target
+
+// Target: voiced-speech-like harmonics with AM, equal at L and R. Interference:
+// strong colored (AR(1) low-passed) noise reaching each mic with a different
+// delay and gain; the back mic sees the interference only.
+static void make_scene(void) {
+  float hist[MAX_DELAY + 1] = {0};
+  float v = 0.0f;
+  srand(777);
+  for (int i = 0; i < NUM_SAMPLES; i++) {
+    float t = (float)i / FS;
+    float am = 1.0f + 0.5f * sinf(2.0f * PI * 3.0f * t);
+    float s = 0.0f;
+    for (int h = 1; h <= 6; h++)
+      s += sinf(2.0f * PI * 150.0f * h * t) / (float)h;
+    g_target[i] = 0.1f * am * s;
+
+    float w = ((float)rand() / RAND_MAX) * 2.0f - 1.0f;
+    v = 0.95f * v + 0.3f * w;
+    memmove(hist + 1, hist, MAX_DELAY * sizeof(float));
+    hist[0] = v;
+
+    g_in[i * 3 + 0] = g_target[i] + hist[2];
+    g_in[i * 3 + 1] = g_target[i] + 0.8f * hist[5];
+    g_in[i * 3 + 2] = hist[0];
+  }
+}
+
+// SNR of out against the target delayed by `delay`, over [from, to)
+static float snr_db(const float *out, int delay, int from, int to) {
+  double s = 0.0, n = 0.0;
+  for (int i = from; i < to; i++) {
+    float ref = (i >= delay) ? g_target[i - delay] : 0.0f;
+    s += ref * ref;
+    n += (out[i] - ref) * (out[i] - ref);
+  }
+  return (float)(10.0 * log10(s / (n + 1e-12)));
+}
+
+static double now_sec(void) { return (double)clock() / CLOCKS_PER_SEC; }
+
+int main() {
+  int failures = 0;
+  g_in = malloc(NUM_SAMPLES * 3 * sizeof(float));
+  g_target = malloc(NUM_SAMPLES * sizeof(float));
+  float *out_td = malloc(NUM_SAMPLES * sizeof(float));
+  float *out_sb = malloc(NUM_SAMPLES * sizeof(float));
+  make_scene();
+
+  GscConfig cfg = base_cfg;
+
+  // --- Time-domain reference ---
+  size_t td_bytes = gsc_mem_bytes(&cfg);
+  void *td_mem = malloc(td_bytes);
+  GscState td;
+  gsc_init(&td, &cfg, td_mem, td_bytes);
+  gsc_set_power_mode(&td, GSC_POWER_RUNNING);
+
+  // --- Subband ---
+  size_t sb_bytes = gsc_subband_mem_bytes(&sb_cfg);
+  void *sb_mem = malloc(sb_bytes);
+  GscSubbandState sb;
+  if (!sb_bytes || gsc_subband_init(&sb, &sb_cfg, sb_mem, sb_bytes) != 0) {
+    printf("FAIL: gsc_subband_init\n");
+    return 1;
+  }
+  int latency = gsc_subband_latency(&sb);
+
+  // 1. Perfect reconstruction with adaptation disabled: out = D[n - K]
+  {
+    GscConfig frozen = cfg;
+    frozen.eta_max = 0.0f;
+    GscSubbandState pr;
+    GscSubbandConfig pr_cfg = sb_cfg;
+    pr_cfg.mu = 0.0f;
+    gsc_subband_init(&pr, &pr_cfg, sb_mem, sb_bytes);
+    for (int b = 0; b < NUM_SAMPLES; b += BLOCK)
+      gsc_subband_process_block(&pr, &frozen, g_in + b * 3, out_sb + b, BLOCK);
+
+    float max_err = 0.0f;
+    for (int i = latency; i < NUM_SAMPLES; i++) {
+      int j = i - latency;
+      float d = 0.5f * (g_in[j * 3 + 0] + g_in[j * 3 + 1]);
+      float err = fabsf(out_sb[i] - d);
+      if (err > max_err)
+        max_err = err;
+    }
+    printf("Reconstruction error (mu=0): %.3e, latency %d samples\n", max_err,
+           latency);
+    if (max_err > 1e-4f) {
+      printf("FAIL: filterbank does not reconstruct\n");
+      failures++;
+    }
+    gsc_subband_init(&sb, &sb_cfg, sb_mem, sb_bytes);
+  }
+
+  // 2. Convergence and cost against the time-domain GSC
+  double t0 = now_sec();
+  for (int b = 0; b < NUM_SAMPLES; b += BLOCK)
+    gsc_process_block(&td, &cfg, g_in + b * 3, out_td + b, BLOCK);
+  double t_td = now_sec() - t0;
+
+  t0 = now_sec();
+  for (int b = 0; b < NUM_SAMPLES; b += BLOCK)
+    gsc_subband_process_block(&sb, &cfg, g_in + b * 3, out_sb + b, BLOCK);
+  double t_sb = now_sec() - t0;
+
+  int early = FS / 2;
+  float td_early = snr_db(out_td, 0, 0, early);
+  float sb_early = snr_db(out_sb, latency, latency, latency + early);
+  float td_late = snr_db(out_td, 0, NUM_SAMPLES - FS, NUM_SAMPLES);
+  float sb_late = snr_db(out_sb, latency, NUM_SAMPLES - FS, NUM_SAMPLES);
+  float in_snr = 0.0f;
+  {
+    double s = 0.0, n = 0.0;
+    for (int i = 0; i < NUM_SAMPLES; i++) {
+      float d = 0.5f * (g_in[i * 3 + 0] + g_in[i * 3 + 1]);
+      s += g_target[i] * g_target[i];
+      n += (d - g_target[i]) * (d - g_target[i]);
+    }
+    in_snr = (float)(10.0 * log10(s / n));
+  }
+
+  printf("Fixed beamformer SNR:   %6.2f dB\n", in_snr);
+  printf("Time-domain (M=%d):     first 0.5 s %6.2f dB, last 1 s %6.2f dB, "
+         "%.3f us/sample\n",
+         cfg.M, td_early, td_late, t_td * 1e6 / NUM_SAMPLES);
+  printf("Subband (K=%d, R=%d): first 0.5 s %6.2f dB, last 1 s %6.2f dB, "
+         "%.3f us/sample\n",
+         sb_cfg.fft_size, sb_cfg.hop, sb_early, sb_late,
+         t_sb * 1e6 / NUM_SAMPLES);
+
+  if (sb_late < in_snr + 3.0f) {
+    printf("FAIL: subband GSC does not suppress the interference\n");
+    failures++;
+  }
+  if (sb_early < td_early) {
+    printf("FAIL: subband GSC converges slower than time-domain GSC\n");
+    failures++;
+  }
+
+  // 3. Invalid frame/hop combinations must be rejected
+  GscSubbandConfig bad = sb_cfg;
+  bad.hop = 96; // 256 / 96 not an integer
+  GscSubbandConfig bad2 = sb_cfg;
+  bad2.fft_size = 200; // not a power of 2
+  if (gsc_subband_mem_bytes(&bad) != 0 || gsc_subband_mem_bytes(&bad2) != 0) {
+    printf("FAIL: invalid config accepted\n");
+    failures++;
+  }
+
+  free(sb_mem);
+  free(td_mem);
+  free(out_sb);
+  free(out_td);
+  free(g_target);
+  free(g_in);
+
+  if (failures == 0) {
+    printf("PASS\n");
+    return 0;
+  }
+  printf("FAIL (%d)\n", failures);
+  return 1;
+}
@@ -0,0 +1,352 @@
+/**
+ * @file test_offline.c
+ * @brief Offline runner: WAV/raw decoding, bit-exact match with the live
+ *        callback path, partial final block, channel map, stats; 4-mic
+ *        input, the fixed-point chain and the mic DC blockers in the
+ *        callback path
+ */
+
+#include "../src/app/offline.h"
+#include "../src/utils/wav_io.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#define FS 16000
+#define FRAMES (FS * 2 + 123) // Not a multiple of the block size
+#define IN_WAV "test_offline_in.wav"
+#define IN_RAW "test_offline_in.raw"
+#define OUT_WAV "test_offline_out.wav"
+
+static void put_u16(FILE *f, unsigned v) {
+  fputc((int)(v & 0xFF), f);
+  fputc((int)((v >> 8) & 0xFF), f);
+}
+
+static void put_u32(FILE *f, unsigned long v) {
+  put_u16(f, (unsigned)(v & 0xFFFF));
+  put_u16(f, (unsigned)((v >> 16) & 0xFFFF));
+}
+
+// Target speech-like tone on L/R, interferer mostly on the back mic
+static short sample(long n, int ch) {
+  double t = (double)n / FS;
+  double s = 0.3 * sin(2.0 * M_PI * 440.0 * t);
+  double v = 0.2 * sin(2.0 * M_PI * 1700.0 * t + ch);
+  double x = (ch == 2) ? v : s + 0.3 * v;
+  return (short)lrint(x * 32767.0);
+}
+
+// PCM16 3-channel WAV with an extra chunk before "data"
+static int write_pcm16(const char *path) {
+  FILE *f = fopen(path, "wb");
+  if (!f)
+    return -1;
+  unsigned long data_bytes = (unsigned long)FRAMES * 3 * 2;
+  fwrite("RIFF", 1, 4, f);
+  put_u32(f, 4 + (8 + 16) + (8 + 6) + (8 + data_bytes));
+  fwrite("WAVE", 1, 4, f);
+  fwrite("fmt ", 1, 4, f);
+  put_u32(f, 16);
+  put_u16(f, 1); // PCM
+  put_u16(f, 3);
+  put_u32(f, FS);
+  put_u32(f, FS * 3 * 2);
+  put_u16(f, 3 * 2);
+  put_u16(f, 16);
+  fwrite("LIST", 1, 4, f);
+  put_u32(f, 6);
+  fwrite("abcdef", 1, 6, f);
+  fwrite("data", 1, 4, f);
+  put_u32(f, data_bytes);
+  for (long n = 0; n < FRAMES; n++) {
+    for (int ch = 0; ch < 3; ch++)
+      put_u16(f, (unsigned)(unsigned short)sample(n, ch));
+  }
+  return fclose(f);
+}
+
+// Reference: the live path, callback by callback
+static float *run_direct(const PipelineConfig *cfg, const int *map) {
+  Pipeline pl;
+  if (pipeline_init(&pl, cfg) != 0)
+    return NULL;
+  int N = cfg->block_frames;
+  long blocks = (FRAMES + N - 1) / N;
+  float *in = calloc((size_t)N * 3, sizeof(float));
+  float *out = malloc((size_t)N * 2 * sizeof(float));
+  float *all = malloc((size_t)FRAMES * 2 * sizeof(float));
+  for (long b = 0; b < blocks; b++) {
+    memset(in, 0, (size_t)N * 3 * sizeof(float));
+    long n = FRAMES - b * N < N ? FRAMES - b * N : N;
+    for (long i = 0; i < n; i++) {
+      for (int p = 0; p < 3; p++)
+        in[i * 3 + map[p]] = sample(b * N + i, p) * (1.0f / 32768.0f);
+    }
+    pipeline_process(in, out, N, &pl);
+    memcpy(all + b * N * 2, out, (size_t)n * 2 * sizeof(float));
+  }
+  pipeline_free(&pl);
+  free(in);
+  free(out);
+  return all;
+}
+
+static int compare_output(const char *path, const float *ref) {
+  WavInfo info;
+  WavReader *wr = wav_open_read(path, &info);
+  if (!wr || info.channels != 2 || info.sample_rate != FS ||
+      info.frames != FRAMES) {
+    printf("  output header wrong\n");
+    wav_close_read(wr);
+    return -1;
+  }
+  float *got = malloc((size_t)FRAMES * 2 * sizeof(float));
+  long n = wav_read_frames(wr, got, FRAMES);
+  wav_close_read(wr);
+  int ok = n == FRAMES &&
+           memcmp(got, ref, (size_t)FRAMES * 2 * sizeof(float)) == 0;
+  free(got);
+  return ok ? 0 : -1;
+}
+
+int main(void) {
+  printf("Testing offline runner...\n");
+  int failures = 0;
+
+  PipelineConfig cfg;
+  pipeline_default_config(&cfg);
+  cfg.aec_on = 1;
+  cfg.agc_on = 1;
+  cfg.ng_on = 1;
+
+  if (write_pcm16(IN_WAV) != 0) {
+    printf("FAIL: cannot write input\n");
+    return 1;
+  }
+
+  // 1. PCM16 WAV, identity map: identical to calling the callback directly
+  OfflineOptions opts;
+  offline_default_options(&opts);
+  opts.in_path = IN_WAV;
+  opts.out_path = OUT_WAV;
+  OfflineStats stats;
+  float *ref = run_direct(&cfg, opts.channel_map);
+  if (!ref || offline_run(&opts, &cfg, &stats) != 0 ||
+      compare_output(OUT_WAV, ref) != 0) {
+    printf("FAIL: PCM16 output differs from direct processing\n");
+    failures++;
+  }
+  printf("Frames %ld @ %d Hz: %.0f samples/s, RTF %.4f\n", stats.frames,
+         stats.sample_rate, stats.samples_per_sec, stats.rtf);
+  if (stats.frames != FRAMES || stats.sample_rate != FS ||
+      stats.samples_per_sec <= 0.0 || stats.rtf <= 0.0) {
+    printf("FAIL: stats\n");
+    failures++;
+  }
+
+  // Output is not silent and both sides carry the same signal
+  double energy = 0.0;
+  for (long i = 0; i < FRAMES; i++)
+    energy += ref[i * 2] * ref[i * 2];
+  if (!(energy > 0.0) || ref[(FRAMES - 1) * 2] != ref[(FRAMES - 1) * 2 + 1]) {
+    printf("FAIL: output empty or channels differ\n");
+    failures++;
+  }
+  free(ref);
+
+  // 2. Raw float32 input with a swapped channel map
+  {
+    FILE *f = fopen(IN_RAW, "wb");
+    for (long n = 0; n < FRAMES; n++) {
+      for (int ch = 0; ch < 3; ch++) {
+        float v = sample(n, ch) * (1.0f / 32768.0f);
+        fwrite(&v, sizeof(v), 1, f);
+      }
+    }
+    fclose(f);
+
+    offline_default_options(&opts);
+    opts.in_path = IN_RAW;
+    opts.out_path = OUT_WAV;
+    opts.raw_channels = 3; // raw_rate left at its default, the pipeline rate
+    opts.channel_map[0] = 1;
+    opts.channel_map[1] = 0;
+    ref = run_direct(&cfg, opts.channel_map);
+    if (!ref || offline_run(&opts, &cfg, NULL) != 0 ||
+        compare_output(OUT_WAV, ref) != 0) {
+      printf("FAIL: raw input / channel map\n");
+      failures++;
+    }
+    free(ref);
+  }
+
+  // 3. 4-mic input: the callback runs the 4-channel GSC on [TL, TR, BL, BR]
+  //    frames; the subband mode (3-channel only) falls back to it
+  {
+    PipelineConfig cfg4;
+    pipeline_default_config(&cfg4);
+    cfg4.mics = 4;
+    cfg4.beam_dir = BEAM_DIR_LEFT;
+    cfg4.gsc_mode = GSC_MODE_SUBBAND;
+    const int N = cfg4.block_frames;
+    Pipeline pl;
+    GscState st;
+    size_t mem_size = gsc_mem_bytes(&cfg4.gsc);
+    void *mem = malloc(mem_size);
+    float *in = malloc((size_t)N * 4 * sizeof(float));
+    float *out = malloc((size_t)N * 2 * sizeof(float));
+    float *ref4 = malloc((size_t)N * sizeof(float));
+    int ok = pipeline_init(&pl, &cfg4) == 0 &&
+             gsc_init(&st, &cfg4.gsc, mem, mem_size) == 0 &&
+             pl.gsc_mode == GSC_MODE_TIME;
+    if (ok)
+      gsc_set_power_mode(&st, GSC_POWER_RUNNING);
+    for (long b = 0; ok && b < 20; b++) {
+      for (int i = 0; i < N; i++) {
+        for (int c = 0; c < 4; c++)
+          in[i * 4 + c] = sample(b * N + i, c) * (1.0f / 32768.0f);
+      }
+      pipeline_process(in, out, N, &pl);
+      gsc_process_block_4ch(&st, &cfg4.gsc, in, ref4, N, BEAM_DIR_LEFT);
+      for (int i = 0; i < N; i++)
+        ok &= out[i * 2] == ref4[i] && out[i * 2 + 1] == ref4[i];
+    }
+    if (!ok) {
+      printf("FAIL: 4-mic pipeline\n");
+      failures++;
+    }
+    pipeline_free(&pl);
+    free(mem);
+    free(in);
+    free(out);
+    free(ref4);
+  }
+
+#ifdef LE_FIXED_POINT
+  // 4. Fixed-point build: the 3-mic chain runs the Q15 GSC
+  {
+    PipelineConfig cfgq;
+    pipeline_default_config(&cfgq);
+    const int N = cfgq.block_frames;
+    Pipeline pl;
+    GscQ15State sq;
+    size_t mem_size = gsc_q15_mem_bytes(&cfgq.gsc);
+    void *mem = malloc(mem_size);
+    float *in = malloc((size_t)N * 3 * sizeof(float));
+    float *out = malloc((size_t)N * 2 * sizeof(float));
+    q15_t *in_q = malloc((size_t)N * 3 * sizeof(q15_t));
+    q15_t *ref_q = malloc((size_t)N * sizeof(q15_t));
+    int ok = pipeline_init(&pl, &cfgq) == 0 && pl.fixed &&
+             gsc_q15_init(&sq, &cfgq.gsc, mem, mem_size) == 0;
+    for (long b = 0; ok && b < 20; b++) {
+      for (int i = 0; i < N; i++) {
+        for (int c = 0; c < 3; c++)
+          in[i * 3 + c] = sample(b * N + i, c) * (1.0f / 32768.0f);
+      }
+      pipeline_process(in, out, N, &pl);
+      float_to_q15_batch(in, in_q, N * 3);
+      gsc_q15_process_block(&sq, in_q, ref_q, N);
+      for (int i = 0; i < N; i++)
+        ok &= out[i * 2] == q15_to_float(ref_q[i]);
+    }
+    if (!ok) {
+      printf("FAIL: fixed-point pipeline\n");
+      failures++;
+    }
+    pipeline_free(&pl);
+    free(mem);
+    free(in);
+    free(out);
+    free(in_q);
+    free(ref_q);
+  }
+#endif
+
+  // 5. Mic DC blockers: one bank lane per mic ahead of the GSC, reset in
+  //    place by pipeline_reuse
+  {
+    PipelineConfig cfgh;
+    pipeline_default_config(&cfgh);
+    cfgh.mics = 4;
+    cfgh.mic_hpf_hz = 20.0f;
+    const int N = cfgh.block_frames;
+    Pipeline pl;
+    GscState st;
+    BiquadBank bk;
+    BiquadState dc;
+    float bk_mem[BIQUAD_BANK_FLOATS(4, 1)];
+    size_t mem_size = gsc_mem_bytes(&cfgh.gsc);
+    void *mem = malloc(mem_size);
+    float *in = malloc((size_t)N * 4 * sizeof(float));
+    float *pre = malloc((size_t)N * 4 * sizeof(float));
+    float *out = malloc((size_t)N * 2 * sizeof(float));
+    float *first = malloc((size_t)N * 2 * sizeof(float));
+    float *ref4 = malloc((size_t)N * sizeof(float));
+    int ok = pipeline_init(&pl, &cfgh) == 0 &&
+             gsc_init(&st, &cfgh.gsc, mem, mem_size) == 0 &&
+             biquad_bank_init(&bk, 4, 1, bk_mem, sizeof(bk_mem)) == 0;
+    if (ok) {
+      gsc_set_power_mode(&st, GSC_POWER_RUNNING);
+      biquad_dc_block(&dc, FS, cfgh.mic_hpf_hz);
+      for (int c = 0; c < 4; c++)
+        biquad_bank_set(&bk, 0, c, &dc);
+    }
+    for (long b = 0; ok && b < 20; b++) {
+      for (int i = 0; i < N; i++) {
+        for (int c = 0; c < 4; c++) // Offset on every mic
+          in[i * 4 + c] = sample(b * N + i, c) * (1.0f / 32768.0f) + 0.1f;
+      }
+      pipeline_process(in, out, N, &pl);
+      biquad_bank_process(&bk, in, 4, pre, N);
+      gsc_process_block_4ch(&st, &cfgh.gsc, pre, ref4, N, BEAM_DIR_FRONT);
+      for (int i = 0; i < N; i++)
+        ok &= out[i * 2] == ref4[i];
+      if (b == 0)
+        memcpy(first, out, (size_t)N * 2 * sizeof(float));
+    }
+    // Same layout: reset in place, the first block comes out again
+    for (int i = 0; ok && i < N; i++) {
+      for (int c = 0; c < 4; c++)
+        in[i * 4 + c] = sample(i, c) * (1.0f / 32768.0f) + 0.1f;
+    }
+    ok = ok && pipeline_reuse(&pl, &cfgh) == 0 && pl.mic_hpf_mem != NULL &&
+         pipeline_process(in, out, N, &pl) == 0 &&
+         memcmp(out, first, (size_t)N * 2 * sizeof(float)) == 0;
+    if (!ok) {
+      printf("FAIL: mic DC blockers\n");
+      failures++;
+    }
+    pipeline_free(&pl);
+    free(mem);
+    free(in);
+    free(pre);
+    free(out);
+    free(first);
+    free(ref4);
+  }
+
+  // 6. Errors are reported, not crashed on
+  opts.in_path = "does_not_exist.wav";
+  opts.raw_channels = 0;
+  if (offline_run(&opts, &cfg, NULL) == 0) {
+    printf("FAIL: missing input accepted\n");
+    failures++;
+  }
+
+  remove(IN_WAV);
+  remove(IN_RAW);
+  remove(OUT_WAV);
+
+  if (failures == 0) {
+    printf("PASS\n");
+    return 0;
+  }
+  printf("FAIL (%d)\n", failures);
+  return 1;
+}
@@ -0,0 +1,172 @@
+/**
+ * @file test_param_mailbox.c
+ * @brief Parameter mailbox: snapshot semantics and torn-read stress test
+ */
+
+#include "../src/utils/param_mailbox.h"
+#include <math.h>
+#include <stdio.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+#define NUM_PUBLISHES 200000
+
+static ParamMailbox g_mb;
+static le_atomic_int g_writer_done;
+
+static DspParams make_params(int k) {
+  DspParams p = {0};
+  p.gsc.M = 64;
+  p.gsc.alpha = (float)k;
+  p.gsc.mu_max = (float)k;
+  p.gsc.leak_lambda = (float)k;
+  p.gsc.g_lo = (float)k;
+  p.gsc.g_hi = (float)k;
+  p.aec_on = k & 1;
+  p.agc_on = k;
+  p.ng_on = k;
+  p.agc_target_db = -(float)(k % 60);
+  p.ng_thresh_db = -(float)(k % 80);
+  return p;
+}
+
+// Every field of a snapshot must come from the same publish
+static int snapshot_consistent(const DspParams *p) {
+  int k = p->agc_on;
+  if (p->gsc.alpha != (float)k || p->gsc.mu_max != (float)k ||
+      p->gsc.leak_lambda != (float)k || p->gsc.g_lo != (float)k ||
+      p->gsc.g_hi != (float)k || p->ng_on != k || p->aec_on != (k & 1))
+    return 0;
+  if (p->agc_target_db != -(float)(k % 60) ||
+      p->ng_thresh_db != -(float)(k % 80))
+    return 0;
+  return fabsf(p->agc_target_rms - powf(10.0f, p->agc_target_db / 20.0f)) <
+         1e-6f;
+}
+
+// Publishes the same way the web server does: edit fields, then publish
+static void writer_body(void) {
+  for (int k = 1; k <= NUM_PUBLISHES; k++) {
+    DspParams *p = param_mailbox_edit(&g_mb);
+    *p = make_params(k);
+    param_mailbox_publish(&g_mb);
+  }
+  le_atomic_store(&g_writer_done, 1);
+}
+
+#ifdef _WIN32
+static DWORD WINAPI writer_thread(LPVOID arg) {
+  (void)arg;
+  writer_body();
+  return 0;
+}
+#else
+static void *writer_thread(void *arg) {
+  (void)arg;
+  writer_body();
+  return NULL;
+}
+#endif
+
+static int test_single_thread(void) {
+  DspParams init = make_params(0);
+  init.agc_target_db = -20.0f;
+  init.ng_thresh_db = -40.0f;
+  param_mailbox_init(&g_mb, &init);
+
+  const DspParams *p = NULL;
+  if (param_mailbox_poll(&g_mb, &p) != 0 || !p || p->version != 0 ||
+      fabsf(p->agc_target_rms - 0.1f) > 1e-6f ||
+      fabsf(p->ng_thresh_linear - 0.01f) > 1e-6f) {
+    printf("FAIL: initial snapshot\n");
+    return 1;
+  }
+
+  // Several publishes between polls: only the newest is seen, once
+  DspParams *w = param_mailbox_edit(&g_mb);
+  w->gsc.alpha = 0.5f;
+  param_mailbox_publish(&g_mb);
+  w = param_mailbox_edit(&g_mb);
+  w->agc_target_db = 0.0f;
+  param_mailbox_publish(&g_mb);
+
+  if (param_mailbox_poll(&g_mb, &p) != 1 || p->version != 2 ||
+      p->gsc.alpha != 0.5f || fabsf(p->agc_target_rms - 1.0f) > 1e-6f ||
+      fabsf(p->ng_thresh_linear - 0.01f) > 1e-6f) {
+    printf("FAIL: latest snapshot not delivered\n");
+    return 1;
+  }
+  if (param_mailbox_poll(&g_mb, &p) != 0 || p->version != 2) {
+    printf("FAIL: snapshot reported as changed twice\n");
+    return 1;
+  }
+  printf("Single thread: OK\n");
+  return 0;
+}
+
+static int test_concurrent(void) {
+  DspParams init = make_params(0);
+  param_mailbox_init(&g_mb, &init);
+  le_atomic_store(&g_writer_done, 0);
+
+#ifdef _WIN32
+  HANDLE th = CreateThread(NULL, 0, writer_thread, NULL, 0, NULL);
+#else
+  pthread_t th;
+  pthread_create(&th, NULL, writer_thread, NULL);
+#endif
+
+  unsigned int last_version = 0;
+  long polls = 0, changes = 0, torn = 0, backwards = 0;
+  for (;;) {
+    int done = le_atomic_load(&g_writer_done);
+    const DspParams *p;
+    if (param_mailbox_poll(&g_mb, &p)) {
+      changes++;
+      if (!snapshot_consistent(p))
+        torn++;
+      if (p->version <= last_version)
+        backwards++;
+      last_version = p->version;
+    }
+    polls++;
+    if (done && last_version == NUM_PUBLISHES)
+      break;
+    if (done && polls > 100L * NUM_PUBLISHES)
+      break;
+  }
+
+#ifdef _WIN32
+  WaitForSingleObject(th, INFINITE);
+  CloseHandle(th);
+#else
+  pthread_join(th, NULL);
+#endif
+
+  printf("Concurrent: %d publishes, %ld snapshots taken, %ld torn, final "
+         "version %u\n",
+         NUM_PUBLISHES, changes, torn, last_version);
+  if (torn || backwards || last_version != NUM_PUBLISHES) {
+    printf("FAIL: inconsistent or lost snapshot\n");
+    return 1;
+  }
+  return 0;
+}
+
+int main(void) {
+  printf("Testing parameter mailbox...\n");
+  int failures = 0;
+  failures += test_single_thread();
+  failures += test_concurrent();
+
+  if (failures == 0) {
+    printf("PASS\n");
+    return 0;
+  }
+  printf("FAIL (%d)\n", failures);
+  return 1;
+}
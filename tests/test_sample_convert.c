@@ -0,0 +1,81 @@
+/**
+ * @file test_sample_convert.c
+ * @brief Float <-> S16/S32 conversion of the native backends: full scale
+ *        and out-of-range values clip to the largest code of the same sign
+ */
+
+#include "../src/audio/sample_convert.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+static int failures = 0;
+
+static void check_s32(float v, int32_t expect) {
+  int32_t got = sample_float_to_s32(v);
+  if (got != expect) {
+    printf("FAIL: s32(%.9g) = %ld, expected %ld\n", (double)v, (long)got,
+           (long)expect);
+    failures++;
+  }
+}
+
+static void check_s16(float v, int16_t expect) {
+  int16_t got = sample_float_to_s16(v);
+  if (got != expect) {
+    printf("FAIL: s16(%.9g) = %d, expected %d\n", (double)v, got, expect);
+    failures++;
+  }
+}
+
+int main(void) {
+  printf("Testing sample conversion...\n");
+  const float above = nextafterf(1.0f, 2.0f);
+  const float below = nextafterf(-1.0f, -2.0f);
+
+  // Full scale and just outside: never wraps to the opposite sign
+  check_s32(1.0f, INT32_MAX);
+  check_s32(-1.0f, -INT32_MAX);
+  check_s32(above, INT32_MAX);
+  check_s32(below, -INT32_MAX);
+  check_s32(4.0f, INT32_MAX);
+  check_s32(-4.0f, -INT32_MAX);
+  check_s32(INFINITY, INT32_MAX);
+  check_s32(-INFINITY, -INT32_MAX);
+  check_s32(NAN, INT32_MAX);
+  check_s32(0.0f, 0);
+  check_s32(0.5f, 1073741823);
+
+  check_s16(1.0f, 32767);
+  check_s16(-1.0f, -32767);
+  check_s16(above, 32767);
+  check_s16(below, -32767);
+  check_s16(4.0f, 32767);
+  check_s16(-4.0f, -32767);
+  check_s16(NAN, 32767);
+  check_s16(0.0f, 0);
+  check_s16(0.5f, 16383);
+
+  // S16 -> float -> S16 keeps the sample within one code (2^15 vs
+  // 2^15 - 1 scaling, truncated toward zero)
+  for (int32_t x = -32768 + 1; x <= 32767; x += 97) {
+    int16_t y = sample_float_to_s16(sample_s16_to_float((int16_t)x));
+    if (abs(y - x) > 1) {
+      printf("FAIL: s16 round trip %d -> %d\n", x, y);
+      failures++;
+      break;
+    }
+  }
+  if (sample_s32_to_float(INT32_MIN) != -1.0f ||
+      sample_s16_to_float(INT16_MIN) != -1.0f) {
+    printf("FAIL: negative full scale does not read as -1\n");
+    failures++;
+  }
+
+  if (failures == 0) {
+    printf("PASS\n");
+    return 0;
+  }
+  printf("FAIL (%d)\n", failures);
+  return 1;
+}
@@ -0,0 +1,161 @@
+/**
+ * @file test_scope_tap.c
+ * @brief Scope tap: spectrum peaks, blocking-matrix channels, frame rate
+ */
+
+#include "../src/dsp/scope_tap.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#define FS 16000
+#define BLOCK 480 // Callback block size used by main.c
+#define SECONDS 2
+
+static uint16_t get_u16(const uint8_t *p) {
+  return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static float half_to_float(uint16_t h) {
+  int exp = (h >> 10) & 0x1F;
+  int mant = h & 0x3FF;
+  float v;
+  if (exp == 0)
+    v = ldexpf((float)mant, -24);
+  else if (exp == 31)
+    v = INFINITY;
+  else
+    v = ldexpf((float)(mant | 0x400), exp - 25);
+  return (h & 0x8000) ? -v : v;
+}
+
+static int peak_bin(const uint8_t *spec, int bins) {
+  int best = 0;
+  for (int k = 1; k < bins; k++) {
+    if (spec[k] > spec[best])
+      best = k;
+  }
+  return best;
+}
+
+int main(void) {
+  printf("Testing scope tap...\n");
+  int failures = 0;
+
+  ScopeConfig cfg = {.fft_size = 512, .rate_hz = 10, .wave_points = 128};
+  size_t bytes = scope_tap_mem_bytes(&cfg);
+  void *mem = malloc(bytes);
+  ScopeTap st;
+  if (!bytes || scope_tap_init(&st, &cfg, FS, mem, bytes) != 0) {
+    printf("FAIL: init\n");
+    return 1;
+  }
+
+  size_t frame_cap = scope_tap_frame_bytes(&st);
+  uint8_t *frame = malloc(frame_cap);
+  float in[BLOCK * 3], out[BLOCK];
+
+  // L: 1 kHz full scale, R: 3 kHz at -20 dB, B: silent, out: 2 kHz at -6 dB.
+  // U1 = L - R holds both tones, U2 = (L + R) / 2 holds both at -6 dB.
+  int frames_sent = 0;
+  size_t last_len = 0;
+  uint8_t *last = malloc(frame_cap);
+  long n = 0;
+  for (int b = 0; b < FS * SECONDS / BLOCK; b++) {
+    for (int i = 0; i < BLOCK; i++, n++) {
+      double t = (double)n / FS;
+      in[i * 3 + 0] = (float)sin(2.0 * M_PI * 1000.0 * t);
+      in[i * 3 + 1] = (float)(0.1 * sin(2.0 * M_PI * 3000.0 * t));
+      in[i * 3 + 2] = 0.0f;
+      out[i] = (float)(0.5 * sin(2.0 * M_PI * 2000.0 * t));
+    }
+    scope_tap_push(&st, in, out, BLOCK, 0.0f);
+    size_t len = scope_tap_poll(&st, frame, frame_cap);
+    if (len > 0) {
+      frames_sent++;
+      memcpy(last, frame, len);
+      last_len = len;
+    }
+  }
+
+  int expect = SECONDS * cfg.rate_hz;
+  printf("Frames: %d in %d s (rate %d Hz), %u bytes each\n", frames_sent,
+         SECONDS, cfg.rate_hz, (unsigned)last_len);
+  if (frames_sent < expect - 1 || frames_sent > expect + 1 ||
+      last_len != frame_cap) {
+    printf("FAIL: frame rate or size\n");
+    failures++;
+  }
+
+  int bins = get_u16(last + 4);
+  int wave = get_u16(last + 6);
+  const uint8_t *spec = last + SCOPE_HEADER_BYTES;
+  const uint8_t *wav = spec + SCOPE_CHANNELS * bins;
+  int k1 = 1000 * 512 / FS, k2 = 2000 * 512 / FS, k3 = 3000 * 512 / FS;
+  float db_per_step = (SCOPE_DB_MAX - SCOPE_DB_MIN) / 255.0f;
+
+  // Peaks in the right bins, levels relative to full scale
+  float l_db = SCOPE_DB_MIN + spec[0 * bins + k1] * db_per_step;
+  float r_db = SCOPE_DB_MIN + spec[1 * bins + k3] * db_per_step;
+  printf("L peak bin %d (%.1f dB), R peak bin %d (%.1f dB), out peak bin %d\n",
+         peak_bin(spec, bins), l_db, peak_bin(spec + bins, bins), r_db,
+         peak_bin(spec + 3 * bins, bins));
+  if (bins != 257 || wave != 128 || peak_bin(spec, bins) != k1 ||
+      peak_bin(spec + bins, bins) != k3 ||
+      peak_bin(spec + 3 * bins, bins) != k2 || fabsf(l_db) > 1.0f ||
+      fabsf(r_db + 20.0f) > 1.0f || spec[2 * bins + k1] != 0) {
+    printf("FAIL: channel spectra\n");
+    failures++;
+  }
+  // Blocking-matrix references
+  const uint8_t *u1 = spec + 4 * bins;
+  const uint8_t *u2 = spec + 5 * bins;
+  float u2_db = SCOPE_DB_MIN + u2[k1] * db_per_step;
+  if (u1[k1] < spec[k1] - 2 || u1[k3] < spec[bins + k3] - 2 ||
+      fabsf(u2_db + 6.0f) > 1.0f) {
+    printf("FAIL: blocking-matrix references (U2 %.1f dB)\n", u2_db);
+    failures++;
+  }
+
+  // Waveform of L stays within full scale and is not silent
+  float wmax = 0.0f;
+  for (int w = 0; w < wave; w++) {
+    float v = fabsf(half_to_float(get_u16(wav + 2 * w)));
+    if (v > wmax)
+      wmax = v;
+  }
+  if (wmax < 0.9f || wmax > 1.001f) {
+    printf("FAIL: waveform peak %.3f\n", wmax);
+    failures++;
+  }
+
+  // Ring full: pushes are dropped without blocking, the tap keeps working
+  for (int b = 0; b < 4 * SCOPE_RING_BLOCKS; b++)
+    scope_tap_push(&st, in, out, BLOCK, 0.0f);
+  for (int b = 0; b < FS / BLOCK; b++) {
+    scope_tap_push(&st, in, out, BLOCK, 0.0f);
+    scope_tap_poll(&st, frame, frame_cap);
+  }
+
+  ScopeConfig bad = cfg;
+  bad.wave_points = 300;
+  if (scope_tap_mem_bytes(&bad) != 0) {
+    printf("FAIL: invalid config accepted\n");
+    failures++;
+  }
+
+  free(last);
+  free(frame);
+  free(mem);
+  if (failures == 0) {
+    printf("PASS\n");
+    return 0;
+  }
+  printf("FAIL (%d)\n", failures);
+  return 1;
+}
@@ -0,0 +1,310 @@
+/**
+ * @file test_simd_dispatch.c
+ * @brief Runtime SIMD dispatch: every variant the CPU can run matches the
+ *        scalar kernels (tails, aliasing, short FFT spans), and modules pick
+ *        up the selected table
+ */
+
+#include "../src/dsp/gsc.h"
+#include "../src/dsp/le_fft.h"
+#include "../src/dsp/simd_dispatch.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_M 80
+#define MAX_H 64
+#define FFT_N 512
+#define BQ_LANES 19
+#define BQ_STAGES 6
+#define BQ_STRIDE 24 // BQ_LANES rounded up to a vector of 8
+#define BQ_FRAMES 37
+
+static float randf(void) {
+  return ((float)rand() / (float)RAND_MAX) * 2.0f - 1.0f;
+}
+
+static void fill(float *x, int n) {
+  for (int i = 0; i < n; i++)
+    x[i] = randf();
+}
+
+static float max_diff(const float *a, const float *b, int n) {
+  float d = 0.0f;
+  for (int i = 0; i < n; i++)
+    d = fmaxf(d, fabsf(a[i] - b[i]));
+  return d;
+}
+
+// Largest magnitude, at least 1
+static float peak(const float *x, int n) {
+  float p = 1.0f;
+  for (int i = 0; i < n; i++)
+    p = fmaxf(p, fabsf(x[i]));
+  return p;
+}
+
+// Stable random sections (poles inside radius 0.95), zero state
+static void fill_biquads(float *coef, float *z) {
+  for (int s = 0; s < BQ_STAGES; s++) {
+    float *c = coef + s * 5 * BQ_STRIDE;
+    for (int l = 0; l < BQ_STRIDE; l++) {
+      float r = 0.95f * fabsf(randf()), th = 3.14159f * fabsf(randf());
+      c[l] = randf();
+      c[BQ_STRIDE + l] = randf();
+      c[2 * BQ_STRIDE + l] = randf();
+      c[3 * BQ_STRIDE + l] = -2.0f * r * cosf(th);
+      c[4 * BQ_STRIDE + l] = r * r;
+    }
+  }
+  memset(z, 0, 2 * BQ_STAGES * BQ_STRIDE * sizeof(float));
+}
+
+// Biquad banks of every lane count and stage depth, mono and interleaved
+// (in place) input; returns failures
+static int check_biquad_bank(const LeSimdKernels *k, const LeSimdKernels *ref) {
+  const char *name = le_simd_name(k->level);
+  const float tol = 1e-5f; // Relative: resonant cascades amplify rounding
+  static float coef[5 * BQ_STAGES * BQ_STRIDE];
+  static float z_ref[2 * BQ_STAGES * BQ_STRIDE], z[2 * BQ_STAGES * BQ_STRIDE];
+  static float in[BQ_FRAMES * BQ_LANES];
+  static float o_ref[BQ_FRAMES * BQ_LANES], o[BQ_FRAMES * BQ_LANES];
+  int failures = 0;
+
+  for (int lanes = 1; lanes <= BQ_LANES; lanes++) {
+    for (int stages = 1; stages <= BQ_STAGES; stages++) {
+      int n = BQ_FRAMES * lanes;
+      fill_biquads(coef, z_ref);
+      fill(in, n);
+      memcpy(z, z_ref, sizeof(z));
+
+      // Mono: one signal through every lane, two blocks to carry the state
+      for (int b = 0; b < 2; b++) {
+        ref->biquad_bank(coef, z_ref, BQ_STRIDE, lanes, stages, in, 0, o_ref,
+                         BQ_FRAMES);
+        k->biquad_bank(coef, z, BQ_STRIDE, lanes, stages, in, 0, o,
+                       BQ_FRAMES);
+      }
+      if (max_diff(o_ref, o, n) > tol * peak(o_ref, n) ||
+          max_diff(z_ref, z, 2 * BQ_STAGES * BQ_STRIDE) >
+              tol * peak(o_ref, n)) {
+        printf("FAIL: %s biquad_bank mono lanes=%d stages=%d\n", name, lanes,
+               stages);
+        failures++;
+      }
+
+      // Interleaved, out aliasing in
+      memcpy(o_ref, in, n * sizeof(float));
+      memcpy(o, in, n * sizeof(float));
+      ref->biquad_bank(coef, z_ref, BQ_STRIDE, lanes, stages, o_ref, lanes,
+                       o_ref, BQ_FRAMES);
+      k->biquad_bank(coef, z, BQ_STRIDE, lanes, stages, o, lanes, o,
+                     BQ_FRAMES);
+      if (max_diff(o_ref, o, n) > tol * peak(o_ref, n)) {
+        printf("FAIL: %s biquad_bank in place lanes=%d stages=%d\n", name,
+               lanes, stages);
+        failures++;
+      }
+    }
+  }
+  return failures;
+}
+
+// Compare one variant against the scalar table; returns failures
+static int check_kernels(const LeSimdKernels *k, const LeSimdKernels *ref) {
+  const char *name = le_simd_name(k->level);
+  const float tol = 1e-4f;
+  int failures = 0;
+
+  // Lengths around every vector width, including pure tails
+  for (int M = 1; M <= MAX_M; M++) {
+    float w1[MAX_M], w2[MAX_M], u1[MAX_M], u2[MAX_M];
+    fill(w1, M);
+    fill(w2, M);
+    fill(u1, M);
+    fill(u2, M);
+
+    float d_ref = ref->dot2(w1, u1, w2, u2, M);
+    float e_ref = ref->energy2(u1, u2, M);
+    if (fabsf(k->dot2(w1, u1, w2, u2, M) - d_ref) > tol * M ||
+        fabsf(k->energy2(u1, u2, M) - e_ref) > tol * M) {
+      printf("FAIL: %s dot2/energy2 M=%d\n", name, M);
+      failures++;
+    }
+
+    float a1[MAX_M], a2[MAX_M];
+    memcpy(a1, w1, sizeof(w1));
+    memcpy(a2, w2, sizeof(w2));
+    ref->update2(w1, u1, w2, u2, M, 0.999f, 0.01f);
+    k->update2(a1, u1, a2, u2, M, 0.999f, 0.01f);
+    if (max_diff(a1, w1, M) > tol || max_diff(a2, w2, M) > tol) {
+      printf("FAIL: %s update2 M=%d\n", name, M);
+      failures++;
+    }
+
+    // Spectrum MACs (out aliasing W, as the AEC update does)
+    float acc_re[MAX_M], acc_im[MAX_M], b_re[MAX_M], b_im[MAX_M];
+    fill(acc_re, M);
+    fill(acc_im, M);
+    memcpy(b_re, acc_re, sizeof(acc_re));
+    memcpy(b_im, acc_im, sizeof(acc_im));
+    ref->cmac(acc_re, acc_im, w1, w2, u1, u2, M);
+    k->cmac(b_re, b_im, w1, w2, u1, u2, M);
+    if (max_diff(acc_re, b_re, M) > tol || max_diff(acc_im, b_im, M) > tol) {
+      printf("FAIL: %s cmac n=%d\n", name, M);
+      failures++;
+    }
+    ref->cmac_conj(acc_re, acc_im, acc_re, acc_im, w1, w2, u1, u2, M);
+    k->cmac_conj(b_re, b_im, b_re, b_im, w1, w2, u1, u2, M);
+    if (max_diff(acc_re, b_re, M) > tol || max_diff(acc_im, b_im, M) > tol) {
+      printf("FAIL: %s cmac_conj n=%d\n", name, M);
+      failures++;
+    }
+  }
+
+  // Every radix-4 span, short ones included
+  for (int h = 1; h <= MAX_H; h *= 2) {
+    float tw[4 * MAX_H], re[4 * MAX_H + 16], im[4 * MAX_H + 16];
+    float r2[4 * MAX_H + 16], i2[4 * MAX_H + 16];
+    fill(tw, 4 * h);
+    fill(re, 4 * h + 16);
+    fill(im, 4 * h + 16);
+    memcpy(r2, re, sizeof(re));
+    memcpy(i2, im, sizeof(im));
+    ref->fft_radix4(re, im, h, tw);
+    k->fft_radix4(r2, i2, h, tw);
+    // The 16 guard values past the group must be untouched
+    if (max_diff(re, r2, 4 * h + 16) > tol ||
+        max_diff(im, i2, 4 * h + 16) > tol) {
+      printf("FAIL: %s fft_radix4 h=%d\n", name, h);
+      failures++;
+    }
+  }
+  return failures + check_biquad_bank(k, ref);
+}
+
+int main(void) {
+  printf("Testing SIMD dispatch...\n");
+  int failures = 0;
+  srand(42);
+
+  LeSimdLevel best = le_simd_detect();
+  printf("  detected: %s; available:", le_simd_name(best));
+  for (int l = 0; l < LE_SIMD_COUNT; l++) {
+    if (le_simd_kernels_for((LeSimdLevel)l))
+      printf(" %s", le_simd_name((LeSimdLevel)l));
+  }
+  printf("\n");
+
+  // 1. Scalar is always there; the active table defaults to the best one
+  const LeSimdKernels *ref = le_simd_kernels_for(LE_SIMD_SCALAR);
+  if (!ref || !le_simd_kernels_for(best) ||
+      le_simd_kernels()->level != best) {
+    printf("FAIL: default selection\n");
+    failures++;
+  }
+  // le_simd_init only selects once: it never undoes an override
+  le_simd_set_level(LE_SIMD_SCALAR);
+  le_simd_init();
+  if (le_simd_kernels() != ref) {
+    printf("FAIL: le_simd_init replaced the selected level\n");
+    failures++;
+  }
+  le_simd_set_level(best);
+
+  // 2. Names round-trip; unknown names and unavailable levels are refused
+  for (int l = 0; l < LE_SIMD_COUNT; l++) {
+    if (le_simd_parse(le_simd_name((LeSimdLevel)l)) != l) {
+      printf("FAIL: name round-trip %d\n", l);
+      failures++;
+    }
+  }
+  if (le_simd_parse("mmx") != -1 || le_simd_parse(NULL) != -1 ||
+      le_simd_set_level(LE_SIMD_COUNT) != -1) {
+    printf("FAIL: invalid names / levels accepted\n");
+    failures++;
+  }
+
+  // 3. Every runnable variant matches the scalar reference
+  for (int l = 0; l < LE_SIMD_COUNT; l++) {
+    const LeSimdKernels *k = le_simd_kernels_for((LeSimdLevel)l);
+    if (k)
+      failures += check_kernels(k, ref);
+  }
+
+  // 4. Modules latch the table active at init: same GSC output and FFT
+  //    spectrum from every variant
+  GscConfig cfg = {.M = 64,
+                   .alpha = 0.005f,
+                   .eps = 1e-6f,
+                   .mu_max = 0.1f,
+                   .eta_max = 0.01f,
+                   .leak_lambda = 1e-4f,
+                   .g_lo = 0.3f,
+                   .g_hi = 0.7f,
+                   .beta_min = 0.0f,
+                   .beta_max = 1.0f};
+  static float gsc_mem[6 * 64], in[3 * 2000], out_ref[2000], out[2000];
+  static float fft_mem[4 * FFT_N], src_re[FFT_N], src_im[FFT_N];
+  static float re_ref[FFT_N], im_ref[FFT_N], re[FFT_N], im[FFT_N];
+  // One source in all three mics plus independent noise, so beta converges
+  // and the NLMS filter actually adapts
+  for (int n = 0; n < 2000; n++) {
+    float src = randf();
+    for (int c = 0; c < 3; c++)
+      in[3 * n + c] = src + 0.3f * randf();
+  }
+  fill(src_re, FFT_N);
+  fill(src_im, FFT_N);
+
+  // Scalar (level 0) runs first and produces the reference
+  for (int l = 0; l < LE_SIMD_COUNT; l++) {
+    if (le_simd_set_level((LeSimdLevel)l) != 0)
+      continue;
+    GscState st;
+    LeFftPlan plan;
+    if (gsc_init(&st, &cfg, gsc_mem, sizeof(gsc_mem)) != 0 ||
+        le_fft_plan_init(&plan, FFT_N, fft_mem, sizeof(fft_mem)) != 0 ||
+        st.simd->level != (LeSimdLevel)l ||
+        plan.simd->level != (LeSimdLevel)l) {
+      printf("FAIL: %s not picked up at init\n",
+             le_simd_name((LeSimdLevel)l));
+      failures++;
+      continue;
+    }
+    const int is_ref = (l == LE_SIMD_SCALAR);
+    float *o = is_ref ? out_ref : out;
+    float *r = is_ref ? re_ref : re;
+    float *i = is_ref ? im_ref : im;
+    gsc_process_block(&st, &cfg, in, o, 2000);
+    memcpy(r, src_re, sizeof(src_re));
+    memcpy(i, src_im, sizeof(src_im));
+    le_fft_complex(&plan, r, i, 0);
+    if (is_ref)
+      continue;
+
+    float d_gsc = max_diff(out, out_ref, 2000);
+    if (st.last_mu <= 0.0f) {
+      printf("FAIL: GSC did not adapt\n");
+      failures++;
+    }
+    float d_fft =
+        fmaxf(max_diff(re, re_ref, FFT_N), max_diff(im, im_ref, FFT_N));
+    printf("  %-6s gsc max diff %.2e, fft max diff %.2e\n",
+           le_simd_name((LeSimdLevel)l), d_gsc, d_fft);
+    if (d_gsc > 1e-4f || d_fft > 1e-3f) {
+      printf("FAIL: %s output differs from scalar\n",
+             le_simd_name((LeSimdLevel)l));
+      failures++;
+    }
+  }
+  le_simd_set_level(best);
+
+  if (failures == 0) {
+    printf("PASS\n");
+    return 0;
+  }
+  printf("FAIL (%d)\n", failures);
+  return 1;
+}
@@ -0,0 +1,136 @@
+/**
+ * @file test_stage_profile.c
+ * @brief Stage profiler: the output is unchanged, every stage is charged
+ *        with the samples it ran on, intervals and JSON
+ */
+
+#include "../src/app/pipeline.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#define FS 16000
+#define N 480
+#define BLOCKS 50
+
+static void make_block(float *in, int b) {
+  for (int i = 0; i < N; i++) {
+    double t = (double)(b * N + i) / FS;
+    in[i * 3 + 0] = (float)(0.3 * sin(2.0 * M_PI * 440.0 * t));
+    in[i * 3 + 1] = (float)(0.3 * sin(2.0 * M_PI * 440.0 * t + 0.2));
+    in[i * 3 + 2] = (float)(0.1 * sin(2.0 * M_PI * 1250.0 * t));
+  }
+}
+
+int main(void) {
+  printf("Testing stage profiler...\n");
+  int failures = 0;
+
+  // 1. 64-bit totals do not wrap past 2^32 cycles
+  PerfMetrics pm;
+  perf_reset(&pm);
+  perf_update(&pm, 1000, 3000000000ull);
+  perf_update(&pm, 1000, 3000000000ull);
+  if (pm.total_cycles != 6000000000ull || pm.samples_processed != 2000 ||
+      fabsf(pm.avg_cycles_per_sample - 3e6f) > 1.0f) {
+    printf("FAIL: PerfMetrics overflow\n");
+    failures++;
+  }
+
+  // 2. Same chain with and without the profile: bit-identical output
+  PipelineConfig cfg;
+  pipeline_default_config(&cfg);
+  cfg.agc_on = 1;
+  cfg.ng_on = 1;
+  Pipeline a, b;
+  if (pipeline_init(&a, &cfg) != 0 || pipeline_init(&b, &cfg) != 0) {
+    printf("FAIL: pipeline_init\n");
+    return 1;
+  }
+  StageProfile profile;
+  stage_profile_init(&profile);
+  b.profile = &profile;
+  if (profile.ticks_per_us <= 0.0) {
+    printf("FAIL: tick rate %.3f\n", profile.ticks_per_us);
+    failures++;
+  }
+
+  float in[N * 3], out_a[N * 2], out_b[N * 2];
+  StageProfileStats half, end, d;
+  int mismatch = 0;
+  for (int k = 0; k < BLOCKS; k++) {
+    make_block(in, k);
+    pipeline_process(in, out_a, N, &a);
+    pipeline_process(in, out_b, N, &b);
+    if (memcmp(out_a, out_b, sizeof(out_a)) != 0)
+      mismatch++;
+    if (k == BLOCKS / 2 - 1)
+      stage_profile_snapshot(&profile, &half);
+  }
+  stage_profile_snapshot(&profile, &end);
+  if (mismatch) {
+    printf("FAIL: %d blocks differ with profiling on\n", mismatch);
+    failures++;
+  }
+
+  // 3. Every stage that ran saw every sample; the AEC was off
+  const uint64_t total = (uint64_t)BLOCKS * N;
+  if (end.blocks != BLOCKS ||
+      end.stage[PIPE_STAGE_GSC].samples_processed != total ||
+      end.stage[PIPE_STAGE_AGC].samples_processed != total ||
+      end.stage[PIPE_STAGE_GATE].samples_processed != total ||
+      end.stage[PIPE_STAGE_OUTPUT].samples_processed != total ||
+      end.stage[PIPE_STAGE_AEC].samples_processed != 0 ||
+      end.stage[PIPE_STAGE_GSC].total_cycles == 0 ||
+      end.stage[PIPE_STAGE_AEC].avg_cycles_per_sample != 0.0f) {
+    printf("FAIL: stage sample counts\n");
+    failures++;
+  }
+  for (int i = 0; i < PIPE_STAGE_COUNT; i++) {
+    printf("  %-6s %9.1f ticks/sample %8.2f us/block\n",
+           stage_profile_name((PipelineStage)i),
+           end.stage[i].avg_cycles_per_sample,
+           stage_profile_us_per_block(&end, (PipelineStage)i));
+  }
+
+  // 4. Interval = second half only
+  stage_profile_diff(&end, &half, &d);
+  if (d.blocks != BLOCKS / 2 ||
+      d.stage[PIPE_STAGE_GSC].samples_processed != total / 2 ||
+      d.stage[PIPE_STAGE_GSC].total_cycles >
+          end.stage[PIPE_STAGE_GSC].total_cycles) {
+    printf("FAIL: interval difference\n");
+    failures++;
+  }
+
+  // 5. JSON export
+  char json[1024];
+  size_t len = stage_profile_format_json(&end, json, sizeof(json));
+  if (len == 0 || len != strlen(json) ||
+      strncmp(json, "{\"type\":\"profile\"", 17) != 0 ||
+      !strstr(json, "\"name\":\"gate\"") || json[len - 1] != '}' ||
+      stage_profile_format_json(&end, json, 32) != 0) {
+    printf("FAIL: JSON\n");
+    failures++;
+  }
+
+  // 6. pipeline_reuse keeps the profile
+  if (pipeline_reuse(&b, &cfg) != 0 || b.profile != &profile) {
+    printf("FAIL: profile dropped by pipeline_reuse\n");
+    failures++;
+  }
+
+  pipeline_free(&a);
+  pipeline_free(&b);
+  if (failures == 0) {
+    printf("PASS\n");
+    return 0;
+  }
+  printf("FAIL (%d)\n", failures);
+  return 1;
+}
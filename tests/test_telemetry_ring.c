@@ -0,0 +1,201 @@
+/**
+ * @file test_telemetry_ring.c
+ * @brief Record ring (audio -> server telemetry) and batch packing
+ */
+
+#include "../src/dsp/ring_buffer.h"
+#include "../src/utils/telemetry.h"
+#include <stdio.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+#define RING_RECORDS 64
+#define NUM_RECORDS 500000
+
+static TelemetryRecord g_storage[RING_RECORDS];
+static RecordRing g_ring;
+static le_atomic_int g_dropped;
+
+static void fill_record(TelemetryRecord *rec, uint32_t seq) {
+  memset(rec, 0, sizeof(*rec));
+  rec->seq = seq;
+  rec->frames = 480;
+  rec->rms_l = (float)seq;
+  rec->beta = -(float)seq;
+  rec->phase[2] = (float)(seq & 0xFF);
+}
+
+// Producer behaves like process_audio: never waits, counts rejected records
+static void producer_body(void) {
+  TelemetryRecord rec;
+  for (uint32_t seq = 1; seq <= NUM_RECORDS; seq++) {
+    // Some work between blocks so the consumer can keep up most of the time
+    for (volatile int k = 0; k < 100; k++) {
+    }
+    fill_record(&rec, seq);
+    if (record_ring_push(&g_ring, &rec) != 0)
+      le_atomic_fetch_add(&g_dropped, 1);
+  }
+}
+
+#ifdef _WIN32
+static DWORD WINAPI producer_thread(LPVOID arg) {
+  (void)arg;
+  producer_body();
+  return 0;
+}
+#else
+static void *producer_thread(void *arg) {
+  (void)arg;
+  producer_body();
+  return NULL;
+}
+#endif
+
+static int test_single_thread(void) {
+  record_ring_init(&g_ring, g_storage, sizeof(TelemetryRecord), RING_RECORDS);
+  TelemetryRecord rec, out[RING_RECORDS];
+
+  for (uint32_t i = 0; i < RING_RECORDS; i++) {
+    fill_record(&rec, i);
+    if (record_ring_push(&g_ring, &rec) != 0) {
+      printf("FAIL: push rejected before the ring is full\n");
+      return 1;
+    }
+  }
+  fill_record(&rec, 999);
+  if (record_ring_push(&g_ring, &rec) != -1) {
+    printf("FAIL: push accepted into a full ring\n");
+    return 1;
+  }
+
+  unsigned int n = record_ring_pop_batch(&g_ring, out, 10);
+  n += record_ring_pop_batch(&g_ring, out + 10, RING_RECORDS);
+  if (n != RING_RECORDS || record_ring_read_available(&g_ring) != 0) {
+    printf("FAIL: popped %u records\n", n);
+    return 1;
+  }
+  for (uint32_t i = 0; i < RING_RECORDS; i++) {
+    if (out[i].seq != i || out[i].rms_l != (float)i) {
+      printf("FAIL: record %u out of order\n", i);
+      return 1;
+    }
+  }
+
+  if (record_ring_init(&g_ring, g_storage, sizeof(TelemetryRecord), 48) !=
+      -1) {
+    printf("FAIL: non power-of-2 capacity accepted\n");
+    return 1;
+  }
+  printf("Single thread: OK\n");
+  return 0;
+}
+
+// Every record is either received intact and in order, or counted as dropped
+static int test_concurrent(void) {
+  record_ring_init(&g_ring, g_storage, sizeof(TelemetryRecord), RING_RECORDS);
+  le_atomic_store(&g_dropped, 0);
+
+#ifdef _WIN32
+  HANDLE th = CreateThread(NULL, 0, producer_thread, NULL, 0, NULL);
+#else
+  pthread_t th;
+  pthread_create(&th, NULL, producer_thread, NULL);
+#endif
+
+  TelemetryRecord batch[16];
+  uint32_t last_seq = 0;
+  long received = 0, corrupt = 0;
+  while (last_seq < NUM_RECORDS &&
+         received + le_atomic_load(&g_dropped) < NUM_RECORDS) {
+    unsigned int n = record_ring_pop_batch(&g_ring, batch, 16);
+    for (unsigned int i = 0; i < n; i++) {
+      const TelemetryRecord *r = &batch[i];
+      if (r->seq <= last_seq || r->rms_l != (float)r->seq ||
+          r->beta != -(float)r->seq || r->phase[2] != (float)(r->seq & 0xFF))
+        corrupt++;
+      last_seq = r->seq;
+      received++;
+    }
+  }
+
+#ifdef _WIN32
+  WaitForSingleObject(th, INFINITE);
+  CloseHandle(th);
+#else
+  pthread_join(th, NULL);
+#endif
+  received += record_ring_pop_batch(&g_ring, batch, 16);
+
+  long dropped = le_atomic_load(&g_dropped);
+  printf("Concurrent: %d pushed, %ld received, %ld dropped, %ld corrupt\n",
+         NUM_RECORDS, received, dropped, corrupt);
+  if (corrupt || received + dropped != NUM_RECORDS) {
+    printf("FAIL: lost or corrupt records\n");
+    return 1;
+  }
+  return 0;
+}
+
+static uint32_t get_u32(const uint8_t *p) {
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) |
+         ((uint32_t)p[3] << 24);
+}
+
+static float get_f32(const uint8_t *p) {
+  uint32_t v = get_u32(p);
+  float f;
+  memcpy(&f, &v, sizeof(f));
+  return f;
+}
+
+static int test_pack(void) {
+  TelemetryRecord recs[3];
+  uint8_t frame[TELEMETRY_HEADER_BYTES + 3 * TELEMETRY_RECORD_BYTES];
+  for (int i = 0; i < 3; i++)
+    fill_record(&recs[i], (uint32_t)(100 + i));
+  recs[2].dsp_us = 123.5f;
+
+  size_t len = telemetry_pack_batch(recs, 3, 7, frame, sizeof(frame));
+  const uint8_t *r2 =
+      frame + TELEMETRY_HEADER_BYTES + 2 * TELEMETRY_RECORD_BYTES;
+  if (len != sizeof(frame) || frame[0] != TELEMETRY_FRAME_KIND ||
+      frame[1] != TELEMETRY_FRAME_VERSION || frame[2] != 3 || frame[3] != 0 ||
+      get_u32(frame + 4) != 7 || get_u32(r2) != 102 ||
+      get_f32(r2 + 8 + 7 * 4) != 123.5f ||
+      get_f32(r2 + 8 + 14 * 4) != (float)(102 & 0xFF)) {
+    printf("FAIL: packed batch layout\n");
+    return 1;
+  }
+  if (telemetry_pack_batch(recs, 3, 0, frame, sizeof(frame) - 1) != 0) {
+    printf("FAIL: pack overflowed the output buffer\n");
+    return 1;
+  }
+  if (sizeof(TelemetryRecord) != TELEMETRY_RECORD_BYTES) {
+    printf("FAIL: TelemetryRecord is padded (%u bytes)\n",
+           (unsigned)sizeof(TelemetryRecord));
+    return 1;
+  }
+  printf("Batch packing: OK\n");
+  return 0;
+}
+
+int main(void) {
+  printf("Testing telemetry ring...\n");
+  int failures = 0;
+  failures += test_single_thread();
+  failures += test_concurrent();
+  failures += test_pack();
+
+  if (failures == 0) {
+    printf("PASS\n");
+    return 0;
+  }
+  printf("FAIL (%d)\n", failures);
+  return 1;
+}
@@ -0,0 +1,162 @@
+/**
+ * @file test_tuner.c
+ * @brief GSC tuner: SI-SNR scoring, thread-count independence, grid and
+ *        adaptive search never lose to the base config
+ */
+
+#include "../src/app/tuner.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#define FS 16000
+#define SECONDS 3
+
+static float randf(unsigned *s) {
+  *s = *s * 1664525u + 1013904223u;
+  return (float)(*s >> 8) * (2.0f / 16777216.0f) - 1.0f;
+}
+
+// Frontal talker (identical on L/R and the back mic) plus a noise source
+// that reaches L and R with different delays and B only weakly
+static void make_scene(float *in, float *target, long frames, int variant) {
+  unsigned seed = 1234u + (unsigned)variant;
+  unsigned seed_b = 99u + (unsigned)variant;
+  float noise_hist[8] = {0};
+  float g = 0.5f + 0.1f * variant;
+  for (long n = 0; n < frames; n++) {
+    double t = (double)n / FS;
+    double env = 0.6 + 0.4 * sin(2.0 * M_PI * 3.0 * t);
+    float s = (float)(0.3 * env *
+                      (sin(2.0 * M_PI * 220.0 * t) +
+                       0.5 * sin(2.0 * M_PI * 440.0 * t + 0.3) +
+                       0.25 * sin(2.0 * M_PI * 660.0 * t + 1.1)));
+    memmove(noise_hist + 1, noise_hist, 7 * sizeof(float));
+    noise_hist[0] = 0.3f * randf(&seed);
+    in[n * 3 + 0] = s + g * noise_hist[2];
+    in[n * 3 + 1] = s + g * noise_hist[5];
+    in[n * 3 + 2] = s + 0.2f * noise_hist[0] + 0.01f * randf(&seed_b);
+    target[n] = s;
+  }
+}
+
+int main(void) {
+  printf("Testing GSC tuner...\n");
+  int failures = 0;
+
+  long frames = FS * SECONDS;
+  float *in = malloc((size_t)frames * 3 * sizeof(float));
+  float *target = malloc((size_t)frames * sizeof(float));
+  TuneCorpus corpus;
+  memset(&corpus, 0, sizeof(corpus));
+  for (int v = 0; v < 3; v++) {
+    char name[32];
+    snprintf(name, sizeof(name), "scene%d", v);
+    make_scene(in, target, frames - 777 * v, v);
+    if (tune_corpus_add(&corpus, name, in, target, frames - 777 * v, FS) != 0) {
+      printf("FAIL: corpus\n");
+      return 1;
+    }
+  }
+
+  PipelineConfig base;
+  pipeline_default_config(&base);
+  TuneOptions opts;
+  tune_default_options(&opts);
+
+  // 1. Scoring does not depend on how trials are spread over threads
+  GscConfig cands[3] = {base.gsc, base.gsc, base.gsc};
+  cands[1].g_lo = 0.5f;
+  cands[1].g_hi = 0.9f;
+  cands[2].mu_max = 0.0f; // No adaptation: output is the fixed beamformer
+  cands[2].eta_max = 0.0f;
+  TuneResult r1[3], r4[3];
+  opts.threads = 1;
+  int e1 = tune_evaluate(&corpus, &base, cands, 3, &opts, r1);
+  opts.threads = 4;
+  int e4 = tune_evaluate(&corpus, &base, cands, 3, &opts, r4);
+  for (int c = 0; c < 3; c++) {
+    printf("Candidate %d: SNR gain %.2f dB, convergence %.2f s, score %.2f\n",
+           c, r1[c].snr_gain_db, r1[c].convergence_s, r1[c].score);
+  }
+  if (e1 != 0 || e4 != 0 || memcmp(r1, r4, sizeof(r1)) != 0) {
+    printf("FAIL: results depend on the thread count\n");
+    failures++;
+  }
+  // Gain is measured against (L + R) / 2, so without adaptation it is 0 dB
+  // (up to Q15 rounding in LE_FIXED_POINT builds) and the never-moving beta
+  // is converged from the start
+#ifdef LE_FIXED_POINT
+  const float gain_tol = 0.01f;
+#else
+  const float gain_tol = 0.0f;
+#endif
+  if (fabsf(r1[2].snr_gain_db) > gain_tol || r1[2].convergence_s != 0.0f ||
+      r1[0].snr_gain_db == 0.0f) {
+    printf("FAIL: SNR gain scoring\n");
+    failures++;
+  }
+
+  // 2. Grid over two parameters: (3 x 3) - 0 inverted + base
+  tune_default_options(&opts);
+  opts.method = TUNE_METHOD_GRID;
+  for (int p = 0; p < TUNE_PARAM_COUNT; p++)
+    opts.range[p].enabled = (p == TUNE_MU_MAX || p == TUNE_ALPHA);
+  TuneResult best, hist[16];
+  int evaluated = 0;
+  if (tune_run(&corpus, &base, &opts, &best, hist, 16, &evaluated) != 0 ||
+      evaluated != 10) {
+    printf("FAIL: grid ran %d candidates\n", evaluated);
+    failures++;
+  }
+  printf("Grid best: alpha %.4f mu_max %.4f -> %.2f dB (base %.2f)\n",
+         best.gsc.alpha, best.gsc.mu_max, best.snr_gain_db, hist[0].score);
+  for (int i = 0; i < evaluated && i < 16; i++) {
+    if (hist[i].score > best.score) {
+      printf("FAIL: best is not the maximum\n");
+      failures++;
+      break;
+    }
+  }
+  if (best.score < hist[0].score || memcmp(&hist[0].gsc, &base.gsc,
+                                           sizeof(GscConfig)) != 0) {
+    printf("FAIL: grid lost to the base config\n");
+    failures++;
+  }
+
+  // 3. Adaptive search: reproducible with a fixed seed, beats the base
+  tune_default_options(&opts);
+  opts.trials = 24;
+  opts.population = 8;
+  TuneResult a, b;
+  if (tune_run(&corpus, &base, &opts, &a, NULL, 0, &evaluated) != 0 ||
+      evaluated != 24 ||
+      tune_run(&corpus, &base, &opts, &b, NULL, 0, NULL) != 0 ||
+      memcmp(&a, &b, sizeof(a)) != 0) {
+    printf("FAIL: adaptive search not reproducible\n");
+    failures++;
+  }
+  printf("Adaptive best: score %.2f (SNR gain %.2f dB, %.2f s), g_lo %.3f "
+         "g_hi %.3f\n",
+         a.score, a.snr_gain_db, a.convergence_s, a.gsc.g_lo, a.gsc.g_hi);
+  if (a.score < r1[0].score || a.gsc.g_lo > a.gsc.g_hi ||
+      a.gsc.M != base.gsc.M) {
+    printf("FAIL: adaptive result\n");
+    failures++;
+  }
+
+  tune_corpus_free(&corpus);
+  free(in);
+  free(target);
+  if (failures == 0) {
+    printf("PASS\n");
+    return 0;
+  }
+  printf("FAIL (%d)\n", failures);
+  return 1;
+}
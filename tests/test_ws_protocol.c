@@ -0,0 +1,125 @@
+/**
+ * @file test_ws_protocol.c
+ * @brief Binary control TLV round trip, malformed frames, JSON fallback
+ */
+
+#include "../src/server/ws_protocol.h"
+#include <stdio.h>
+#include <string.h>
+
+static DspParams defaults(void) {
+  DspParams p;
+  memset(&p, 0, sizeof(p));
+  p.gsc.M = 64;
+  p.gsc.alpha = 0.01f;
+  p.gsc.mu_max = 0.01f;
+  p.gsc.leak_lambda = 0.0001f;
+  p.agc_target_db = -30.0f;
+  p.ng_thresh_db = -50.0f;
+  return p;
+}
+
+static int test_round_trip(void) {
+  uint8_t buf[64];
+  size_t n = ws_control_begin(buf, sizeof(buf));
+  n = ws_control_put_f32(buf, sizeof(buf), n, WS_TAG_ALPHA, 0.25f);
+  n = ws_control_put_u8(buf, sizeof(buf), n, WS_TAG_AEC_ON, 1);
+  n = ws_control_put_u8(buf, sizeof(buf), n, 200, 7); // Unknown: skipped
+  n = ws_control_put_f32(buf, sizeof(buf), n, WS_TAG_NG_THRESH, -42.5f);
+  n = ws_control_put_i32(buf, sizeof(buf), n, WS_TAG_OUTPUT_DEVICE, 3);
+
+  DspParams p = defaults();
+  int device = -1;
+  int changed = ws_control_apply(buf, n, &p, &device);
+  if (n != 2 + 6 + 3 + 3 + 6 + 6 || changed != 3 || p.gsc.alpha != 0.25f ||
+      p.aec_on != 1 || p.ng_thresh_db != -42.5f || device != 3 ||
+      p.gsc.mu_max != 0.01f || p.agc_target_db != -30.0f) {
+    printf("FAIL: control round trip (len %u, changed %d)\n", (unsigned)n,
+           changed);
+    return 1;
+  }
+  printf("Control TLV round trip: %u bytes, OK\n", (unsigned)n);
+  return 0;
+}
+
+static int test_malformed(void) {
+  uint8_t buf[64];
+  size_t n = ws_control_begin(buf, sizeof(buf));
+  n = ws_control_put_f32(buf, sizeof(buf), n, WS_TAG_ALPHA, 0.5f);
+  n = ws_control_put_f32(buf, sizeof(buf), n, WS_TAG_MU_MAX, 0.5f);
+
+  DspParams p = defaults();
+  int device = -1;
+  // Truncated last entry: nothing may change
+  if (ws_control_apply(buf, n - 1, &p, &device) != -1 ||
+      p.gsc.alpha != 0.01f) {
+    printf("FAIL: truncated frame partially applied\n");
+    return 1;
+  }
+  // Wrong version / wrong kind
+  buf[1] = WS_PROTOCOL_VERSION + 1;
+  if (ws_control_apply(buf, n, &p, &device) != -1) {
+    printf("FAIL: unsupported version accepted\n");
+    return 1;
+  }
+  buf[1] = WS_PROTOCOL_VERSION;
+  buf[0] = WS_KIND_TELEMETRY;
+  if (ws_control_apply(buf, n, &p, &device) != -1) {
+    printf("FAIL: telemetry frame accepted as control\n");
+    return 1;
+  }
+  // Encoder refuses entries that do not fit
+  if (ws_control_put_f32(buf, 9, 2, WS_TAG_ALPHA, 1.0f) != 8 ||
+      ws_control_put_f32(buf, 7, 2, WS_TAG_ALPHA, 1.0f) != 0) {
+    printf("FAIL: encoder bounds\n");
+    return 1;
+  }
+  printf("Malformed frames rejected: OK\n");
+  return 0;
+}
+
+static int test_json_fallback(void) {
+  TelemetryRecord rec;
+  memset(&rec, 0, sizeof(rec));
+  rec.rms_l = 0.5f;
+  rec.rms_out = 0.125f;
+  rec.beta = -1.25f;
+  rec.mu = 0.003f;
+  rec.phase[1] = 2.0f;
+
+  char json[512];
+  size_t len = ws_format_stats_json(&rec, json, sizeof(json));
+  float l, r, b, e, beta, mu;
+  if (len == 0 || len != strlen(json) ||
+      sscanf(json,
+             "{\"l\": %f, \"r\": %f, \"b\": %f, \"e\": %f, \"beta\": %f, "
+             "\"mu\": %f",
+             &l, &r, &b, &e, &beta, &mu) != 6 ||
+      l != 0.5f || e != 0.125f || beta != -1.25f ||
+      strstr(json, "\"phase\": [0.00,2.00,0.00]") == NULL) {
+    printf("FAIL: JSON stats: %s\n", json);
+    return 1;
+  }
+  if (ws_format_stats_json(&rec, json, 16) != 0) {
+    printf("FAIL: JSON stats truncated silently\n");
+    return 1;
+  }
+  printf("JSON fallback (%u bytes) vs binary record (%d bytes): OK\n",
+         (unsigned)len, TELEMETRY_RECORD_BYTES);
+  return 0;
+}
+
+int main(void) {
+  printf("Testing WebSocket protocol...\n");
+  int failures = 0;
+  failures += test_round_trip();
+  failures += test_malformed();
+  failures += test_json_fallback();
+
+  if (failures == 0) {
+    printf("PASS\n");
+    return 0;
+  }
+  printf("FAIL (%d)\n", failures);
+  return 1;
+}
@@ -15,11 +15,15 @@ class RollingChart {
         for (let i = 0; i < colors.length; i++) this.data.push(new Array(maxPoints).fill(min));
     }
 
-    add(values) { // values is array [v1, v2...]
+    push(values) { // values is array [v1, v2...]; call draw() afterwards
         for (let i = 0; i < this.data.length; i++) {
             this.data[i].shift();
             this.data[i].push(values[i]);
         }
+    }
+
+    add(values) {
+        this.push(values);
         this.draw();
     }
 
@@ -63,8 +67,232 @@ const chartError = new RollingChart('chart-error', 100, ['#00E5FF'], 0, 1.0);
 const wsUrl = (location.protocol === 'https:' ? 'wss://' : 'ws://') + location.host + '/ws';
 let socket;
 
+// Binary protocol (see src/server/ws_protocol.h), negotiated via subprotocol.
+// Servers that do not accept it fall back to JSON text frames.
+const WS_SUBPROTOCOL = 'lombardear.bin.v1';
+const WS_PROTOCOL_VERSION = 1;
+const WS_KIND_CONTROL = 2;
+const WS_TAG = {
+    alpha: 1, leak: 2, mu_max: 3, aec_on: 4, agc_on: 5, ng_on: 6,
+    agc_target: 7, ng_thresh: 8, output_device: 9
+};
+const WS_TAG_U8 = new Set([WS_TAG.aec_on, WS_TAG.agc_on, WS_TAG.ng_on]);
+
+// Telemetry batch (see src/utils/telemetry.h):
+//   u8 kind, u8 version, u16 count, u32 dropped, then count records of
+//   u32 seq, u32 frames, 15 x f32 (little-endian)
+const TELEMETRY_FRAME_KIND = 1;
+const TELEMETRY_HEADER_BYTES = 8;
+const TELEMETRY_RECORD_BYTES = 68;
+
+function decodeTelemetry(buf) {
+    const dv = new DataView(buf);
+    if (buf.byteLength < TELEMETRY_HEADER_BYTES || dv.getUint8(0) !== TELEMETRY_FRAME_KIND ||
+        dv.getUint8(1) !== WS_PROTOCOL_VERSION) return null;
+    const count = dv.getUint16(2, true);
+    const dropped = dv.getUint32(4, true);
+    const records = [];
+    for (let i = 0; i < count; i++) {
+        let o = TELEMETRY_HEADER_BYTES + i * TELEMETRY_RECORD_BYTES;
+        if (o + TELEMETRY_RECORD_BYTES > buf.byteLength) break;
+        const f = (k) => dv.getFloat32(o + 8 + k * 4, true);
+        records.push({
+            seq: dv.getUint32(o, true), frames: dv.getUint32(o + 4, true),
+            l: f(0), r: f(1), b: f(2), e: f(3),
+            beta: f(4), mu: f(5), gamma: f(6), dspUs: f(7),
+            jitter: { delay: f(8), mean: f(9), std: f(10), fill: f(11) },
+            phase: [f(12), f(13), f(14)]
+        });
+    }
+    return { dropped: dropped, records: records };
+}
+
+function handleTelemetry(batch) {
+    // One chart point per audio block, one redraw per batch
+    batch.records.forEach(rec => {
+        chartLevels.push([rec.l, rec.r, rec.b]);
+        chartError.push([rec.e]);
+        chartBeta.push([rec.beta]);
+        chartMu.push([rec.mu]);
+    });
+    [chartLevels, chartError, chartBeta, chartMu].forEach(c => c.draw());
+    if (batch.records.length > 0) {
+        const last = batch.records[batch.records.length - 1];
+        document.getElementById('val-beta').innerText = last.beta.toFixed(3);
+        document.getElementById('val-mu').innerText = last.mu.toFixed(5);
+    }
+}
+
+// Spectrum/waveform frame (see src/dsp/scope_tap.h):
+//   u8 kind, u8 version, u8 channels, u8 reserved, u16 bins, u16 wave_points,
+//   u32 sample_rate, f32 db_min, f32 db_max, u8 spectrum[ch][bins],
+//   f16 waveform[ch][wave_points]
+const SCOPE_FRAME_KIND = 3;
+const SCOPE_HEADER_BYTES = 20;
+const SCOPE_NAMES = ['L', 'R', 'B', 'Out', 'U1 (L-R)', 'U2 (D-\u03b2B)'];
+const SCOPE_COLORS = ['#00E676', '#2979FF', '#FF1744', '#FFFFFF', '#FFD600', '#d500f9'];
+const scopeVisible = [true, true, true, true, false, false];
+
+function halfToFloat(h) {
+    const exp = (h >> 10) & 0x1f;
+    const mant = h & 0x3ff;
+    let v;
+    if (exp === 0) v = mant * Math.pow(2, -24);
+    else if (exp === 31) v = mant ? NaN : Infinity;
+    else v = (mant + 1024) * Math.pow(2, exp - 25);
+    return (h & 0x8000) ? -v : v;
+}
+
+function decodeScope(buf) {
+    const dv = new DataView(buf);
+    if (buf.byteLength < SCOPE_HEADER_BYTES || dv.getUint8(1) !== WS_PROTOCOL_VERSION) return null;
+    const channels = dv.getUint8(2);
+    const bins = dv.getUint16(4, true);
+    const wavePoints = dv.getUint16(6, true);
+    if (buf.byteLength < SCOPE_HEADER_BYTES + channels * (bins + 2 * wavePoints)) return null;
+    const frame = {
+        sampleRate: dv.getUint32(8, true),
+        dbMin: dv.getFloat32(12, true),
+        dbMax: dv.getFloat32(16, true),
+        spectra: [], waves: []
+    };
+    let o = SCOPE_HEADER_BYTES;
+    for (let ch = 0; ch < channels; ch++, o += bins) {
+        frame.spectra.push(new Uint8Array(buf, o, bins));
+    }
+    for (let ch = 0; ch < channels; ch++) {
+        const w = new Float32Array(wavePoints);
+        for (let i = 0; i < wavePoints; i++, o += 2) w[i] = halfToFloat(dv.getUint16(o, true));
+        frame.waves.push(w);
+    }
+    return frame;
+}
+
+function fitCanvas(canvas) {
+    canvas.width = canvas.clientWidth;
+    canvas.height = canvas.clientHeight;
+    return canvas.getContext('2d');
+}
+
+function drawScope(frame) {
+    const spec = document.getElementById('scope-spectrum');
+    let ctx = fitCanvas(spec);
+    let w = spec.width, h = spec.height;
+
+    // dB grid every 20 dB, frequency labels every kHz
+    ctx.strokeStyle = '#444';
+    ctx.fillStyle = '#888';
+    ctx.font = '10px monospace';
+    ctx.lineWidth = 1;
+    for (let db = Math.ceil(frame.dbMin / 20) * 20; db <= frame.dbMax; db += 20) {
+        const y = h - (db - frame.dbMin) / (frame.dbMax - frame.dbMin) * h;
+        ctx.beginPath(); ctx.moveTo(0, y); ctx.lineTo(w, y); ctx.stroke();
+        ctx.fillText(db + ' dB', 2, y - 2);
+    }
+    const nyquist = frame.sampleRate / 2;
+    for (let f = 1000; f < nyquist; f += 1000) {
+        const x = f / nyquist * w;
+        ctx.beginPath(); ctx.moveTo(x, 0); ctx.lineTo(x, h); ctx.stroke();
+        ctx.fillText((f / 1000) + 'k', x + 2, h - 2);
+    }
+
+    frame.spectra.forEach((s, ch) => {
+        if (!scopeVisible[ch]) return;
+        ctx.strokeStyle = SCOPE_COLORS[ch];
+        ctx.beginPath();
+        for (let k = 0; k < s.length; k++) {
+            const x = k / (s.length - 1) * w;
+            const y = h - s[k] / 255 * h;
+            if (k === 0) ctx.moveTo(x, y); else ctx.lineTo(x, y);
+        }
+        ctx.stroke();
+    });
+
+    const wave = document.getElementById('scope-wave');
+    ctx = fitCanvas(wave);
+    w = wave.width; h = wave.height;
+    ctx.strokeStyle = '#444';
+    ctx.beginPath(); ctx.moveTo(0, h / 2); ctx.lineTo(w, h / 2); ctx.stroke();
+    frame.waves.forEach((v, ch) => {
+        if (!scopeVisible[ch]) return;
+        ctx.strokeStyle = SCOPE_COLORS[ch];
+        ctx.beginPath();
+        for (let i = 0; i < v.length; i++) {
+            const x = i / (v.length - 1) * w;
+            const y = h / 2 - Math.max(-1, Math.min(1, v[i])) * h / 2;
+            if (i === 0) ctx.moveTo(x, y); else ctx.lineTo(x, y);
+        }
+        ctx.stroke();
+    });
+}
+
+// Channel toggles
+SCOPE_NAMES.forEach((name, ch) => {
+    const label = document.createElement('label');
+    label.style.color = SCOPE_COLORS[ch];
+    const box = document.createElement('input');
+    box.type = 'checkbox';
+    box.checked = scopeVisible[ch];
+    box.addEventListener('change', () => { scopeVisible[ch] = box.checked; });
+    label.appendChild(box);
+    label.appendChild(document.createTextNode(' ' + name));
+    document.getElementById('scope-channels').appendChild(label);
+});
+
+// Encode {tag: value} pairs as a binary control frame (u8 tag, u8 len, value)
+function encodeControl(values) {
+    const entries = Object.entries(values);
+    const buf = new ArrayBuffer(2 + entries.length * 6);
+    const dv = new DataView(buf);
+    dv.setUint8(0, WS_KIND_CONTROL);
+    dv.setUint8(1, WS_PROTOCOL_VERSION);
+    let o = 2;
+    entries.forEach(([key, value]) => {
+        const tag = WS_TAG[key];
+        dv.setUint8(o, tag);
+        if (WS_TAG_U8.has(tag)) {
+            dv.setUint8(o + 1, 1);
+            dv.setUint8(o + 2, value ? 1 : 0);
+            o += 3;
+        } else if (tag === WS_TAG.output_device) {
+            dv.setUint8(o + 1, 4);
+            dv.setInt32(o + 2, value, true);
+            o += 6;
+        } else {
+            dv.setUint8(o + 1, 4);
+            dv.setFloat32(o + 2, value, true);
+            o += 6;
+        }
+    });
+    return buf.slice(0, o);
+}
+
+// Send control values in whichever protocol the server accepted
+function sendControl(values) {
+    if (!socket || socket.readyState !== WebSocket.OPEN) return;
+    if (socket.protocol === WS_SUBPROTOCOL) {
+        socket.send(encodeControl(values));
+    } else {
+        const json = Object.assign({}, values);
+        if ('output_device' in json) {
+            json.set_output_device = json.output_device;
+            delete json.output_device;
+        }
+        socket.send(JSON.stringify(json));
+    }
+}
+
+// JSON fallback stats: one object per server poll
+function handleJsonStats(msg) {
+    handleTelemetry({
+        dropped: 0,
+        records: [{ l: msg.l, r: msg.r, b: msg.b, e: msg.e, beta: msg.beta, mu: msg.mu }]
+    });
+}
+
 function connect() {
-    socket = new WebSocket(wsUrl);
+    socket = new WebSocket(wsUrl, [WS_SUBPROTOCOL]);
+    socket.binaryType = 'arraybuffer';
     const statusEl = document.getElementById('status');
 
     socket.onopen = () => {
@@ -80,6 +308,18 @@ function connect() {
 
     socket.onmessage = (event) => {
         try {
+            if (event.data instanceof ArrayBuffer) {
+                const kind = new DataView(event.data).getUint8(0);
+                if (kind === SCOPE_FRAME_KIND) {
+                    const frame = decodeScope(event.data);
+                    if (frame) drawScope(frame);
+                } else {
+                    const batch = decodeTelemetry(event.data);
+                    if (batch) handleTelemetry(batch);
+                }
+                return;
+            }
+
             const msg = JSON.parse(event.data);
 
             // Handle device list message
@@ -95,17 +335,38 @@ function connect() {
                 return;
             }
 
-            chartLevels.add([msg.l, msg.r, msg.b]);
-            chartError.add([msg.e]);
-            chartBeta.add([msg.beta]);
-            chartMu.add([msg.mu]);
+            // Deadline monitor and stage profile, once per second
+            if (msg.type === 'monitor') {
+                handleMonitor(msg);
+                return;
+            }
+            if (msg.type === 'profile') {
+                handleProfile(msg);
+                return;
+            }
 
-            document.getElementById('val-beta').innerText = msg.beta.toFixed(3);
-            document.getElementById('val-mu').innerText = msg.mu.toFixed(5);
+            if (msg.beta !== undefined) handleJsonStats(msg);
         } catch (e) { console.error(e); }
     };
 }
 
+function handleMonitor(msg) {
+    const iv = msg.interval;
+    document.getElementById('val-load').innerText =
+        (100 * iv.load).toFixed(1) + ' %';
+    document.getElementById('lbl-deadline').innerText =
+        `p99 ${iv.p99_us} us, max ${iv.max_us} us, overruns ${msg.overruns}, xruns ${msg.xruns}`;
+}
+
+// Per-stage share of the DSP time (builds with LE_PROFILE_STAGES only)
+function handleProfile(msg) {
+    const rows = msg.stages.map(s =>
+        `<tr><td>${s.name}</td><td>${s.us_per_block.toFixed(1)} us</td>` +
+        `<td>${s.cycles_per_sample.toFixed(0)} cyc/smp</td>` +
+        `<td>${(100 * s.share).toFixed(0)} %</td></tr>`);
+    document.getElementById('tbl-profile').innerHTML = rows.join('');
+}
+
 connect();
 
 // Controls
@@ -128,7 +389,7 @@ function sendParams() {
         document.getElementById('lbl-agc-target').innerText = agcTarget;
         document.getElementById('lbl-ng-thresh').innerText = ngThresh;
 
-        socket.send(JSON.stringify({
+        sendControl({
             alpha: alpha,
             leak: leak,
             mu_max: muMax,
@@ -137,7 +398,7 @@ function sendParams() {
             ng_on: ngOn,
             agc_target: agcTarget,
             ng_thresh: ngThresh
-        }));
+        });
     }
 }
 
@@ -154,8 +415,6 @@ document.getElementById('sld-ng-thresh').addEventListener('input', sendParams);
 
 // Output device change handler
 document.getElementById('sel-output-device').addEventListener('change', (e) => {
-    if (socket && socket.readyState === WebSocket.OPEN) {
-        const deviceId = parseInt(e.target.value, 10);
-        socket.send(JSON.stringify({ set_output_device: deviceId }));
-    }
+    const deviceId = parseInt(e.target.value, 10);
+    sendControl({ output_device: deviceId });
 });